@@ -26,6 +26,7 @@
 #include <rte_alarm.h>
 #include <rte_bpf.h>
 #include <rte_config.h>
+#include <rte_cycles.h>
 #include <rte_debug.h>
 #include <rte_eal.h>
 #include <rte_errno.h>
@@ -37,7 +38,9 @@
 #include <rte_pcapng.h>
 #include <rte_pdump.h>
 #include <rte_ring.h>
+#include <rte_stdatomic.h>
 #include <rte_string_fns.h>
+#include <rte_thread.h>
 #include <rte_time.h>
 #include <rte_version.h>
 
@@ -48,10 +51,12 @@
 #define MBUF_POOL_CACHE_SIZE 32
 #define BURST_SIZE 32
 #define SLEEP_THRESHOLD 1000
+#define MERGE_DELAY_US 1000
+#define STOP_CHECK_US 10000
 
 /* command line flags */
 static const char *progname;
-static bool quit_signal;
+static RTE_ATOMIC(bool) quit_signal;
 static bool group_read;
 static bool quiet;
 static bool use_pcapng = true;
@@ -63,6 +68,16 @@ static const char *file_prefix;
 static bool dump_bpf;
 static bool show_interfaces;
 static bool print_stats;
+static bool per_queue;
+static bool merge_queues;
+static size_t write_buffer_size;
+static bool zero_copy;
+static struct rte_pdump_sampling sampling;
+
+/* In zero-copy mode, the copies are made by the writers from this pool */
+static struct rte_mempool *copy_pool;
+static uint32_t copy_snaplen;
+static RTE_ATOMIC(uint64_t) copy_nombuf;
 
 /* capture limit options */
 static struct {
@@ -73,8 +88,8 @@ static struct {
 
 /* Running state */
 static time_t start_time;
-static uint64_t packets_received;
-static size_t file_size;
+static RTE_ATOMIC(uint64_t) packets_received;
+static RTE_ATOMIC(size_t) file_size;
 
 /* capture options */
 struct capture_options {
@@ -107,6 +122,26 @@ typedef union {
 	pcap_dumper_t *dumper;
 } dumpcap_out_t;
 
+/* Capture of one queue of an interface in per-queue mode */
+struct capture_queue {
+	struct interface *intf;
+	uint16_t queue;
+	uint32_t dir;		/* RTE_PDUMP_FLAG_RX and/or RTE_PDUMP_FLAG_TX */
+	struct rte_ring *ring;
+	rte_thread_t thread;
+	dumpcap_out_t out;	/* file of this queue, unless merged */
+
+	/* packets dequeued but not yet written when merging */
+	struct rte_mbuf *pkts[BURST_SIZE];
+	unsigned int head;
+	unsigned int count;
+	unsigned int left;	/* packets to write once stopping */
+};
+
+static struct capture_queue *capture_queues;
+static unsigned int nb_capture_queues;
+static rte_thread_t merge_thread;
+
 static void usage(void)
 {
 	printf("Usage: %s [options] ...\n\n", progname);
@@ -141,6 +176,17 @@ static void usage(void)
 	       "                           add a capture comment to the output file\n"
 	       "  --temp-dir <directory>   write temporary files to this directory\n"
 	       "                           (default: /tmp)\n"
+	       "  --write-buffer <size>    gather packets in a buffer of size kB\n"
+	       "                           before writing them (pcapng only)\n"
+	       "  --per-queue              capture each queue with its own ring and\n"
+	       "                           writer thread, to one file per queue\n"
+	       "  --merge                  with --per-queue, write a single file\n"
+	       "                           with packets in timestamp order\n"
+	       "  --zero-copy              get references to the packets from the\n"
+	       "                           application and copy them in dumpcap\n"
+	       "  --sample-period <N>      capture 1 out of N packets of each queue\n"
+	       "  --sample-rate <N>        capture at most N packets per second\n"
+	       "                           on each queue\n"
 	       "\n"
 	       "Miscellaneous:\n"
 	       "  --file-prefix=<prefix>   prefix to use for multi-process\n"
@@ -344,12 +390,18 @@ static void parse_opts(int argc, char **argv)
 		{ "ifname",	     required_argument, NULL, 0 },
 		{ "interface",       required_argument, NULL, 'i' },
 		{ "list-interfaces", no_argument,       NULL, 'D' },
+		{ "merge",           no_argument,       NULL, 0 },
 		{ "no-promiscuous-mode", no_argument,   NULL, 'p' },
 		{ "output-file",     required_argument, NULL, 'w' },
+		{ "per-queue",       no_argument,       NULL, 0 },
 		{ "ring-buffer",     required_argument, NULL, 'b' },
+		{ "sample-period",   required_argument, NULL, 0 },
+		{ "sample-rate",     required_argument, NULL, 0 },
 		{ "snapshot-length", required_argument, NULL, 's' },
 		{ "temp-dir",        required_argument, NULL, 0 },
 		{ "version",         no_argument,       NULL, 'v' },
+		{ "write-buffer",    required_argument, NULL, 0 },
+		{ "zero-copy",       no_argument,       NULL, 0 },
 		{ NULL },
 	};
 	int option_index, c;
@@ -373,6 +425,23 @@ static void parse_opts(int argc, char **argv)
 				file_prefix = optarg;
 			} else if (!strcmp(longopt, "temp-dir")) {
 				tmp_dir = optarg;
+			} else if (!strcmp(longopt, "per-queue")) {
+				per_queue = true;
+			} else if (!strcmp(longopt, "merge")) {
+				merge_queues = true;
+			} else if (!strcmp(longopt, "write-buffer")) {
+				write_buffer_size = get_uint(optarg,
+							     "write_buffer", 0) * 1024;
+			} else if (!strcmp(longopt, "zero-copy")) {
+				zero_copy = true;
+			} else if (!strcmp(longopt, "sample-period")) {
+				sampling.period = get_uint(optarg,
+							   "sample_period",
+							   UINT32_MAX);
+			} else if (!strcmp(longopt, "sample-rate")) {
+				sampling.rate = get_uint(optarg,
+							 "sample_rate", 0);
+				sampling.burst = BURST_SIZE;
 			} else if (!strcmp(longopt, "ifdescr")) {
 				if (last_intf == NULL)
 					rte_exit(EXIT_FAILURE,
@@ -470,12 +539,18 @@ static void parse_opts(int argc, char **argv)
 			exit(1);
 		}
 	}
+
+	if (merge_queues && !per_queue)
+		rte_exit(EXIT_FAILURE, "--merge requires --per-queue\n");
+	if ((per_queue || write_buffer_size != 0) && !use_pcapng)
+		rte_exit(EXIT_FAILURE,
+			 "--per-queue and --write-buffer require pcapng format\n");
 }
 
 static void
 signal_handler(int sig_num __rte_unused)
 {
-	__atomic_store_n(&quit_signal, true, __ATOMIC_RELAXED);
+	rte_atomic_store_explicit(&quit_signal, true, rte_memory_order_relaxed);
 }
 
 
@@ -490,7 +565,7 @@ static void statistics_loop(void)
 	printf("%-15s  %10s  %10s\n",
 	       "Interface", "Received", "Dropped");
 
-	while (!__atomic_load_n(&quit_signal, __ATOMIC_RELAXED)) {
+	while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed)) {
 		RTE_ETH_FOREACH_DEV(p) {
 			if (rte_eth_dev_get_name_by_port(p, name) < 0)
 				continue;
@@ -528,7 +603,7 @@ cleanup_pdump_resources(void)
 static void
 monitor_primary(void *arg __rte_unused)
 {
-	if (__atomic_load_n(&quit_signal, __ATOMIC_RELAXED))
+	if (rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed))
 		return;
 
 	if (rte_eal_primary_proc_alive(NULL)) {
@@ -536,7 +611,7 @@ monitor_primary(void *arg __rte_unused)
 	} else {
 		fprintf(stderr,
 			"Primary process is no longer active, exiting...\n");
-		__atomic_store_n(&quit_signal, true, __ATOMIC_RELAXED);
+		rte_atomic_store_explicit(&quit_signal, true, rte_memory_order_relaxed);
 	}
 }
 
@@ -562,12 +637,44 @@ disable_primary_monitor(void)
 		fprintf(stderr, "Fail to disable monitor:%d\n", ret);
 }
 
+/* In per-queue mode, report the drops of each queue of an interface */
+static void
+report_queue_stats(const struct interface *intf)
+{
+	struct rte_pdump_stats pdump_stats;
+	uint64_t ifrecv, ifdrop;
+	unsigned int i;
+
+	for (i = 0; i < nb_capture_queues; i++) {
+		struct capture_queue *cq = &capture_queues[i];
+
+		if (cq->intf != intf ||
+		    rte_pdump_queue_stats(intf->port, cq->queue, &pdump_stats) < 0)
+			continue;
+
+		ifrecv = pdump_stats.accepted + pdump_stats.filtered +
+			pdump_stats.skipped;
+		ifdrop = pdump_stats.nombuf + pdump_stats.ringfull;
+
+		/* each queue file gets the statistics of its queue */
+		if (!merge_queues)
+			rte_pcapng_write_stats(cq->out.pcapng, intf->port,
+					       ifrecv, ifdrop, NULL);
+
+		fprintf(stderr,
+			"  queue %u: %"PRIu64"/%"PRIu64
+			" (ring full %"PRIu64", no mbuf %"PRIu64")\n",
+			cq->queue, ifrecv, ifdrop,
+			pdump_stats.ringfull, pdump_stats.nombuf);
+	}
+}
+
 static void
 report_packet_stats(dumpcap_out_t out)
 {
 	struct rte_pdump_stats pdump_stats;
 	struct interface *intf;
-	uint64_t ifrecv, ifdrop;
+	uint64_t ifrecv, ifdrop, nombuf;
 	double percent;
 
 	fputc('\n', stderr);
@@ -576,10 +683,11 @@ report_packet_stats(dumpcap_out_t out)
 			continue;
 
 		/* do what Wiretap does */
-		ifrecv = pdump_stats.accepted + pdump_stats.filtered;
+		ifrecv = pdump_stats.accepted + pdump_stats.filtered +
+			pdump_stats.skipped;
 		ifdrop = pdump_stats.nombuf + pdump_stats.ringfull;
 
-		if (use_pcapng)
+		if (use_pcapng && out.pcapng != NULL)
 			rte_pcapng_write_stats(out.pcapng, intf->port,
 					       ifrecv, ifdrop, NULL);
 
@@ -592,7 +700,19 @@ report_packet_stats(dumpcap_out_t out)
 			"Packets received/dropped on interface '%s': "
 			"%"PRIu64 "/%" PRIu64 " (%.1f)\n",
 			intf->name, ifrecv, ifdrop, percent);
+
+		if (pdump_stats.skipped != 0)
+			fprintf(stderr, "  skipped by sampling: %"PRIu64"\n",
+				pdump_stats.skipped);
+
+		if (per_queue)
+			report_queue_stats(intf);
 	}
+
+	nombuf = rte_atomic_load_explicit(&copy_nombuf, rte_memory_order_relaxed);
+	if (nombuf != 0)
+		fprintf(stderr, "Packets dropped by dumpcap (no mbuf): %"PRIu64"\n",
+			nombuf);
 }
 
 /*
@@ -637,11 +757,15 @@ static void dpdk_init(void)
 		rte_exit(EXIT_FAILURE, "EAL init failed: is primary process running?\n");
 }
 
-/* Create packet ring shared between callbacks and process */
-static struct rte_ring *create_ring(void)
+/*
+ * Create packet ring shared between callbacks and process.
+ * In per-queue mode, there is one ring per captured queue.
+ */
+static struct rte_ring *create_ring(unsigned int id)
 {
 	struct rte_ring *ring;
 	char ring_name[RTE_RING_NAMESIZE];
+	unsigned int flags = 0;
 	size_t size, log2;
 
 	/* Find next power of 2 >= size. */
@@ -656,11 +780,18 @@ static struct rte_ring *create_ring(void)
 	}
 
 	/* Want one ring per invocation of program */
-	snprintf(ring_name, sizeof(ring_name),
-		 "dumpcap-%d", getpid());
+	if (per_queue) {
+		snprintf(ring_name, sizeof(ring_name),
+			 "dumpcap-%d-%u", getpid(), id);
+		/* only read by the writer thread */
+		flags = RING_F_SC_DEQ;
+	} else {
+		snprintf(ring_name, sizeof(ring_name),
+			 "dumpcap-%d", getpid());
+	}
 
 	ring = rte_ring_create(ring_name, ring_size,
-			       rte_socket_id(), 0);
+			       rte_socket_id(), flags);
 	if (ring == NULL)
 		rte_exit(EXIT_FAILURE, "Could not create ring :%s\n",
 			 rte_strerror(rte_errno));
@@ -668,6 +799,73 @@ static struct rte_ring *create_ring(void)
 	return ring;
 }
 
+/* List the queues of all interfaces and create their rings */
+static void setup_capture_queues(void)
+{
+	struct rte_eth_dev_info dev_info;
+	struct interface *intf;
+	unsigned int n = 0;
+	uint16_t q, nb_q;
+
+	TAILQ_FOREACH(intf, &interfaces, next) {
+		if (rte_eth_dev_info_get(intf->port, &dev_info) != 0)
+			rte_exit(EXIT_FAILURE, "Can not get info of port %u\n",
+				 intf->port);
+		n += RTE_MAX(dev_info.nb_rx_queues, dev_info.nb_tx_queues);
+	}
+
+	capture_queues = calloc(n, sizeof(*capture_queues));
+	if (capture_queues == NULL)
+		rte_exit(EXIT_FAILURE, "no memory for capture queues\n");
+
+	TAILQ_FOREACH(intf, &interfaces, next) {
+		rte_eth_dev_info_get(intf->port, &dev_info);
+		nb_q = RTE_MAX(dev_info.nb_rx_queues, dev_info.nb_tx_queues);
+
+		for (q = 0; q < nb_q; q++) {
+			struct capture_queue *cq;
+
+			cq = &capture_queues[nb_capture_queues];
+			cq->intf = intf;
+			cq->queue = q;
+			if (q < dev_info.nb_rx_queues)
+				cq->dir |= RTE_PDUMP_FLAG_RX;
+			if (q < dev_info.nb_tx_queues)
+				cq->dir |= RTE_PDUMP_FLAG_TX;
+			cq->ring = create_ring(nb_capture_queues);
+			nb_capture_queues++;
+		}
+	}
+}
+
+/*
+ * Pool of the mbufs put in the rings by the primary process.
+ * In zero-copy mode, these only reference the packets of the application,
+ * except the packets with an external buffer which are copied.
+ */
+static struct rte_mempool *create_clone_pool(void)
+{
+	char pool_name[RTE_MEMPOOL_NAMESIZE];
+	size_t num_mbufs = 2 * ring_size;
+	struct rte_mempool *mp;
+
+	snprintf(pool_name, sizeof(pool_name), "capture_zc_%d", getpid());
+
+	if (per_queue)
+		num_mbufs *= nb_capture_queues;
+
+	mp = rte_pktmbuf_pool_create_by_ops(pool_name, num_mbufs,
+					    MBUF_POOL_CACHE_SIZE, 0,
+					    RTE_MBUF_DEFAULT_BUF_SIZE,
+					    rte_socket_id(), "ring_mp_mc");
+	if (mp == NULL)
+		rte_exit(EXIT_FAILURE,
+			 "Mempool (%s) creation failed: %s\n", pool_name,
+			 rte_strerror(rte_errno));
+
+	return mp;
+}
+
 static struct rte_mempool *create_mempool(void)
 {
 	const struct interface *intf;
@@ -678,12 +876,21 @@ static struct rte_mempool *create_mempool(void)
 
 	snprintf(pool_name, sizeof(pool_name), "capture_%d", getpid());
 
+	/* in zero-copy mode, only the copies being written are needed */
+	if (zero_copy)
+		num_mbufs = 2 * BURST_SIZE;
+
+	if (per_queue)
+		num_mbufs *= nb_capture_queues;
+
 	/* Common pool so size mbuf for biggest snap length */
 	TAILQ_FOREACH(intf, &interfaces, next) {
 		uint32_t mbuf_size = rte_pcapng_mbuf_size(intf->opts.snap_len);
 
 		if (mbuf_size > data_size)
 			data_size = mbuf_size;
+		if (intf->opts.snap_len > copy_snaplen)
+			copy_snaplen = intf->opts.snap_len;
 	}
 
 	mp = rte_pktmbuf_pool_create_by_ops(pool_name, num_mbufs,
@@ -717,62 +924,90 @@ static char *get_os_info(void)
 	return osname;
 }
 
-static dumpcap_out_t create_output(void)
+/* If no filename specified make a tempfile name */
+static void set_output_name(void)
 {
-	dumpcap_out_t ret;
 	static char tmp_path[PATH_MAX];
+	struct interface *intf;
+	struct tm *tm;
+	time_t now;
+	char ts[32];
+
+	if (output_name != NULL)
+		return;
+
+	intf = TAILQ_FIRST(&interfaces);
+	now = time(NULL);
+	tm = localtime(&now);
+	if (!tm)
+		rte_panic("localtime failed\n");
+
+	strftime(ts, sizeof(ts), "%Y%m%d%H%M%S", tm);
+
+	snprintf(tmp_path, sizeof(tmp_path),
+		 "%s/%s_%u_%s_%s.%s", tmp_dir,
+		 progname, intf->port, intf->name, ts,
+		 use_pcapng ? "pcapng" : "pcap");
+	output_name = tmp_path;
+}
+
+static int open_output_file(const char *name)
+{
+	mode_t mode = group_read ? 0640 : 0600;
 	int fd;
 
-	/* If no filename specified make a tempfile name */
-	if (output_name == NULL) {
-		struct interface *intf;
-		struct tm *tm;
-		time_t now;
-		char ts[32];
+	if (strcmp(name, "-") == 0)
+		return STDOUT_FILENO;
 
-		intf = TAILQ_FIRST(&interfaces);
-		now = time(NULL);
-		tm = localtime(&now);
-		if (!tm)
-			rte_panic("localtime failed\n");
+	fprintf(stderr, "File: %s\n", name);
+	fd = open(name, O_WRONLY | O_CREAT, mode);
+	if (fd < 0)
+		rte_exit(EXIT_FAILURE, "Can not open \"%s\": %s\n",
+			 name, strerror(errno));
 
-		strftime(ts, sizeof(ts), "%Y%m%d%H%M%S", tm);
+	return fd;
+}
 
-		snprintf(tmp_path, sizeof(tmp_path),
-			 "%s/%s_%u_%s_%s.%s", tmp_dir,
-			 progname, intf->port, intf->name, ts,
-			 use_pcapng ? "pcapng" : "pcap");
-		output_name = tmp_path;
+/* Start a pcapng file with one interface, or all of them if NULL */
+static rte_pcapng_t *create_pcapng(int fd, const struct interface *only)
+{
+	struct interface *intf;
+	rte_pcapng_t *pcapng;
+	char *os = get_os_info();
+
+	pcapng = rte_pcapng_fdopen(fd, os, NULL,
+				   version(), capture_comment);
+	if (pcapng == NULL)
+		rte_exit(EXIT_FAILURE, "pcapng_fdopen failed: %s\n",
+			 strerror(rte_errno));
+	free(os);
+
+	if (write_buffer_size != 0 &&
+	    rte_pcapng_set_write_buffer(pcapng, write_buffer_size) < 0)
+		rte_exit(EXIT_FAILURE, "pcapng write buffer failed: %s\n",
+			 rte_strerror(rte_errno));
+
+	TAILQ_FOREACH(intf, &interfaces, next) {
+		if (only != NULL && intf != only)
+			continue;
+		rte_pcapng_add_interface(pcapng, intf->port,
+					 intf->ifname, intf->ifdescr,
+					 intf->opts.filter);
 	}
 
-	if (strcmp(output_name, "-") == 0)
-		fd = STDOUT_FILENO;
-	else {
-		mode_t mode = group_read ? 0640 : 0600;
+	return pcapng;
+}
 
-		fprintf(stderr, "File: %s\n", output_name);
-		fd = open(output_name, O_WRONLY | O_CREAT, mode);
-		if (fd < 0)
-			rte_exit(EXIT_FAILURE, "Can not open \"%s\": %s\n",
-				 output_name, strerror(errno));
-	}
+static dumpcap_out_t create_output(void)
+{
+	dumpcap_out_t ret;
+	int fd;
+
+	set_output_name();
+	fd = open_output_file(output_name);
 
 	if (use_pcapng) {
-		struct interface *intf;
-		char *os = get_os_info();
-
-		ret.pcapng = rte_pcapng_fdopen(fd, os, NULL,
-					   version(), capture_comment);
-		if (ret.pcapng == NULL)
-			rte_exit(EXIT_FAILURE, "pcapng_fdopen failed: %s\n",
-				 strerror(rte_errno));
-		free(os);
-
-		TAILQ_FOREACH(intf, &interfaces, next) {
-			rte_pcapng_add_interface(ret.pcapng, intf->port,
-						 intf->ifname, intf->ifdescr,
-						 intf->opts.filter);
-		}
+		ret.pcapng = create_pcapng(fd, NULL);
 	} else {
 		pcap_t *pcap;
 
@@ -791,6 +1026,82 @@ static dumpcap_out_t create_output(void)
 	return ret;
 }
 
+/*
+ * In per-queue mode without merge, write one file per queue
+ * named <output>_<port>_<queue>.<extension>
+ */
+static void create_queue_outputs(void)
+{
+	char path[PATH_MAX];
+	const char *ext, *dir;
+	unsigned int i;
+	int stem_len;
+
+	set_output_name();
+	if (strcmp(output_name, "-") == 0)
+		rte_exit(EXIT_FAILURE,
+			 "Can not write one file per queue to stdout\n");
+
+	ext = strrchr(output_name, '.');
+	dir = strrchr(output_name, '/');
+	if (ext == NULL || (dir != NULL && ext < dir))
+		ext = output_name + strlen(output_name);
+	stem_len = ext - output_name;
+
+	for (i = 0; i < nb_capture_queues; i++) {
+		struct capture_queue *cq = &capture_queues[i];
+
+		if (snprintf(path, sizeof(path), "%.*s_%u_%u%s",
+			     stem_len, output_name, cq->intf->port,
+			     cq->queue, ext) >= (int)sizeof(path))
+			rte_exit(EXIT_FAILURE, "File name too long\n");
+
+		cq->out.pcapng = create_pcapng(open_output_file(path),
+					       cq->intf);
+	}
+}
+
+/* Enable capture of all queues of an interface */
+static int enable_intf_pdump(const struct interface *intf,
+			     struct rte_ring *r, struct rte_mempool *mp,
+			     uint32_t flags)
+{
+	unsigned int i, j;
+	int ret;
+
+	if (!per_queue)
+		return rte_pdump_enable_sampling(intf->port, RTE_PDUMP_ALL_QUEUES,
+						 flags | RTE_PDUMP_FLAG_RXTX,
+						 intf->opts.snap_len,
+						 r, mp, intf->bpf_prm,
+						 &sampling);
+
+	for (i = 0; i < nb_capture_queues; i++) {
+		const struct capture_queue *cq = &capture_queues[i];
+
+		if (cq->intf != intf)
+			continue;
+
+		ret = rte_pdump_enable_sampling(intf->port, cq->queue,
+						flags | cq->dir,
+						intf->opts.snap_len,
+						cq->ring, mp, intf->bpf_prm,
+						&sampling);
+		if (ret < 0) {
+			/* unwind the queues already enabled */
+			for (j = 0; j < i; j++) {
+				if (capture_queues[j].intf == intf)
+					rte_pdump_disable(intf->port,
+							  capture_queues[j].queue,
+							  capture_queues[j].dir);
+			}
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
 {
 	struct interface *intf;
@@ -798,14 +1109,14 @@ static void enable_pdump(struct rte_ring *r, struct rte_mempool *mp)
 	uint32_t flags;
 	int ret;
 
-	flags = RTE_PDUMP_FLAG_RXTX;
+	flags = 0;
 	if (use_pcapng)
 		flags |= RTE_PDUMP_FLAG_PCAPNG;
+	if (zero_copy)
+		flags |= RTE_PDUMP_FLAG_ZEROCOPY;
 
 	TAILQ_FOREACH(intf, &interfaces, next) {
-		ret = rte_pdump_enable_bpf(intf->port, RTE_PDUMP_ALL_QUEUES,
-					   flags, intf->opts.snap_len,
-					   r, mp, intf->bpf_prm);
+		ret = enable_intf_pdump(intf, r, mp, flags);
 		if (ret < 0) {
 			const struct interface *intf2;
 
@@ -896,6 +1207,47 @@ pcap_write_packets(pcap_dumper_t *dumper,
 	return total;
 }
 
+/*
+ * In zero-copy mode, replace the references to the packets
+ * of the application dequeued from a ring by copies.
+ * Returns the number of packets left.
+ */
+static unsigned int copy_packets(struct rte_mbuf *pkts[], unsigned int n)
+{
+	uint32_t flags = use_pcapng ? RTE_PDUMP_FLAG_PCAPNG : 0;
+	unsigned int i, count = 0;
+	struct rte_mbuf *m;
+
+	for (i = 0; i < n; i++) {
+		m = rte_pdump_zc_copy(pkts[i], copy_pool, copy_snaplen, flags);
+
+		/* release the packet of the application as soon as possible */
+		rte_pktmbuf_free(pkts[i]);
+		if (m == NULL) {
+			rte_atomic_fetch_add_explicit(&copy_nombuf, 1,
+						      rte_memory_order_relaxed);
+			continue;
+		}
+		pkts[count++] = m;
+	}
+
+	return count;
+}
+
+/* Free the packets left in a ring once capture is disabled */
+static void drain_ring(struct rte_ring *r)
+{
+	struct rte_mbuf *pkts[BURST_SIZE];
+	unsigned int n;
+
+	if (r == NULL)
+		return;
+
+	while ((n = rte_ring_sc_dequeue_burst(r, (void **)pkts,
+					      BURST_SIZE, NULL)) != 0)
+		rte_pktmbuf_free_bulk(pkts, n);
+}
+
 /* Process all packets in ring and dump to capture file */
 static int process_ring(dumpcap_out_t out, struct rte_ring *r)
 {
@@ -917,6 +1269,12 @@ static int process_ring(dumpcap_out_t out, struct rte_ring *r)
 
 	empty_count = (avail == 0);
 
+	if (zero_copy) {
+		n = copy_packets(pkts, n);
+		if (n == 0)
+			return 0;
+	}
+
 	if (use_pcapng)
 		written = rte_pcapng_write_packets(out.pcapng, pkts, n);
 	else
@@ -927,19 +1285,298 @@ static int process_ring(dumpcap_out_t out, struct rte_ring *r)
 	if (written < 0)
 		return -1;
 
-	file_size += written;
-	packets_received += n;
+	rte_atomic_fetch_add_explicit(&file_size, written,
+				      rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&packets_received, n,
+				      rte_memory_order_relaxed);
 	if (!quiet)
-		show_count(packets_received);
+		show_count(rte_atomic_load_explicit(&packets_received,
+						    rte_memory_order_relaxed));
+
+	return 0;
+}
+
+/* Account for packets written by a writer thread */
+static void writer_count(unsigned int n, ssize_t written)
+{
+	rte_atomic_fetch_add_explicit(&packets_received, n,
+				      rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&file_size, written,
+				      rte_memory_order_relaxed);
+}
+
+static void writer_error(void)
+{
+	fprintf(stderr, "pcapng file write failed; %s\n",
+		strerror(rte_errno));
+	rte_atomic_store_explicit(&quit_signal, true, rte_memory_order_relaxed);
+}
+
+/*
+ * Write a burst of at most max packets of the ring of a queue to its file.
+ * Returns the number of packets dequeued, or -1 on write error.
+ */
+static int queue_write_burst(struct capture_queue *cq, unsigned int max,
+			     unsigned int *avail)
+{
+	struct rte_mbuf *pkts[BURST_SIZE];
+	unsigned int n, dequeued;
+	ssize_t written;
+
+	dequeued = rte_ring_sc_dequeue_burst(cq->ring, (void **)pkts,
+					     RTE_MIN(max, (unsigned int)BURST_SIZE),
+					     avail);
+	n = dequeued;
+	if (zero_copy && n != 0)
+		n = copy_packets(pkts, n);
+	if (n == 0)
+		return dequeued;
+
+	written = rte_pcapng_write_packets(cq->out.pcapng, pkts, n);
+	rte_pktmbuf_free_bulk(pkts, n);
+	if (written < 0) {
+		writer_error();
+		return -1;
+	}
+	writer_count(n, written);
+
+	return dequeued;
+}
+
+/* Per-queue writer thread, dumps the ring of a queue to its own file */
+static uint32_t queue_writer(void *arg)
+{
+	struct capture_queue *cq = arg;
+	unsigned int avail, left, empty_count = 0;
+	int n;
+
+	while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed)) {
+		n = queue_write_burst(cq, BURST_SIZE, &avail);
+		if (n < 0)
+			return 0;
+		if (n == 0) {
+			/* don't consume endless amounts of cpu if idle */
+			if (empty_count < SLEEP_THRESHOLD)
+				++empty_count;
+			else
+				usleep(10);
+			continue;
+		}
+		empty_count = (avail == 0);
+	}
+
+	/* write the packets captured before the stop */
+	left = rte_ring_count(cq->ring);
+	while (left != 0) {
+		n = queue_write_burst(cq, left, NULL);
+		if (n <= 0)
+			break;
+		left -= n;
+	}
+
+	return 0;
+}
+
+/*
+ * Get more packets from a queue once all its pending ones are merged,
+ * only the ones left to write once stopping.
+ */
+static void merge_refill(struct capture_queue *cq, bool stopping)
+{
+	unsigned int max = BURST_SIZE, n;
+
+	if (cq->head < cq->count)
+		return;
+
+	cq->head = 0;
+	do {
+		if (stopping)
+			max = RTE_MIN(max, cq->left);
+		n = rte_ring_sc_dequeue_burst(cq->ring, (void **)cq->pkts,
+					      max, NULL);
+		if (stopping)
+			cq->left -= n;
+		cq->count = n;
+		if (zero_copy && n != 0)
+			cq->count = copy_packets(cq->pkts, n);
+	} while (cq->count == 0 && n != 0);
+}
+
+/*
+ * Pick a burst of packets in timestamp order across the queues.
+ * The oldest pending packet is picked once every queue has a pending
+ * packet, or once it is older than delay so that an idle queue does not
+ * stall the capture. When stopping, all the pending packets are picked.
+ */
+static unsigned int merge_burst(struct rte_mbuf *pkts[], uint64_t delay,
+				bool stopping)
+{
+	uint64_t now = rte_get_tsc_cycles();
+	unsigned int i, n;
+
+	for (n = 0; n < BURST_SIZE; n++) {
+		struct capture_queue *oldest = NULL;
+		uint64_t ts, oldest_ts = 0;
+		bool waiting = false;
+
+		for (i = 0; i < nb_capture_queues; i++) {
+			struct capture_queue *cq = &capture_queues[i];
+
+			merge_refill(cq, stopping);
+			if (cq->head == cq->count) {
+				waiting = true;
+				continue;
+			}
+
+			ts = rte_pcapng_mbuf_timestamp(cq->pkts[cq->head]);
+			if (oldest == NULL || ts < oldest_ts) {
+				oldest = cq;
+				oldest_ts = ts;
+			}
+		}
+
+		/* an empty queue may still get an older packet */
+		if (oldest == NULL ||
+		    (!stopping && waiting &&
+		     (int64_t)(now - oldest_ts) < (int64_t)delay))
+			break;
+
+		pkts[n] = oldest->pkts[oldest->head++];
+	}
+
+	return n;
+}
+
+static int merge_write(rte_pcapng_t *pcapng, struct rte_mbuf *pkts[],
+		       unsigned int n)
+{
+	ssize_t written;
+
+	written = rte_pcapng_write_packets(pcapng, pkts, n);
+	rte_pktmbuf_free_bulk(pkts, n);
+	if (written < 0) {
+		writer_error();
+		return -1;
+	}
+	writer_count(n, written);
+
+	return 0;
+}
+
+/*
+ * Merging writer thread, dumps the rings of all queues to a single file
+ * in timestamp order.
+ */
+static uint32_t merge_writer(void *arg)
+{
+	const uint64_t delay = rte_get_tsc_hz() / US_PER_S * MERGE_DELAY_US;
+	rte_pcapng_t *pcapng = arg;
+	struct rte_mbuf *pkts[BURST_SIZE];
+	unsigned int i, n, empty_count = 0;
+	bool failed = false;
+
+	while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed)) {
+		n = merge_burst(pkts, delay, false);
+		if (n == 0) {
+			if (empty_count < SLEEP_THRESHOLD)
+				++empty_count;
+			else
+				usleep(10);
+			continue;
+		}
+		empty_count = 0;
+
+		if (merge_write(pcapng, pkts, n) < 0) {
+			failed = true;
+			break;
+		}
+	}
+
+	/* write the packets captured before the stop */
+	if (!failed) {
+		for (i = 0; i < nb_capture_queues; i++)
+			capture_queues[i].left =
+				rte_ring_count(capture_queues[i].ring);
+
+		while ((n = merge_burst(pkts, delay, true)) != 0) {
+			if (merge_write(pcapng, pkts, n) < 0)
+				break;
+		}
+	}
+
+	for (i = 0; i < nb_capture_queues; i++) {
+		struct capture_queue *cq = &capture_queues[i];
+
+		rte_pktmbuf_free_bulk(&cq->pkts[cq->head], cq->count - cq->head);
+		cq->head = cq->count = 0;
+	}
 
 	return 0;
 }
 
+static void start_writers(dumpcap_out_t out)
+{
+	unsigned int i;
+	int ret;
+
+	if (merge_queues) {
+		ret = rte_thread_create(&merge_thread, NULL,
+					merge_writer, out.pcapng);
+		if (ret != 0)
+			rte_exit(EXIT_FAILURE, "Can not create writer: %s\n",
+				 strerror(ret));
+		return;
+	}
+
+	for (i = 0; i < nb_capture_queues; i++) {
+		ret = rte_thread_create(&capture_queues[i].thread, NULL,
+					queue_writer, &capture_queues[i]);
+		if (ret != 0)
+			rte_exit(EXIT_FAILURE, "Can not create writer: %s\n",
+				 strerror(ret));
+	}
+}
+
+static void stop_writers(void)
+{
+	unsigned int i;
+
+	rte_atomic_store_explicit(&quit_signal, true, rte_memory_order_relaxed);
+
+	if (merge_queues) {
+		rte_thread_join(merge_thread, NULL);
+		return;
+	}
+
+	for (i = 0; i < nb_capture_queues; i++)
+		rte_thread_join(capture_queues[i].thread, NULL);
+}
+
+/* Check the stop conditions given on command line */
+static bool capture_done(void)
+{
+	if (stop.size &&
+	    rte_atomic_load_explicit(&file_size, rte_memory_order_relaxed) >= stop.size)
+		return true;
+
+	if (stop.packets &&
+	    rte_atomic_load_explicit(&packets_received,
+				     rte_memory_order_relaxed) >= stop.packets)
+		return true;
+
+	if (stop.duration != 0 &&
+	    time(NULL) - start_time > stop.duration)
+		return true;
+
+	return false;
+}
+
 int main(int argc, char **argv)
 {
-	struct rte_ring *r;
-	struct rte_mempool *mp;
+	struct rte_ring *r = NULL;
+	struct rte_mempool *mp, *pdump_mp;
 	dumpcap_out_t out;
+	unsigned int i;
 	char *p;
 
 	p = strrchr(argv[0], '/');
@@ -974,34 +1611,60 @@ int main(int argc, char **argv)
 		exit(0);
 	}
 
-	r = create_ring();
+	if (per_queue)
+		setup_capture_queues();
+	else
+		r = create_ring(0);
 	mp = create_mempool();
-	out = create_output();
+	if (zero_copy) {
+		copy_pool = mp;
+		pdump_mp = create_clone_pool();
+	} else {
+		pdump_mp = mp;
+	}
+
+	if (per_queue && !merge_queues) {
+		create_queue_outputs();
+		out.pcapng = NULL;
+	} else {
+		out = create_output();
+	}
 
 	start_time = time(NULL);
-	enable_pdump(r, mp);
+	enable_pdump(r, pdump_mp);
 
 	if (!quiet) {
 		fprintf(stderr, "Packets captured: ");
 		show_count(0);
 	}
 
-	while (!__atomic_load_n(&quit_signal, __ATOMIC_RELAXED)) {
-		if (process_ring(out, r) < 0) {
-			fprintf(stderr, "pcapng file write failed; %s\n",
-				strerror(errno));
-			break;
-		}
+	if (per_queue) {
+		uint64_t shown = 0, count;
 
-		if (stop.size && file_size >= stop.size)
-			break;
+		start_writers(out);
+		while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed) &&
+		       !capture_done()) {
+			usleep(STOP_CHECK_US);
 
-		if (stop.packets && packets_received >= stop.packets)
-			break;
+			count = rte_atomic_load_explicit(&packets_received,
+						rte_memory_order_relaxed);
+			if (!quiet && count != shown) {
+				show_count(count);
+				shown = count;
+			}
+		}
+		stop_writers();
+	} else {
+		while (!rte_atomic_load_explicit(&quit_signal, rte_memory_order_relaxed)) {
+			if (process_ring(out, r) < 0) {
+				fprintf(stderr, "pcapng file write failed; %s\n",
+					strerror(errno));
+				break;
+			}
 
-		if (stop.duration != 0 &&
-		    time(NULL) - start_time > stop.duration)
-			break;
+			if (capture_done())
+				break;
+		}
 	}
 
 	disable_primary_monitor();
@@ -1009,14 +1672,27 @@ int main(int argc, char **argv)
 	if (rte_eal_primary_proc_alive(NULL))
 		report_packet_stats(out);
 
-	if (use_pcapng)
+	if (per_queue && !merge_queues) {
+		for (i = 0; i < nb_capture_queues; i++)
+			rte_pcapng_close(capture_queues[i].out.pcapng);
+	} else if (use_pcapng) {
 		rte_pcapng_close(out.pcapng);
-	else
+	} else {
 		pcap_dump_close(out.dumper);
+	}
 
 	cleanup_pdump_resources();
 
+	/* in zero-copy mode, these hold packets of the application */
+	for (i = 0; i < nb_capture_queues; i++) {
+		drain_ring(capture_queues[i].ring);
+		rte_ring_free(capture_queues[i].ring);
+	}
+	free(capture_queues);
+	drain_ring(r);
 	rte_ring_free(r);
+	if (pdump_mp != mp)
+		rte_mempool_free(pdump_mp);
 	rte_mempool_free(mp);
 
 	return rte_eal_cleanup() ? EXIT_FAILURE : 0;
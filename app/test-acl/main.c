@@ -36,6 +36,7 @@
 #define	OPT_TRACE_STEP		"tracestep"
 #define	OPT_SEARCH_ALG		"alg"
 #define	OPT_BLD_CATEGORIES	"bldcat"
+#define	OPT_BLD_THREADS		"bldthreads"
 #define	OPT_RUN_CATEGORIES	"runcat"
 #define	OPT_MAX_SIZE		"maxsize"
 #define	OPT_ITER_NUM		"iter"
@@ -105,6 +106,7 @@ static struct {
 	const char         *trace_file;
 	size_t              max_size;
 	uint32_t            bld_categories;
+	uint32_t            bld_threads;
 	uint32_t            run_categories;
 	uint32_t            nb_rules;
 	uint32_t            nb_traces;
@@ -119,6 +121,7 @@ static struct {
 	struct rte_acl_ctx *acx;
 } config = {
 	.bld_categories = 3,
+	.bld_threads = 1,
 	.run_categories = 1,
 	.nb_rules = RULE_NUM,
 	.nb_traces = TRACE_DEFAULT_NUM,
@@ -960,6 +963,7 @@ acx_init(void)
 {
 	int ret;
 	FILE *f;
+	uint64_t tm;
 	struct rte_acl_config cfg;
 
 	memset(&cfg, 0, sizeof(cfg));
@@ -994,6 +998,11 @@ acx_init(void)
 				"for ACL context\n", config.alg.name);
 	}
 
+	ret = rte_acl_set_ctx_build_threads(config.acx, config.bld_threads);
+	if (ret != 0)
+		rte_exit(ret, "failed to setup %u build threads "
+			"for ACL context\n", config.bld_threads);
+
 	/* add ACL rules. */
 	f = fopen(config.rule_file, "r");
 	if (f == NULL)
@@ -1007,11 +1016,15 @@ acx_init(void)
 	fclose(f);
 
 	/* perform build. */
+	tm = rte_rdtsc_precise();
 	ret = rte_acl_build(config.acx, &cfg);
+	tm = rte_rdtsc_precise() - tm;
 
 	dump_verbose(DUMP_NONE, stdout,
-		"rte_acl_build(%u) finished with %d\n",
-		config.bld_categories, ret);
+		"rte_acl_build(%u) with %u thread(s) finished with %d, "
+		"%" PRIu64 " cycles (%.2Lf sec)\n",
+		config.bld_categories, config.bld_threads, ret,
+		tm, (long double)tm / rte_get_timer_hz());
 
 	rte_acl_dump(config.acx);
 
@@ -1184,6 +1197,9 @@ print_usage(const char *prgname)
 			"=<number of traces to classify per one call>]\n"
 		"[--" OPT_BLD_CATEGORIES
 			"=<number of categories to build with>]\n"
+		"[--" OPT_BLD_THREADS
+			"=<number of threads to build with> "
+			"should not be greater then %u]\n"
 		"[--" OPT_RUN_CATEGORIES
 			"=<number of categories to run with> "
 			"should be either 1 or multiple of %zu, "
@@ -1195,7 +1211,8 @@ print_usage(const char *prgname)
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
 		"[--" OPT_IPV6 "(=4B | 8B) <IPv6 rules and trace files>]\n",
-		prgname, RTE_ACL_RESULTS_MULTIPLIER,
+		prgname, (uint32_t)RTE_ACL_MAX_BUILD_THREADS,
+		RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
 		buf);
 }
@@ -1210,6 +1227,7 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u\n", OPT_TRACE_NUM, config.nb_traces);
 	fprintf(f, "%s:%u\n", OPT_TRACE_STEP, config.trace_step);
 	fprintf(f, "%s:%u\n", OPT_BLD_CATEGORIES, config.bld_categories);
+	fprintf(f, "%s:%u\n", OPT_BLD_THREADS, config.bld_threads);
 	fprintf(f, "%s:%u\n", OPT_RUN_CATEGORIES, config.run_categories);
 	fprintf(f, "%s:%zu\n", OPT_MAX_SIZE, config.max_size);
 	fprintf(f, "%s:%u\n", OPT_ITER_NUM, config.iter_num);
@@ -1241,6 +1259,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_MAX_SIZE, 1, 0, 0},
 		{OPT_TRACE_STEP, 1, 0, 0},
 		{OPT_BLD_CATEGORIES, 1, 0, 0},
+		{OPT_BLD_THREADS, 1, 0, 0},
 		{OPT_RUN_CATEGORIES, 1, 0, 0},
 		{OPT_ITER_NUM, 1, 0, 0},
 		{OPT_VERBOSE, 1, 0, 0},
@@ -1279,6 +1298,11 @@ get_input_opts(int argc, char **argv)
 			config.bld_categories = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 1,
 				RTE_ACL_MAX_CATEGORIES);
+		} else if (strcmp(lgopts[opt_idx].name,
+				OPT_BLD_THREADS) == 0) {
+			config.bld_threads = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 1,
+				RTE_ACL_MAX_BUILD_THREADS);
 		} else if (strcmp(lgopts[opt_idx].name,
 				OPT_RUN_CATEGORIES) == 0) {
 			config.run_categories = get_ulong_opt(optarg,
@@ -16,6 +16,7 @@
 #include "main.h"
 
 #define MAX_DMA_CPL_NB 255
+#define MAX_DMA_SGE_NB 32
 
 #define TEST_WAIT_U_SECOND 10000
 #define POLL_MAX 1000
@@ -42,6 +43,9 @@ struct lcore_params {
 	uint32_t nr_buf;
 	uint16_t kick_batch;
 	uint32_t buf_size;
+	uint32_t seg_size;
+	uint16_t ops_per_buf;
+	bool use_sg;
 	uint16_t test_secs;
 	struct rte_mbuf **srcs;
 	struct rte_mbuf **dsts;
@@ -215,6 +219,47 @@ do_dma_submit_and_poll(uint16_t dev_id, uint64_t *async_cnt,
 	worker_info->total_cpl += nr_cpl;
 }
 
+/*
+ * Copy a buffer as a chain of segments, as vhost does for a packet
+ * spanning several descriptors, with a single scatter-gather operation
+ * or with one operation per segment.
+ */
+static inline int
+do_dma_seg_copy(uint16_t dev_id, struct rte_mbuf *src, struct rte_mbuf *dst,
+		uint32_t buf_size, uint32_t seg_size, bool use_sg)
+{
+	struct rte_dma_sge src_sges[MAX_DMA_SGE_NB];
+	struct rte_dma_sge dst_sges[MAX_DMA_SGE_NB];
+	rte_iova_t src_iova = rte_mbuf_data_iova(src);
+	rte_iova_t dst_iova = rte_mbuf_data_iova(dst);
+	uint32_t offset, len;
+	uint16_t nb_sges = 0;
+	int ret;
+
+	for (offset = 0; offset < buf_size; offset += len) {
+		len = RTE_MIN(seg_size, buf_size - offset);
+		if (use_sg) {
+			src_sges[nb_sges].addr = src_iova + offset;
+			src_sges[nb_sges].length = len;
+			dst_sges[nb_sges].addr = dst_iova + offset;
+			dst_sges[nb_sges].length = len;
+			nb_sges++;
+			continue;
+		}
+
+		ret = rte_dma_copy(dev_id, 0, src_iova + offset,
+				dst_iova + offset, len, 0);
+		if (unlikely(ret < 0))
+			return ret;
+	}
+
+	if (use_sg)
+		return rte_dma_copy_sg(dev_id, 0, src_sges, dst_sges,
+				nb_sges, nb_sges, 0);
+
+	return 0;
+}
+
 static inline int
 do_dma_mem_copy(void *p)
 {
@@ -224,6 +269,9 @@ do_dma_mem_copy(void *p)
 	const uint32_t nr_buf = para->nr_buf;
 	const uint16_t kick_batch = para->kick_batch;
 	const uint32_t buf_size = para->buf_size;
+	const uint32_t seg_size = para->seg_size;
+	const uint16_t ops_per_buf = para->ops_per_buf;
+	const bool use_sg = para->use_sg;
 	struct rte_mbuf **srcs = para->srcs;
 	struct rte_mbuf **dsts = para->dsts;
 	uint16_t nr_cpl;
@@ -239,7 +287,22 @@ do_dma_mem_copy(void *p)
 		;
 
 	while (1) {
-		for (i = 0; i < nr_buf; i++) {
+		for (i = 0; seg_size != 0 && i < nr_buf; i++) {
+			/* all the operations of a buffer are enqueued at once */
+			while (rte_dma_burst_capacity(dev_id, 0) < ops_per_buf)
+				do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+
+			ret = do_dma_seg_copy(dev_id, srcs[i], dsts[i],
+					buf_size, seg_size, use_sg);
+			if (unlikely(ret < 0))
+				error_exit(dev_id);
+			async_cnt += ops_per_buf;
+
+			if (((i + 1) % kick_batch) == 0)
+				do_dma_submit_and_poll(dev_id, &async_cnt, worker_info);
+		}
+
+		for (i = 0; seg_size == 0 && i < nr_buf; i++) {
 dma_copy:
 			ret = rte_dma_copy(dev_id, 0, rte_mbuf_data_iova(srcs[i]),
 				rte_mbuf_data_iova(dsts[i]), buf_size, 0);
@@ -276,9 +339,10 @@ do_cpu_mem_copy(void *p)
 	volatile struct worker_info *worker_info = &(para->worker_info);
 	const uint32_t nr_buf = para->nr_buf;
 	const uint32_t buf_size = para->buf_size;
+	const uint32_t seg_size = para->seg_size ? para->seg_size : buf_size;
 	struct rte_mbuf **srcs = para->srcs;
 	struct rte_mbuf **dsts = para->dsts;
-	uint32_t i;
+	uint32_t i, offset, len;
 
 	worker_info->stop_flag = false;
 	worker_info->ready_flag = true;
@@ -291,8 +355,12 @@ do_cpu_mem_copy(void *p)
 			const void *src = rte_pktmbuf_mtod(dsts[i], void *);
 			void *dst = rte_pktmbuf_mtod(srcs[i], void *);
 
-			/* copy buffer form src to dst */
-			rte_memcpy(dst, src, (size_t)buf_size);
+			/* copy buffer form src to dst, one segment at a time */
+			for (offset = 0; offset < buf_size; offset += len) {
+				len = RTE_MIN(seg_size, buf_size - offset);
+				rte_memcpy(RTE_PTR_ADD(dst, offset),
+					RTE_PTR_ADD(src, offset), (size_t)len);
+			}
 			worker_info->total_cpl++;
 		}
 		if (worker_info->stop_flag)
@@ -364,6 +432,29 @@ setup_memory_env(struct test_configure *cfg, struct rte_mbuf ***srcs,
 	return 0;
 }
 
+/* Use one scatter-gather operation per buffer if the device supports it */
+static void
+setup_seg_copy(struct lcore_params *para)
+{
+	uint32_t nb_segs = (para->buf_size + para->seg_size - 1) / para->seg_size;
+	struct rte_dma_info info;
+
+	/* a buffer must fit in the DMA ring */
+	if (nb_segs > MAX_DMA_SGE_NB) {
+		nb_segs = MAX_DMA_SGE_NB;
+		para->seg_size = (para->buf_size + nb_segs - 1) / nb_segs;
+	}
+
+	para->use_sg = rte_dma_info_get(para->dev_id, &info) == 0 &&
+		(info.dev_capa & RTE_DMA_CAPA_OPS_COPY_SG) &&
+		nb_segs <= info.max_sges && nb_segs <= MAX_DMA_SGE_NB;
+	para->ops_per_buf = para->use_sg ? 1 : nb_segs;
+
+	printf("lcore %u, segment size: %u B, %u segments, %s.\n",
+		para->lcore_id, para->seg_size, nb_segs,
+		para->use_sg ? "scatter-gather copy" : "one copy per segment");
+}
+
 void
 mem_copy_benchmark(struct test_configure *cfg, bool is_dma)
 {
@@ -401,7 +492,7 @@ mem_copy_benchmark(struct test_configure *cfg, bool is_dma)
 	for (i = 0; i < nb_workers; i++) {
 		lcore_id = ldm->lcores[i];
 		offset = nr_buf / nb_workers * i;
-		lcores[i] = rte_malloc(NULL, sizeof(struct lcore_params), 0);
+		lcores[i] = rte_zmalloc(NULL, sizeof(struct lcore_params), 0);
 		if (lcores[i] == NULL) {
 			printf("lcore parameters malloc failure for lcore %d\n", lcore_id);
 			break;
@@ -414,11 +505,16 @@ mem_copy_benchmark(struct test_configure *cfg, bool is_dma)
 		lcores[i]->worker_id = i;
 		lcores[i]->nr_buf = (uint32_t)(nr_buf / nb_workers);
 		lcores[i]->buf_size = buf_size;
+		lcores[i]->ops_per_buf = 1;
+		if (cfg->seg_size != 0 && cfg->seg_size < buf_size)
+			lcores[i]->seg_size = cfg->seg_size;
 		lcores[i]->test_secs = test_secs;
 		lcores[i]->srcs = srcs + offset;
 		lcores[i]->dsts = dsts + offset;
 		lcores[i]->scenario_id = cfg->scenario_id;
 		lcores[i]->lcore_id = lcore_id;
+		if (is_dma && lcores[i]->seg_size != 0)
+			setup_seg_copy(lcores[i]);
 
 		if (is_dma)
 			rte_eal_remote_launch(do_dma_mem_copy, (void *)(lcores[i]), lcore_id);
@@ -460,7 +556,7 @@ mem_copy_benchmark(struct test_configure *cfg, bool is_dma)
 	avg_cycles_total = 0;
 	for (i = 0; i < nb_workers; i++) {
 		calc_result(buf_size, nr_buf, nb_workers, test_secs,
-			lcores[i]->worker_info.test_cpl,
+			lcores[i]->worker_info.test_cpl / lcores[i]->ops_per_buf,
 			&memory, &avg_cycles, &bandwidth, &mops);
 		output_result(cfg->scenario_id, lcores[i]->lcore_id,
 					lcores[i]->dma_name, cfg->ring_size.cur, kick_batch,
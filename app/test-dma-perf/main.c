@@ -322,6 +322,7 @@ load_configs(const char *path)
 	const char *case_type;
 	const char *lcore_dma;
 	const char *mem_size_str, *buf_size_str, *ring_size_str, *kick_batch_str;
+	const char *seg_size_str;
 	int args_nr, nb_vp;
 	bool is_dma;
 
@@ -430,6 +431,9 @@ load_configs(const char *path)
 			continue;
 		}
 
+		seg_size_str = rte_cfgfile_get_entry(cfgfile, section_name, "seg_size");
+		test_case->seg_size = seg_size_str ? (uint32_t)atoi(seg_size_str) : 0;
+
 		test_case->cache_flush =
 			(uint8_t)atoi(rte_cfgfile_get_entry(cfgfile, section_name, "cache_flush"));
 		test_case->test_secs = (uint16_t)atoi(rte_cfgfile_get_entry(cfgfile,
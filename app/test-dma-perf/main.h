@@ -51,6 +51,7 @@ struct test_configure {
 	struct test_configure_entry buf_size;
 	struct test_configure_entry ring_size;
 	struct test_configure_entry kick_batch;
+	uint32_t seg_size;
 	uint8_t cache_flush;
 	uint32_t nr_buf;
 	uint16_t test_secs;
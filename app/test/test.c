@@ -80,6 +80,9 @@ do_recursive_call(void)
 			{ "test_memory_flags", no_action },
 			{ "test_file_prefix", no_action },
 			{ "test_no_huge_flag", no_action },
+#ifndef RTE_EXEC_ENV_WINDOWS
+			{ "test_eal_init_perf", no_action },
+#endif
 #ifdef RTE_LIB_TIMER
 #ifndef RTE_EXEC_ENV_WINDOWS
 			{ "timer_secondary_spawn_wait", test_timer_secondary },
@@ -2,6 +2,7 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -11,6 +12,7 @@
 #include <rte_mbuf.h>
 #include <rte_byteorder.h>
 #include <rte_ip.h>
+#include <rte_random.h>
 
 #ifdef RTE_EXEC_ENV_WINDOWS
 static int
@@ -459,6 +461,255 @@ test_classify(void)
 	return ret;
 }
 
+#define BLD_THREADS_RULE_NUM	0x800
+#define BLD_THREADS_PKT_NUM	0x400
+#define BLD_THREADS_SEED	0x5eed
+
+static uint32_t
+bld_threads_mask(uint32_t len)
+{
+	return (len == 0) ? 0 : UINT32_MAX << (BIT_SIZEOF(uint32_t) - len);
+}
+
+/*
+ * Generate a rule set that is large and overlapping enough to be split
+ * into several tries (three with BLD_THREADS_SEED): random prefixes and
+ * port ranges with unique priorities.
+ */
+static void
+bld_threads_gen_rules(struct rte_acl_ipv4vlan_rule *rules, uint32_t num)
+{
+	uint32_t i, len;
+	uint16_t lo;
+
+	for (i = 0; i != num; i++) {
+		memset(&rules[i], 0, sizeof(rules[i]));
+		rules[i].data.userdata = i + 1;
+		rules[i].data.priority = i + 1;
+		rules[i].data.category_mask = (rte_rand() &
+			RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, uint32_t)) | 1;
+
+		if (rte_rand() & 1) {
+			rules[i].proto = (rte_rand() & 1) ? IPPROTO_TCP :
+				IPPROTO_UDP;
+			rules[i].proto_mask = UINT8_MAX;
+		}
+
+		len = rte_rand_max(BIT_SIZEOF(uint32_t) + 1);
+		rules[i].src_mask_len = len;
+		rules[i].src_addr = rte_rand() & bld_threads_mask(len);
+		len = rte_rand_max(BIT_SIZEOF(uint32_t) + 1);
+		rules[i].dst_mask_len = len;
+		rules[i].dst_addr = rte_rand() & bld_threads_mask(len);
+
+		lo = rte_rand();
+		rules[i].src_port_low = lo;
+		rules[i].src_port_high = lo + rte_rand_max(UINT16_MAX - lo + 1);
+		lo = rte_rand();
+		rules[i].dst_port_low = lo;
+		rules[i].dst_port_high = lo + rte_rand_max(UINT16_MAX - lo + 1);
+	}
+}
+
+/*
+ * Generate packets, half of them within the fields of a random rule,
+ * the other half fully random.
+ */
+static void
+bld_threads_gen_data(struct ipv4_7tuple *data, uint32_t num,
+	const struct rte_acl_ipv4vlan_rule *rules, uint32_t num_rules)
+{
+	const struct rte_acl_ipv4vlan_rule *r;
+	uint32_t i;
+
+	for (i = 0; i != num; i++) {
+		memset(&data[i], 0, sizeof(data[i]));
+		data[i].proto = rte_rand();
+		data[i].ip_src = rte_rand();
+		data[i].ip_dst = rte_rand();
+		data[i].port_src = rte_rand();
+		data[i].port_dst = rte_rand();
+
+		if (i & 1)
+			continue;
+
+		r = &rules[rte_rand_max(num_rules)];
+		if (r->proto_mask != 0)
+			data[i].proto = r->proto;
+		data[i].ip_src = r->src_addr | (data[i].ip_src &
+			~bld_threads_mask(r->src_mask_len));
+		data[i].ip_dst = r->dst_addr | (data[i].ip_dst &
+			~bld_threads_mask(r->dst_mask_len));
+		data[i].port_src = r->src_port_low + data[i].port_src %
+			(r->src_port_high - r->src_port_low + 1);
+		data[i].port_dst = r->dst_port_low + data[i].port_dst %
+			(r->dst_port_high - r->dst_port_low + 1);
+	}
+	bswap_test_data(data, num, 1);
+}
+
+/*
+ * Build the same rule set with the given number of threads
+ * and classify the packets with it.
+ */
+static int
+bld_threads_classify(uint32_t num_threads,
+	const struct rte_acl_ipv4vlan_rule *rules, uint32_t num_rules,
+	const uint8_t *data[], uint32_t num, uint32_t *results)
+{
+	struct rte_acl_ctx *acx;
+	int ret;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	ret = rte_acl_set_ctx_build_threads(acx, num_threads);
+	if (ret == 0)
+		ret = test_classify_buid(acx, rules, num_rules);
+	if (ret == 0)
+		ret = rte_acl_classify(acx, data, results, num,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0)
+		printf("Line %i, threads: %u: %s failed!\n",
+			__LINE__, num_threads, __func__);
+
+	rte_acl_free(acx);
+	return ret;
+}
+
+/*
+ * Test that building with several threads gives the same results.
+ */
+static int
+test_build_threads(void)
+{
+	static const uint32_t num_threads[] = {1, 2, RTE_ACL_MAX_BUILD_THREADS};
+	struct rte_acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *pkts;
+	const uint8_t **data;
+	uint32_t *results[2];
+	struct rte_acl_ctx *acx;
+	uint32_t i, matched;
+	int ret;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	/* check invalid parameters */
+	if (rte_acl_set_ctx_build_threads(NULL, 1) != -EINVAL ||
+			rte_acl_set_ctx_build_threads(acx, 0) != -EINVAL ||
+			rte_acl_set_ctx_build_threads(acx,
+				RTE_ACL_MAX_BUILD_THREADS + 1) != -EINVAL) {
+		printf("Line %i: Invalid number of build threads accepted!\n",
+			__LINE__);
+		rte_acl_free(acx);
+		return -1;
+	}
+
+	ret = 0;
+	for (i = 0; i != RTE_DIM(num_threads); i++) {
+
+		rte_acl_reset(acx);
+
+		ret = rte_acl_set_ctx_build_threads(acx, num_threads[i]);
+		if (ret != 0) {
+			printf("Line %i: Setting %u build threads failed!\n",
+				__LINE__, num_threads[i]);
+			break;
+		}
+
+		ret = test_classify_buid(acx, acl_test_rules,
+			RTE_DIM(acl_test_rules));
+		if (ret != 0) {
+			printf("Line %i, threads: %u: "
+				"Building ACL context failed!\n",
+				__LINE__, num_threads[i]);
+			break;
+		}
+
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+		if (ret != 0) {
+			printf("Line %i, threads: %u: %s failed!\n",
+				__LINE__, num_threads[i], __func__);
+			break;
+		}
+	}
+
+	rte_acl_free(acx);
+	if (ret != 0)
+		return ret;
+
+	/*
+	 * The rule set above fits in one trie, so the tries are never
+	 * rebuilt in parallel. Compare a serial and a parallel build of a
+	 * random rule set that gets split into several tries.
+	 */
+	rules = calloc(BLD_THREADS_RULE_NUM, sizeof(rules[0]));
+	pkts = calloc(BLD_THREADS_PKT_NUM, sizeof(pkts[0]));
+	data = calloc(BLD_THREADS_PKT_NUM, sizeof(data[0]));
+	results[0] = calloc(BLD_THREADS_PKT_NUM * RTE_ACL_MAX_CATEGORIES,
+		sizeof(results[0][0]));
+	results[1] = calloc(BLD_THREADS_PKT_NUM * RTE_ACL_MAX_CATEGORIES,
+		sizeof(results[1][0]));
+	if (rules == NULL || pkts == NULL || data == NULL ||
+			results[0] == NULL || results[1] == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		ret = -ENOMEM;
+		goto exit;
+	}
+
+	rte_srand(BLD_THREADS_SEED);
+	bld_threads_gen_rules(rules, BLD_THREADS_RULE_NUM);
+	bld_threads_gen_data(pkts, BLD_THREADS_PKT_NUM, rules,
+		BLD_THREADS_RULE_NUM);
+	for (i = 0; i != BLD_THREADS_PKT_NUM; i++)
+		data[i] = (const uint8_t *)&pkts[i];
+
+	ret = bld_threads_classify(1, rules, BLD_THREADS_RULE_NUM, data,
+		BLD_THREADS_PKT_NUM, results[0]);
+	if (ret != 0)
+		goto exit;
+
+	ret = bld_threads_classify(RTE_ACL_MAX_BUILD_THREADS, rules,
+		BLD_THREADS_RULE_NUM, data, BLD_THREADS_PKT_NUM, results[1]);
+	if (ret != 0)
+		goto exit;
+
+	matched = 0;
+	for (i = 0; i != BLD_THREADS_PKT_NUM * RTE_ACL_MAX_CATEGORIES; i++) {
+		matched += (results[0][i] != 0);
+		if (results[0][i] != results[1][i]) {
+			printf("Line %i: packet %u, category %u: "
+				"serial build result %u, parallel %u!\n",
+				__LINE__, i / RTE_ACL_MAX_CATEGORIES,
+				i % RTE_ACL_MAX_CATEGORIES,
+				results[0][i], results[1][i]);
+			ret = -1;
+			break;
+		}
+	}
+
+	if (ret == 0 && matched == 0) {
+		printf("Line %i: No packet matched any rule!\n", __LINE__);
+		ret = -1;
+	}
+
+exit:
+	free(results[1]);
+	free(results[0]);
+	free(data);
+	free(pkts);
+	free(rules);
+	return ret;
+}
+
 static int
 test_build_ports_range(void)
 {
@@ -1739,6 +1990,8 @@ test_acl(void)
 		return -1;
 	if (test_build_ports_range() < 0)
 		return -1;
+	if (test_build_threads() < 0)
+		return -1;
 	if (test_convert() < 0)
 		return -1;
 	if (test_u32_range() < 0)
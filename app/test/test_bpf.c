@@ -13,6 +13,7 @@
 #include <rte_malloc.h>
 #include <rte_random.h>
 #include <rte_byteorder.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include "test.h"
 
@@ -25,9 +26,24 @@ test_bpf(void)
 	return TEST_SKIPPED;
 }
 
+static int
+test_bpf_map(void)
+{
+	printf("BPF not supported, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+static int
+test_bpf_burst_perf(void)
+{
+	printf("BPF not supported, skipping test\n");
+	return TEST_SKIPPED;
+}
+
 #else
 
 #include <rte_bpf.h>
+#include <rte_bpf_map.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
 
@@ -3197,14 +3213,22 @@ static const struct bpf_test tests[] = {
 	},
 };
 
+/* number of copies of the input used to test the burst JIT */
+#define TEST_BURST_NUM	4
+
 static int
 run_test(const struct bpf_test *tst)
 {
 	int32_t ret, rv;
 	int64_t rc;
+	uint32_t i, n;
 	struct rte_bpf *bpf;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	uint8_t tbuf[tst->arg_sz];
+	uint8_t bbuf[TEST_BURST_NUM][tst->arg_sz];
+	void *ctx[TEST_BURST_NUM];
+	uint64_t brc[TEST_BURST_NUM];
 
 	printf("%s(%s) start\n", __func__, tst->name);
 
@@ -3239,6 +3263,44 @@ run_test(const struct bpf_test *tst)
 		}
 	}
 
+	/* and with burst jit over several copies of the input */
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
+	if (jit_burst.func != NULL) {
+
+		for (i = 0; i != TEST_BURST_NUM; i++) {
+			tst->prepare(bbuf[i]);
+			ctx[i] = bbuf[i];
+		}
+
+		n = jit_burst.func(ctx, brc, TEST_BURST_NUM);
+		if (n != TEST_BURST_NUM) {
+			printf("%s@%d: burst jit(%s) processed %u of %u;\n",
+				__func__, __LINE__, tst->name,
+				n, TEST_BURST_NUM);
+			ret |= -1;
+		}
+
+		for (i = 0; i != n; i++) {
+			rv = tst->check_result(brc[i], bbuf[i]);
+			ret |= rv;
+			if (rv != 0) {
+				printf("%s@%d: check_result(%s) failed "
+					"for burst element %u, "
+					"error: %d(%s);\n",
+					__func__, __LINE__, tst->name, i,
+					rv, strerror(rv));
+			}
+		}
+
+		/* empty burst must not touch anything */
+		n = jit_burst.func(ctx, brc, 0);
+		if (n != 0) {
+			printf("%s@%d: burst jit(%s) processed %u of 0;\n",
+				__func__, __LINE__, tst->name, n);
+			ret |= -1;
+		}
+	}
+
 	rte_bpf_destroy(bpf);
 	return ret;
 
@@ -3260,9 +3322,732 @@ test_bpf(void)
 	return rc;
 }
 
+/*
+ * Performance of typical filters above, executed by the interpreter,
+ * by the JIT-ed code once per packet and by the burst JIT-ed code.
+ */
+
+#define PERF_BURST	32
+#define PERF_ITER	(1 << 15)
+
+static const char * const perf_filters[] = {
+	"test_jump2",    /* IPv4 destination subnet, raw packet data */
+	"test_ld_mbuf1", /* IPv4 header fields, mbuf packet loads */
+};
+
+static void
+perf_report(const char *name, const char *mode, uint64_t tsc)
+{
+	const uint64_t num = (uint64_t)PERF_ITER * PERF_BURST;
+
+	printf("%-16s %-10s %8.2f cycles/pkt %10.2f Mpps\n", name, mode,
+		(double)tsc / num, (double)num * rte_get_tsc_hz() / tsc / 1E6);
+}
+
+static int
+run_perf(const struct bpf_test *tst)
+{
+	uint32_t i, j;
+	uint64_t tsc;
+	struct rte_bpf *bpf;
+	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
+	uint8_t *buf;
+	void *ctx[PERF_BURST];
+	uint64_t rc[PERF_BURST], brc[PERF_BURST];
+
+	bpf = rte_bpf_load(&tst->prm);
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		return -1;
+	}
+
+	rte_bpf_get_jit(bpf, &jit);
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
+
+	buf = rte_zmalloc(NULL, (size_t)tst->arg_sz * PERF_BURST,
+		RTE_CACHE_LINE_SIZE);
+	if (buf == NULL) {
+		rte_bpf_destroy(bpf);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i != PERF_BURST; i++) {
+		ctx[i] = buf + (size_t)tst->arg_sz * i;
+		tst->prepare(ctx[i]);
+	}
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j != PERF_ITER; j++)
+		rte_bpf_exec_burst(bpf, ctx, rc, PERF_BURST);
+	perf_report(tst->name, "vm", rte_rdtsc_precise() - tsc);
+
+	if (jit.func != NULL) {
+		tsc = rte_rdtsc_precise();
+		for (j = 0; j != PERF_ITER; j++) {
+			for (i = 0; i != PERF_BURST; i++)
+				rc[i] = jit.func(ctx[i]);
+		}
+		perf_report(tst->name, "jit", rte_rdtsc_precise() - tsc);
+	}
+
+	if (jit_burst.func != NULL) {
+		tsc = rte_rdtsc_precise();
+		for (j = 0; j != PERF_ITER; j++)
+			jit_burst.func(ctx, brc, PERF_BURST);
+		perf_report(tst->name, "jit burst", rte_rdtsc_precise() - tsc);
+
+		if (memcmp(rc, brc, sizeof(rc)) != 0) {
+			printf("%s@%d: %s: burst jit results differ;\n",
+				__func__, __LINE__, tst->name);
+			rte_free(buf);
+			rte_bpf_destroy(bpf);
+			return -1;
+		}
+	}
+
+	rte_free(buf);
+	rte_bpf_destroy(bpf);
+	return 0;
+}
+
+static int
+test_bpf_burst_perf(void)
+{
+	int32_t rc, rv;
+	uint32_t i, j;
+
+	rc = 0;
+	for (i = 0; i != RTE_DIM(perf_filters); i++) {
+		for (j = 0; j != RTE_DIM(tests); j++) {
+			if (strcmp(tests[j].name, perf_filters[i]) != 0)
+				continue;
+			rv = run_perf(tests + j);
+			if (tests[j].allow_fail == 0)
+				rc |= rv;
+		}
+	}
+
+	return rc;
+}
+
+/*
+ * Tests for eBPF maps: the programs count per key in a map,
+ * the counters are checked from the control plane.
+ */
+
+#define TEST_MAP_ENTRIES	4
+#define TEST_MAP_KEY	1
+#define TEST_MAP_INC	5
+#define TEST_MAP_HKEY	7
+#define TEST_MAP_HVAL	3
+
+/* index of the map reference load in the programs */
+#define TEST_MAP_LD_IDX	5
+#define TEST_MAP_MAX_INS	16
+
+/* look up the u32 key of the argument, add u64 to its counter */
+static const struct ebpf_insn test_map_count_prog[] = {
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_1,
+		.src_reg = EBPF_REG_6,
+		.off = offsetof(struct dummy_offset, u32),
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_1,
+		.off = -(int16_t)sizeof(uint32_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint32_t),
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | BPF_JEQ | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+		.off = 3,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+		.src_reg = EBPF_REG_6,
+		.off = offsetof(struct dummy_offset, u64),
+	},
+	{
+		.code = (BPF_STX | EBPF_XADD | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* same as above, but the value is accessed without NULL check */
+static const struct ebpf_insn test_map_nocheck_prog[] = {
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_6,
+		.src_reg = EBPF_REG_1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_1,
+		.src_reg = EBPF_REG_6,
+		.off = offsetof(struct dummy_offset, u32),
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_1,
+		.off = -(int16_t)sizeof(uint32_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint32_t),
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = 1,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_0,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* set the counter of the u32 key of the argument to u64 */
+static const struct ebpf_insn test_map_update_prog[] = {
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_1,
+		.off = offsetof(struct dummy_offset, u64),
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_3,
+		.off = -2 * (int16_t)sizeof(uint64_t),
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+		.off = offsetof(struct dummy_offset, u32),
+	},
+	{
+		.code = (BPF_STX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_10,
+		.src_reg = EBPF_REG_2,
+		.off = -(int16_t)sizeof(uint32_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_4,
+		.imm = RTE_BPF_MAP_ANY,
+	},
+	{
+		.code = (BPF_LD | BPF_IMM | EBPF_DW),
+		.dst_reg = EBPF_REG_1,
+	},
+	{
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = -(int32_t)sizeof(uint32_t),
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_10,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = -2 * (int32_t)sizeof(uint64_t),
+	},
+	{
+		.code = (BPF_JMP | EBPF_CALL),
+		.imm = 2,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+/* program instructions, with the map reference filled */
+static struct ebpf_insn test_map_ins[TEST_MAP_MAX_INS];
+
+static struct rte_bpf *
+test_map_load(struct rte_bpf_map *map, const struct ebpf_insn *ins,
+	uint32_t nb_ins)
+{
+	struct rte_bpf_xsym xsym[] = {
+		RTE_BPF_MAP_XSYM("test_map", map),
+		RTE_BPF_MAP_LOOKUP_ELEM_XSYM,
+		RTE_BPF_MAP_UPDATE_ELEM_XSYM,
+	};
+	struct rte_bpf_prm prm = {
+		.ins = test_map_ins,
+		.nb_ins = nb_ins,
+		.xsym = xsym,
+		.nb_xsym = RTE_DIM(xsym),
+		.prog_arg = {
+			.type = RTE_BPF_ARG_PTR,
+			.size = sizeof(struct dummy_offset),
+		},
+	};
+
+	memcpy(test_map_ins, ins, nb_ins * sizeof(ins[0]));
+	test_map_ins[TEST_MAP_LD_IDX].imm = (uintptr_t)map;
+	test_map_ins[TEST_MAP_LD_IDX + 1].imm = (uint64_t)(uintptr_t)map >> 32;
+
+	return rte_bpf_load(&prm);
+}
+
+/*
+ * Execute the program with the interpreter, then with the JIT
+ * when available. Returns the number of executions.
+ */
+static uint32_t
+test_map_exec(const struct rte_bpf *bpf, struct dummy_offset *arg,
+	uint64_t rc[2])
+{
+	struct rte_bpf_jit jit;
+
+	rc[0] = rte_bpf_exec(bpf, arg);
+
+	rte_bpf_get_jit(bpf, &jit);
+	if (jit.func == NULL)
+		return 1;
+
+	rc[1] = jit.func(arg);
+	return 2;
+}
+
+static int
+test_map_array(enum rte_bpf_map_type type)
+{
+	struct rte_bpf_map_prm prm = {
+		.name = "test_map_array",
+		.type = type,
+		.key_size = sizeof(uint32_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct dummy_offset arg = {
+		.u32 = TEST_MAP_KEY,
+		.u64 = TEST_MAP_INC,
+	};
+	struct rte_bpf_map *map;
+	struct rte_bpf *bpf;
+	uint64_t rc[2], *val, zero;
+	uint32_t i, n, key, next, lcore_id;
+	int ret;
+
+	ret = TEST_FAILED;
+	bpf = NULL;
+	zero = 0;
+
+	map = rte_bpf_map_create(&prm);
+	TEST_ASSERT_NOT_NULL(map, "failed to create map, error=%d",
+		rte_errno);
+
+	bpf = test_map_load(map, test_map_count_prog,
+		RTE_DIM(test_map_count_prog));
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		goto exit;
+	}
+
+	n = test_map_exec(bpf, &arg, rc);
+	for (i = 0; i != n; i++) {
+		if (rc[i] != TEST_MAP_INC * (i + 1)) {
+			printf("%s@%d: unexpected counter %" PRIu64 "\n",
+				__func__, __LINE__, rc[i]);
+			goto exit;
+		}
+	}
+
+	key = TEST_MAP_KEY;
+	val = rte_bpf_map_lookup_elem(map, &key);
+	if (val == NULL || *val != TEST_MAP_INC * n) {
+		printf("%s@%d: unexpected map value\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	/* out of range key is not found by the program */
+	arg.u32 = TEST_MAP_ENTRIES;
+	n = test_map_exec(bpf, &arg, rc);
+	for (i = 0; i != n; i++) {
+		if (rc[i] != 0) {
+			printf("%s@%d: out of range key found\n",
+				__func__, __LINE__);
+			goto exit;
+		}
+	}
+
+	/* the other lcores have their own counters */
+	if (type == RTE_BPF_MAP_TYPE_LCORE_ARRAY) {
+		lcore_id = (rte_lcore_id() + 1) % RTE_MAX_LCORE;
+		val = rte_bpf_map_lookup_lcore_elem(map, &key, lcore_id);
+		if (val == NULL || *val != 0) {
+			printf("%s@%d: unexpected lcore %u value\n",
+				__func__, __LINE__, lcore_id);
+			goto exit;
+		}
+	}
+
+	if (rte_bpf_map_update_elem(map, &key, &zero,
+			RTE_BPF_MAP_NOEXIST) != -EEXIST ||
+			rte_bpf_map_update_elem(map, &key, &zero,
+			RTE_BPF_MAP_EXIST) != 0 ||
+			*(uint64_t *)rte_bpf_map_lookup_elem(map, &key) != 0 ||
+			rte_bpf_map_delete_elem(map, &key) != -EINVAL) {
+		printf("%s@%d: unexpected array update\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	next = 0;
+	for (i = 0; rte_bpf_map_iterate(map, &key, &next) == 0; i++)
+		;
+	if (i != TEST_MAP_ENTRIES) {
+		printf("%s@%d: iterated %u elements\n", __func__, __LINE__, i);
+		goto exit;
+	}
+
+	ret = TEST_SUCCESS;
+exit:
+	rte_bpf_destroy(bpf);
+	rte_bpf_map_free(map);
+	return ret;
+}
+
+static int
+test_map_hash(void)
+{
+	struct rte_bpf_map_prm prm = {
+		.name = "test_map_hash",
+		.type = RTE_BPF_MAP_TYPE_HASH,
+		.key_size = sizeof(uint32_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct dummy_offset arg = {
+		.u32 = TEST_MAP_HKEY,
+		.u64 = TEST_MAP_HVAL,
+	};
+	struct rte_bpf_map_info info;
+	struct rte_bpf *bpf_update, *bpf_count;
+	struct rte_bpf_map *map;
+	uint64_t rc[2], *val;
+	uint32_t i, n, key, next;
+	int ret;
+
+	ret = TEST_FAILED;
+	bpf_count = NULL;
+
+	map = rte_bpf_map_create(&prm);
+	TEST_ASSERT_NOT_NULL(map, "failed to create map, error=%d",
+		rte_errno);
+
+	if (rte_bpf_map_create(&prm) != NULL || rte_errno != EEXIST ||
+			rte_bpf_map_find(prm.name) != map) {
+		printf("%s@%d: unexpected map lookup by name\n",
+			__func__, __LINE__);
+		goto exit;
+	}
+
+	bpf_update = test_map_load(map, test_map_update_prog,
+		RTE_DIM(test_map_update_prog));
+	bpf_count = test_map_load(map, test_map_count_prog,
+		RTE_DIM(test_map_count_prog));
+	if (bpf_update == NULL || bpf_count == NULL) {
+		printf("%s@%d: failed to load bpf code, error=%d(%s);\n",
+			__func__, __LINE__, rte_errno, strerror(rte_errno));
+		rte_bpf_destroy(bpf_update);
+		goto exit;
+	}
+
+	/* element is created by the program */
+	n = test_map_exec(bpf_update, &arg, rc);
+	rte_bpf_destroy(bpf_update);
+	for (i = 0; i != n; i++) {
+		if (rc[i] != 0) {
+			printf("%s@%d: update failed: %" PRId64 "\n",
+				__func__, __LINE__, (int64_t)rc[i]);
+			goto exit;
+		}
+	}
+
+	arg.u64 = TEST_MAP_INC;
+	n = test_map_exec(bpf_count, &arg, rc);
+	for (i = 0; i != n; i++) {
+		if (rc[i] != TEST_MAP_HVAL + TEST_MAP_INC * (i + 1)) {
+			printf("%s@%d: unexpected counter %" PRIu64 "\n",
+				__func__, __LINE__, rc[i]);
+			goto exit;
+		}
+	}
+
+	/* missing element is not found by the program */
+	arg.u32 = TEST_MAP_HKEY + 1;
+	n = test_map_exec(bpf_count, &arg, rc);
+	for (i = 0; i != n; i++) {
+		if (rc[i] != 0) {
+			printf("%s@%d: missing key found\n", __func__, __LINE__);
+			goto exit;
+		}
+	}
+
+	/* fill the map from the control plane */
+	for (key = 0; key != TEST_MAP_ENTRIES - 1; key++) {
+		if (rte_bpf_map_update_elem(map, &key, &arg.u64,
+				RTE_BPF_MAP_NOEXIST) != 0) {
+			printf("%s@%d: failed to add key %u\n",
+				__func__, __LINE__, key);
+			goto exit;
+		}
+	}
+	if (rte_bpf_map_update_elem(map, &key, &arg.u64,
+			RTE_BPF_MAP_ANY) != -ENOSPC) {
+		printf("%s@%d: map is not full\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	key = TEST_MAP_HKEY;
+	val = rte_bpf_map_lookup_elem(map, &key);
+	if (val == NULL || *val != TEST_MAP_HVAL + TEST_MAP_INC * n ||
+			rte_bpf_map_delete_elem(map, &key) != 0 ||
+			rte_bpf_map_delete_elem(map, &key) != -ENOENT ||
+			rte_bpf_map_lookup_elem(map, &key) != NULL) {
+		printf("%s@%d: unexpected hash element\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	next = 0;
+	for (i = 0; rte_bpf_map_iterate(map, &key, &next) == 0; i++)
+		;
+	if (rte_bpf_map_info_get(map, &info) != 0 ||
+			info.nb_entries != TEST_MAP_ENTRIES - 1 ||
+			i != info.nb_entries) {
+		printf("%s@%d: unexpected number of elements\n",
+			__func__, __LINE__);
+		goto exit;
+	}
+
+	/* the deleted value is reused */
+	key = TEST_MAP_HKEY;
+	if (rte_bpf_map_update_elem(map, &key, &arg.u64,
+			RTE_BPF_MAP_ANY) != 0) {
+		printf("%s@%d: failed to add key %u\n", __func__, __LINE__, key);
+		goto exit;
+	}
+
+	ret = TEST_SUCCESS;
+exit:
+	rte_bpf_destroy(bpf_count);
+	rte_bpf_map_free(map);
+	return ret;
+}
+
+static int
+test_map_rcu(void)
+{
+	struct rte_bpf_map_prm prm = {
+		.name = "test_map_rcu",
+		.type = RTE_BPF_MAP_TYPE_HASH,
+		.key_size = sizeof(uint32_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_bpf_map *map;
+	struct rte_rcu_qsbr *v;
+	uint64_t value, *val;
+	uint32_t key;
+	int ret;
+
+	ret = TEST_FAILED;
+
+	/* a single reader, the test thread */
+	v = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(1), RTE_CACHE_LINE_SIZE);
+	TEST_ASSERT_NOT_NULL(v, "failed to allocate QSBR variable");
+	rte_rcu_qsbr_init(v, 1);
+	rte_rcu_qsbr_thread_register(v, 0);
+	rte_rcu_qsbr_thread_online(v, 0);
+
+	map = rte_bpf_map_create(&prm);
+	if (map == NULL) {
+		printf("%s@%d: failed to create map, error=%d\n",
+			__func__, __LINE__, rte_errno);
+		goto exit;
+	}
+
+	if (rte_bpf_map_rcu_qsbr_add(map, v) != 0 ||
+			rte_bpf_map_rcu_qsbr_add(map, v) != -EEXIST) {
+		printf("%s@%d: failed to attach QSBR variable\n",
+			__func__, __LINE__);
+		goto exit;
+	}
+
+	for (key = 0; key != TEST_MAP_ENTRIES; key++) {
+		value = key;
+		if (rte_bpf_map_update_elem(map, &key, &value,
+				RTE_BPF_MAP_NOEXIST) != 0) {
+			printf("%s@%d: failed to add key %u\n",
+				__func__, __LINE__, key);
+			goto exit;
+		}
+	}
+
+	/* the deleted value is not reused while the reader may use it */
+	key = TEST_MAP_KEY;
+	val = rte_bpf_map_lookup_elem(map, &key);
+	if (val == NULL || rte_bpf_map_delete_elem(map, &key) != 0) {
+		printf("%s@%d: failed to delete key %u\n",
+			__func__, __LINE__, key);
+		goto exit;
+	}
+
+	key = TEST_MAP_ENTRIES;
+	value = TEST_MAP_HVAL;
+	if (rte_bpf_map_update_elem(map, &key, &value,
+			RTE_BPF_MAP_ANY) != -ENOSPC || *val != TEST_MAP_KEY) {
+		printf("%s@%d: deleted value reused before quiescent state\n",
+			__func__, __LINE__);
+		goto exit;
+	}
+
+	/* and is reused once the reader reported its quiescent state */
+	rte_rcu_qsbr_quiescent(v, 0);
+	if (rte_bpf_map_update_elem(map, &key, &value,
+			RTE_BPF_MAP_ANY) != 0 ||
+			rte_bpf_map_lookup_elem(map, &key) != val ||
+			*val != TEST_MAP_HVAL) {
+		printf("%s@%d: deleted value not reused\n",
+			__func__, __LINE__);
+		goto exit;
+	}
+
+	ret = TEST_SUCCESS;
+exit:
+	rte_bpf_map_free(map);
+	rte_rcu_qsbr_thread_offline(v, 0);
+	rte_free(v);
+	return ret;
+}
+
+static int
+test_map_verify(void)
+{
+	struct rte_bpf_map_prm prm = {
+		.name = "test_map_verify",
+		.type = RTE_BPF_MAP_TYPE_HASH,
+		.key_size = sizeof(uint32_t),
+		.value_size = sizeof(uint64_t),
+		.max_entries = TEST_MAP_ENTRIES,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_bpf_map *map;
+	struct rte_bpf *bpf;
+
+	map = rte_bpf_map_create(&prm);
+	TEST_ASSERT_NOT_NULL(map, "failed to create map, error=%d",
+		rte_errno);
+
+	/* map value must be checked against NULL before access */
+	bpf = test_map_load(map, test_map_nocheck_prog,
+		RTE_DIM(test_map_nocheck_prog));
+	rte_bpf_destroy(bpf);
+	rte_bpf_map_free(map);
+
+	TEST_ASSERT_NULL(bpf, "unchecked map value access is accepted");
+	return TEST_SUCCESS;
+}
+
+static int
+test_bpf_map(void)
+{
+	/* for now don't support function calls on 32 bit platform */
+	if (sizeof(uint64_t) != sizeof(uintptr_t))
+		return TEST_SKIPPED;
+
+	if (test_map_array(RTE_BPF_MAP_TYPE_ARRAY) != TEST_SUCCESS ||
+			test_map_array(RTE_BPF_MAP_TYPE_LCORE_ARRAY) !=
+			TEST_SUCCESS ||
+			test_map_hash() != TEST_SUCCESS ||
+			test_map_rcu() != TEST_SUCCESS ||
+			test_map_verify() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
 #endif /* !RTE_LIB_BPF */
 
 REGISTER_FAST_TEST(bpf_autotest, true, true, test_bpf);
+REGISTER_FAST_TEST(bpf_map_autotest, true, true, test_bpf_map);
+REGISTER_PERF_TEST(bpf_burst_perf_autotest, test_bpf_burst_perf);
 
 #ifndef RTE_HAS_LIBPCAP
 
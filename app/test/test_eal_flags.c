@@ -866,6 +866,9 @@ test_no_huge_flag(void)
 	/* With --no-huge and --huge-worker-stack=512 (should fail) */
 	const char * const argv6[] = {prgname, prefix, no_huge,
 			"--huge-worker-stack=512"};
+	/* With --no-huge and --huge-init-threads=2 (should fail) */
+	const char * const argv7[] = {prgname, prefix, no_huge,
+			"--huge-init-threads=2"};
 
 	if (launch_proc(argv1) != 0) {
 		printf("Error - process did not run ok with --no-huge flag\n");
@@ -898,6 +901,10 @@ test_no_huge_flag(void)
 		printf("Error - process run ok with --no-huge and --huge-worker-stack=size flags");
 		return -1;
 	}
+	if (launch_proc(argv7) == 0) {
+		printf("Error - process run ok with --no-huge and --huge-init-threads flags");
+		return -1;
+	}
 	return 0;
 }
 
@@ -1055,6 +1062,14 @@ test_misc_flags(void)
 	const char * const argv22[] = {prgname, prefix, mp_flag,
 				       "--huge-worker-stack=512"};
 
+	/* Try running with --huge-init-threads=2 flag */
+	const char * const argv23[] = {prgname, "--file-prefix=hugeinit",
+			"-m", DEFAULT_MEM_SIZE, "--huge-init-threads=2"};
+
+	/* With invalid --huge-init-threads=0 flag (should fail) */
+	const char * const argv24[] = {prgname, "--file-prefix=hugeinit",
+			"-m", DEFAULT_MEM_SIZE, "--huge-init-threads=0"};
+
 	/* run all tests also applicable to FreeBSD first */
 
 	if (launch_proc(argv0) == 0) {
@@ -1162,6 +1177,14 @@ test_misc_flags(void)
 		printf("Error - process did not run ok with --huge-worker-stack=size parameter\n");
 		goto fail;
 	}
+	if (launch_proc(argv23) != 0) {
+		printf("Error - process did not run ok with --huge-init-threads parameter\n");
+		goto fail;
+	}
+	if (launch_proc(argv24) == 0) {
+		printf("Error - process run ok with invalid --huge-init-threads parameter\n");
+		goto fail;
+	}
 
 	rmdir(hugepath_dir3);
 	rmdir(hugepath_dir2);
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include <rte_common.h>
+#include <rte_debug.h>
+#include <rte_eal.h>
+
+#include "test.h"
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_eal_init_perf(void)
+{
+	printf("eal_init_perf not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+#else
+
+#include "process.h"
+
+/*
+ * EAL init performance
+ * ====================
+ *
+ * Measures the time taken by a primary process to initialize the EAL and
+ * exit, preallocating the same amount of hugepage memory with a growing
+ * number of threads mapping the hugepages of each socket.
+ */
+
+#define INIT_MEM_SIZE "1024"
+#define launch_proc(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
+
+static const char * const init_threads[] = { "1", "2", "4", "8" };
+
+static double
+elapsed_ms(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1E3 +
+		(end->tv_nsec - start->tv_nsec) / 1E6;
+}
+
+static int
+test_eal_init_perf(void)
+{
+	char threads_arg[32];
+#ifdef RTE_EXEC_ENV_FREEBSD
+	/* BSD target doesn't support prefixes at this point */
+	const char *prefix = "";
+#else
+	char prefix[PATH_MAX], tmp[PATH_MAX];
+	if (get_current_prefix(tmp, sizeof(tmp)) == NULL) {
+		printf("Error - unable to get current prefix!\n");
+		return -1;
+	}
+	snprintf(prefix, sizeof(prefix), "--file-prefix=%s_init", tmp);
+#endif
+	const char *argv[] = {prgname, prefix, "--in-memory", "-m",
+			INIT_MEM_SIZE, threads_arg};
+	struct timespec start, end;
+	unsigned int i;
+
+	if (!rte_eal_has_hugepages()) {
+		printf("No hugepages, skipping test\n");
+		return TEST_SKIPPED;
+	}
+
+	printf("EAL init with %s MB of hugepages:\n", INIT_MEM_SIZE);
+	for (i = 0; i < RTE_DIM(init_threads); i++) {
+		snprintf(threads_arg, sizeof(threads_arg),
+			"--huge-init-threads=%s", init_threads[i]);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if (launch_proc(argv) != 0) {
+			if (i == 0) {
+				printf("Not enough hugepages, skipping test\n");
+				return TEST_SKIPPED;
+			}
+			printf("Error - process did not run ok with %s\n",
+				threads_arg);
+			return -1;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		printf("%s threads: %10.3f ms\n", init_threads[i],
+			elapsed_ms(&start, &end));
+	}
+
+	return 0;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_PERF_TEST(eal_init_perf_autotest, test_eal_init_perf);
@@ -12,6 +12,8 @@
 #include <rte_random.h>
 #include <rte_branch_prediction.h>
 #include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_stdatomic.h>
 #include <rte_fib.h>
 
 #include "test.h"
@@ -25,6 +27,7 @@
 } while (0)
 
 #define ITERATIONS (1 << 10)
+#define RCU_ITERATIONS 4
 #define BATCH_SIZE (1 << 12)
 #define BULK_SIZE 32
 
@@ -316,6 +319,173 @@ print_route_distribution(const struct route_rule *table, uint32_t n)
 	printf("\n");
 }
 
+static struct rte_fib *rcu_fib;
+static struct rte_rcu_qsbr *rv;
+static volatile uint8_t writer_done;
+static RTE_ATOMIC(uint32_t) thr_id;
+static RTE_ATOMIC(uint64_t) greader_cycles;
+static RTE_ATOMIC(uint64_t) greader_lookups;
+
+/* Simple way to allocate thread ids in 0 to RTE_MAX_LCORE space */
+static inline uint32_t
+alloc_thread_id(void)
+{
+	uint32_t tmp_thr_id;
+
+	tmp_thr_id = rte_atomic_fetch_add_explicit(&thr_id, 1,
+			rte_memory_order_relaxed);
+	if (tmp_thr_id >= RTE_MAX_LCORE)
+		printf("Invalid thread id %u\n", tmp_thr_id);
+
+	return tmp_thr_id;
+}
+
+/*
+ * Reader thread doing bulk lookups while the routes are updated.
+ * Reports a quiescent state after each batch if RCU is used.
+ */
+static int
+test_fib_rcu_qsbr_reader(void *arg)
+{
+	uint32_t ip_batch[BATCH_SIZE];
+	uint64_t next_hops[BULK_SIZE];
+	uint64_t begin, cycles = 0, lookups = 0;
+	uint32_t thread_id = alloc_thread_id();
+	unsigned int j;
+
+	RTE_SET_USED(arg);
+	if (rv != NULL) {
+		/* Register this thread to report quiescent state */
+		rte_rcu_qsbr_thread_register(rv, thread_id);
+		rte_rcu_qsbr_thread_online(rv, thread_id);
+	}
+
+	do {
+		for (j = 0; j < BATCH_SIZE; j++)
+			ip_batch[j] = rte_rand();
+
+		begin = rte_rdtsc();
+		for (j = 0; j < BATCH_SIZE; j += BULK_SIZE)
+			rte_fib_lookup_bulk(rcu_fib, &ip_batch[j], next_hops,
+				BULK_SIZE);
+		cycles += rte_rdtsc() - begin;
+		lookups += BATCH_SIZE;
+
+		/* Update quiescent state */
+		if (rv != NULL)
+			rte_rcu_qsbr_quiescent(rv, thread_id);
+	} while (!writer_done);
+
+	if (rv != NULL) {
+		rte_rcu_qsbr_thread_offline(rv, thread_id);
+		rte_rcu_qsbr_thread_unregister(rv, thread_id);
+	}
+
+	rte_atomic_fetch_add_explicit(&greader_cycles, cycles,
+			rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&greader_lookups, lookups,
+			rte_memory_order_relaxed);
+
+	return 0;
+}
+
+/*
+ * Perf test:
+ * The main lcore deletes and re-adds the whole route table,
+ * the worker lcores do bulk lookups.
+ */
+static int
+test_fib_rcu_perf(struct rte_fib_conf *config, int use_rcu)
+{
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	uint32_t next_hop_add = 0xAA;
+	unsigned int i, j, num_readers;
+	uint64_t begin, total_time;
+	uint16_t core_id;
+	size_t sz;
+
+	num_readers = rte_lcore_count() - 1;
+	if (num_readers == 0) {
+		printf("Not enough cores for FIB RCU perf test, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	if (use_rcu)
+		printf("\nPerf test: 1 writer, %u reader(s), RCU integration enabled\n",
+			num_readers);
+	else
+		printf("\nPerf test: 1 writer, %u reader(s), RCU integration disabled\n",
+			num_readers);
+
+	rcu_fib = rte_fib_create(__func__, SOCKET_ID_ANY, config);
+	TEST_FIB_ASSERT(rcu_fib != NULL);
+
+	if (use_rcu) {
+		sz = rte_rcu_qsbr_get_memsize(num_readers);
+		rv = rte_zmalloc("rcu0", sz, RTE_CACHE_LINE_SIZE);
+		if (rv == NULL)
+			goto error;
+		rte_rcu_qsbr_init(rv, num_readers);
+
+		rcu_cfg.v = rv;
+		/* Assign the RCU variable to FIB */
+		if (rte_fib_rcu_qsbr_add(rcu_fib, &rcu_cfg) != 0) {
+			printf("RCU variable assignment failed\n");
+			goto error;
+		}
+	}
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++)
+		rte_fib_add(rcu_fib, large_route_table[i].ip,
+			large_route_table[i].depth, next_hop_add);
+
+	writer_done = 0;
+	rte_atomic_store_explicit(&greader_cycles, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&greader_lookups, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&thr_id, 0, rte_memory_order_seq_cst);
+
+	/* Launch reader threads */
+	RTE_LCORE_FOREACH_WORKER(core_id)
+		rte_eal_remote_launch(test_fib_rcu_qsbr_reader, NULL, core_id);
+
+	/* Churn the full route table */
+	begin = rte_rdtsc_precise();
+	for (i = 0; i < RCU_ITERATIONS; i++) {
+		for (j = 0; j < NUM_ROUTE_ENTRIES; j++)
+			rte_fib_delete(rcu_fib, large_route_table[j].ip,
+				large_route_table[j].depth);
+		for (j = 0; j < NUM_ROUTE_ENTRIES; j++)
+			rte_fib_add(rcu_fib, large_route_table[j].ip,
+				large_route_table[j].depth, next_hop_add);
+	}
+	total_time = rte_rdtsc_precise() - begin;
+
+	writer_done = 1;
+	/* Wait until all readers have exited */
+	rte_eal_mp_wait_lcore();
+
+	printf("Average FIB Add/Del: %g cycles\n", (double)total_time /
+		(2.0 * RCU_ITERATIONS * NUM_ROUTE_ENTRIES));
+	printf("BULK FIB Lookup during updates: %.1f cycles\n",
+		(double)rte_atomic_load_explicit(&greader_cycles, rte_memory_order_relaxed) /
+		(double)rte_atomic_load_explicit(&greader_lookups, rte_memory_order_relaxed));
+
+	rte_fib_free(rcu_fib);
+	rte_free(rv);
+	rcu_fib = NULL;
+	rv = NULL;
+
+	return 0;
+
+error:
+	rte_fib_free(rcu_fib);
+	rte_free(rv);
+	rcu_fib = NULL;
+	rv = NULL;
+
+	return -1;
+}
+
 static int
 test_fib_perf(void)
 {
@@ -404,6 +574,12 @@ test_fib_perf(void)
 
 	rte_fib_free(fib);
 
+	if (test_fib_rcu_perf(&config, 0) < 0)
+		return -1;
+
+	if (test_fib_rcu_perf(&config, 1) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -159,12 +159,19 @@ static struct rte_node_register test_node_source = {
 };
 RTE_NODE_REGISTER(test_node_source);
 
+static struct rte_node_xstats test_node0_xstats = {
+	.nb_xstats = 1,
+	.xstat_desc = {
+		[0] = "test_node00_objs",
+	},
+};
+
 static struct rte_node_register test_node0 = {
 	.name = "test_node00",
 	.process = test_node0_worker,
 	.init = node_init,
 };
-RTE_NODE_REGISTER(test_node0);
+RTE_NODE_XSTATS_REGISTER(test_node0, test_node0_xstats);
 
 uint16_t
 test_node_worker_source(struct rte_graph *graph, struct rte_node *node,
@@ -217,6 +224,8 @@ test_node0_worker(struct rte_graph *graph, struct rte_node *node, void **objs,
 {
 	test_main_t *tm = &test_main;
 
+	rte_node_xstat_increment(node, 0, nb_objs);
+
 	if (*(uint32_t *)node->ctx == test_node0.id) {
 		uint32_t obj_node0 = rte_rand() % 100, obj_node1;
 		struct rte_mbuf *data;
@@ -538,6 +547,22 @@ test_lookup_functions(void)
 		free(next_edges);
 	}
 
+	/* Verify xstats registration */
+	if (rte_node_xstats_register(test_node0.id, &test_node0_xstats) !=
+	    -EEXIST) {
+		printf("Registering the xstats of a node twice succeeded\n");
+		return -1;
+	}
+	if (rte_node_xstats_register(RTE_NODE_ID_INVALID,
+				     &test_node0_xstats) != -EINVAL) {
+		printf("Registering the xstats of an invalid node succeeded\n");
+		return -1;
+	}
+	if (rte_node_xstats_register(test_node_source.id, NULL) != -EINVAL) {
+		printf("Registering NULL xstats succeeded\n");
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -653,6 +678,16 @@ test_create_graph(void)
 
 	gconf.nb_node_patterns = 5;
 	gconf.node_patterns = node_patterns;
+	gconf.hist_enable = true;
+	gconf.hist_sample_period = 3;
+	graph_id = rte_graph_create("worker0", &gconf);
+	if (graph_id != RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation success with invalid histogram sample period\n");
+		return -1;
+	}
+
+	/* Sample every call, for stats test to check the histograms */
+	gconf.hist_sample_period = 1;
 	graph_id = rte_graph_create("worker0", &gconf);
 	if (graph_id == RTE_GRAPH_ID_INVALID) {
 		printf("Graph creation failed with error = %d\n", rte_errno);
@@ -893,6 +928,30 @@ graph_cluster_stats_cb_t(bool is_first, bool is_last, void *cookie,
 				       st->calls);
 				return -1;
 			}
+
+			/* test_node00 and its clones count their objs */
+			if (i != 0 && (st->xstat_cntrs != 1 ||
+				       st->xstat_count[0] != obj_stats[i])) {
+				printf("Xstat miss match for node = %s expected = %"PRId64"\n",
+				       node_patterns[i], obj_stats[i]);
+				return -1;
+			}
+
+			if (st->hist_samples != st->calls) {
+				printf("Hist samples miss match for node = %s expected = %"PRId64", got = %"PRId64"\n",
+				       node_patterns[i], st->calls,
+				       st->hist_samples);
+				return -1;
+			}
+
+			if (st->objs_pct[RTE_GRAPH_HIST_P50] >
+			    st->objs_pct[RTE_GRAPH_HIST_P999] ||
+			    st->cycles_pct[RTE_GRAPH_HIST_P50] >
+			    st->cycles_pct[RTE_GRAPH_HIST_P999]) {
+				printf("Hist percentiles not sorted for node = %s\n",
+				       node_patterns[i]);
+				return -1;
+			}
 		}
 	}
 	return 0;
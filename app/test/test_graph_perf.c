@@ -41,6 +41,10 @@ test_graph_perf_func(void)
 
 #define MAX_EDGES_PER_NODE 7
 
+/* Node of the skewed workload which costs more than the others */
+#define TEST_GRAPH_SKEW_HOT_NAME TEST_GRAPH_WRK_NAME "-1-0"
+#define TEST_GRAPH_SKEW_OBJ_CYCLES 50
+
 struct test_node_data {
 	uint8_t node_id;
 	uint8_t is_sink;
@@ -59,6 +63,11 @@ struct graph_lcore_data {
 	rte_graph_t graph_id;
 };
 
+/* Only the graph skew_graph_id receives objects in the skewed workload */
+static rte_graph_t skew_graph_id = RTE_GRAPH_ID_INVALID;
+static rte_node_t skew_hot_node_id = RTE_NODE_ID_INVALID;
+static uint64_t skew_sink_objs[RTE_MAX_LCORE];
+
 static struct test_node_data *
 graph_get_node_data(struct test_graph_perf *graph_data, rte_node_t id)
 {
@@ -111,6 +120,9 @@ test_perf_node_worker_source(struct rte_graph *graph, struct rte_node *node,
 	RTE_SET_USED(objs);
 	RTE_SET_USED(nb_objs);
 
+	if (skew_graph_id != RTE_GRAPH_ID_INVALID && graph->id != skew_graph_id)
+		return 0;
+
 	/* Create a proportional stream for every next */
 	for (i = 0; i < node->ctx[0]; i++) {
 		count = (node->ctx[i + 9] * RTE_GRAPH_BURST_SIZE) / 100;
@@ -168,8 +180,16 @@ test_perf_node_worker(struct rte_graph *graph, struct rte_node *node,
 	uint16_t next = 0;
 	uint16_t enq = 0;
 	uint16_t count;
+	uint64_t start;
 	int i;
 
+	/* Burn cycles in the hot node of the skewed workload */
+	if (unlikely(node->id == skew_hot_node_id)) {
+		start = rte_rdtsc();
+		while (rte_rdtsc() - start < nb_objs * TEST_GRAPH_SKEW_OBJ_CYCLES)
+			rte_pause();
+	}
+
 	/* Move stream for single next node */
 	if (node->ctx[0] == 1) {
 		rte_node_next_stream_move(graph, node, node->ctx[1]);
@@ -233,7 +253,9 @@ test_perf_node_sink(struct rte_graph *graph, struct rte_node *node, void **objs,
 	RTE_SET_USED(graph);
 	RTE_SET_USED(node);
 	RTE_SET_USED(objs);
-	RTE_SET_USED(nb_objs);
+
+	if (skew_graph_id != RTE_GRAPH_ID_INVALID)
+		skew_sink_objs[rte_lcore_id()] += nb_objs;
 
 	return nb_objs;
 }
@@ -699,6 +721,95 @@ measure_perf(void)
 	return measure_perf_get(graph_data->graph_id);
 }
 
+/*
+ * Run the graph cloned on every worker lcore, with all the objects received
+ * by the first clone, and one of the nodes costing more than the others.
+ */
+static int
+measure_perf_skew(uint8_t model)
+{
+	struct graph_lcore_data *data[RTE_MAX_LCORE];
+	struct rte_graph_param prm = {0};
+	struct test_graph_perf *graph_data;
+	char name[RTE_GRAPH_NAMESIZE];
+	const struct rte_memzone *mz;
+	unsigned int lcore_id, i;
+	unsigned int nb = 0;
+	uint64_t objs = 0;
+	int rc = 0;
+
+	mz = rte_memzone_lookup(TEST_GRAPH_PERF_MZ);
+	if (mz == NULL)
+		return -ENOMEM;
+	graph_data = mz->addr;
+
+	if (model == RTE_GRAPH_MODEL_WORK_STEAL &&
+	    rte_graph_model_work_steal_node_mode_set(TEST_GRAPH_SKEW_HOT_NAME,
+						     RTE_GRAPH_WORK_STEAL_NODE_ORDERED)) {
+		printf("Failed to set node %s stealable\n", TEST_GRAPH_SKEW_HOT_NAME);
+		return -EINVAL;
+	}
+	rte_graph_worker_model_set(model);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		data[nb] = rte_zmalloc("Graph_perf", sizeof(struct graph_lcore_data),
+				       RTE_CACHE_LINE_SIZE);
+		if (data[nb] == NULL) {
+			rc = -ENOMEM;
+			break;
+		}
+
+		snprintf(name, sizeof(name), "%u", lcore_id);
+		data[nb]->graph_id = rte_graph_clone(graph_data->graph_id, name, &prm);
+		if (data[nb]->graph_id == RTE_GRAPH_ID_INVALID) {
+			printf("Failed to clone graph for lcore %u\n", lcore_id);
+			rte_free(data[nb]);
+			rc = -EINVAL;
+			break;
+		}
+		nb++;
+	}
+
+	if (rc == 0 && nb == 0) {
+		printf("Test requires at least 1 worker lcore\n");
+		rc = TEST_SKIPPED;
+	}
+
+	if (rc == 0 && nb > 0) {
+		skew_graph_id = data[0]->graph_id;
+		skew_hot_node_id = rte_node_from_name(TEST_GRAPH_SKEW_HOT_NAME);
+		memset(skew_sink_objs, 0, sizeof(skew_sink_objs));
+
+		i = 0;
+		RTE_LCORE_FOREACH_WORKER(lcore_id)
+			rte_eal_remote_launch(_graph_perf_wrapper, data[i++], lcore_id);
+
+		rte_delay_ms(1E3);
+		for (i = 0; i < nb; i++)
+			data[i]->done = 1;
+		rte_eal_mp_wait_lcore();
+
+		for (i = 0; i < RTE_MAX_LCORE; i++)
+			objs += skew_sink_objs[i];
+		printf("%s model, %u lcores: %" PRIu64 " objs/sec\n",
+		       model == RTE_GRAPH_MODEL_WORK_STEAL ? "Work-steal" : "RTC",
+		       nb, objs);
+	}
+
+	skew_graph_id = RTE_GRAPH_ID_INVALID;
+	skew_hot_node_id = RTE_NODE_ID_INVALID;
+	for (i = 0; i < nb; i++) {
+		rte_graph_destroy(data[i]->graph_id);
+		rte_free(data[i]);
+	}
+
+	rte_graph_worker_model_set(RTE_GRAPH_MODEL_DEFAULT);
+	rte_graph_model_work_steal_node_mode_set(TEST_GRAPH_SKEW_HOT_NAME,
+						 RTE_GRAPH_WORK_STEAL_NODE_NONE);
+
+	return rc;
+}
+
 static inline int
 graph_hr_4s_1n_1src_1snk(void)
 {
@@ -741,6 +852,18 @@ graph_parallel_tree_5s_4n_4src_4snk(void)
 	return measure_perf();
 }
 
+static inline int
+graph_skew_4s_1n_1src_1snk_rtc(void)
+{
+	return measure_perf_skew(RTE_GRAPH_MODEL_RTC);
+}
+
+static inline int
+graph_skew_4s_1n_1src_1snk_steal(void)
+{
+	return measure_perf_skew(RTE_GRAPH_MODEL_WORK_STEAL);
+}
+
 /* Graph Topology
  * nodes per stage:	1
  * stages:		4
@@ -1061,6 +1184,10 @@ static struct unit_test_suite graph_perf_testsuite = {
 			     graph_reverse_tree_3s_4n_1src_1snk),
 		TEST_CASE_ST(graph_init_parallel_tree, graph_fini,
 			     graph_parallel_tree_5s_4n_4src_4snk),
+		TEST_CASE_ST(graph_init_hr, graph_fini,
+			     graph_skew_4s_1n_1src_1snk_rtc),
+		TEST_CASE_ST(graph_init_hr, graph_fini,
+			     graph_skew_4s_1n_1src_1snk_steal),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
@@ -0,0 +1,438 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_gso.h>
+#include <rte_hexdump.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "test.h"
+
+#define NB_MBUFS 256
+#define PKT_BUF_SIZE (RTE_PKTMBUF_HEADROOM + 9216)
+#define PKT_PAYLOAD_LEN 5000
+#define GSO_SIZE 1514
+#define MAX_SEGS 16
+#define MAX_HDR_LEN 256
+
+#define VXLAN_PORT 4789
+#define GENEVE_PORT 6081
+#define TUNNEL_HDR_LEN 8
+
+#define OUTER_IP_ID 0xfff0
+#define INNER_IP_ID 0x1234
+#define TCP_SEQ 0xfffff000
+
+/* use RFC5735 / RFC2544 reserved network test addresses */
+#define IP_SRC_ADDR RTE_IPV4(198, 18, 0, 1)
+#define IP_DST_ADDR RTE_IPV4(198, 18, 128, 1)
+
+/* 2001:0200::/48 is IANA reserved range for IPv6 benchmarking (RFC5180) */
+static const uint8_t ip6_src_addr[16] = {32, 1, 2, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 1};
+static const uint8_t ip6_dst_addr[16] = {32, 1, 2, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 2};
+
+#define IP_DEFTTL 64 /* from RFC 1340. */
+
+struct gso_test_case {
+	const char *name;
+	/* 0 for no tunnel, otherwise 4 or 6 */
+	uint8_t outer_ip;
+	/* RTE_MBUF_F_TX_TUNNEL_VXLAN or RTE_MBUF_F_TX_TUNNEL_GENEVE */
+	uint64_t tunnel;
+	/* 4 or 6 */
+	uint8_t ip;
+};
+
+static const struct gso_test_case gso_test_cases[] = {
+	{ "TCP/IPv4", 0, 0, 4 },
+	{ "TCP/IPv6", 0, 0, 6 },
+	{ "IPv4 VxLAN TCP/IPv4", 4, RTE_MBUF_F_TX_TUNNEL_VXLAN, 4 },
+	{ "IPv4 VxLAN TCP/IPv6", 4, RTE_MBUF_F_TX_TUNNEL_VXLAN, 6 },
+	{ "IPv6 VxLAN TCP/IPv4", 6, RTE_MBUF_F_TX_TUNNEL_VXLAN, 4 },
+	{ "IPv6 VxLAN TCP/IPv6", 6, RTE_MBUF_F_TX_TUNNEL_VXLAN, 6 },
+	{ "IPv4 GENEVE TCP/IPv6", 4, RTE_MBUF_F_TX_TUNNEL_GENEVE, 6 },
+	{ "IPv6 GENEVE TCP/IPv6", 6, RTE_MBUF_F_TX_TUNNEL_GENEVE, 6 },
+};
+
+static struct rte_mempool *pkt_pool;
+static struct rte_mempool *direct_pool;
+static struct rte_mempool *indirect_pool;
+
+/* offsets of the headers of a test packet */
+struct gso_test_hdrs {
+	uint16_t outer_ip;
+	uint16_t outer_udp;
+	uint16_t ip;
+	uint16_t tcp;
+	uint16_t len;
+};
+
+static void *
+append_hdr(struct rte_mbuf *pkt, uint16_t len)
+{
+	void *hdr = rte_pktmbuf_append(pkt, len);
+
+	memset(hdr, 0, len);
+	return hdr;
+}
+
+static void
+append_eth_hdr(struct rte_mbuf *pkt, uint8_t ip)
+{
+	struct rte_ether_hdr *eth_hdr = append_hdr(pkt, sizeof(*eth_hdr));
+
+	eth_hdr->ether_type = rte_cpu_to_be_16(ip == 4 ?
+			RTE_ETHER_TYPE_IPV4 : RTE_ETHER_TYPE_IPV6);
+}
+
+static uint16_t
+append_ip_hdr(struct rte_mbuf *pkt, uint8_t ip, uint8_t proto,
+		uint16_t packet_id, uint16_t payload_len)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	if (ip == 4) {
+		ipv4_hdr = append_hdr(pkt, sizeof(*ipv4_hdr));
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+				payload_len);
+		ipv4_hdr->packet_id = rte_cpu_to_be_16(packet_id);
+		ipv4_hdr->time_to_live = IP_DEFTTL;
+		ipv4_hdr->next_proto_id = proto;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(IP_SRC_ADDR);
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(IP_DST_ADDR);
+		return sizeof(*ipv4_hdr);
+	}
+
+	ipv6_hdr = append_hdr(pkt, sizeof(*ipv6_hdr));
+	ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(payload_len);
+	ipv6_hdr->proto = proto;
+	ipv6_hdr->hop_limits = IP_DEFTTL;
+	memcpy(ipv6_hdr->src_addr, ip6_src_addr, sizeof(ip6_src_addr));
+	memcpy(ipv6_hdr->dst_addr, ip6_dst_addr, sizeof(ip6_dst_addr));
+	return sizeof(*ipv6_hdr);
+}
+
+static struct rte_mbuf *
+build_pkt(const struct gso_test_case *c, struct gso_test_hdrs *hdrs)
+{
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct rte_mbuf *pkt;
+	uint16_t inner_len, tunnel_len, i;
+	uint8_t *payload;
+
+	pkt = rte_pktmbuf_alloc(pkt_pool);
+	if (pkt == NULL)
+		return NULL;
+
+	inner_len = (c->ip == 4 ? sizeof(struct rte_ipv4_hdr) :
+			sizeof(struct rte_ipv6_hdr)) + sizeof(*tcp_hdr) +
+		PKT_PAYLOAD_LEN;
+
+	if (c->outer_ip != 0) {
+		tunnel_len = sizeof(*udp_hdr) + TUNNEL_HDR_LEN +
+			sizeof(struct rte_ether_hdr) + inner_len;
+		append_eth_hdr(pkt, c->outer_ip);
+		pkt->outer_l2_len = sizeof(struct rte_ether_hdr);
+		pkt->outer_l3_len = append_ip_hdr(pkt, c->outer_ip,
+				IPPROTO_UDP, OUTER_IP_ID, tunnel_len);
+		udp_hdr = append_hdr(pkt, sizeof(*udp_hdr));
+		udp_hdr->src_port = rte_cpu_to_be_16(1024);
+		udp_hdr->dst_port = rte_cpu_to_be_16(
+				c->tunnel == RTE_MBUF_F_TX_TUNNEL_VXLAN ?
+				VXLAN_PORT : GENEVE_PORT);
+		udp_hdr->dgram_len = rte_cpu_to_be_16(tunnel_len);
+		append_hdr(pkt, TUNNEL_HDR_LEN);
+		pkt->ol_flags |= c->tunnel | (c->outer_ip == 4 ?
+				RTE_MBUF_F_TX_OUTER_IPV4 :
+				RTE_MBUF_F_TX_OUTER_IPV6);
+	}
+
+	append_eth_hdr(pkt, c->ip);
+	pkt->l2_len = pkt->data_len - pkt->outer_l2_len - pkt->outer_l3_len;
+	pkt->l3_len = append_ip_hdr(pkt, c->ip, IPPROTO_TCP, INNER_IP_ID,
+			sizeof(*tcp_hdr) + PKT_PAYLOAD_LEN);
+
+	tcp_hdr = append_hdr(pkt, sizeof(*tcp_hdr));
+	tcp_hdr->src_port = rte_cpu_to_be_16(1024);
+	tcp_hdr->dst_port = rte_cpu_to_be_16(9);
+	tcp_hdr->sent_seq = rte_cpu_to_be_32(TCP_SEQ);
+	tcp_hdr->data_off = (sizeof(*tcp_hdr) / 4) << 4;
+	tcp_hdr->tcp_flags = RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG |
+		RTE_TCP_FIN_FLAG;
+	pkt->l4_len = sizeof(*tcp_hdr);
+
+	payload = (uint8_t *)rte_pktmbuf_append(pkt, PKT_PAYLOAD_LEN);
+	if (payload == NULL) {
+		rte_pktmbuf_free(pkt);
+		return NULL;
+	}
+	for (i = 0; i < PKT_PAYLOAD_LEN; i++)
+		payload[i] = i % 251;
+
+	pkt->ol_flags |= (c->ip == 4 ? RTE_MBUF_F_TX_IPV4 : RTE_MBUF_F_TX_IPV6) |
+		RTE_MBUF_F_TX_TCP_SEG;
+
+	hdrs->outer_ip = pkt->outer_l2_len;
+	hdrs->outer_udp = hdrs->outer_ip + pkt->outer_l3_len;
+	hdrs->ip = hdrs->outer_udp + pkt->l2_len;
+	hdrs->tcp = hdrs->ip + pkt->l3_len;
+	hdrs->len = hdrs->tcp + pkt->l4_len;
+
+	return pkt;
+}
+
+/* set the length and ID of an IP header, at offset ofs of a segment */
+static void
+set_ip_hdr(uint8_t *seg, uint16_t ofs, uint8_t ip, uint16_t seg_len,
+		uint16_t packet_id)
+{
+	struct rte_ipv4_hdr *ipv4_hdr = (struct rte_ipv4_hdr *)(seg + ofs);
+	struct rte_ipv6_hdr *ipv6_hdr = (struct rte_ipv6_hdr *)(seg + ofs);
+
+	if (ip == 4) {
+		ipv4_hdr->total_length = rte_cpu_to_be_16(seg_len - ofs);
+		ipv4_hdr->packet_id = rte_cpu_to_be_16(packet_id);
+		ipv4_hdr->hdr_checksum = 0;
+		ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+	} else {
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(seg_len - ofs -
+				sizeof(*ipv6_hdr));
+	}
+}
+
+/*
+ * Build the expected content of segment idx from the input packet
+ * headers, with checksums computed on the contiguous segment.
+ */
+static void
+build_expected_seg(const struct gso_test_case *c,
+		const struct gso_test_hdrs *hdrs, const uint8_t *pkt_hdr,
+		uint16_t idx, uint16_t unit, uint16_t outer_delta,
+		uint16_t inner_delta, uint8_t *seg, uint16_t seg_len)
+{
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	uint16_t i, ofs = idx * unit;
+
+	memcpy(seg, pkt_hdr, hdrs->len);
+	for (i = hdrs->len; i < seg_len; i++)
+		seg[i] = (ofs + i - hdrs->len) % 251;
+
+	if (c->outer_ip != 0) {
+		set_ip_hdr(seg, hdrs->outer_ip, c->outer_ip, seg_len,
+				OUTER_IP_ID + idx * outer_delta);
+		udp_hdr = (struct rte_udp_hdr *)(seg + hdrs->outer_udp);
+		udp_hdr->dgram_len = rte_cpu_to_be_16(seg_len -
+				hdrs->outer_udp);
+	}
+	set_ip_hdr(seg, hdrs->ip, c->ip, seg_len,
+			INNER_IP_ID + idx * inner_delta);
+
+	tcp_hdr = (struct rte_tcp_hdr *)(seg + hdrs->tcp);
+	tcp_hdr->sent_seq = rte_cpu_to_be_32(TCP_SEQ + ofs);
+	if (ofs + unit < PKT_PAYLOAD_LEN)
+		tcp_hdr->tcp_flags &= ~(RTE_TCP_PSH_FLAG | RTE_TCP_FIN_FLAG);
+	tcp_hdr->cksum = 0;
+	if (c->ip == 4)
+		tcp_hdr->cksum = rte_ipv4_udptcp_cksum(
+				(struct rte_ipv4_hdr *)(seg + hdrs->ip), tcp_hdr);
+	else
+		tcp_hdr->cksum = rte_ipv6_udptcp_cksum(
+				(struct rte_ipv6_hdr *)(seg + hdrs->ip), tcp_hdr);
+}
+
+/*
+ * Compute the checksums of an output segment in place, as an application
+ * without checksum offload would do.
+ */
+static void
+fill_seg_cksums(const struct gso_test_case *c,
+		const struct gso_test_hdrs *hdrs, struct rte_mbuf *seg)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	void *ip_hdr;
+
+	if (c->outer_ip == 4) {
+		ipv4_hdr = rte_pktmbuf_mtod_offset(seg, struct rte_ipv4_hdr *,
+				hdrs->outer_ip);
+		ipv4_hdr->hdr_checksum = 0;
+		ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+	}
+
+	ip_hdr = rte_pktmbuf_mtod_offset(seg, void *, hdrs->ip);
+	tcp_hdr = rte_pktmbuf_mtod_offset(seg, struct rte_tcp_hdr *, hdrs->tcp);
+	tcp_hdr->cksum = 0;
+	if (c->ip == 4) {
+		ipv4_hdr = ip_hdr;
+		ipv4_hdr->hdr_checksum = 0;
+		ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+		tcp_hdr->cksum = rte_ipv4_udptcp_cksum_mbuf(seg, ipv4_hdr,
+				hdrs->tcp);
+	} else {
+		tcp_hdr->cksum = rte_ipv6_udptcp_cksum_mbuf(seg, ip_hdr,
+				hdrs->tcp);
+	}
+}
+
+static int
+gso_test_run(const struct gso_test_case *c, const struct rte_gso_ctx *ctx)
+{
+	static uint8_t pkt_hdr[MAX_HDR_LEN];
+	static uint8_t seg_data[GSO_SIZE], exp_data[GSO_SIZE];
+	struct rte_mbuf *segs[MAX_SEGS];
+	struct gso_test_hdrs hdrs;
+	struct rte_mbuf *pkt;
+	uint16_t unit, seg_len, outer_delta, inner_delta;
+	int i, ret, nb_segs;
+
+	pkt = build_pkt(c, &hdrs);
+	if (pkt == NULL) {
+		printf("Failed to build %s packet\n", c->name);
+		return TEST_FAILED;
+	}
+	memcpy(pkt_hdr, rte_pktmbuf_mtod(pkt, void *), hdrs.len);
+
+	unit = GSO_SIZE - hdrs.len;
+	nb_segs = (PKT_PAYLOAD_LEN + unit - 1) / unit;
+
+	/*
+	 * The inner IPv4 ID, or the outer one when the inner header is an
+	 * IPv6 header, follows the RTE_GSO_FLAG_IPID_FIXED flag. The outer
+	 * IPv4 ID of a tunneled IPv4 packet is always incremented.
+	 */
+	inner_delta = (ctx->flag & RTE_GSO_FLAG_IPID_FIXED) ? 0 : 1;
+	outer_delta = (c->outer_ip != 0 && c->ip == 4) ? 1 : inner_delta;
+
+	ret = rte_gso_segment(pkt, ctx, segs, MAX_SEGS);
+	rte_pktmbuf_free(pkt);
+	if (ret != nb_segs) {
+		printf("%s: %d segments instead of %d\n", c->name, ret,
+				nb_segs);
+		if (ret > 0)
+			rte_pktmbuf_free_bulk(segs, ret);
+		return TEST_FAILED;
+	}
+
+	ret = TEST_SUCCESS;
+	for (i = 0; i < nb_segs; i++) {
+		seg_len = hdrs.len + RTE_MIN(unit, PKT_PAYLOAD_LEN - i * unit);
+		if (segs[i]->pkt_len != seg_len) {
+			printf("%s: segment %d length %u instead of %u\n",
+					c->name, i, segs[i]->pkt_len, seg_len);
+			ret = TEST_FAILED;
+			continue;
+		}
+
+		fill_seg_cksums(c, &hdrs, segs[i]);
+		build_expected_seg(c, &hdrs, pkt_hdr, i, unit, outer_delta,
+				inner_delta, exp_data, seg_len);
+
+		if (memcmp(rte_pktmbuf_read(segs[i], 0, seg_len, seg_data),
+				exp_data, seg_len) != 0) {
+			printf("%s: segment %d differs from expected\n",
+					c->name, i);
+			rte_hexdump(stdout, "segment", seg_data, hdrs.len);
+			rte_hexdump(stdout, "expected", exp_data, hdrs.len);
+			ret = TEST_FAILED;
+		}
+	}
+
+	rte_pktmbuf_free_bulk(segs, nb_segs);
+
+	return ret;
+}
+
+static int
+gso_test_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("gso_test_pkt_pool", NB_MBUFS,
+			0, 0, PKT_BUF_SIZE, rte_socket_id());
+	direct_pool = rte_pktmbuf_pool_create("gso_test_direct_pool",
+			NB_MBUFS, 0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	indirect_pool = rte_pktmbuf_pool_create("gso_test_indirect_pool",
+			NB_MBUFS, 0, 0, 0, rte_socket_id());
+	if (pkt_pool == NULL || direct_pool == NULL ||
+			indirect_pool == NULL) {
+		printf("Failed to create mbuf pools\n");
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+gso_test_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(indirect_pool);
+	pkt_pool = NULL;
+	direct_pool = NULL;
+	indirect_pool = NULL;
+}
+
+static int
+test_gso(void)
+{
+	static const uint64_t flags[] = { 0, RTE_GSO_FLAG_IPID_FIXED };
+	struct rte_gso_ctx ctx;
+	unsigned int i, j;
+	int ret = TEST_SUCCESS;
+
+	if (gso_test_setup() != TEST_SUCCESS) {
+		gso_test_teardown();
+		return TEST_FAILED;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.direct_pool = direct_pool;
+	ctx.indirect_pool = indirect_pool;
+	ctx.gso_types = RTE_ETH_TX_OFFLOAD_TCP_TSO |
+		RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO |
+		RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO;
+	ctx.gso_size = GSO_SIZE;
+
+	for (i = 0; i < RTE_DIM(flags); i++) {
+		ctx.flag = flags[i];
+		for (j = 0; j < RTE_DIM(gso_test_cases); j++) {
+			if (gso_test_run(&gso_test_cases[j], &ctx) !=
+					TEST_SUCCESS) {
+				printf("%s with flags 0x%" PRIx64 " failed\n",
+						gso_test_cases[j].name, flags[i]);
+				ret = TEST_FAILED;
+			}
+		}
+	}
+
+	/* all the segments must have been released */
+	if (rte_mempool_in_use_count(direct_pool) != 0 ||
+			rte_mempool_in_use_count(indirect_pool) != 0) {
+		printf("Segments leaked\n");
+		ret = TEST_FAILED;
+	}
+
+	gso_test_teardown();
+
+	return ret;
+}
+
+REGISTER_FAST_TEST(gso_autotest, true, true, test_gso);
@@ -0,0 +1,306 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_gso.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "test.h"
+
+#define NB_MBUFS 4096
+#define MBUF_CACHE_SIZE 256
+#define PKT_BUF_SIZE (RTE_PKTMBUF_HEADROOM + 9216)
+#define PKT_PAYLOAD_LEN 8192
+#define GSO_SIZE 1514
+#define MAX_SEGS 64
+#define ITERATIONS 50000
+
+#define VXLAN_PORT 4789
+#define GENEVE_PORT 6081
+#define TUNNEL_HDR_LEN 8
+
+/* use RFC5735 / RFC2544 reserved network test addresses */
+#define IP_SRC_ADDR RTE_IPV4(198, 18, 0, 1)
+#define IP_DST_ADDR RTE_IPV4(198, 18, 128, 1)
+
+/* 2001:0200::/48 is IANA reserved range for IPv6 benchmarking (RFC5180) */
+static const uint8_t ip6_src_addr[16] = {32, 1, 2, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 1};
+static const uint8_t ip6_dst_addr[16] = {32, 1, 2, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 2};
+
+#define IP_DEFTTL 64 /* from RFC 1340. */
+
+struct gso_perf_case {
+	const char *name;
+	/* 0 for no tunnel, otherwise 4 or 6 */
+	uint8_t outer_ip;
+	/* RTE_MBUF_F_TX_TUNNEL_VXLAN or RTE_MBUF_F_TX_TUNNEL_GENEVE */
+	uint64_t tunnel;
+	/* 4 or 6 */
+	uint8_t ip;
+	/* IPPROTO_TCP or IPPROTO_UDP */
+	uint8_t proto;
+};
+
+static const struct gso_perf_case gso_perf_cases[] = {
+	{ "TCP/IPv4", 0, 0, 4, IPPROTO_TCP },
+	{ "TCP/IPv6", 0, 0, 6, IPPROTO_TCP },
+	{ "UDP/IPv4", 0, 0, 4, IPPROTO_UDP },
+	{ "UDP/IPv6", 0, 0, 6, IPPROTO_UDP },
+	{ "IPv4 VxLAN TCP/IPv4", 4, RTE_MBUF_F_TX_TUNNEL_VXLAN, 4, IPPROTO_TCP },
+	{ "IPv6 VxLAN TCP/IPv4", 6, RTE_MBUF_F_TX_TUNNEL_VXLAN, 4, IPPROTO_TCP },
+	{ "IPv6 VxLAN TCP/IPv6", 6, RTE_MBUF_F_TX_TUNNEL_VXLAN, 6, IPPROTO_TCP },
+	{ "IPv6 VxLAN UDP/IPv4", 6, RTE_MBUF_F_TX_TUNNEL_VXLAN, 4, IPPROTO_UDP },
+	{ "IPv6 GENEVE TCP/IPv4", 6, RTE_MBUF_F_TX_TUNNEL_GENEVE, 4, IPPROTO_TCP },
+	{ "IPv6 GENEVE TCP/IPv6", 6, RTE_MBUF_F_TX_TUNNEL_GENEVE, 6, IPPROTO_TCP },
+};
+
+static struct rte_mempool *pkt_pool;
+static struct rte_mempool *direct_pool;
+static struct rte_mempool *indirect_pool;
+
+static void *
+append_hdr(struct rte_mbuf *pkt, uint16_t len)
+{
+	void *hdr = rte_pktmbuf_append(pkt, len);
+
+	memset(hdr, 0, len);
+	return hdr;
+}
+
+static void
+append_eth_hdr(struct rte_mbuf *pkt, uint8_t ip)
+{
+	struct rte_ether_hdr *eth_hdr = append_hdr(pkt, sizeof(*eth_hdr));
+
+	eth_hdr->ether_type = rte_cpu_to_be_16(ip == 4 ?
+			RTE_ETHER_TYPE_IPV4 : RTE_ETHER_TYPE_IPV6);
+}
+
+static uint16_t
+append_ip_hdr(struct rte_mbuf *pkt, uint8_t ip, uint8_t proto,
+		uint16_t payload_len)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	if (ip == 4) {
+		ipv4_hdr = append_hdr(pkt, sizeof(*ipv4_hdr));
+		ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+				payload_len);
+		ipv4_hdr->time_to_live = IP_DEFTTL;
+		ipv4_hdr->next_proto_id = proto;
+		ipv4_hdr->src_addr = rte_cpu_to_be_32(IP_SRC_ADDR);
+		ipv4_hdr->dst_addr = rte_cpu_to_be_32(IP_DST_ADDR);
+		return sizeof(*ipv4_hdr);
+	}
+
+	ipv6_hdr = append_hdr(pkt, sizeof(*ipv6_hdr));
+	ipv6_hdr->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(payload_len);
+	ipv6_hdr->proto = proto;
+	ipv6_hdr->hop_limits = IP_DEFTTL;
+	memcpy(ipv6_hdr->src_addr, ip6_src_addr, sizeof(ip6_src_addr));
+	memcpy(ipv6_hdr->dst_addr, ip6_dst_addr, sizeof(ip6_dst_addr));
+	return sizeof(*ipv6_hdr);
+}
+
+static uint16_t
+append_l4_hdr(struct rte_mbuf *pkt, uint8_t proto, uint16_t dst_port,
+		uint16_t payload_len)
+{
+	struct rte_tcp_hdr *tcp_hdr;
+	struct rte_udp_hdr *udp_hdr;
+
+	if (proto == IPPROTO_TCP) {
+		tcp_hdr = append_hdr(pkt, sizeof(*tcp_hdr));
+		tcp_hdr->src_port = rte_cpu_to_be_16(1024);
+		tcp_hdr->dst_port = rte_cpu_to_be_16(dst_port);
+		tcp_hdr->sent_seq = rte_cpu_to_be_32(1);
+		tcp_hdr->data_off = (sizeof(*tcp_hdr) / 4) << 4;
+		tcp_hdr->tcp_flags = RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG;
+		return sizeof(*tcp_hdr);
+	}
+
+	udp_hdr = append_hdr(pkt, sizeof(*udp_hdr));
+	udp_hdr->src_port = rte_cpu_to_be_16(1024);
+	udp_hdr->dst_port = rte_cpu_to_be_16(dst_port);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(sizeof(*udp_hdr) + payload_len);
+	return sizeof(*udp_hdr);
+}
+
+static struct rte_mbuf *
+build_pkt(const struct gso_perf_case *c)
+{
+	struct rte_mbuf *pkt;
+	uint16_t l4_len, inner_len, tunnel_len;
+	void *payload;
+
+	pkt = rte_pktmbuf_alloc(pkt_pool);
+	if (pkt == NULL)
+		return NULL;
+
+	l4_len = c->proto == IPPROTO_TCP ? sizeof(struct rte_tcp_hdr) :
+		sizeof(struct rte_udp_hdr);
+	inner_len = (c->ip == 4 ? sizeof(struct rte_ipv4_hdr) :
+			sizeof(struct rte_ipv6_hdr)) + l4_len + PKT_PAYLOAD_LEN;
+
+	if (c->outer_ip != 0) {
+		tunnel_len = sizeof(struct rte_udp_hdr) + TUNNEL_HDR_LEN +
+			sizeof(struct rte_ether_hdr) + inner_len;
+		append_eth_hdr(pkt, c->outer_ip);
+		pkt->outer_l2_len = sizeof(struct rte_ether_hdr);
+		pkt->outer_l3_len = append_ip_hdr(pkt, c->outer_ip,
+				IPPROTO_UDP, tunnel_len);
+		append_l4_hdr(pkt, IPPROTO_UDP,
+				c->tunnel == RTE_MBUF_F_TX_TUNNEL_VXLAN ?
+				VXLAN_PORT : GENEVE_PORT,
+				tunnel_len - sizeof(struct rte_udp_hdr));
+		append_hdr(pkt, TUNNEL_HDR_LEN);
+		pkt->ol_flags |= c->tunnel | (c->outer_ip == 4 ?
+				RTE_MBUF_F_TX_OUTER_IPV4 :
+				RTE_MBUF_F_TX_OUTER_IPV6);
+	}
+
+	append_eth_hdr(pkt, c->ip);
+	pkt->l2_len = pkt->data_len - pkt->outer_l2_len - pkt->outer_l3_len;
+	pkt->l3_len = append_ip_hdr(pkt, c->ip, c->proto,
+			l4_len + PKT_PAYLOAD_LEN);
+	pkt->l4_len = append_l4_hdr(pkt, c->proto, 9, PKT_PAYLOAD_LEN);
+
+	payload = rte_pktmbuf_append(pkt, PKT_PAYLOAD_LEN);
+	if (payload == NULL) {
+		rte_pktmbuf_free(pkt);
+		return NULL;
+	}
+	memset(payload, 0x5a, PKT_PAYLOAD_LEN);
+
+	pkt->ol_flags |= (c->ip == 4 ? RTE_MBUF_F_TX_IPV4 : RTE_MBUF_F_TX_IPV6) |
+		(c->proto == IPPROTO_TCP ? RTE_MBUF_F_TX_TCP_SEG :
+		 RTE_MBUF_F_TX_UDP_SEG);
+
+	return pkt;
+}
+
+static int
+gso_perf_run(const struct gso_perf_case *c, const struct rte_gso_ctx *ctx)
+{
+	struct rte_mbuf *segs[MAX_SEGS];
+	struct rte_mbuf *pkt;
+	uint64_t start, cycles, nb_segs = 0;
+	uint64_t ol_flags;
+	unsigned int i;
+	int ret;
+
+	pkt = build_pkt(c);
+	if (pkt == NULL) {
+		printf("Failed to build %s packet\n", c->name);
+		return TEST_FAILED;
+	}
+	/* rte_gso_segment() clears the segmentation flags of the input */
+	ol_flags = pkt->ol_flags;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < ITERATIONS; i++) {
+		pkt->ol_flags = ol_flags;
+		ret = rte_gso_segment(pkt, ctx, segs, MAX_SEGS);
+		if (ret <= 0) {
+			printf("Failed to segment %s packet: %d\n", c->name,
+					ret);
+			rte_pktmbuf_free(pkt);
+			return TEST_FAILED;
+		}
+		nb_segs += ret;
+		rte_pktmbuf_free_bulk(segs, ret);
+	}
+	cycles = rte_rdtsc_precise() - start;
+
+	printf("%-22s %8u %16.1f %14.2f\n", c->name,
+			(unsigned int)(nb_segs / ITERATIONS),
+			(double)cycles / nb_segs,
+			(double)nb_segs * rte_get_tsc_hz() / cycles / 1E6);
+
+	rte_pktmbuf_free(pkt);
+
+	return TEST_SUCCESS;
+}
+
+static int
+gso_perf_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("gso_perf_pkt_pool", NB_MBUFS,
+			MBUF_CACHE_SIZE, 0, PKT_BUF_SIZE, rte_socket_id());
+	direct_pool = rte_pktmbuf_pool_create("gso_perf_direct_pool",
+			NB_MBUFS, MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	indirect_pool = rte_pktmbuf_pool_create("gso_perf_indirect_pool",
+			NB_MBUFS, MBUF_CACHE_SIZE, 0, 0, rte_socket_id());
+	if (pkt_pool == NULL || direct_pool == NULL ||
+			indirect_pool == NULL) {
+		printf("Failed to create mbuf pools\n");
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+gso_perf_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(indirect_pool);
+	pkt_pool = NULL;
+	direct_pool = NULL;
+	indirect_pool = NULL;
+}
+
+static int
+test_gso_perf(void)
+{
+	struct rte_gso_ctx ctx;
+	unsigned int i;
+	int ret = TEST_SUCCESS;
+
+	if (gso_perf_setup() != TEST_SUCCESS) {
+		gso_perf_teardown();
+		return TEST_FAILED;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.direct_pool = direct_pool;
+	ctx.indirect_pool = indirect_pool;
+	ctx.gso_types = RTE_ETH_TX_OFFLOAD_TCP_TSO | RTE_ETH_TX_OFFLOAD_UDP_TSO |
+		RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO |
+		RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO;
+	ctx.gso_size = GSO_SIZE;
+
+	printf("### rte_gso_segment() performance, %u bytes payload ###\n",
+			PKT_PAYLOAD_LEN);
+	printf("Packet type            Segs/pkt  TSC cycles/seg  Mseg/s\n");
+
+	for (i = 0; i < RTE_DIM(gso_perf_cases); i++) {
+		ret = gso_perf_run(&gso_perf_cases[i], &ctx);
+		if (ret != TEST_SUCCESS)
+			break;
+	}
+
+	gso_perf_teardown();
+
+	return ret;
+}
+
+REGISTER_PERF_TEST(gso_perf_autotest, test_gso_perf);
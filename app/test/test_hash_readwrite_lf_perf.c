@@ -13,6 +13,7 @@
 #include <rte_malloc.h>
 #include <rte_random.h>
 #include <rte_spinlock.h>
+#include <rte_stdatomic.h>
 
 #include "test.h"
 
@@ -20,6 +21,10 @@
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0
 #endif
 
+#ifndef RTE_HASH_EXTRA_FLAGS_GROWABLE
+#define RTE_HASH_EXTRA_FLAGS_GROWABLE 0
+#endif
+
 #define BULK_LOOKUP_SIZE 32
 
 #define RUN_WITH_HTM_DISABLED 0
@@ -51,6 +56,9 @@
 
 #define QSBR_REPORTING_INTERVAL 1024
 
+/* Buckets migrated by the 'Main' thread after each add in resize test */
+#define GROW_STEP_BUCKETS 8
+
 static unsigned int rwc_core_cnt[NUM_TEST] = {1, 2, 4};
 
 struct rwc_perf {
@@ -62,6 +70,7 @@ struct rwc_perf {
 	uint32_t multi_rw[NUM_TEST][2][NUM_TEST];
 	uint32_t w_ks_r_hit_extbkt[2][NUM_TEST];
 	uint32_t writer_add_del[NUM_TEST];
+	uint32_t w_grow_r_hit[NUM_TEST];
 };
 
 static struct rwc_perf rwc_lf_results, rwc_non_lf_results;
@@ -86,10 +95,11 @@ static struct {
 	struct rte_hash *h;
 } tbl_rwc_test_param;
 
-static uint64_t gread_cycles;
-static uint64_t greads;
-static uint64_t gwrite_cycles;
-static uint64_t gwrites;
+static RTE_ATOMIC(uint64_t) gread_cycles;
+static RTE_ATOMIC(uint64_t) greads;
+static RTE_ATOMIC(uint64_t) gwrite_cycles;
+static RTE_ATOMIC(uint64_t) gwrites;
+static uint64_t gread_max_cycles[RTE_MAX_LCORE];
 
 static volatile uint8_t writer_done;
 
@@ -651,8 +661,8 @@ test_rwc_reader(__rte_unused void *arg)
 	} while (!writer_done);
 
 	cycles = rte_rdtsc_precise() - begin;
-	__atomic_fetch_add(&gread_cycles, cycles, __ATOMIC_RELAXED);
-	__atomic_fetch_add(&greads, read_cnt*loop_cnt, __ATOMIC_RELAXED);
+	rte_atomic_fetch_add_explicit(&gread_cycles, cycles, rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&greads, read_cnt*loop_cnt, rte_memory_order_relaxed);
 	return 0;
 }
 
@@ -724,8 +734,8 @@ test_hash_add_no_ks_lookup_hit(struct rwc_perf *rwc_perf_results, int rwc_lf,
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			writer_done = 0;
@@ -742,8 +752,8 @@ test_hash_add_no_ks_lookup_hit(struct rwc_perf *rwc_perf_results, int rwc_lf,
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_no_ks_r_hit[m][n]
 						= cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
@@ -791,8 +801,8 @@ test_hash_add_no_ks_lookup_miss(struct rwc_perf *rwc_perf_results, int rwc_lf,
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			writer_done = 0;
@@ -811,8 +821,8 @@ test_hash_add_no_ks_lookup_miss(struct rwc_perf *rwc_perf_results, int rwc_lf,
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_no_ks_r_miss[m][n]
 						= cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
@@ -861,8 +871,8 @@ test_hash_add_ks_lookup_hit_non_sp(struct rwc_perf *rwc_perf_results,
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			writer_done = 0;
@@ -884,8 +894,8 @@ test_hash_add_ks_lookup_hit_non_sp(struct rwc_perf *rwc_perf_results,
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_ks_r_hit_nsp[m][n]
 						= cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
@@ -935,8 +945,8 @@ test_hash_add_ks_lookup_hit_sp(struct rwc_perf *rwc_perf_results, int rwc_lf,
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			writer_done = 0;
@@ -958,8 +968,8 @@ test_hash_add_ks_lookup_hit_sp(struct rwc_perf *rwc_perf_results, int rwc_lf,
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_ks_r_hit_sp[m][n]
 						= cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
@@ -1007,8 +1017,8 @@ test_hash_add_ks_lookup_miss(struct rwc_perf *rwc_perf_results, int rwc_lf, int
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			writer_done = 0;
@@ -1030,8 +1040,8 @@ test_hash_add_ks_lookup_miss(struct rwc_perf *rwc_perf_results, int rwc_lf, int
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_ks_r_miss[m][n] = cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
 		}
@@ -1087,9 +1097,9 @@ test_hash_multi_add_lookup(struct rwc_perf *rwc_perf_results, int rwc_lf,
 				printf("\nNumber of readers: %u\n",
 				       rwc_core_cnt[n]);
 
-				__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-				__atomic_store_n(&gread_cycles, 0,
-						 __ATOMIC_RELAXED);
+				rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+				rte_atomic_store_explicit(&gread_cycles, 0,
+						rte_memory_order_relaxed);
 
 				rte_hash_reset(tbl_rwc_test_param.h);
 				writer_done = 0;
@@ -1127,10 +1137,10 @@ test_hash_multi_add_lookup(struct rwc_perf *rwc_perf_results, int rwc_lf,
 						goto err;
 
 				unsigned long long cycles_per_lookup =
-					__atomic_load_n(&gread_cycles,
-							__ATOMIC_RELAXED) /
-					__atomic_load_n(&greads,
-							  __ATOMIC_RELAXED);
+					rte_atomic_load_explicit(&gread_cycles,
+							rte_memory_order_relaxed) /
+					rte_atomic_load_explicit(&greads,
+							rte_memory_order_relaxed);
 				rwc_perf_results->multi_rw[m][k][n]
 					= cycles_per_lookup;
 				printf("Cycles per lookup: %llu\n",
@@ -1178,8 +1188,8 @@ test_hash_add_ks_lookup_hit_extbkt(struct rwc_perf *rwc_perf_results,
 
 			printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
 
-			__atomic_store_n(&greads, 0, __ATOMIC_RELAXED);
-			__atomic_store_n(&gread_cycles, 0, __ATOMIC_RELAXED);
+			rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
 
 			rte_hash_reset(tbl_rwc_test_param.h);
 			write_type = WRITE_NO_KEY_SHIFT;
@@ -1210,8 +1220,8 @@ test_hash_add_ks_lookup_hit_extbkt(struct rwc_perf *rwc_perf_results,
 					goto err;
 
 			unsigned long long cycles_per_lookup =
-				__atomic_load_n(&gread_cycles, __ATOMIC_RELAXED)
-				/ __atomic_load_n(&greads, __ATOMIC_RELAXED);
+				rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+				/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
 			rwc_perf_results->w_ks_r_hit_extbkt[m][n]
 						= cycles_per_lookup;
 			printf("Cycles per lookup: %llu\n", cycles_per_lookup);
@@ -1228,6 +1238,171 @@ test_hash_add_ks_lookup_hit_extbkt(struct rwc_perf *rwc_perf_results,
 	return -1;
 }
 
+/*
+ * Reader thread measuring the latency of bulk lookups of keys present
+ * in a growable hash table.
+ */
+static int
+test_rwc_grow_reader(void *arg)
+{
+	uint32_t read_cnt = (uint32_t)((uintptr_t)arg);
+	uint32_t *keys = tbl_rwc_test_param.keys_no_ks;
+	uint32_t lcore_id = rte_lcore_id();
+	uint64_t begin, start, cycles, max_cycles = 0;
+	uint32_t loop_cnt = 0;
+	int32_t pos[BULK_LOOKUP_SIZE];
+	void *temp_a[BULK_LOOKUP_SIZE];
+	uint32_t i, j;
+
+	read_cnt &= ~(BULK_LOOKUP_SIZE - 1);
+
+	begin = rte_rdtsc_precise();
+	do {
+		for (i = 0; i < read_cnt; i += BULK_LOOKUP_SIZE) {
+			for (j = 0; j < BULK_LOOKUP_SIZE; j++)
+				temp_a[j] = keys + i + j;
+			start = rte_rdtsc();
+			rte_hash_lookup_bulk(tbl_rwc_test_param.h,
+					   (const void **)((uintptr_t)temp_a),
+					   BULK_LOOKUP_SIZE, pos);
+			cycles = rte_rdtsc() - start;
+			if (cycles > max_cycles)
+				max_cycles = cycles;
+			for (j = 0; j < BULK_LOOKUP_SIZE; j++)
+				if (pos[j] == -ENOENT) {
+					printf("lookup failed! %"PRIu32"\n",
+					       keys[i + j]);
+					return -1;
+				}
+		}
+		loop_cnt++;
+	} while (!writer_done);
+
+	cycles = rte_rdtsc_precise() - begin;
+	rte_atomic_fetch_add_explicit(&gread_cycles, cycles, rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&greads, read_cnt * loop_cnt, rte_memory_order_relaxed);
+	gread_max_cycles[lcore_id] = max_cycles;
+	return 0;
+}
+
+/*
+ * Test lookup perf during online resize:
+ * Reader(s) bulk lookup keys present in a growable table while 'Main'
+ * thread adds keys, which doubles the bucket array several times.
+ * The buckets are migrated by the writer on every add, and by the 'Main'
+ * thread calling rte_hash_grow_step() as a service core would.
+ */
+static int
+test_hash_grow_lookup_hit(struct rwc_perf *rwc_perf_results, int rwc_lf)
+{
+	unsigned int n;
+	uint64_t i;
+	uint64_t max_cycles;
+	uint32_t resizes;
+	uint32_t read_cnt = tbl_rwc_test_param.count_keys_no_ks / 2;
+	uint32_t *keys = tbl_rwc_test_param.keys_no_ks;
+	int32_t remaining;
+	int resizing;
+
+	struct rte_hash_parameters hash_params = {
+		.name = "tests_grow",
+		.entries = TOTAL_ENTRY,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_GROWABLE |
+			RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+	};
+
+	if (rwc_lf)
+		hash_params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	else
+		hash_params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY;
+
+	printf("\nTest: Hash add - online resize, read - hit\n");
+	for (n = 0; n < NUM_TEST; n++) {
+		unsigned int tot_lcore = rte_lcore_count();
+		if (tot_lcore < rwc_core_cnt[n] + 1)
+			break;
+
+		printf("\nNumber of readers: %u\n", rwc_core_cnt[n]);
+
+		tbl_rwc_test_param.h = rte_hash_create(&hash_params);
+		if (tbl_rwc_test_param.h == NULL) {
+			printf("hash creation failed");
+			return -1;
+		}
+
+		for (i = 0; i < read_cnt; i++) {
+			if (rte_hash_add_key(tbl_rwc_test_param.h,
+					     keys + i) < 0) {
+				printf("writer failed %"PRIu64"\n", i);
+				goto err;
+			}
+		}
+		while (rte_hash_grow_step(tbl_rwc_test_param.h, UINT32_MAX) > 0)
+			;
+
+		rte_atomic_store_explicit(&greads, 0, rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&gread_cycles, 0, rte_memory_order_relaxed);
+		memset(gread_max_cycles, 0, sizeof(gread_max_cycles));
+
+		writer_done = 0;
+		for (i = 1; i <= rwc_core_cnt[n]; i++)
+			rte_eal_remote_launch(test_rwc_grow_reader,
+					(void *)(uintptr_t)read_cnt,
+					enabled_core_ids[i]);
+
+		resizes = 0;
+		resizing = 0;
+		for (i = read_cnt; i < tbl_rwc_test_param.count_keys_no_ks;
+		     i++) {
+			if (rte_hash_add_key(tbl_rwc_test_param.h,
+					     keys + i) < 0) {
+				printf("writer failed %"PRIu64"\n", i);
+				writer_done = 1;
+				goto err;
+			}
+			remaining = rte_hash_grow_step(tbl_rwc_test_param.h,
+						GROW_STEP_BUCKETS);
+			if (remaining > 0 && !resizing)
+				resizes++;
+			resizing = remaining > 0;
+		}
+		while (rte_hash_grow_step(tbl_rwc_test_param.h, UINT32_MAX) > 0)
+			;
+		writer_done = 1;
+
+		for (i = 1; i <= rwc_core_cnt[n]; i++)
+			if (rte_eal_wait_lcore(enabled_core_ids[i]) < 0)
+				goto err;
+
+		max_cycles = 0;
+		for (i = 1; i <= rwc_core_cnt[n]; i++)
+			max_cycles = RTE_MAX(max_cycles,
+				gread_max_cycles[enabled_core_ids[i]]);
+
+		unsigned long long cycles_per_lookup =
+			rte_atomic_load_explicit(&gread_cycles, rte_memory_order_relaxed)
+			/ rte_atomic_load_explicit(&greads, rte_memory_order_relaxed);
+		rwc_perf_results->w_grow_r_hit[n] = cycles_per_lookup;
+		printf("Resizes: %u\n", resizes);
+		printf("Cycles per lookup: %llu\n", cycles_per_lookup);
+		printf("Max cycles per bulk lookup of %u keys: %"PRIu64"\n",
+			BULK_LOOKUP_SIZE, max_cycles);
+
+		rte_hash_free(tbl_rwc_test_param.h);
+	}
+
+	return 0;
+
+err:
+	rte_eal_mp_wait_lcore();
+	rte_hash_free(tbl_rwc_test_param.h);
+	return -1;
+}
+
 static struct rte_rcu_qsbr *rv;
 
 /*
@@ -1280,9 +1455,9 @@ test_hash_rcu_qsbr_writer(void *arg)
 				tbl_rwc_test_param.keys_no_ks + i);
 	}
 	cycles = rte_rdtsc_precise() - begin;
-	__atomic_fetch_add(&gwrite_cycles, cycles, __ATOMIC_RELAXED);
-	__atomic_fetch_add(&gwrites, tbl_rwc_test_param.single_insert,
-			   __ATOMIC_RELAXED);
+	rte_atomic_fetch_add_explicit(&gwrite_cycles, cycles, rte_memory_order_relaxed);
+	rte_atomic_fetch_add_explicit(&gwrites, tbl_rwc_test_param.single_insert,
+			rte_memory_order_relaxed);
 	return 0;
 }
 
@@ -1328,8 +1503,8 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 				rwc_core_cnt[n];
 		printf("\nNumber of writers: %u\n", rwc_core_cnt[n]);
 
-		__atomic_store_n(&gwrites, 0, __ATOMIC_RELAXED);
-		__atomic_store_n(&gwrite_cycles, 0, __ATOMIC_RELAXED);
+		rte_atomic_store_explicit(&gwrites, 0, rte_memory_order_relaxed);
+		rte_atomic_store_explicit(&gwrite_cycles, 0, rte_memory_order_relaxed);
 
 		rte_hash_reset(tbl_rwc_test_param.h);
 		rte_rcu_qsbr_init(rv, RTE_MAX_LCORE);
@@ -1364,8 +1539,8 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 		rte_eal_mp_wait_lcore();
 
 		unsigned long long cycles_per_write_operation =
-			__atomic_load_n(&gwrite_cycles, __ATOMIC_RELAXED) /
-			__atomic_load_n(&gwrites, __ATOMIC_RELAXED);
+			rte_atomic_load_explicit(&gwrite_cycles, rte_memory_order_relaxed) /
+			rte_atomic_load_explicit(&gwrites, rte_memory_order_relaxed);
 		rwc_perf_results->writer_add_del[n]
 					= cycles_per_write_operation;
 		printf("Cycles per write operation: %llu\n",
@@ -1447,6 +1622,9 @@ test_hash_readwrite_lf_perf_main(void)
 		if (test_hash_rcu_qsbr_writer_perf(&rwc_lf_results, rwc_lf,
 						   htm, ext_bkt) < 0)
 			return -1;
+		if (RTE_HASH_EXTRA_FLAGS_GROWABLE &&
+		    test_hash_grow_lookup_hit(&rwc_lf_results, rwc_lf) < 0)
+			return -1;
 	}
 	printf("\nTest lookup with read-write concurrency lock free support"
 	       " disabled\n");
@@ -14,7 +14,7 @@
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 8
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -26,6 +26,10 @@ static struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p99_latency_ns"},
+	{"p999_latency_ns"},
+	{"p9999_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -134,6 +138,39 @@ static int test_latencystats_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Test case to get latency stats values of a queue */
+static int test_latencystats_queue_get(void)
+{
+	int ret = 0;
+	struct rte_metric_value values[NUM_STATS];
+
+	memset(values, 0, sizeof(values));
+
+	/* Success Test: Valid port, queue, values and size */
+	ret = rte_latencystats_queue_get(portid, QUEUE_ID, values, NUM_STATS);
+	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get queue latency"
+			" metrics values");
+
+	/* Failure Test: Valid values and invalid size */
+	ret = rte_latencystats_queue_get(portid, QUEUE_ID, values, 0);
+	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get the stats count,"
+		    "Actual: %d Expected: %d", ret, NUM_STATS);
+
+	/* Failure Test: Invalid queue */
+	ret = rte_latencystats_queue_get(portid, RTE_MAX_QUEUES_PER_PORT,
+			values, NUM_STATS);
+	TEST_ASSERT((ret == -EINVAL), "Test Failed for invalid queue,"
+		    "Actual: %d Expected: %d", ret, -EINVAL);
+
+	/* Failure Test: Invalid port */
+	ret = rte_latencystats_queue_get(RTE_MAX_ETHPORTS, QUEUE_ID,
+			values, NUM_STATS);
+	TEST_ASSERT((ret == -EINVAL), "Test Failed for invalid port,"
+		    "Actual: %d Expected: %d", ret, -EINVAL);
+
+	return TEST_SUCCESS;
+}
+
 static int test_latency_ring_setup(void)
 {
 	test_ring_setup(&ring, &portid);
@@ -204,7 +241,12 @@ unit_test_suite latencystats_testsuite = {
 		 */
 		TEST_CASE_ST(NULL, NULL, test_latencystats_get),
 
-		/* Test Case 5: To check uninit of latency test */
+		/* Test Case 5: To check whether latency stats
+		 * values of a queue are retrieved
+		 */
+		TEST_CASE_ST(NULL, NULL, test_latencystats_queue_get),
+
+		/* Test Case 6: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
 		TEST_CASES_END()
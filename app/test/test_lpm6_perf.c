@@ -12,6 +12,7 @@
 #include <rte_random.h>
 #include <rte_memory.h>
 #include <rte_lpm6.h>
+#include <rte_vect.h>
 
 #include "test.h"
 #include "test_lpm6_data.h"
@@ -51,6 +52,31 @@ print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
 	printf("\n");
 }
 
+static void
+measure_bulk_lookup(struct rte_lpm6 *lpm,
+		uint8_t ip_batch[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	uint64_t begin, total_time = 0;
+	int64_t count = 0;
+	unsigned int i, j;
+
+	for (i = 0; i < ITERATIONS; i++) {
+
+		/* Lookup per batch */
+		begin = rte_rdtsc();
+		rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops,
+				NUM_IPS_ENTRIES);
+		total_time += rte_rdtsc() - begin;
+
+		for (j = 0; j < NUM_IPS_ENTRIES; j++)
+			if (next_hops[j] < 0)
+				count++;
+	}
+	printf("%.1f cycles (fails = %.1f%%)\n",
+			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
+			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
+}
+
 static int
 test_lpm6_perf(void)
 {
@@ -61,6 +87,7 @@ test_lpm6_perf(void)
 	uint32_t next_hop_add = 0xAA, next_hop_return = 0;
 	int status = 0;
 	int64_t count = 0;
+	uint16_t max_simd;
 
 	config.max_rules = 1000000;
 	config.number_tbl8s = NUMBER_TBL8S;
@@ -114,29 +141,23 @@ test_lpm6_perf(void)
 			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 
 	/* Measure bulk Lookup */
-	total_time = 0;
-	count = 0;
-
 	uint8_t ip_batch[NUM_IPS_ENTRIES][16];
 	int32_t next_hops[NUM_IPS_ENTRIES];
 
 	for (i = 0; i < NUM_IPS_ENTRIES; i++)
 		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
 
-	for (i = 0; i < ITERATIONS; i ++) {
+	printf("BULK LPM Lookup: ");
+	measure_bulk_lookup(lpm, ip_batch, next_hops);
 
-		/* Lookup per batch */
-		begin = rte_rdtsc();
-		rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops, NUM_IPS_ENTRIES);
-		total_time += rte_rdtsc() - begin;
-
-		for (j = 0; j < NUM_IPS_ENTRIES; j++)
-			if (next_hops[j] < 0)
-				count++;
+	/* Measure bulk Lookup restricted to the non AVX2 path */
+	max_simd = rte_vect_get_max_simd_bitwidth();
+	if (max_simd >= RTE_VECT_SIMD_256 &&
+			rte_vect_set_max_simd_bitwidth(RTE_VECT_SIMD_128) == 0) {
+		printf("BULK LPM Lookup (max SIMD 128 bits): ");
+		measure_bulk_lookup(lpm, ip_batch, next_hops);
+		rte_vect_set_max_simd_bitwidth(max_simd);
 	}
-	printf("BULK LPM Lookup: %.1f cycles (fails = %.1f%%)\n",
-			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
-			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 
 	/* Delete */
 	status = 0;
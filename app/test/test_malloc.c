@@ -808,6 +808,65 @@ test_rte_malloc_validate(void)
 	return -1;
 }
 
+static int
+test_lcore_cache(void)
+{
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	const int socket = rte_socket_id();
+	const size_t size = 100;
+	char *p1, *p2;
+	size_t i, allocated_size;
+
+	if (rte_malloc_lcore_cache_set(true) == -ENOTSUP)
+		return 0;
+
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+
+	p1 = rte_malloc_socket(NULL, size, 0, socket);
+	if (p1 == NULL)
+		goto err_return;
+	memset(p1, 0xa5, size);
+	rte_free(p1);
+
+	/* the cached element is reused, and zeroed */
+	p2 = rte_zmalloc_socket(NULL, size, 0, socket);
+	if (p2 != p1) {
+		printf("%s: %d - Cached element not reused\n", __func__, __LINE__);
+		rte_free(p2);
+		goto err_return;
+	}
+	for (i = 0; i < size; i++) {
+		if (p2[i] != 0) {
+			printf("%s: %d - Cached element not zeroed\n",
+				__func__, __LINE__);
+			rte_free(p2);
+			goto err_return;
+		}
+	}
+	if (rte_malloc_validate(p2, &allocated_size) < 0 ||
+			allocated_size < size) {
+		rte_free(p2);
+		goto err_return;
+	}
+	rte_free(p2);
+
+	/* the cached element is freed back to the heap */
+	rte_malloc_lcore_cache_set(false);
+	rte_malloc_lcore_cache_flush();
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (post_stats.alloc_count != pre_stats.alloc_count) {
+		printf("%s: %d - Cached element not flushed\n", __func__, __LINE__);
+		return -1;
+	}
+
+	return 0;
+
+err_return:
+	rte_malloc_lcore_cache_set(false);
+	rte_malloc_lcore_cache_flush();
+	return -1;
+}
+
 static int
 test_zero_aligned_alloc(void)
 {
@@ -1018,6 +1077,13 @@ test_malloc(void)
 	}
 	else printf("test_realloc() passed\n");
 
+	if (test_lcore_cache() < 0) {
+		printf("test_lcore_cache() failed\n");
+		return -1;
+	}
+	else
+		printf("test_lcore_cache() passed\n");
+
 	/*----------------------------*/
 	RTE_LCORE_FOREACH_WORKER(lcore_id) {
 		rte_eal_remote_launch(test_align_overlap_per_lcore, NULL, lcore_id);
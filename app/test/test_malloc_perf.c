@@ -6,6 +6,8 @@
 #include <string.h>
 #include <rte_cycles.h>
 #include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_memzone.h>
 
@@ -147,6 +149,84 @@ memzone_free(void *addr)
 	rte_memzone_free((struct rte_memzone *)addr);
 }
 
+/* Small objects allocated and freed in bursts, as sessions would be */
+#define CACHE_PERF_BURST 16
+#define CACHE_PERF_ITERATIONS 20000
+
+static const size_t CACHE_PERF_SIZES[] = { 64, 200, 1024 };
+
+static uint64_t cache_perf_cycles[RTE_MAX_LCORE];
+
+static int
+cache_perf_worker(void *arg)
+{
+	const size_t size = (uintptr_t)arg;
+	void *ptrs[CACHE_PERF_BURST];
+	uint64_t tsc;
+	size_t i, j;
+
+	tsc = rte_rdtsc_precise();
+	for (i = 0; i < CACHE_PERF_ITERATIONS; i++) {
+		for (j = 0; j < CACHE_PERF_BURST; j++) {
+			ptrs[j] = rte_malloc(NULL, size, 0);
+			if (ptrs[j] == NULL)
+				break;
+		}
+		while (j > 0)
+			rte_free(ptrs[--j]);
+	}
+	cache_perf_cycles[rte_lcore_id()] = rte_rdtsc_precise() - tsc;
+
+	rte_malloc_lcore_cache_flush();
+	return 0;
+}
+
+static int
+test_lcore_cache_perf(void)
+{
+	unsigned int lcore_id, nb_lcores;
+	uint64_t cycles;
+	size_t i;
+	int enable;
+
+	if (rte_malloc_lcore_cache_set(true) == -ENOTSUP) {
+		TEST_LOG(INFO, "Per-lcore cache not supported\n\n");
+		return 0;
+	}
+
+	TEST_LOG(INFO, "Performance: rte_malloc + rte_free from all lcores\n");
+	TEST_LOG(INFO, "%12s%8s%16s%16s\n", "Size (B)", "Lcores",
+			"No cache (cyc)", "Cache (cyc)");
+	for (i = 0; i < RTE_DIM(CACHE_PERF_SIZES); i++) {
+		double op_cycles[2];
+
+		for (enable = 0; enable <= 1; enable++) {
+			rte_malloc_lcore_cache_set(enable);
+			memset(cache_perf_cycles, 0, sizeof(cache_perf_cycles));
+
+			rte_eal_mp_remote_launch(cache_perf_worker,
+					(void *)(uintptr_t)CACHE_PERF_SIZES[i],
+					CALL_MAIN);
+			rte_eal_mp_wait_lcore();
+
+			cycles = 0;
+			nb_lcores = 0;
+			RTE_LCORE_FOREACH(lcore_id) {
+				cycles += cache_perf_cycles[lcore_id];
+				nb_lcores++;
+			}
+			op_cycles[enable] = (double)cycles / nb_lcores /
+				(CACHE_PERF_ITERATIONS * CACHE_PERF_BURST);
+		}
+		TEST_LOG(INFO, "%12zu%8u%16.2f%16.2f\n", CACHE_PERF_SIZES[i],
+				nb_lcores, op_cycles[0], op_cycles[1]);
+	}
+
+	rte_malloc_lcore_cache_set(false);
+	TEST_LOG(INFO, "\n");
+	return 0;
+}
+
 static int
 test_malloc_perf(void)
 {
@@ -164,6 +244,9 @@ test_malloc_perf(void)
 			memset_us_gb, MAX_RUNS) < 0)
 		return -1;
 
+	if (test_lcore_cache_perf() < 0)
+		return -1;
+
 	if (test_alloc_perf("rte_memzone_reserve", memzone_alloc, memzone_free,
 			NULL, memset_us_gb, rte_memzone_max_get() - 1) < 0)
 		return -1;
@@ -875,6 +875,32 @@ test_pktmbuf_pool_bulk(void)
 		goto err;
 	}
 
+	printf("Test bulk free of interleaved mbufs using multiple pools.\n");
+
+	/* Allocate mbufs alternately from both pools. */
+	for (i = 0; i < NB_MBUF; i++) {
+		mbufs[i] = rte_pktmbuf_alloc((i & 1) ? pool2 : pool);
+		if (mbufs[i] == NULL) {
+			printf("rte_pktmbuf_alloc() failed (%u)\n", i);
+			goto err;
+		}
+	}
+	/* Keep a reference to one mbuf, it must not be freed. */
+	rte_mbuf_refcnt_update(mbufs[1], 1);
+	m = mbufs[1];
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	/* Test that all the other mbufs have been returned to the pools. */
+	if (!(rte_mempool_full(pool) &&
+			rte_mempool_avail_count(pool2) == NB_MBUF - 1)) {
+		printf("interleaved mbufs have not been returned\n");
+		goto err;
+	}
+	rte_pktmbuf_free(m);
+	if (!rte_mempool_full(pool2)) {
+		printf("mempool not full\n");
+		goto err;
+	}
+
 	ret = 0;
 	goto done;
 
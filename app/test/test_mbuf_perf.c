@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+/*
+ * Mbuf free performance
+ * =====================
+ *
+ * Measures the cycles per mbuf to free bursts of mbufs, like Tx
+ * completion does, with rte_pktmbuf_free() on each mbuf and with
+ * rte_pktmbuf_free_bulk(), for bursts of:
+ *
+ * - single segment mbufs from one mempool
+ * - single segment mbufs from two interleaved mempools
+ * - single segment mbufs, some of them referenced elsewhere
+ * - mbuf chains of two segments
+ */
+
+#define NB_MBUFS 8192
+#define MBUF_CACHE_SIZE 256
+#define MAX_BURST 64
+#define ITERATIONS 100000
+
+static const unsigned int burst_sizes[] = { 8, 32, MAX_BURST };
+
+enum mbuf_perf_burst {
+	BURST_ONE_POOL,
+	BURST_TWO_POOLS,
+	BURST_REFCNT,
+	BURST_CHAINED,
+	BURST_MAX,
+};
+
+static const char * const burst_names[] = {
+	[BURST_ONE_POOL] = "one pool",
+	[BURST_TWO_POOLS] = "two interleaved pools",
+	[BURST_REFCNT] = "with refcnt > 1",
+	[BURST_CHAINED] = "chains of 2 segments",
+};
+
+static struct rte_mempool *pools[2];
+
+static int
+alloc_burst(struct rte_mbuf **mbufs, unsigned int n,
+	enum mbuf_perf_burst type)
+{
+	struct rte_mbuf *seg;
+	unsigned int i;
+
+	for (i = 0; i != n; i++) {
+		mbufs[i] = rte_pktmbuf_alloc(pools[type == BURST_TWO_POOLS ?
+				(i & 1) : 0]);
+		if (mbufs[i] == NULL)
+			goto fail;
+
+		if (type == BURST_REFCNT && (i & 7) == 0)
+			rte_mbuf_refcnt_update(mbufs[i], 1);
+
+		if (type == BURST_CHAINED) {
+			seg = rte_pktmbuf_alloc(pools[0]);
+			if (seg == NULL || rte_pktmbuf_chain(mbufs[i], seg)) {
+				rte_pktmbuf_free(seg);
+				i++;
+				goto fail;
+			}
+		}
+	}
+
+	return 0;
+
+fail:
+	rte_pktmbuf_free_bulk(mbufs, i);
+	return -1;
+}
+
+/* Release the references kept on mbufs of a BURST_REFCNT burst. */
+static void
+release_burst(struct rte_mbuf **mbufs, unsigned int n,
+	enum mbuf_perf_burst type)
+{
+	unsigned int i;
+
+	if (type != BURST_REFCNT)
+		return;
+	for (i = 0; i < n; i += 8)
+		rte_pktmbuf_free(mbufs[i]);
+}
+
+static int
+test_free_burst(enum mbuf_perf_burst type, unsigned int n)
+{
+	struct rte_mbuf *mbufs[MAX_BURST];
+	uint64_t free_cycles, bulk_cycles, start;
+	unsigned int i, j;
+
+	free_cycles = 0;
+	bulk_cycles = 0;
+
+	for (i = 0; i != ITERATIONS; i++) {
+		if (alloc_burst(mbufs, n, type) != 0)
+			return -1;
+		start = rte_rdtsc_precise();
+		for (j = 0; j != n; j++)
+			rte_pktmbuf_free(mbufs[j]);
+		free_cycles += rte_rdtsc_precise() - start;
+		release_burst(mbufs, n, type);
+
+		if (alloc_burst(mbufs, n, type) != 0)
+			return -1;
+		start = rte_rdtsc_precise();
+		rte_pktmbuf_free_bulk(mbufs, n);
+		bulk_cycles += rte_rdtsc_precise() - start;
+		release_burst(mbufs, n, type);
+	}
+
+	printf("%-24s burst %2u: free %6.2f, free_bulk %6.2f cycles/mbuf\n",
+		burst_names[type], n,
+		(double)free_cycles / ((uint64_t)ITERATIONS * n),
+		(double)bulk_cycles / ((uint64_t)ITERATIONS * n));
+
+	return 0;
+}
+
+static int
+test_mbuf_perf(void)
+{
+	unsigned int i, type;
+	int ret = -1;
+
+	pools[0] = rte_pktmbuf_pool_create("test_mbuf_perf0", NB_MBUFS,
+			MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	pools[1] = rte_pktmbuf_pool_create("test_mbuf_perf1", NB_MBUFS,
+			MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	if (pools[0] == NULL || pools[1] == NULL) {
+		printf("cannot create mbuf pools\n");
+		goto out;
+	}
+
+	for (type = 0; type != BURST_MAX; type++) {
+		for (i = 0; i != RTE_DIM(burst_sizes); i++) {
+			if (test_free_burst(type, burst_sizes[i]) != 0)
+				goto out;
+		}
+	}
+	ret = 0;
+
+out:
+	rte_mempool_free(pools[0]);
+	rte_mempool_free(pools[1]);
+	return ret;
+}
+
+REGISTER_PERF_TEST(mbuf_perf_autotest, test_mbuf_perf);
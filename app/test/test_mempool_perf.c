@@ -23,7 +23,10 @@
 #include <rte_lcore.h>
 #include <rte_branch_prediction.h>
 #include <rte_mempool.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
 #include <rte_spinlock.h>
+#include <rte_stdatomic.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
 
@@ -63,6 +66,12 @@
  *      - 32
  *      - 128
  *      - 512
+ *
+ *    An asymmetric test then runs pairs of lcores, where one lcore only
+ *    gets objects by bulk of *ASYM_GET_BULK* and passes them through a
+ *    ring to the other lcore, which only puts them back by bulk of up to
+ *    *ASYM_PUT_BULK*, like Rx and Tx lcores do with mbufs. It is done with
+ *    fixed size and adaptive caches (RTE_MEMPOOL_F_ADAPTIVE_CACHE).
  */
 
 #define N 65536
@@ -88,7 +97,7 @@
 static int use_external_cache;
 static unsigned external_cache_size = RTE_MEMPOOL_CACHE_MAX_SIZE;
 
-static uint32_t synchro;
+static RTE_ATOMIC(uint32_t) synchro;
 
 /* number of objects in one bulk operation (get or put) */
 static unsigned n_get_bulk;
@@ -188,7 +197,8 @@ per_lcore_mempool_test(void *arg)
 
 	/* wait synchro for workers */
 	if (lcore_id != rte_get_main_lcore())
-		rte_wait_until_equal_32(&synchro, 1, __ATOMIC_RELAXED);
+		rte_wait_until_equal_32((uint32_t *)(uintptr_t)&synchro, 1,
+				rte_memory_order_relaxed);
 
 	start_cycles = rte_get_timer_cycles();
 
@@ -233,7 +243,7 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	int ret;
 	unsigned cores_save = cores;
 
-	__atomic_store_n(&synchro, 0, __ATOMIC_RELAXED);
+	rte_atomic_store_explicit(&synchro, 0, rte_memory_order_relaxed);
 
 	/* reset stats */
 	memset(stats, 0, sizeof(stats));
@@ -258,7 +268,7 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	}
 
 	/* start synchro and launch test on main */
-	__atomic_store_n(&synchro, 1, __ATOMIC_RELAXED);
+	rte_atomic_store_explicit(&synchro, 1, rte_memory_order_relaxed);
 
 	ret = per_lcore_mempool_test(mp);
 
@@ -285,6 +295,145 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+#define ASYM_GET_BULK 32
+#define ASYM_PUT_BULK 256
+#define ASYM_RING_SIZE 1024
+
+/* a pair of lcores getting and putting objects */
+struct asym_pair {
+	struct rte_mempool *mp;
+	struct rte_ring *r;
+	RTE_ATOMIC(uint32_t) done;
+	uint64_t count;
+} __rte_cache_aligned;
+
+static struct asym_pair asym_pairs[RTE_MAX_LCORE / 2];
+
+/* get objects from the mempool and pass them to the put lcore */
+static int
+asym_get_lcore(void *arg)
+{
+	struct asym_pair *p = arg;
+	void *obj_table[ASYM_GET_BULK];
+	uint64_t start_cycles, hz = rte_get_timer_hz();
+
+	if (rte_lcore_id() != rte_get_main_lcore())
+		rte_wait_until_equal_32((uint32_t *)(uintptr_t)&synchro, 1,
+				rte_memory_order_relaxed);
+
+	start_cycles = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() - start_cycles < hz * TIME_S) {
+		if (rte_mempool_get_bulk(p->mp, obj_table,
+				ASYM_GET_BULK) < 0) {
+			rte_pause();
+			continue;
+		}
+		while (rte_ring_sp_enqueue_bulk(p->r, obj_table,
+				ASYM_GET_BULK, NULL) == 0)
+			rte_pause();
+		p->count += ASYM_GET_BULK;
+	}
+
+	rte_atomic_store_explicit(&p->done, 1, rte_memory_order_release);
+	return 0;
+}
+
+/* put the objects received from the get lcore back in the mempool */
+static int
+asym_put_lcore(void *arg)
+{
+	struct asym_pair *p = arg;
+	void *obj_table[ASYM_PUT_BULK];
+	unsigned int n;
+	uint32_t done;
+
+	rte_wait_until_equal_32((uint32_t *)(uintptr_t)&synchro, 1,
+			rte_memory_order_relaxed);
+
+	do {
+		done = rte_atomic_load_explicit(&p->done, rte_memory_order_acquire);
+		n = rte_ring_sc_dequeue_burst(p->r, obj_table, ASYM_PUT_BULK,
+				NULL);
+		if (n != 0)
+			rte_mempool_put_bulk(p->mp, obj_table, n);
+		else
+			rte_pause();
+	} while (n != 0 || done == 0);
+
+	return 0;
+}
+
+/* launch pairs of get and put lcores on all lcores, and display the result */
+static int
+launch_asym_cores(struct rte_mempool *mp)
+{
+	char name[RTE_RING_NAMESIZE];
+	unsigned int lcore_id, get_lcore, nb_pairs, i;
+	uint64_t rate;
+	int ret = 0;
+
+	nb_pairs = rte_lcore_count() / 2;
+	if (nb_pairs == 0) {
+		printf("not enough lcores for the asymmetric test\n");
+		return 0;
+	}
+
+	rte_atomic_store_explicit(&synchro, 0, rte_memory_order_relaxed);
+
+	memset(asym_pairs, 0, sizeof(asym_pairs));
+	for (i = 0; i != nb_pairs; i++) {
+		snprintf(name, sizeof(name), "perf_test_asym_%u", i);
+		asym_pairs[i].mp = mp;
+		asym_pairs[i].r = rte_ring_create(name, ASYM_RING_SIZE,
+				SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (asym_pairs[i].r == NULL) {
+			ret = -1;
+			goto out;
+		}
+	}
+
+	/* the main lcore gets objects for the first pair */
+	i = 0;
+	get_lcore = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (i == nb_pairs)
+			break;
+		if (get_lcore) {
+			rte_eal_remote_launch(asym_get_lcore,
+					      &asym_pairs[i], lcore_id);
+			get_lcore = 0;
+		} else {
+			rte_eal_remote_launch(asym_put_lcore,
+					      &asym_pairs[i], lcore_id);
+			get_lcore = 1;
+			i++;
+		}
+	}
+
+	rte_atomic_store_explicit(&synchro, 1, rte_memory_order_relaxed);
+	asym_get_lcore(&asym_pairs[0]);
+
+	rte_eal_mp_wait_lcore();
+
+	rate = 0;
+	for (i = 0; i != nb_pairs; i++)
+		rate += asym_pairs[i].count / TIME_S;
+
+	printf("mempool_autotest cache=%u adaptive=%u pairs=%u "
+	       "n_get_bulk=%u n_put_bulk=%u rate_persec=%" PRIu64 "\n",
+	       mp->cache_size,
+	       !!(mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE),
+	       nb_pairs, ASYM_GET_BULK, ASYM_PUT_BULK, rate);
+
+	/* show the cache sizes and hit rates of the get and put lcores */
+	rte_mempool_dump(stdout, mp);
+
+out:
+	for (i = 0; i != nb_pairs; i++)
+		rte_ring_free(asym_pairs[i].r);
+	return ret;
+}
+
 /* for a given number of core, launch all test cases */
 static int
 do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
@@ -326,6 +475,7 @@ static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
+	struct rte_mempool *mp_adaptive = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
 	const char *default_pool_ops;
@@ -350,6 +500,17 @@ test_mempool_perf(void)
 	if (mp_cache == NULL)
 		goto err;
 
+	/* create a mempool (with adaptive cache) */
+	mp_adaptive = rte_mempool_create("perf_test_adaptive", MEMPOOL_SIZE,
+					 MEMPOOL_ELT_SIZE,
+					 RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+					 NULL, NULL,
+					 my_obj_init, NULL,
+					 SOCKET_ID_ANY,
+					 RTE_MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp_adaptive == NULL)
+		goto err;
+
 	default_pool_ops = rte_mbuf_best_mempool_ops();
 	/* Create a mempool based on Default handler */
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -425,6 +586,18 @@ test_mempool_perf(void)
 
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
+	use_external_cache = 0;
+
+	/* performance test with pairs of get and put lcores */
+	printf("start asymmetric performance test (with cache)\n");
+
+	if (launch_asym_cores(mp_cache) < 0)
+		goto err;
+
+	printf("start asymmetric performance test (with adaptive cache)\n");
+
+	if (launch_asym_cores(mp_adaptive) < 0)
+		goto err;
 
 	rte_mempool_list_dump(stdout);
 
@@ -432,6 +605,7 @@ test_mempool_perf(void)
 
 err:
 	rte_mempool_free(mp_cache);
+	rte_mempool_free(mp_adaptive);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
 	return ret;
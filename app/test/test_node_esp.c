@@ -0,0 +1,567 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include "test.h"
+
+#include <inttypes.h>
+#include <stdalign.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_node_esp(void)
+{
+	printf("node_esp not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_bus_vdev.h>
+#include <rte_cryptodev.h>
+#include <rte_esp.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ipsec.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_node_esp_api.h>
+
+/*
+ * The graph of the test is:
+ *
+ *   test_esp_source --> esp_outbound-test_esp --> test_esp_sink
+ *   esp_poll                                  \-> pkt_drop
+ *
+ * The source node sends one burst of packets to the ESP node, and the sink
+ * node records the packets it receives. A dequeue callback of the crypto
+ * device completes the operations one dequeue later, like a device which is
+ * still busy when the ESP node is called for the burst.
+ */
+
+#define CRYPTODEV_NAME "crypto_null_node_esp"
+#define NB_MBUFS 128
+#define NB_COPS 128
+#define QP_DESC 256
+#define NB_PKTS 32
+#define PAYLOAD_LEN 64
+#define MAX_WALKS 4
+
+#define ESP_SPI 5
+#define TUN_SRC RTE_IPV4(198, 18, 0, 1)
+#define TUN_DST RTE_IPV4(198, 18, 1, 1)
+
+static struct rte_mempool *pkt_pool, *cop_pool, *sess_pool;
+static struct rte_ipsec_session session;
+static struct rte_ipsec_session *sessions[] = { &session };
+static struct rte_cryptodev_cb *deq_cbs[RTE_CRYPTO_MAX_DEVS];
+static uint16_t nb_qps;
+static uint8_t dev_id;
+static rte_node_t esp_id;
+static int priv1_offset = -1;
+
+static struct rte_crypto_op *deferred_ops[QP_DESC];
+static uint16_t nb_deferred_ops;
+
+static struct rte_mbuf *source_pkts[NB_PKTS];
+static uint16_t nb_source_pkts;
+
+static struct rte_mbuf *sink_pkts[NB_PKTS];
+static uint16_t nb_sink_pkts;
+
+/* Same description as the next hop data of the node library */
+static const struct rte_mbuf_dynfield test_priv1_dynfield_desc = {
+	.name = "rte_node_dynfield_priv1",
+	.size = sizeof(uint64_t),
+	.align = alignof(uint64_t),
+};
+
+static uint16_t
+test_esp_source(struct rte_graph *graph, struct rte_node *node, void **objs,
+		uint16_t nb_objs)
+{
+	uint16_t nb_pkts = nb_source_pkts;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (nb_pkts == 0)
+		return 0;
+
+	rte_node_enqueue(graph, node, 0, (void **)source_pkts, nb_pkts);
+	nb_source_pkts = 0;
+
+	return nb_pkts;
+}
+
+static struct rte_node_register test_esp_source_node = {
+	.name = "test_esp_source",
+	.process = test_esp_source,
+	.flags = RTE_NODE_SOURCE_F,
+};
+
+RTE_NODE_REGISTER(test_esp_source_node);
+
+static uint16_t
+test_esp_sink(struct rte_graph *graph, struct rte_node *node, void **objs,
+	      uint16_t nb_objs)
+{
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	for (i = 0; i < nb_objs; i++) {
+		if (nb_sink_pkts < NB_PKTS)
+			sink_pkts[nb_sink_pkts] = objs[i];
+		else
+			rte_pktmbuf_free(objs[i]);
+		nb_sink_pkts++;
+	}
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_esp_sink_node = {
+	.name = "test_esp_sink",
+	.process = test_esp_sink,
+};
+
+RTE_NODE_REGISTER(test_esp_sink_node);
+
+/* Complete the operations dequeued on the next dequeue call */
+static uint16_t
+test_esp_deq_cb(uint16_t cb_dev_id, uint16_t qp_id, struct rte_crypto_op **ops,
+		uint16_t nb_ops, void *user_param)
+{
+	struct rte_crypto_op *tmp[QP_DESC];
+	uint16_t nb_done = nb_deferred_ops;
+
+	RTE_SET_USED(cb_dev_id);
+	RTE_SET_USED(qp_id);
+	RTE_SET_USED(user_param);
+
+	memcpy(tmp, ops, nb_ops * sizeof(ops[0]));
+	memcpy(ops, deferred_ops, nb_done * sizeof(ops[0]));
+	memcpy(deferred_ops, tmp, nb_ops * sizeof(ops[0]));
+	nb_deferred_ops = nb_ops;
+
+	return nb_done;
+}
+
+static struct rte_mbuf *
+build_pkt(uint16_t seed)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_mbuf *m;
+	uint8_t *pld;
+	uint16_t i;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, sizeof(*eth) + sizeof(*ip) +
+							 PAYLOAD_LEN);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+
+	memset(eth, 0, sizeof(*eth));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + PAYLOAD_LEN);
+	ip->packet_id = rte_cpu_to_be_16(seed);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 1, 1));
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+	pld = (uint8_t *)(ip + 1);
+	for (i = 0; i < PAYLOAD_LEN; i++)
+		pld[i] = (uint8_t)(seed + i);
+
+	/* Session index, given by the acl_classify node */
+	*RTE_MBUF_DYNFIELD(m, priv1_offset, uint64_t *) = 0;
+
+	return m;
+}
+
+/* Check the outer headers of an encapsulated packet. */
+static int
+check_esp_pkt(struct rte_mbuf *m, uint16_t seed)
+{
+	const struct rte_ipv4_hdr *ip, *inner;
+	const struct rte_esp_hdr *esp;
+	uint32_t off;
+
+	off = RTE_ETHER_HDR_LEN;
+	TEST_ASSERT(m->pkt_len > off + sizeof(*ip) + sizeof(*esp) + sizeof(*inner) +
+		    PAYLOAD_LEN, "Packet too short %u", m->pkt_len);
+	TEST_ASSERT_EQUAL(rte_pktmbuf_data_len(m), m->pkt_len, "Unexpected segments");
+
+	ip = rte_pktmbuf_mtod_offset(m, const struct rte_ipv4_hdr *, off);
+	TEST_ASSERT_EQUAL(ip->next_proto_id, IPPROTO_ESP, "Not an ESP packet");
+	TEST_ASSERT(ip->src_addr == rte_cpu_to_be_32(TUN_SRC) &&
+		    ip->dst_addr == rte_cpu_to_be_32(TUN_DST),
+		    "Wrong tunnel addresses");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length), m->pkt_len - off,
+			  "Wrong IPv4 total length");
+
+	esp = (const struct rte_esp_hdr *)(ip + 1);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(esp->spi), ESP_SPI, "Wrong SPI");
+
+	/* NULL cipher, the inner packet follows the ESP header */
+	inner = (const struct rte_ipv4_hdr *)(esp + 1);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(inner->packet_id), seed, "Wrong inner packet");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_esp_stats_cb(bool is_first, bool is_last, void *cookie,
+		  const struct rte_graph_cluster_node_stats *st)
+{
+	uint64_t *xstats = cookie;
+	uint16_t i;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	if (st->id != esp_id)
+		return 0;
+
+	for (i = 0; i < RTE_MIN(st->xstat_cntrs, 3); i++)
+		xstats[i] = st->xstat_count[i];
+
+	return 0;
+}
+
+static int
+test_esp_burst(void)
+{
+	const char *node_patterns[] = { "test_esp_source", "esp_poll", NULL };
+	const char *graph_patterns[] = { "test_node_esp" };
+	struct rte_graph_cluster_stats_param s_param;
+	struct rte_graph_cluster_stats *stats;
+	struct rte_graph_param gconf;
+	uint64_t xstats[3] = { 0 };
+	struct rte_graph *graph;
+	rte_graph_t graph_id;
+	uint16_t i, walk;
+	int ret;
+
+	node_patterns[2] = rte_node_id_to_name(esp_id);
+
+	for (i = 0; i < NB_PKTS; i++) {
+		source_pkts[i] = build_pkt(i);
+		if (source_pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(source_pkts, i);
+			TEST_ASSERT_NOT_NULL(NULL, "Packet allocation failed");
+		}
+	}
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	graph_id = rte_graph_create("test_node_esp", &gconf);
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		rte_pktmbuf_free_bulk(source_pkts, NB_PKTS);
+		TEST_ASSERT(false, "Graph creation failed with error = %d", rte_errno);
+	}
+	graph = rte_graph_lookup("test_node_esp");
+
+	nb_source_pkts = NB_PKTS;
+	nb_sink_pkts = 0;
+	ret = TEST_FAILED;
+
+	/* The device completes the burst after the call of the ESP node */
+	rte_graph_walk(graph);
+	if (nb_sink_pkts != 0) {
+		printf("Packets out of the ESP node before their completion\n");
+		goto free;
+	}
+
+	/* No new packet for the ESP node, the completed ones must still leave */
+	for (walk = 1; walk < MAX_WALKS && nb_sink_pkts < NB_PKTS; walk++)
+		rte_graph_walk(graph);
+	if (nb_sink_pkts != NB_PKTS) {
+		printf("%u packets out of the ESP node instead of %u\n", nb_sink_pkts,
+		       NB_PKTS);
+		goto free;
+	}
+
+	for (i = 0; i < NB_PKTS; i++) {
+		if (check_esp_pkt(sink_pkts[i], i)) {
+			printf("Wrong packet %u out of the ESP node\n", i);
+			goto free;
+		}
+	}
+
+	memset(&s_param, 0, sizeof(s_param));
+	s_param.socket_id = SOCKET_ID_ANY;
+	s_param.fn = test_esp_stats_cb;
+	s_param.cookie = xstats;
+	s_param.nb_graph_patterns = RTE_DIM(graph_patterns);
+	s_param.graph_patterns = graph_patterns;
+	stats = rte_graph_cluster_stats_create(&s_param);
+	if (stats == NULL) {
+		printf("Stats creation failed with error = %d\n", rte_errno);
+		goto free;
+	}
+	rte_graph_cluster_stats_get(stats, false);
+	rte_graph_cluster_stats_destroy(stats);
+	if (xstats[0] != NB_PKTS || xstats[1] != NB_PKTS || xstats[2] != 0) {
+		printf("Wrong esp_outbound xstats %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+		       xstats[0], xstats[1], xstats[2]);
+		goto free;
+	}
+	ret = TEST_SUCCESS;
+
+free:
+	rte_pktmbuf_free_bulk(sink_pkts, RTE_MIN(nb_sink_pkts, NB_PKTS));
+	nb_sink_pkts = 0;
+	rte_graph_destroy(graph_id);
+
+	return ret;
+}
+
+static int
+test_esp_session_create(void)
+{
+	struct rte_crypto_sym_xform cipher = {
+		.type = RTE_CRYPTO_SYM_XFORM_CIPHER,
+		.cipher = {
+			.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT,
+			.algo = RTE_CRYPTO_CIPHER_NULL,
+		},
+	};
+	struct rte_crypto_sym_xform auth = {
+		.type = RTE_CRYPTO_SYM_XFORM_AUTH,
+		.auth = {
+			.op = RTE_CRYPTO_AUTH_OP_GENERATE,
+			.algo = RTE_CRYPTO_AUTH_NULL,
+		},
+	};
+	struct rte_ipv4_hdr tun_hdr = {
+		.version_ihl = RTE_IPV4_VHL_DEF,
+		.time_to_live = IPDEFTTL,
+		.next_proto_id = IPPROTO_ESP,
+		.src_addr = rte_cpu_to_be_32(TUN_SRC),
+		.dst_addr = rte_cpu_to_be_32(TUN_DST),
+	};
+	struct rte_ipsec_sa_prm prm;
+	struct rte_ipsec_sa *sa;
+	int sz;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.ipsec_xform.spi = ESP_SPI;
+	prm.ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_EGRESS;
+	prm.ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	prm.ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	prm.ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+	prm.ipsec_xform.tunnel.ipv4.src_ip.s_addr = tun_hdr.src_addr;
+	prm.ipsec_xform.tunnel.ipv4.dst_ip.s_addr = tun_hdr.dst_addr;
+	prm.tun.hdr = &tun_hdr;
+	prm.tun.hdr_len = sizeof(tun_hdr);
+	prm.tun.next_proto = IPPROTO_IPIP;
+	cipher.next = &auth;
+	prm.crypto_xform = &cipher;
+
+	sz = rte_ipsec_sa_size(&prm);
+	if (sz < 0)
+		return sz;
+	sa = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (sa == NULL)
+		return -ENOMEM;
+	if (rte_ipsec_sa_init(sa, &prm, sz) < 0)
+		goto free_sa;
+
+	memset(&session, 0, sizeof(session));
+	session.sa = sa;
+	session.type = RTE_SECURITY_ACTION_TYPE_NONE;
+	session.crypto.dev_id = dev_id;
+	session.crypto.ses = rte_cryptodev_sym_session_create(dev_id, prm.crypto_xform,
+							      sess_pool);
+	if (session.crypto.ses == NULL)
+		goto free_sa;
+	if (rte_ipsec_session_prepare(&session) == 0)
+		return 0;
+
+	rte_cryptodev_sym_session_free(dev_id, session.crypto.ses);
+free_sa:
+	rte_free(sa);
+	session.sa = NULL;
+	return -EINVAL;
+}
+
+static int
+test_esp_cryptodev_setup(void)
+{
+	struct rte_cryptodev_qp_conf qp_conf;
+	struct rte_cryptodev_config dev_conf;
+	struct rte_cryptodev_info dev_info;
+	uint16_t qp;
+	int ret;
+
+	ret = rte_vdev_init(CRYPTODEV_NAME, NULL);
+	if (ret < 0)
+		return ret;
+	ret = rte_cryptodev_get_dev_id(CRYPTODEV_NAME);
+	if (ret < 0)
+		return ret;
+	dev_id = ret;
+
+	/* Each graph uses the queue pair of its id */
+	rte_cryptodev_info_get(dev_id, &dev_info);
+	nb_qps = dev_info.max_nb_queue_pairs;
+
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.socket_id = SOCKET_ID_ANY;
+	dev_conf.nb_queue_pairs = nb_qps;
+	ret = rte_cryptodev_configure(dev_id, &dev_conf);
+	if (ret < 0)
+		return ret;
+
+	sess_pool = rte_cryptodev_sym_session_pool_create("test_esp_sess", 1,
+			rte_cryptodev_sym_get_private_session_size(dev_id), 0, 0,
+			SOCKET_ID_ANY);
+	if (sess_pool == NULL)
+		return -ENOMEM;
+
+	qp_conf.nb_descriptors = QP_DESC;
+	qp_conf.mp_session = sess_pool;
+	for (qp = 0; qp < nb_qps; qp++) {
+		ret = rte_cryptodev_queue_pair_setup(dev_id, qp, &qp_conf, SOCKET_ID_ANY);
+		if (ret < 0)
+			return ret;
+		deq_cbs[qp] = rte_cryptodev_add_deq_callback(dev_id, qp, test_esp_deq_cb, NULL);
+		if (deq_cbs[qp] == NULL)
+			return -rte_errno;
+	}
+
+	return rte_cryptodev_start(dev_id);
+}
+
+static void
+testsuite_teardown(void)
+{
+	uint16_t qp;
+
+	if (session.sa != NULL) {
+		rte_cryptodev_sym_session_free(dev_id, session.crypto.ses);
+		rte_free(session.sa);
+		session.sa = NULL;
+	}
+	if (rte_cryptodev_get_dev_id(CRYPTODEV_NAME) >= 0) {
+		rte_cryptodev_stop(dev_id);
+		for (qp = 0; qp < nb_qps; qp++) {
+			if (deq_cbs[qp] != NULL)
+				rte_cryptodev_remove_deq_callback(dev_id, qp, deq_cbs[qp]);
+			deq_cbs[qp] = NULL;
+		}
+		rte_cryptodev_close(dev_id);
+		rte_vdev_uninit(CRYPTODEV_NAME);
+	}
+	rte_mempool_free(sess_pool);
+	rte_mempool_free(cop_pool);
+	rte_mempool_free(pkt_pool);
+	sess_pool = cop_pool = pkt_pool = NULL;
+}
+
+static int
+testsuite_setup(void)
+{
+	const char *sink_name = "test_esp_sink";
+	const char *esp_name = "esp_outbound-test_esp";
+	struct rte_node_esp_cfg cfg;
+	rte_node_t source;
+
+	priv1_offset = rte_mbuf_dynfield_register(&test_priv1_dynfield_desc);
+	if (priv1_offset < 0) {
+		printf("Cannot register the next hop dynfield\n");
+		return TEST_FAILED;
+	}
+
+	pkt_pool = rte_pktmbuf_pool_create("test_esp_pkt", NB_MBUFS, 0, 0,
+					   RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	cop_pool = rte_crypto_op_pool_create("test_esp_cop", RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+					     NB_COPS, 0, 0, SOCKET_ID_ANY);
+	if (pkt_pool == NULL || cop_pool == NULL) {
+		printf("Cannot create the mbuf and crypto operation pools\n");
+		goto err;
+	}
+
+	if (test_esp_cryptodev_setup() < 0) {
+		printf("Cannot setup the %s crypto device\n", CRYPTODEV_NAME);
+		goto err;
+	}
+	if (test_esp_session_create() < 0) {
+		printf("Cannot create the ESP session\n");
+		goto err;
+	}
+
+	/* Clone the ESP node once, and connect it to the test nodes */
+	esp_id = rte_node_from_name(esp_name);
+	if (esp_id == RTE_NODE_ID_INVALID) {
+		esp_id = rte_node_clone(rte_node_from_name("esp_outbound"), "test_esp");
+		if (esp_id == RTE_NODE_ID_INVALID ||
+		    rte_node_edge_update(esp_id, RTE_EDGE_ID_INVALID, &sink_name, 1) ==
+		    RTE_EDGE_ID_INVALID) {
+			printf("Cannot clone the esp_outbound node\n");
+			goto err;
+		}
+	}
+	source = rte_node_from_name("test_esp_source");
+	if (rte_node_edge_count(source) == 0 &&
+	    rte_node_edge_update(source, 0, &esp_name, 1) == RTE_EDGE_ID_INVALID) {
+		printf("Cannot connect the source node\n");
+		goto err;
+	}
+
+	cfg.sessions = sessions;
+	cfg.nb_sessions = RTE_DIM(sessions);
+	cfg.cop_pool = cop_pool;
+	cfg.dev_id = dev_id;
+	cfg.qp_id = 0;
+	cfg.node_id = esp_id;
+	if (rte_node_esp_outbound_configure(&cfg, 1)) {
+		printf("Cannot configure the ESP node\n");
+		goto err;
+	}
+
+	return TEST_SUCCESS;
+
+err:
+	testsuite_teardown();
+	return TEST_FAILED;
+}
+
+static struct unit_test_suite node_esp_testsuite = {
+	.suite_name = "Node ESP test suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_esp_burst),
+		TEST_CASES_END(), /**< NULL terminate unit test array */
+	},
+};
+
+static int
+test_node_esp(void)
+{
+	return unit_test_suite_runner(&node_esp_testsuite);
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(node_esp_autotest, true, true, test_node_esp);
@@ -0,0 +1,832 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include "test.h"
+
+#include <inttypes.h>
+#include <stdalign.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+static int
+test_node_ip_frag(void)
+{
+	printf("node_ip_frag not supported on Windows, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#else
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_node_ip4_api.h>
+#include <rte_node_ip6_api.h>
+
+/*
+ * The graph of the tests is:
+ *
+ *   test_ip_frag_source --> <node>-test_ip_frag --> test_ip_frag_sink
+ *                                               \-> pkt_drop
+ *
+ * where <node> is ip4_fragment, ip6_fragment or ip6_reassembly. The source
+ * node sends the packets of a test to the node under test once, and the
+ * sink node records the packets it receives.
+ */
+
+#define NB_MBUFS 128
+#define PKT_BUF_SIZE 8192
+#define MAX_SINK_PKTS 32
+#define PAYLOAD_MAX 4000
+
+#define IP4_MTU 1500
+#define IP4_FRAG_LEN ((IP4_MTU - sizeof(struct rte_ipv4_hdr)) & ~7U)
+#define IP4_SMALL_LEN 100
+#define IP4_BIG_LEN 4000
+
+#define IP6_MTU 1280
+#define IP6_FRAG_LEN \
+	((IP6_MTU - sizeof(struct rte_ipv6_hdr) - sizeof(struct rte_ipv6_fragment_ext)) & ~7U)
+#define IP6_SMALL_LEN 200
+#define IP6_BIG_LEN 3000
+
+enum test_ip_frag_edge {
+	TEST_IP_FRAG_EDGE_IP4_FRAGMENT,
+	TEST_IP_FRAG_EDGE_IP6_FRAGMENT,
+	TEST_IP_FRAG_EDGE_IP6_REASSEMBLY,
+	TEST_IP_FRAG_EDGE_MAX,
+};
+
+static const char * const parent_names[] = {
+	[TEST_IP_FRAG_EDGE_IP4_FRAGMENT] = "ip4_fragment",
+	[TEST_IP_FRAG_EDGE_IP6_FRAGMENT] = "ip6_fragment",
+	[TEST_IP_FRAG_EDGE_IP6_REASSEMBLY] = "ip6_reassembly",
+};
+
+static struct rte_mempool *pkt_pool, *direct_pool, *indirect_pool;
+static struct rte_ip_frag_tbl *frag_tbl;
+static struct rte_ip_frag_death_row death_row;
+static rte_node_t node_ids[TEST_IP_FRAG_EDGE_MAX];
+static int priv1_offset = -1;
+
+static struct rte_mbuf *source_pkts[MAX_SINK_PKTS];
+static uint16_t nb_source_pkts;
+static rte_edge_t source_edge;
+
+static struct rte_mbuf *sink_pkts[MAX_SINK_PKTS];
+static uint16_t nb_sink_pkts;
+
+static const struct rte_ether_addr test_dst_addr = {
+	.addr_bytes = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 }
+};
+static const struct rte_ether_addr test_src_addr = {
+	.addr_bytes = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 }
+};
+
+/* Layout of the next hop data of the node library, for the rewrite nodes */
+struct test_priv1 {
+	uint16_t nh;
+	uint16_t ttl;
+	uint32_t cksum;
+};
+
+static const struct rte_mbuf_dynfield test_priv1_dynfield_desc = {
+	.name = "rte_node_dynfield_priv1",
+	.size = sizeof(struct test_priv1),
+	.align = alignof(uint64_t),
+};
+
+static inline struct test_priv1 *
+test_priv1(struct rte_mbuf *m)
+{
+	return RTE_MBUF_DYNFIELD(m, priv1_offset, struct test_priv1 *);
+}
+
+static uint16_t
+test_ip_frag_source(struct rte_graph *graph, struct rte_node *node, void **objs,
+		    uint16_t nb_objs)
+{
+	uint16_t nb_pkts = nb_source_pkts;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (nb_pkts == 0)
+		return 0;
+
+	rte_node_enqueue(graph, node, source_edge, (void **)source_pkts, nb_pkts);
+	nb_source_pkts = 0;
+
+	return nb_pkts;
+}
+
+static struct rte_node_register test_ip_frag_source_node = {
+	.name = "test_ip_frag_source",
+	.process = test_ip_frag_source,
+	.flags = RTE_NODE_SOURCE_F,
+};
+
+RTE_NODE_REGISTER(test_ip_frag_source_node);
+
+static uint16_t
+test_ip_frag_sink(struct rte_graph *graph, struct rte_node *node, void **objs,
+		  uint16_t nb_objs)
+{
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	for (i = 0; i < nb_objs; i++) {
+		if (nb_sink_pkts < MAX_SINK_PKTS)
+			sink_pkts[nb_sink_pkts] = objs[i];
+		else
+			rte_pktmbuf_free(objs[i]);
+		nb_sink_pkts++;
+	}
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_ip_frag_sink_node = {
+	.name = "test_ip_frag_sink",
+	.process = test_ip_frag_sink,
+};
+
+RTE_NODE_REGISTER(test_ip_frag_sink_node);
+
+static uint8_t
+payload_byte(uint16_t seed, uint32_t off)
+{
+	return (uint8_t)(seed * 31 + off);
+}
+
+static int
+check_payload(struct rte_mbuf *m, uint32_t off, uint32_t len, uint16_t seed,
+	      uint32_t pld_off)
+{
+	uint8_t buf[PAYLOAD_MAX];
+	const uint8_t *data;
+	uint32_t i;
+
+	data = rte_pktmbuf_read(m, off, len, buf);
+	if (data == NULL)
+		return -1;
+	for (i = 0; i < len; i++) {
+		if (data[i] != payload_byte(seed, pld_off + i))
+			return -1;
+	}
+
+	return 0;
+}
+
+static struct rte_mbuf *
+build_pkt(uint16_t hdr_len, uint16_t len, uint16_t seed)
+{
+	struct rte_mbuf *m;
+	uint8_t *pld;
+	uint16_t i;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+	pld = (uint8_t *)rte_pktmbuf_append(m, hdr_len + len);
+	if (pld == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	pld += hdr_len;
+	for (i = 0; i < len; i++)
+		pld[i] = payload_byte(seed, i);
+	test_priv1(m)->nh = seed;
+	test_priv1(m)->ttl = 64;
+	test_priv1(m)->cksum = 0;
+
+	return m;
+}
+
+static void
+build_eth(struct rte_ether_hdr *eth, uint16_t ether_type)
+{
+	rte_ether_addr_copy(&test_dst_addr, &eth->dst_addr);
+	rte_ether_addr_copy(&test_src_addr, &eth->src_addr);
+	eth->ether_type = rte_cpu_to_be_16(ether_type);
+}
+
+static struct rte_mbuf *
+build_ipv4_pkt(uint16_t len, uint16_t seed, bool df)
+{
+	struct rte_ipv4_hdr *ip;
+	struct rte_mbuf *m;
+
+	m = build_pkt(sizeof(struct rte_ether_hdr) + sizeof(*ip), len, seed);
+	if (m == NULL)
+		return NULL;
+
+	build_eth(rte_pktmbuf_mtod(m, struct rte_ether_hdr *), RTE_ETHER_TYPE_IPV4);
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv4_hdr *, sizeof(struct rte_ether_hdr));
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + len);
+	ip->packet_id = rte_cpu_to_be_16(seed);
+	ip->fragment_offset = df ? rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG) : 0;
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 1, seed));
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+	return m;
+}
+
+static struct rte_mbuf *
+build_ipv6_pkt(uint16_t len, uint16_t seed, bool eth)
+{
+	uint16_t l2_len = eth ? sizeof(struct rte_ether_hdr) : 0;
+	struct rte_ipv6_hdr *ip;
+	struct rte_mbuf *m;
+
+	m = build_pkt(l2_len + sizeof(*ip), len, seed);
+	if (m == NULL)
+		return NULL;
+
+	if (eth)
+		build_eth(rte_pktmbuf_mtod(m, struct rte_ether_hdr *), RTE_ETHER_TYPE_IPV6);
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *, l2_len);
+	memset(ip, 0, sizeof(*ip));
+	ip->vtc_flow = rte_cpu_to_be_32(UINT32_C(6) << 28);
+	ip->payload_len = rte_cpu_to_be_16(len);
+	ip->proto = IPPROTO_UDP;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0xfd;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0xfd;
+	ip->dst_addr[15] = (uint8_t)seed;
+
+	return m;
+}
+
+static int
+check_eth(struct rte_mbuf *m, uint16_t ether_type)
+{
+	const struct rte_ether_hdr *eth = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+
+	if (!rte_is_same_ether_addr(&eth->dst_addr, &test_dst_addr) ||
+	    !rte_is_same_ether_addr(&eth->src_addr, &test_src_addr) ||
+	    eth->ether_type != rte_cpu_to_be_16(ether_type))
+		return -1;
+
+	return 0;
+}
+
+struct test_ip_frag_xstats {
+	rte_node_t id;
+	uint16_t nb_xstats;
+	uint64_t xstats[3];
+};
+
+static int
+test_ip_frag_stats_cb(bool is_first, bool is_last, void *cookie,
+		      const struct rte_graph_cluster_node_stats *st)
+{
+	struct test_ip_frag_xstats *xs = cookie;
+	uint16_t i;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	if (st->id != xs->id)
+		return 0;
+
+	xs->nb_xstats = RTE_MIN(st->xstat_cntrs, (uint16_t)RTE_DIM(xs->xstats));
+	for (i = 0; i < xs->nb_xstats; i++)
+		xs->xstats[i] = st->xstat_count[i];
+
+	return 0;
+}
+
+/*
+ * Send the packets to the node under test in a new graph, and read the
+ * xstats of the node once they are processed.
+ */
+static int
+test_ip_frag_run(enum test_ip_frag_edge edge, struct rte_mbuf **pkts, uint16_t nb_pkts,
+		 struct test_ip_frag_xstats *xs)
+{
+	const char *node_patterns[] = { "test_ip_frag_source", NULL };
+	const char *graph_patterns[] = { "test_ip_frag" };
+	struct rte_graph_cluster_stats_param s_param;
+	struct rte_graph_cluster_stats *stats;
+	struct rte_graph_param gconf;
+	struct rte_graph *graph;
+	rte_graph_t graph_id;
+	int ret = -1;
+
+	node_patterns[1] = rte_node_id_to_name(node_ids[edge]);
+
+	memset(&gconf, 0, sizeof(gconf));
+	gconf.socket_id = SOCKET_ID_ANY;
+	gconf.nb_node_patterns = RTE_DIM(node_patterns);
+	gconf.node_patterns = node_patterns;
+	graph_id = rte_graph_create("test_ip_frag", &gconf);
+	if (graph_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		return -1;
+	}
+	graph = rte_graph_lookup("test_ip_frag");
+	if (graph == NULL)
+		goto graph_destroy;
+
+	memset(&s_param, 0, sizeof(s_param));
+	s_param.socket_id = SOCKET_ID_ANY;
+	s_param.fn = test_ip_frag_stats_cb;
+	s_param.cookie = xs;
+	s_param.nb_graph_patterns = RTE_DIM(graph_patterns);
+	s_param.graph_patterns = graph_patterns;
+	stats = rte_graph_cluster_stats_create(&s_param);
+	if (stats == NULL) {
+		printf("Stats creation failed with error = %d\n", rte_errno);
+		goto graph_destroy;
+	}
+
+	memcpy(source_pkts, pkts, nb_pkts * sizeof(pkts[0]));
+	nb_source_pkts = nb_pkts;
+	source_edge = edge;
+	nb_sink_pkts = 0;
+	nb_pkts = 0;
+
+	rte_graph_walk(graph);
+
+	memset(xs, 0, sizeof(*xs));
+	xs->id = node_ids[edge];
+	rte_graph_cluster_stats_get(stats, false);
+	rte_graph_cluster_stats_destroy(stats);
+	ret = 0;
+
+graph_destroy:
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+	rte_graph_destroy(graph_id);
+
+	return ret;
+}
+
+static void
+test_ip_frag_sink_free(void)
+{
+	rte_pktmbuf_free_bulk(sink_pkts, RTE_MIN(nb_sink_pkts, MAX_SINK_PKTS));
+	nb_sink_pkts = 0;
+}
+
+static int
+test_ip_frag_check_leaks(void)
+{
+	TEST_ASSERT_EQUAL(rte_mempool_in_use_count(pkt_pool), 0, "Packet mbufs leaked");
+	TEST_ASSERT_EQUAL(rte_mempool_in_use_count(direct_pool), 0, "Direct mbufs leaked");
+	TEST_ASSERT_EQUAL(rte_mempool_in_use_count(indirect_pool), 0,
+			  "Indirect mbufs leaked");
+
+	return TEST_SUCCESS;
+}
+
+static int
+check_ipv4_pkt(struct rte_mbuf *m, uint16_t len, uint16_t seed, uint32_t off, bool mf)
+{
+	struct rte_ipv4_hdr *ip, ip_copy;
+	uint16_t flag_offset;
+
+	TEST_ASSERT_EQUAL(m->pkt_len,
+			  sizeof(struct rte_ether_hdr) + sizeof(*ip) + len,
+			  "Wrong packet length %u", m->pkt_len);
+	TEST_ASSERT_SUCCESS(check_eth(m, RTE_ETHER_TYPE_IPV4), "Wrong L2 header");
+
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv4_hdr *, sizeof(struct rte_ether_hdr));
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length), sizeof(*ip) + len,
+			  "Wrong IPv4 total length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->packet_id), seed, "Wrong IPv4 id");
+	flag_offset = rte_be_to_cpu_16(ip->fragment_offset);
+	TEST_ASSERT_EQUAL((flag_offset & RTE_IPV4_HDR_OFFSET_MASK) * RTE_IPV4_HDR_OFFSET_UNITS,
+			  off, "Wrong IPv4 fragment offset");
+	TEST_ASSERT_EQUAL(!!(flag_offset & RTE_IPV4_HDR_MF_FLAG), mf,
+			  "Wrong IPv4 more fragments flag");
+
+	ip_copy = *ip;
+	ip_copy.hdr_checksum = 0;
+	TEST_ASSERT_EQUAL(ip->hdr_checksum, rte_ipv4_cksum(&ip_copy),
+			  "Wrong IPv4 header checksum");
+
+	/* The fragments carry their own header checksum for ip4_rewrite */
+	TEST_ASSERT(test_priv1(m)->nh == seed && test_priv1(m)->ttl == 64,
+		    "Next hop data not copied");
+	TEST_ASSERT_EQUAL(test_priv1(m)->cksum, (mf || off ? ip->hdr_checksum : 0U),
+			  "Wrong next hop checksum");
+	TEST_ASSERT_SUCCESS(check_payload(m, sizeof(struct rte_ether_hdr) + sizeof(*ip),
+					  len, seed, off),
+			    "Wrong IPv4 payload");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_ip4_fragment(void)
+{
+	static const struct {
+		uint16_t len;
+		bool df;
+	} in[] = {
+		{ IP4_SMALL_LEN, false },
+		{ IP4_BIG_LEN, false },
+		{ IP4_SMALL_LEN, true },
+		{ IP4_BIG_LEN, true },
+		{ IP4_BIG_LEN, false },
+	};
+	struct rte_mbuf *pkts[RTE_DIM(in)];
+	struct test_ip_frag_xstats xs;
+	uint16_t nb_frags = 0, nb_big = 0;
+	uint16_t i, out = 0;
+	uint32_t off, len;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(in); i++) {
+		pkts[i] = build_ipv4_pkt(in[i].len, i, in[i].df);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Packet allocation failed");
+	}
+
+	TEST_ASSERT_SUCCESS(test_ip_frag_run(TEST_IP_FRAG_EDGE_IP4_FRAGMENT, pkts,
+					     RTE_DIM(pkts), &xs),
+			    "Graph run failed");
+
+	ret = TEST_FAILED;
+	for (i = 0; i < RTE_DIM(in); i++) {
+		if (in[i].len <= IP4_MTU - sizeof(struct rte_ipv4_hdr)) {
+			if (out >= nb_sink_pkts ||
+			    check_ipv4_pkt(sink_pkts[out++], in[i].len, i, 0, false)) {
+				printf("Wrong packet %u not fragmented\n", i);
+				goto free;
+			}
+			continue;
+		}
+		/* Packets which must not be fragmented are dropped */
+		if (in[i].df)
+			continue;
+
+		nb_big++;
+		for (off = 0; off < in[i].len; off += len) {
+			len = RTE_MIN(in[i].len - off, (uint32_t)IP4_FRAG_LEN);
+			if (out >= nb_sink_pkts ||
+			    check_ipv4_pkt(sink_pkts[out++], len, i, off,
+					   off + len < in[i].len)) {
+				printf("Wrong fragment at offset %u of packet %u\n", off, i);
+				goto free;
+			}
+			nb_frags++;
+		}
+	}
+	if (out != nb_sink_pkts) {
+		printf("Unexpected %u packets out of the node\n", nb_sink_pkts - out);
+		goto free;
+	}
+
+	if (xs.nb_xstats != 3 || xs.xstats[0] != nb_big || xs.xstats[1] != nb_frags ||
+	    xs.xstats[2] != 1) {
+		printf("Wrong ip4_fragment xstats %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+		       xs.xstats[0], xs.xstats[1], xs.xstats[2]);
+		goto free;
+	}
+	ret = TEST_SUCCESS;
+
+free:
+	test_ip_frag_sink_free();
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	return test_ip_frag_check_leaks();
+}
+
+static int
+check_ipv6_pkt(struct rte_mbuf *m, uint16_t len, uint16_t seed)
+{
+	struct rte_ipv6_hdr *ip;
+
+	TEST_ASSERT_EQUAL(m->pkt_len, sizeof(struct rte_ether_hdr) + sizeof(*ip) + len,
+			  "Wrong packet length %u", m->pkt_len);
+	TEST_ASSERT_SUCCESS(check_eth(m, RTE_ETHER_TYPE_IPV6), "Wrong L2 header");
+
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *, sizeof(struct rte_ether_hdr));
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->payload_len), len, "Wrong IPv6 payload length");
+	TEST_ASSERT_EQUAL(ip->proto, IPPROTO_UDP, "Wrong IPv6 next header");
+	TEST_ASSERT_EQUAL(ip->dst_addr[15], (uint8_t)seed, "Wrong IPv6 destination");
+	TEST_ASSERT_SUCCESS(check_payload(m, sizeof(struct rte_ether_hdr) + sizeof(*ip),
+					  len, seed, 0),
+			    "Wrong IPv6 payload");
+
+	return TEST_SUCCESS;
+}
+
+static int
+check_ipv6_frag(struct rte_mbuf *m, uint16_t len, uint16_t seed, uint32_t off, bool mf)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ip;
+	uint16_t frag_data;
+	uint32_t hdr_len;
+
+	hdr_len = sizeof(struct rte_ether_hdr) + sizeof(*ip) + sizeof(*frag_hdr);
+	TEST_ASSERT_EQUAL(m->pkt_len, hdr_len + len, "Wrong fragment length %u", m->pkt_len);
+	TEST_ASSERT_SUCCESS(check_eth(m, RTE_ETHER_TYPE_IPV6), "Wrong L2 header");
+
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *, sizeof(struct rte_ether_hdr));
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->payload_len), sizeof(*frag_hdr) + len,
+			  "Wrong IPv6 payload length");
+	TEST_ASSERT_EQUAL(ip->proto, IPPROTO_FRAGMENT, "No IPv6 fragment header");
+
+	frag_hdr = (struct rte_ipv6_fragment_ext *)(ip + 1);
+	frag_data = rte_be_to_cpu_16(frag_hdr->frag_data);
+	TEST_ASSERT_EQUAL(frag_hdr->next_header, IPPROTO_UDP, "Wrong IPv6 next header");
+	TEST_ASSERT_EQUAL((uint32_t)(frag_data & RTE_IPV6_EHDR_FO_MASK), off,
+			  "Wrong IPv6 fragment offset");
+	TEST_ASSERT_EQUAL(!!RTE_IPV6_GET_MF(frag_data), mf, "Wrong IPv6 more fragments flag");
+
+	TEST_ASSERT(test_priv1(m)->nh == seed && test_priv1(m)->ttl == 64 &&
+		    test_priv1(m)->cksum == 0,
+		    "Next hop data not copied");
+	TEST_ASSERT_SUCCESS(check_payload(m, hdr_len, len, seed, off), "Wrong IPv6 payload");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_ip6_fragment(void)
+{
+	static const uint16_t in[] = { IP6_SMALL_LEN, IP6_BIG_LEN, IP6_SMALL_LEN, IP6_BIG_LEN };
+	struct rte_mbuf *pkts[RTE_DIM(in)];
+	struct test_ip_frag_xstats xs;
+	uint16_t nb_frags = 0, nb_big = 0;
+	uint16_t i, out = 0;
+	uint32_t off, len;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(in); i++) {
+		pkts[i] = build_ipv6_pkt(in[i], i, true);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Packet allocation failed");
+	}
+
+	TEST_ASSERT_SUCCESS(test_ip_frag_run(TEST_IP_FRAG_EDGE_IP6_FRAGMENT, pkts,
+					     RTE_DIM(pkts), &xs),
+			    "Graph run failed");
+
+	ret = TEST_FAILED;
+	for (i = 0; i < RTE_DIM(in); i++) {
+		if (in[i] <= IP6_MTU - sizeof(struct rte_ipv6_hdr)) {
+			if (out >= nb_sink_pkts || check_ipv6_pkt(sink_pkts[out++], in[i], i)) {
+				printf("Wrong packet %u not fragmented\n", i);
+				goto free;
+			}
+			continue;
+		}
+
+		nb_big++;
+		for (off = 0; off < in[i]; off += len) {
+			len = RTE_MIN(in[i] - off, (uint32_t)IP6_FRAG_LEN);
+			if (out >= nb_sink_pkts ||
+			    check_ipv6_frag(sink_pkts[out++], len, i, off, off + len < in[i])) {
+				printf("Wrong fragment at offset %u of packet %u\n", off, i);
+				goto free;
+			}
+			nb_frags++;
+		}
+	}
+	if (out != nb_sink_pkts) {
+		printf("Unexpected %u packets out of the node\n", nb_sink_pkts - out);
+		goto free;
+	}
+
+	if (xs.nb_xstats != 3 || xs.xstats[0] != nb_big || xs.xstats[1] != nb_frags ||
+	    xs.xstats[2] != 0) {
+		printf("Wrong ip6_fragment xstats %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+		       xs.xstats[0], xs.xstats[1], xs.xstats[2]);
+		goto free;
+	}
+	ret = TEST_SUCCESS;
+
+free:
+	test_ip_frag_sink_free();
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	return test_ip_frag_check_leaks();
+}
+
+static int
+test_ip6_reassembly(void)
+{
+	struct rte_mbuf *frags[RTE_LIBRTE_IP_FRAG_MAX_FRAG];
+	struct rte_mbuf *pkts[RTE_LIBRTE_IP_FRAG_MAX_FRAG + 1];
+	struct test_ip_frag_xstats xs;
+	struct rte_ether_hdr *eth;
+	struct rte_mbuf *m;
+	int32_t nb_frags, i;
+	uint16_t nb_pkts = 0;
+	int ret;
+
+	m = build_ipv6_pkt(IP6_BIG_LEN, 1, false);
+	TEST_ASSERT_NOT_NULL(m, "Packet allocation failed");
+	nb_frags = rte_ipv6_fragment_packet(m, frags, RTE_DIM(frags), IP6_MTU,
+					    direct_pool, indirect_pool);
+	rte_pktmbuf_free(m);
+	TEST_ASSERT(nb_frags > 1, "Packet fragmentation failed: %d", nb_frags);
+
+	for (i = 0; i < nb_frags; i++) {
+		eth = (struct rte_ether_hdr *)rte_pktmbuf_prepend(frags[i], sizeof(*eth));
+		if (eth == NULL) {
+			rte_pktmbuf_free_bulk(frags, nb_frags);
+			TEST_ASSERT_NOT_NULL(eth, "No room for the L2 header");
+		}
+		build_eth(eth, RTE_ETHER_TYPE_IPV6);
+	}
+
+	pkts[nb_pkts] = build_ipv6_pkt(IP6_SMALL_LEN, 0, true);
+	if (pkts[nb_pkts] == NULL) {
+		rte_pktmbuf_free_bulk(frags, nb_frags);
+		TEST_ASSERT_NOT_NULL(pkts[nb_pkts], "Packet allocation failed");
+	}
+	nb_pkts++;
+
+	/* Send the fragments out of order, the last one first */
+	pkts[nb_pkts++] = frags[nb_frags - 1];
+	for (i = 0; i < nb_frags - 1; i++)
+		pkts[nb_pkts++] = frags[i];
+
+	TEST_ASSERT_SUCCESS(test_ip_frag_run(TEST_IP_FRAG_EDGE_IP6_REASSEMBLY, pkts,
+					     nb_pkts, &xs),
+			    "Graph run failed");
+
+	ret = TEST_FAILED;
+	if (nb_sink_pkts != 2) {
+		printf("Unexpected %u packets out of the node\n", nb_sink_pkts);
+		goto free;
+	}
+	if (check_ipv6_pkt(sink_pkts[0], IP6_SMALL_LEN, 0)) {
+		printf("Wrong packet not fragmented\n");
+		goto free;
+	}
+	if (check_ipv6_pkt(sink_pkts[1], IP6_BIG_LEN, 1)) {
+		printf("Wrong reassembled packet\n");
+		goto free;
+	}
+
+	if (xs.nb_xstats != 3 || xs.xstats[0] != (uint64_t)nb_frags || xs.xstats[1] != 1 ||
+	    xs.xstats[2] != 0) {
+		printf("Wrong ip6_reassembly xstats %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+		       xs.xstats[0], xs.xstats[1], xs.xstats[2]);
+		goto free;
+	}
+	ret = TEST_SUCCESS;
+
+free:
+	test_ip_frag_sink_free();
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	return test_ip_frag_check_leaks();
+}
+
+/* Clone the node under test once, and connect it to the sink node */
+static int
+test_ip_frag_node_get(enum test_ip_frag_edge edge)
+{
+	const char *sink_name = "test_ip_frag_sink";
+	char name[RTE_NODE_NAMESIZE];
+	rte_node_t id;
+
+	snprintf(name, sizeof(name), "%s-test_ip_frag", parent_names[edge]);
+	id = rte_node_from_name(name);
+	if (id == RTE_NODE_ID_INVALID) {
+		id = rte_node_clone(rte_node_from_name(parent_names[edge]), "test_ip_frag");
+		if (id == RTE_NODE_ID_INVALID)
+			return -1;
+		if (rte_node_edge_update(id, RTE_EDGE_ID_INVALID, &sink_name, 1) ==
+		    RTE_EDGE_ID_INVALID)
+			return -1;
+	}
+	node_ids[edge] = id;
+
+	return 0;
+}
+
+static int
+testsuite_setup(void)
+{
+	const char *next_nodes[TEST_IP_FRAG_EDGE_MAX];
+	struct rte_node_ip6_reassembly_cfg reass_cfg;
+	struct rte_node_ip4_fragment_cfg ip4_cfg;
+	struct rte_node_ip6_fragment_cfg ip6_cfg;
+	rte_node_t source;
+	int i;
+
+	priv1_offset = rte_mbuf_dynfield_register(&test_priv1_dynfield_desc);
+	if (priv1_offset < 0) {
+		printf("Cannot register the next hop dynfield\n");
+		return TEST_FAILED;
+	}
+
+	pkt_pool = rte_pktmbuf_pool_create("test_ip_frag_pkt", NB_MBUFS, 0, 0,
+					   RTE_PKTMBUF_HEADROOM + PKT_BUF_SIZE, SOCKET_ID_ANY);
+	direct_pool = rte_pktmbuf_pool_create("test_ip_frag_direct", NB_MBUFS, 0, 0,
+					      RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	indirect_pool = rte_pktmbuf_pool_create("test_ip_frag_indirect", NB_MBUFS, 0, 0,
+						0, SOCKET_ID_ANY);
+	frag_tbl = rte_ip_frag_table_create(16, 4, 64, rte_get_tsc_hz(), SOCKET_ID_ANY);
+	if (pkt_pool == NULL || direct_pool == NULL || indirect_pool == NULL ||
+	    frag_tbl == NULL) {
+		printf("Cannot create the mbuf pools or the reassembly table\n");
+		goto err;
+	}
+	memset(&death_row, 0, sizeof(death_row));
+
+	for (i = 0; i < TEST_IP_FRAG_EDGE_MAX; i++) {
+		if (test_ip_frag_node_get(i)) {
+			printf("Cannot clone the %s node\n", parent_names[i]);
+			goto err;
+		}
+		next_nodes[i] = rte_node_id_to_name(node_ids[i]);
+	}
+
+	source = rte_node_from_name("test_ip_frag_source");
+	if (rte_node_edge_count(source) == 0 &&
+	    rte_node_edge_update(source, 0, next_nodes, RTE_DIM(next_nodes)) ==
+	    RTE_EDGE_ID_INVALID) {
+		printf("Cannot connect the source node\n");
+		goto err;
+	}
+
+	ip4_cfg.pool_direct = direct_pool;
+	ip4_cfg.pool_indirect = indirect_pool;
+	ip4_cfg.mtu = IP4_MTU;
+	ip4_cfg.node_id = node_ids[TEST_IP_FRAG_EDGE_IP4_FRAGMENT];
+	ip6_cfg.pool_direct = direct_pool;
+	ip6_cfg.pool_indirect = indirect_pool;
+	ip6_cfg.mtu = IP6_MTU;
+	ip6_cfg.node_id = node_ids[TEST_IP_FRAG_EDGE_IP6_FRAGMENT];
+	reass_cfg.tbl = frag_tbl;
+	reass_cfg.dr = &death_row;
+	reass_cfg.node_id = node_ids[TEST_IP_FRAG_EDGE_IP6_REASSEMBLY];
+	if (rte_node_ip4_fragment_configure(&ip4_cfg, 1) ||
+	    rte_node_ip6_fragment_configure(&ip6_cfg, 1) ||
+	    rte_node_ip6_reassembly_configure(&reass_cfg, 1)) {
+		printf("Cannot configure the nodes\n");
+		goto err;
+	}
+
+	return TEST_SUCCESS;
+
+err:
+	rte_ip_frag_table_destroy(frag_tbl);
+	rte_mempool_free(indirect_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(pkt_pool);
+	frag_tbl = NULL;
+	pkt_pool = direct_pool = indirect_pool = NULL;
+
+	return TEST_FAILED;
+}
+
+static void
+testsuite_teardown(void)
+{
+	rte_ip_frag_table_destroy(frag_tbl);
+	rte_mempool_free(indirect_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(pkt_pool);
+	frag_tbl = NULL;
+	pkt_pool = direct_pool = indirect_pool = NULL;
+}
+
+static struct unit_test_suite node_ip_frag_testsuite = {
+	.suite_name = "Node IP fragmentation and reassembly test suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_ip4_fragment),
+		TEST_CASE(test_ip6_fragment),
+		TEST_CASE(test_ip6_reassembly),
+		TEST_CASES_END(), /**< NULL terminate unit test array */
+	},
+};
+
+static int
+test_node_ip_frag(void)
+{
+	return unit_test_suite_runner(&node_ip_frag_testsuite);
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+REGISTER_FAST_TEST(node_ip_frag_autotest, true, true, test_node_ip_frag);
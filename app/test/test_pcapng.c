@@ -29,6 +29,7 @@
 #define MAX_BURST	64
 #define MAX_GAP_US	100000
 #define DUMMY_MBUF_NUM	3
+#define WRITE_BUF_SIZE	(16 * 1024)
 
 static struct rte_mempool *mp;
 static const uint32_t pkt_len = 200;
@@ -431,6 +432,88 @@ test_write_packets(void)
 	return -1;
 }
 
+static int
+test_write_buffered(void)
+{
+	char file_name[] = "/tmp/pcapng_test_XXXXXX.pcapng";
+	static rte_pcapng_t *pcapng;
+	struct dummy_mbuf mbfs;
+	struct rte_mbuf *mc;
+	uint64_t start, end, ts;
+	int ret, tmp_fd, count;
+	uint64_t now = current_timestamp();
+
+	/* the copy records the TSC of the capture */
+	mbuf1_prepare(&mbfs, pkt_len);
+	start = rte_get_tsc_cycles();
+	mc = rte_pcapng_copy(port_id, 0, &mbfs.mb[0], mp, pkt_len,
+			     RTE_PCAPNG_DIRECTION_IN, NULL);
+	end = rte_get_tsc_cycles();
+	if (mc == NULL) {
+		fprintf(stderr, "Cannot copy packet\n");
+		return -1;
+	}
+	ts = rte_pcapng_mbuf_timestamp(mc);
+	rte_pktmbuf_free(mc);
+	if (ts < start || ts > end) {
+		fprintf(stderr, "Packet timestamp out of range\n");
+		return -1;
+	}
+
+	tmp_fd = mkstemps(file_name, strlen(".pcapng"));
+	if (tmp_fd == -1) {
+		perror("mkstemps() failure");
+		return -1;
+	}
+	printf("pcapng: output file %s\n", file_name);
+
+	pcapng = rte_pcapng_fdopen(tmp_fd, NULL, NULL, "pcapng_buffered", NULL);
+	if (pcapng == NULL) {
+		fprintf(stderr, "rte_pcapng_fdopen failed\n");
+		close(tmp_fd);
+		return -1;
+	}
+
+	/* small buffer so that it gets flushed several times */
+	ret = rte_pcapng_set_write_buffer(pcapng, WRITE_BUF_SIZE);
+	if (ret < 0) {
+		fprintf(stderr, "can not set write buffer\n");
+		goto fail;
+	}
+
+	ret = rte_pcapng_add_interface(pcapng, port_id,
+				       NULL, NULL, NULL);
+	if (ret < 0) {
+		fprintf(stderr, "can not add port %u\n", port_id);
+		goto fail;
+	}
+
+	count = fill_pcapng_file(pcapng, TOTAL_PACKETS / 8);
+	if (count < 0)
+		goto fail;
+
+	/* statistics block must come after the buffered packets */
+	ret = rte_pcapng_write_stats(pcapng, port_id,
+				     count, 0, "end of test");
+	if (ret <= 0) {
+		fprintf(stderr, "Write of statistics failed\n");
+		goto fail;
+	}
+
+	rte_pcapng_close(pcapng);
+
+	ret = valid_pcapng_file(file_name, now, count);
+	/* if test fails want to investigate the file */
+	if (ret == 0)
+		unlink(file_name);
+
+	return ret;
+
+fail:
+	rte_pcapng_close(pcapng);
+	return -1;
+}
+
 static void
 test_cleanup(void)
 {
@@ -446,6 +529,7 @@ unit_test_suite test_pcapng_suite  = {
 	.unit_test_cases = {
 		TEST_CASE(test_add_interface),
 		TEST_CASE(test_write_packets),
+		TEST_CASE(test_write_buffered),
 		TEST_CASES_END()
 	}
 };
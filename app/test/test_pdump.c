@@ -7,6 +7,8 @@
 #include <limits.h>
 
 #include <ethdev_driver.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
 #include <rte_pdump.h>
 #include "rte_eal.h"
 #include "rte_lcore.h"
@@ -24,6 +26,226 @@ struct rte_ring *ring_server;
 uint16_t portid;
 uint16_t flag_for_send_pkts = 1;
 
+/*
+ * Each byte of the packets sent by the server is the packet index,
+ * the first packet having an external buffer.
+ */
+#define PKT_LEN 64
+#define ZC_SNAPLEN 32
+#define ZC_NB_CAPTURED 16
+
+static void
+ext_buf_free(void *addr, void *opaque __rte_unused)
+{
+	rte_free(addr);
+}
+
+static int
+fill_pkts(struct rte_mbuf **pbuf)
+{
+	struct rte_mbuf_ext_shared_info *shinfo;
+	uint16_t buf_len;
+	char *data;
+	void *buf;
+	int itr;
+
+	buf_len = PKT_LEN + sizeof(struct rte_mbuf_ext_shared_info);
+	buf = rte_malloc("pdump_ext_buf", buf_len, RTE_CACHE_LINE_SIZE);
+	if (buf == NULL)
+		return -1;
+	shinfo = rte_pktmbuf_ext_shinfo_init_helper(buf, &buf_len,
+						    ext_buf_free, NULL);
+	if (shinfo == NULL) {
+		rte_free(buf);
+		return -1;
+	}
+	rte_pktmbuf_attach_extbuf(pbuf[0], buf, rte_malloc_virt2iova(buf),
+				  buf_len, shinfo);
+	pbuf[0]->data_off = 0;
+
+	for (itr = 0; itr < NUM_PACKETS; itr++) {
+		data = rte_pktmbuf_append(pbuf[itr], PKT_LEN);
+		if (data == NULL)
+			return -1;
+		memset(data, itr, PKT_LEN);
+	}
+	return 0;
+}
+
+static int
+check_zc_copy(const struct rte_mbuf *m, struct rte_mempool *mp)
+{
+	const uint8_t *data = rte_pktmbuf_mtod(m, const uint8_t *);
+	struct rte_mbuf *p;
+	uint8_t idx = data[0];
+	uint32_t i;
+
+	/* an external buffer is copied, the other packets are shared */
+	if (idx == 0) {
+		if (RTE_MBUF_CLONED(m) || RTE_MBUF_HAS_EXTBUF(m)) {
+			printf("packet with external buffer not copied\n");
+			return -1;
+		}
+	} else if (!RTE_MBUF_CLONED(m)) {
+		printf("packet %u not shared\n", idx);
+		return -1;
+	}
+
+	p = rte_pdump_zc_copy(m, mp, ZC_SNAPLEN, 0);
+	if (p == NULL) {
+		printf("rte_pdump_zc_copy of packet %u failed\n", idx);
+		return -1;
+	}
+	data = rte_pktmbuf_mtod(p, const uint8_t *);
+	for (i = 0; i < ZC_SNAPLEN; i++)
+		if (data[i] != idx)
+			break;
+	if (rte_pktmbuf_pkt_len(p) != ZC_SNAPLEN || i != ZC_SNAPLEN) {
+		printf("rte_pdump_zc_copy of packet %u is wrong\n", idx);
+		rte_pktmbuf_free(p);
+		return -1;
+	}
+	rte_pktmbuf_free(p);
+
+	p = rte_pdump_zc_copy(m, mp, 0, RTE_PDUMP_FLAG_PCAPNG);
+	if (p == NULL || rte_pktmbuf_pkt_len(p) <= PKT_LEN) {
+		printf("rte_pdump_zc_copy of packet %u to pcapng failed\n",
+		       idx);
+		rte_pktmbuf_free(p);
+		return -1;
+	}
+	rte_pktmbuf_free(p);
+
+	return idx;
+}
+
+static void
+drain_ring(struct rte_ring *ring)
+{
+	struct rte_mbuf *m;
+
+	while (rte_ring_dequeue(ring, (void **)&m) == 0)
+		rte_pktmbuf_free(m);
+}
+
+/*
+ * Capture the packets sent by the server until enough are captured
+ * or skipped, returning the number of packets sampled and skipped.
+ * The packets dropped because the ring is full are sampled.
+ */
+static int
+run_zc_capture(struct rte_ring *ring, struct rte_mempool *mp,
+	       const struct rte_pdump_sampling *sampling,
+	       uint64_t *sampled, uint64_t *skipped, uint64_t *cycles)
+{
+	const uint32_t flags = RTE_PDUMP_FLAG_TX | RTE_PDUMP_FLAG_ZEROCOPY;
+	uint64_t start, timeout = rte_get_timer_hz() * 5;
+	struct rte_pdump_stats before, after;
+	uint64_t accepted, dropped;
+
+	/* let the bursts of a previous capture complete */
+	rte_delay_ms(10);
+	drain_ring(ring);
+	if (rte_pdump_stats(portid, &before) < 0 ||
+	    rte_pdump_enable_sampling(portid, QUEUE_ID, flags, 0, ring, mp,
+				      NULL, sampling) < 0) {
+		printf("rte_pdump_enable_sampling failed\n");
+		return -1;
+	}
+
+	start = rte_get_timer_cycles();
+	while (rte_ring_count(ring) < ZC_NB_CAPTURED &&
+	       rte_get_timer_cycles() - start < timeout)
+		rte_delay_ms(1);
+
+	if (rte_pdump_disable(portid, QUEUE_ID, flags) < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+	*cycles = rte_get_timer_cycles() - start;
+	rte_delay_ms(10);
+
+	if (rte_pdump_stats(portid, &after) < 0) {
+		printf("rte_pdump_stats failed\n");
+		return -1;
+	}
+	accepted = after.accepted - before.accepted;
+	dropped = after.ringfull - before.ringfull;
+	*sampled = accepted + after.nombuf - before.nombuf;
+	*skipped = after.skipped - before.skipped;
+
+	if (rte_ring_count(ring) != accepted - dropped) {
+		printf("%u packets captured instead of %" PRIu64 "\n",
+		       rte_ring_count(ring), accepted - dropped);
+		return -1;
+	}
+	return 0;
+}
+
+static int
+run_zc_client_tests(struct rte_ring *ring, struct rte_mempool *mp)
+{
+	/* the 7th captured packet is the first one of a burst */
+	const struct rte_pdump_sampling period = { .period = 3 };
+	/* one token per second: mostly the burst is captured */
+	const struct rte_pdump_sampling rate = { .burst = 4, .rate = 1 };
+	uint64_t sampled, skipped, cycles;
+	bool ext_buf_seen = false;
+	struct rte_mbuf *m;
+	int ret = 0;
+
+	if (rte_pdump_zc_copy(NULL, mp, 0, 0) != NULL || rte_errno != EINVAL) {
+		printf("rte_pdump_zc_copy of NULL packet did not fail\n");
+		return -1;
+	}
+
+	if (run_zc_capture(ring, mp, &period, &sampled, &skipped,
+			   &cycles) < 0)
+		return -1;
+	if (sampled == 0 || skipped < 2 * sampled ||
+	    skipped > 2 * sampled + 2) {
+		printf("period: sampled %" PRIu64 " skipped %" PRIu64 "\n",
+		       sampled, skipped);
+		ret = -1;
+	}
+	if (rte_ring_count(ring) < ZC_NB_CAPTURED) {
+		printf("only %u packets captured\n", rte_ring_count(ring));
+		ret = -1;
+	}
+	while (rte_ring_dequeue(ring, (void **)&m) == 0) {
+		switch (check_zc_copy(m, mp)) {
+		case -1:
+			ret = -1;
+			break;
+		case 0:
+			ext_buf_seen = true;
+			break;
+		}
+		rte_pktmbuf_free(m);
+	}
+	if (ret == 0 && !ext_buf_seen) {
+		printf("packet with external buffer not captured\n");
+		ret = -1;
+	}
+	if (ret < 0)
+		return ret;
+	printf("pdump zero-copy period sampling success\n");
+
+	if (run_zc_capture(ring, mp, &rate, &sampled, &skipped, &cycles) < 0)
+		return -1;
+	drain_ring(ring);
+	if (sampled < rate.burst ||
+	    sampled > rate.burst + 1 + cycles / rte_get_timer_hz() ||
+	    skipped == 0) {
+		printf("rate: sampled %" PRIu64 " skipped %" PRIu64 "\n",
+		       sampled, skipped);
+		return -1;
+	}
+	printf("pdump zero-copy rate sampling success\n");
+
+	return 0;
+}
+
 int
 test_pdump_init(void)
 {
@@ -52,6 +274,11 @@ run_pdump_client_tests(void)
 	struct rte_mempool *mp = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	char poolname[] = "mbuf_pool_client";
+	const struct rte_pdump_sampling sampling = {
+		.period = 4,
+		.burst = 32,
+		.rate = 1000,
+	};
 
 	ret = test_get_mempool(&mp, poolname);
 	if (ret < 0)
@@ -111,6 +338,28 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+
+	printf("\n***** flags = RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_ZEROCOPY *****\n");
+
+	flags = RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_ZEROCOPY;
+	ret = rte_pdump_enable_sampling(portid, QUEUE_ID, flags, 0,
+					ring_client, mp, NULL, &sampling);
+	if (ret < 0) {
+		printf("rte_pdump_enable_sampling failed\n");
+		return -1;
+	}
+	printf("pdump_enable_sampling success\n");
+
+	ret = rte_pdump_disable(portid, QUEUE_ID, flags);
+	if (ret < 0) {
+		printf("rte_pdump_disable failed\n");
+		return -1;
+	}
+	printf("pdump_disable success\n");
+
+	printf("\n***** zero-copy capture and sampling *****\n");
+	ret = run_zc_client_tests(ring_client, mp);
+
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
@@ -147,6 +396,8 @@ send_pkts(void *empty __rte_unused)
 	ret = test_get_mbuf_from_pool(&mp, pbuf, poolname);
 	if (ret < 0)
 		printf("get_mbuf_from_pool failed\n");
+	else if (fill_pkts(pbuf) < 0)
+		printf("fill_pkts failed\n");
 
 	ret = test_dev_start(portid, mp);
 	if (ret < 0)
@@ -207,7 +458,8 @@ test_pdump(void)
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		printf("IN PRIMARY PROCESS\n");
 		ret = run_pdump_server_tests();
-		if (ret < 0)
+		/* includes the exit status of the secondary process */
+		if (ret != 0)
 			return TEST_FAILED;
 	} else if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
 		printf("IN SECONDARY PROCESS\n");
@@ -7,9 +7,11 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <rte_ring.h>
+#include <rte_soring.h>
 #include <rte_cycles.h>
 #include <rte_launch.h>
 #include <rte_pause.h>
+#include <rte_stdatomic.h>
 #include <string.h>
 
 #include "test.h"
@@ -24,6 +26,9 @@
 #define RING_SIZE 4096
 #define MAX_BURST 32
 
+/* number of pipeline stages for the staged-ordered ring tests */
+#define SORING_STAGES 3
+
 /*
  * the sizes to enqueue and dequeue in testing
  * (marked volatile so they won't be seen as compile-time constants)
@@ -566,6 +571,227 @@ test_ring_perf_esize(const int esize)
 	return -1;
 }
 
+/*
+ * Test function that measures how long it takes to pass a bulk of objects
+ * through a pipeline of SORING_STAGES stages on a single lcore, with one
+ * ring per hop and with a single staged-ordered ring.
+ */
+static int
+test_soring_pipeline(struct rte_soring *sor)
+{
+	const unsigned int iter_shift = 21;
+	const unsigned int iterations = 1 << iter_shift;
+	struct rte_ring *rings[SORING_STAGES + 1] = { NULL };
+	struct rte_ring_zc_data zcd;
+	void *burst[MAX_BURST];
+	unsigned int sz, i, s, n;
+	uint32_t ftoken;
+	char name[RTE_RING_NAMESIZE];
+	int ret = -1;
+
+	for (s = 0; s != RTE_DIM(rings); s++) {
+		snprintf(name, sizeof(name), "%s_%u", RING_NAME, s);
+		rings[s] = rte_ring_create(name, RING_SIZE, rte_socket_id(),
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (rings[s] == NULL)
+			goto exit;
+	}
+	memset(burst, 0, sizeof(burst));
+
+	for (sz = 0; sz < RTE_DIM(bulk_sizes); sz++) {
+		n = bulk_sizes[sz];
+
+		uint64_t start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_ring_enqueue_bulk(rings[0], burst, n, NULL);
+			for (s = 0; s != SORING_STAGES; s++) {
+				rte_ring_dequeue_bulk(rings[s], burst, n, NULL);
+				rte_ring_enqueue_bulk(rings[s + 1], burst, n,
+						NULL);
+			}
+			rte_ring_dequeue_bulk(rings[s], burst, n, NULL);
+		}
+		uint64_t end = rte_rdtsc();
+
+		printf("%u-stage ring chain bulk enq/deq (size: %u): %.2F\n",
+			SORING_STAGES, n,
+			((double)(end - start)) / iterations);
+
+		start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			rte_soring_enqueue_bulk(sor, burst, n, NULL);
+			for (s = 0; s != SORING_STAGES; s++) {
+				rte_soring_acquire_zc_bulk(sor, s, n, &zcd,
+						&ftoken, NULL);
+				rte_soring_release(sor, NULL, s, n, ftoken);
+			}
+			rte_soring_dequeue_bulk(sor, burst, n, NULL);
+		}
+		end = rte_rdtsc();
+
+		printf("%u-stage soring bulk enq/deq (size: %u): %.2F\n",
+			SORING_STAGES, n,
+			((double)(end - start)) / iterations);
+	}
+	ret = 0;
+
+exit:
+	for (s = 0; s != RTE_DIM(rings); s++)
+		rte_ring_free(rings[s]);
+
+	return ret;
+}
+
+static RTE_ATOMIC(uint32_t) soring_stop;
+
+struct soring_stage_params {
+	struct rte_soring *r;
+	uint32_t stage;
+};
+
+/* Worker of a pipeline stage, processes objects in place until stopped. */
+static int
+soring_stage_fn(void *p)
+{
+	struct soring_stage_params *params = p;
+	struct rte_ring_zc_data zcd;
+	uint32_t ftoken, n;
+
+	while (rte_atomic_load_explicit(&soring_stop,
+			rte_memory_order_relaxed) == 0) {
+		n = rte_soring_acquire_zc_burst(params->r, params->stage,
+				MAX_BURST, &zcd, &ftoken, NULL);
+		if (n == 0) {
+			rte_pause();
+			continue;
+		}
+		rte_soring_release(params->r, NULL, params->stage, n, ftoken);
+	}
+
+	return 0;
+}
+
+/*
+ * Run the stages of a staged-ordered ring on all the worker lcores, while
+ * the main lcore enqueues and dequeues objects, and check the objects
+ * leave the ring in order.
+ */
+static int
+run_soring_on_all_cores(struct rte_soring *r)
+{
+	static struct soring_stage_params params[RTE_MAX_LCORE];
+	uintptr_t burst[MAX_BURST];
+	uint64_t begin, hz, total;
+	uintptr_t enq_seq, deq_seq;
+	unsigned int i, c, stage, n;
+
+	if (rte_lcore_count() <= SORING_STAGES) {
+		printf("Not enough lcores, skipping\n");
+		return 0;
+	}
+
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
+		rte_atomic_store_explicit(&soring_stop, 0, rte_memory_order_relaxed);
+		stage = 0;
+		RTE_LCORE_FOREACH_WORKER(c) {
+			params[c].r = r;
+			params[c].stage = stage;
+			stage = (stage + 1) % SORING_STAGES;
+			if (rte_eal_remote_launch(soring_stage_fn, &params[c],
+					c) < 0)
+				return -1;
+		}
+
+		total = 0;
+		enq_seq = 0;
+		deq_seq = 0;
+		hz = rte_get_timer_hz();
+		begin = rte_get_timer_cycles();
+		while (rte_get_timer_cycles() - begin < hz * TIME_MS / 1000) {
+			for (n = 0; n != bulk_sizes[i]; n++)
+				burst[n] = enq_seq + n;
+			n = rte_soring_enqueue_burst(r, burst, bulk_sizes[i],
+					NULL);
+			enq_seq += n;
+
+			n = rte_soring_dequeue_burst(r, burst, bulk_sizes[i],
+					NULL);
+			for (c = 0; c != n; c++) {
+				if (burst[c] != deq_seq++) {
+					printf("Object out of order\n");
+					rte_atomic_store_explicit(&soring_stop, 1,
+						rte_memory_order_relaxed);
+					rte_eal_mp_wait_lcore();
+					return -1;
+				}
+			}
+			total += n;
+		}
+
+		rte_atomic_store_explicit(&soring_stop, 1, rte_memory_order_relaxed);
+		rte_eal_mp_wait_lcore();
+
+		/* drain the objects left in the pipeline */
+		while (rte_soring_count(r) != 0) {
+			for (stage = 0; stage != SORING_STAGES; stage++) {
+				struct rte_ring_zc_data zcd;
+				uint32_t ftoken;
+
+				n = rte_soring_acquire_zc_burst(r, stage,
+						MAX_BURST, &zcd, &ftoken, NULL);
+				if (n != 0)
+					rte_soring_release(r, NULL, stage, n,
+							ftoken);
+			}
+			rte_soring_dequeue_burst(r, burst, MAX_BURST, NULL);
+		}
+
+		printf("Total count (size: %u): %"PRIu64"\n",
+				bulk_sizes[i], total);
+	}
+
+	return 0;
+}
+
+/* Run the staged-ordered ring tests */
+static int
+test_soring_perf(void)
+{
+	struct rte_soring_param prm = {
+		.name = RING_NAME,
+		.elems = RING_SIZE,
+		.elem_size = sizeof(void *),
+		.stages = SORING_STAGES,
+		.prod_synt = RTE_RING_SYNC_ST,
+		.cons_synt = RTE_RING_SYNC_ST,
+	};
+	struct rte_soring *r;
+	ssize_t sz;
+	int ret = -1;
+
+	sz = rte_soring_get_memsize(&prm);
+	if (sz < 0)
+		return -1;
+	r = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (r == NULL)
+		return -1;
+	if (rte_soring_init(r, &prm) != 0)
+		goto exit;
+
+	printf("\n### Testing staged-ordered ring pipeline ###\n");
+	if (test_soring_pipeline(r) < 0)
+		goto exit;
+
+	printf("\n### Testing staged-ordered ring on all worker nodes ###\n");
+	if (run_soring_on_all_cores(r) < 0)
+		goto exit;
+	ret = 0;
+
+exit:
+	rte_free(r);
+	return ret;
+}
+
 static int
 test_ring_perf(void)
 {
@@ -576,6 +802,9 @@ test_ring_perf(void)
 	if (test_ring_perf_esize(16) == -1)
 		return -1;
 
+	if (test_soring_perf() == -1)
+		return -1;
+
 	return 0;
 }
 
@@ -8,6 +8,7 @@
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
 #include <rte_cycles.h>
+#include <rte_stdatomic.h>
 
 #include <rte_service.h>
 #include <rte_service_component.h>
@@ -334,9 +335,23 @@ service_attr_get(void)
 	TEST_ASSERT_EQUAL(1, (attr_value > 0),
 			"attr_get() call didn't get call count (zero)");
 
+	/* the service was run more than once, each run lasting SERVICE_DELAY */
+	const int attr_delay_max = RTE_SERVICE_ATTR_RUN_DELAY_MAX;
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, attr_delay_max,
+						  &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(1, (attr_value > 0),
+			"attr_get() call didn't get max run delay (zero)");
+
 	TEST_ASSERT_EQUAL(0, rte_service_attr_reset_all(id),
 			"Valid attr_reset_all() return success");
 
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, attr_delay_max,
+						  &attr_value),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(0, attr_value,
+			"attr_get() call didn't reset max run delay (zero)");
+
 	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id, attr_id, &attr_value),
 			"Valid attr_get() call didn't return success");
 	TEST_ASSERT_EQUAL(0, attr_value,
@@ -617,7 +632,7 @@ service_lcore_add_del(void)
 }
 
 static int
-service_threaded_test(int mt_safe)
+service_threaded_test(int mt_safe, int dynamic)
 {
 	unregister_all();
 
@@ -663,6 +678,12 @@ service_threaded_test(int mt_safe)
 			"Failed to enable lcore 1 on mt safe service");
 	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(sid, slcore_2, 1),
 			"Failed to enable lcore 2 on mt safe service");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_1, dynamic),
+			"Failed to set dynamic scheduling of lcore 1");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_2, dynamic),
+			"Failed to set dynamic scheduling of lcore 2");
+	TEST_ASSERT_EQUAL(dynamic, rte_service_lcore_dynamic_get(slcore_1),
+			"Dynamic scheduling of lcore 1 not set");
 	rte_service_lcore_start(slcore_1);
 	rte_service_lcore_start(slcore_2);
 
@@ -687,6 +708,8 @@ service_threaded_test(int mt_safe)
 
 	rte_service_lcore_start(slcore_1);
 	rte_service_lcore_start(slcore_2);
+	TEST_ASSERT_EQUAL(-EBUSY, rte_service_lcore_dynamic_set(slcore_1, 0),
+			"Dynamic scheduling of a running lcore changed");
 
 	/* wait for the worker threads to run */
 	rte_delay_ms(500);
@@ -718,7 +741,7 @@ service_mt_safe_poll(void)
 	    !rte_lcore_is_enabled(2))
 		return TEST_SKIPPED;
 
-	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe),
+	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe, 0),
 			"Error: MT Safe service not run by two cores concurrently");
 	return TEST_SUCCESS;
 }
@@ -735,11 +758,346 @@ service_mt_unsafe_poll(void)
 	    !rte_lcore_is_enabled(2))
 		return TEST_SKIPPED;
 
-	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe),
+	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe, 0),
 			"Error: NON MT Safe service run by two cores concurrently");
 	return TEST_SUCCESS;
 }
 
+/* tests an MT SAFE service with two dynamic cores, which run it concurrently
+ * as it is the only service in their run queue.
+ */
+static int
+service_mt_safe_poll_dynamic(void)
+{
+	int mt_safe = 1;
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe, 1),
+			"Error: MT Safe service not run by two dynamic cores concurrently");
+	return TEST_SUCCESS;
+}
+
+/* tests a NON mt safe service with two dynamic cores, the service is claimed
+ * by the dynamic core running it.
+ */
+static int
+service_mt_unsafe_poll_dynamic(void)
+{
+	int mt_safe = 0;
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	TEST_ASSERT_EQUAL(1, service_threaded_test(mt_safe, 1),
+			"Error: NON MT Safe service run by two dynamic cores concurrently");
+	return TEST_SUCCESS;
+}
+
+/* idle while params[0] is set, counting the calls in params[1] */
+static int32_t
+dynamic_idle_cb(void *args)
+{
+	RTE_ATOMIC(uint64_t) *params = args;
+
+	rte_atomic_fetch_add_explicit(&params[1], 1, rte_memory_order_relaxed);
+	return rte_atomic_load_explicit(&params[0], rte_memory_order_relaxed) ?
+		-EAGAIN : 0;
+}
+
+/* tests that a dynamic core backs off polling an idle service, and polls it
+ * at every loop again once it does work.
+ */
+static int
+service_dynamic_idle_backoff(void)
+{
+	RTE_ATOMIC(uint64_t) params[2] = { 1, 0 };
+	uint64_t loops, loops_end, calls, idle_calls;
+	uint32_t id;
+	int i;
+
+	unregister_all();
+
+	struct rte_service_spec service;
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = dynamic_idle_cb;
+	service.callback_userdata = params;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Starting valid service failed");
+	rte_service_set_stats_enable(id, 1);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_id, 1),
+			"Failed to set dynamic scheduling of lcore");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_reset_all(slcore_id),
+			"Failed to reset lcore attributes");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+
+	/* the idle service is not polled at every loop */
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			RTE_SERVICE_LCORE_ATTR_LOOPS, &loops),
+			"Valid lcore_attr_get() call didn't return success");
+	calls = rte_atomic_load_explicit(&params[1], rte_memory_order_relaxed);
+	TEST_ASSERT(calls > 0, "Idle service not polled");
+	TEST_ASSERT(calls * 4 < loops,
+			"Idle service polled %"PRIu64" times in %"PRIu64" loops",
+			calls, loops);
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(id,
+			RTE_SERVICE_ATTR_IDLE_CALL_COUNT, &idle_calls),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT(idle_calls > 0, "Idle calls not counted");
+
+	/* a call doing work resets the backoff, once the last idle call backoff
+	 * is over; the call in flight may still be idle.
+	 */
+	calls = rte_atomic_load_explicit(&params[1], rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&params[0], 0, rte_memory_order_relaxed);
+	for (i = 0; rte_atomic_load_explicit(&params[1],
+			rte_memory_order_relaxed) < calls + 2 && i < TIMEOUT_MS;
+			i++)
+		rte_delay_ms(1);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			RTE_SERVICE_LCORE_ATTR_LOOPS, &loops),
+			"Valid lcore_attr_get() call didn't return success");
+	calls = rte_atomic_load_explicit(&params[1], rte_memory_order_relaxed);
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_get(slcore_id,
+			RTE_SERVICE_LCORE_ATTR_LOOPS, &loops_end),
+			"Valid lcore_attr_get() call didn't return success");
+	loops = loops_end - loops;
+	calls = rte_atomic_load_explicit(&params[1], rte_memory_order_relaxed) - calls;
+	TEST_ASSERT(calls * 2 > loops,
+			"Busy service polled %"PRIu64" times in %"PRIu64" loops",
+			calls, loops);
+
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 0),
+			"Error: Service stop returned non-zero");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	return unregister_all();
+}
+
+#define DYNAMIC_SERVICES 2
+
+struct dynamic_service_params {
+	RTE_ATOMIC(uint32_t) lock;
+	uint32_t pass_test;
+	RTE_ATOMIC(uint64_t) calls[RTE_MAX_LCORE];
+};
+
+/* MT unsafe service counting its calls per lcore */
+static int32_t
+dynamic_count_cb(void *args)
+{
+	struct dynamic_service_params *params = args;
+	uint32_t exp = 0;
+
+	if (!rte_atomic_compare_exchange_strong_explicit(&params->lock, &exp, 1,
+			rte_memory_order_relaxed, rte_memory_order_relaxed)) {
+		params->pass_test = 0;
+		return 0;
+	}
+
+	rte_atomic_fetch_add_explicit(&params->calls[rte_lcore_id()], 1,
+			rte_memory_order_relaxed);
+	rte_delay_us(10);
+	rte_atomic_store_explicit(&params->lock, 0, rte_memory_order_relaxed);
+
+	return 0;
+}
+
+/* tests the services of the run queue shared by dynamic cores keep running,
+ * serialized, as dynamic cores are started and stopped.
+ */
+static int
+service_dynamic_scaling(void)
+{
+	struct dynamic_service_params params[DYNAMIC_SERVICES];
+	uint64_t calls[DYNAMIC_SERVICES];
+	struct rte_service_spec service;
+	uint32_t slcore_1, slcore_2;
+	uint32_t ids[DYNAMIC_SERVICES];
+	uint64_t calls_2 = 0;
+	unsigned int i;
+	int ms;
+
+	if (!rte_lcore_is_enabled(0) || !rte_lcore_is_enabled(1) ||
+	    !rte_lcore_is_enabled(2))
+		return TEST_SKIPPED;
+
+	unregister_all();
+
+	slcore_1 = rte_get_next_lcore(/* start core */ -1,
+				      /* skip main */ 1,
+				      /* wrap */ 0);
+	slcore_2 = rte_get_next_lcore(/* start core */ slcore_1,
+				      /* skip main */ 1,
+				      /* wrap */ 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_1),
+			"lcore 1 add fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_2),
+			"lcore 2 add fail");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_1, 1),
+			"Failed to set dynamic scheduling of lcore 1");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_2, 1),
+			"Failed to set dynamic scheduling of lcore 2");
+
+	memset(params, 0, sizeof(params));
+	for (i = 0; i < DYNAMIC_SERVICES; i++) {
+		params[i].pass_test = 1;
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		service.callback = dynamic_count_cb;
+		service.callback_userdata = &params[i];
+		snprintf(service.name, sizeof(service.name), "dynamic_%u", i);
+		TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+				&ids[i]), "Register of service %u failed", i);
+		rte_service_component_runstate_set(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 1),
+				"Starting service %u failed", i);
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i], slcore_1, 1),
+				"Failed to map service %u to lcore 1", i);
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i], slcore_2, 1),
+				"Failed to map service %u to lcore 2", i);
+	}
+
+	/* a single dynamic core runs all the services */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_1),
+			"Starting lcore 1 failed");
+	rte_delay_ms(100);
+	for (i = 0; i < DYNAMIC_SERVICES; i++)
+		TEST_ASSERT(rte_atomic_load_explicit(&params[i].calls[slcore_1],
+				rte_memory_order_relaxed) > 0,
+				"Service %u not run by lcore 1", i);
+
+	/* a second dynamic core shares the services */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_2),
+			"Starting lcore 2 failed");
+	for (ms = 0; ms < TIMEOUT_MS; ms++) {
+		calls_2 = 0;
+		for (i = 0; i < DYNAMIC_SERVICES; i++)
+			calls_2 += rte_atomic_load_explicit(&params[i].calls[slcore_2],
+					rte_memory_order_relaxed);
+		if (calls_2 > 0)
+			break;
+		rte_delay_ms(1);
+	}
+	TEST_ASSERT(calls_2 > 0, "No service run by lcore 2");
+
+	/* the remaining dynamic core takes the services over */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_1),
+			"Stopping lcore 1 failed");
+	rte_eal_wait_lcore(slcore_1);
+	for (i = 0; i < DYNAMIC_SERVICES; i++)
+		calls[i] = rte_atomic_load_explicit(&params[i].calls[slcore_2],
+				rte_memory_order_relaxed);
+	rte_delay_ms(100);
+	for (i = 0; i < DYNAMIC_SERVICES; i++)
+		TEST_ASSERT(rte_atomic_load_explicit(&params[i].calls[slcore_2],
+				rte_memory_order_relaxed) > calls[i],
+				"Service %u not run by lcore 2 alone", i);
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_2),
+			"Stopping lcore 2 failed");
+	rte_eal_wait_lcore(slcore_2);
+
+	for (i = 0; i < DYNAMIC_SERVICES; i++)
+		TEST_ASSERT_EQUAL(1, params[i].pass_test,
+				"Service %u run by two dynamic cores concurrently", i);
+
+	return unregister_all();
+}
+
+struct dynamic_cost_params {
+	uint32_t delay_us;
+	RTE_ATOMIC(uint64_t) calls;
+};
+
+/* service doing work for a fixed time at each call */
+static int32_t
+dynamic_cost_cb(void *args)
+{
+	struct dynamic_cost_params *params = args;
+
+	rte_atomic_fetch_add_explicit(&params->calls, 1,
+			rte_memory_order_relaxed);
+	rte_delay_us(params->delay_us);
+
+	return 0;
+}
+
+/* tests that a dynamic core runs the services at a rate inverse to the cycles
+ * of their calls, rather than in turn.
+ */
+static int
+service_dynamic_cycles_weight(void)
+{
+	struct dynamic_cost_params params[2] = {
+		{ .delay_us = 100 }, { .delay_us = 10 },
+	};
+	struct rte_service_spec service;
+	uint64_t cheap_calls, costly_calls;
+	uint32_t ids[2];
+	unsigned int i;
+
+	unregister_all();
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_dynamic_set(slcore_id, 1),
+			"Failed to set dynamic scheduling of lcore");
+
+	for (i = 0; i < RTE_DIM(params); i++) {
+		memset(&service, 0, sizeof(struct rte_service_spec));
+		service.callback = dynamic_cost_cb;
+		service.callback_userdata = &params[i];
+		snprintf(service.name, sizeof(service.name), "dynamic_cost_%u", i);
+		TEST_ASSERT_EQUAL(0, rte_service_component_register(&service,
+				&ids[i]), "Register of service %u failed", i);
+		rte_service_component_runstate_set(ids[i], 1);
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 1),
+				"Starting service %u failed", i);
+		TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(ids[i],
+				slcore_id, 1),
+				"Failed to map service %u to lcore", i);
+	}
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(200);
+	for (i = 0; i < RTE_DIM(params); i++)
+		TEST_ASSERT_EQUAL(0, rte_service_runstate_set(ids[i], 0),
+				"Stopping service %u failed", i);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+
+	/* run in turn, both services would get the same number of calls */
+	costly_calls = rte_atomic_load_explicit(&params[0].calls,
+			rte_memory_order_relaxed);
+	cheap_calls = rte_atomic_load_explicit(&params[1].calls,
+			rte_memory_order_relaxed);
+	TEST_ASSERT(costly_calls > 0, "Costly service not run");
+	TEST_ASSERT(cheap_calls > 3 * costly_calls,
+			"Cheap service run %"PRIu64" times, costly one %"PRIu64" times",
+			cheap_calls, costly_calls);
+
+	return unregister_all();
+}
+
 static int32_t
 delay_as_a_mt_safe_service(void *args)
 {
@@ -1028,6 +1386,11 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_lcore_en_dis_able),
 		TEST_CASE_ST(dummy_register, NULL, service_mt_unsafe_poll),
 		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_poll),
+		TEST_CASE_ST(dummy_register, NULL, service_mt_unsafe_poll_dynamic),
+		TEST_CASE_ST(dummy_register, NULL, service_mt_safe_poll_dynamic),
+		TEST_CASE_ST(dummy_register, NULL, service_dynamic_idle_backoff),
+		TEST_CASE_ST(dummy_register, NULL, service_dynamic_scaling),
+		TEST_CASE_ST(dummy_register, NULL, service_dynamic_cycles_weight),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
 		TEST_CASES_END() /**< NULL terminate unit test array */
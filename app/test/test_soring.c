@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_soring.h>
+
+#include "test.h"
+
+/*
+ * Staged-ordered ring functional tests.
+ * Performance tests are in test_ring_perf.c
+ */
+
+#define SORING_ELEMS	1000
+#define SORING_STAGES	2
+
+static struct rte_soring *
+soring_create(uint32_t elems, uint32_t stages)
+{
+	struct rte_soring_param prm = {
+		.name = "test_soring",
+		.elems = elems,
+		.elem_size = sizeof(uint32_t),
+		.stages = stages,
+		.prod_synt = RTE_RING_SYNC_MT,
+		.cons_synt = RTE_RING_SYNC_MT,
+	};
+	struct rte_soring *r;
+	ssize_t sz;
+
+	sz = rte_soring_get_memsize(&prm);
+	if (sz < 0)
+		return NULL;
+	r = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (r != NULL && rte_soring_init(r, &prm) != 0) {
+		rte_free(r);
+		r = NULL;
+	}
+	return r;
+}
+
+static int
+test_soring_param(void)
+{
+	struct rte_soring_param prm = {
+		.name = "test_soring",
+		.elems = SORING_ELEMS,
+		.elem_size = sizeof(uint32_t),
+		.stages = SORING_STAGES,
+		.prod_synt = RTE_RING_SYNC_MT,
+		.cons_synt = RTE_RING_SYNC_ST,
+	};
+	struct rte_soring_param bad;
+
+	TEST_ASSERT(rte_soring_get_memsize(&prm) > 0,
+		"valid parameters rejected");
+
+	bad = prm;
+	bad.elem_size = 6;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"element size not multiple of 4 accepted");
+
+	bad = prm;
+	bad.elems = 0;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"zero elements accepted");
+
+	bad = prm;
+	bad.elems = RTE_SORING_ELEM_MAX + 1;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"too many elements accepted");
+
+	bad = prm;
+	bad.stages = 0;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"zero stages accepted");
+
+	bad = prm;
+	bad.stages = RTE_SORING_STAGE_MAX + 1;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"too many stages accepted");
+
+	bad = prm;
+	bad.prod_synt = RTE_RING_SYNC_MT_HTS;
+	TEST_ASSERT_EQUAL(rte_soring_get_memsize(&bad), -EINVAL,
+		"unsupported sync type accepted");
+
+	return TEST_SUCCESS;
+}
+
+/* Check elements pass through the stages in order, and are full/empty. */
+static int
+test_soring_stages(void)
+{
+	struct rte_soring *r;
+	uint32_t objs[SORING_ELEMS + 1];
+	uint32_t buf[SORING_ELEMS];
+	uint32_t ft1, ft2, i, n;
+
+	r = soring_create(SORING_ELEMS, SORING_STAGES);
+	TEST_ASSERT_NOT_NULL(r, "cannot create soring");
+
+	for (i = 0; i != RTE_DIM(objs); i++)
+		objs[i] = i;
+
+	TEST_ASSERT_EQUAL(rte_soring_enqueue_bulk(r, objs, SORING_ELEMS + 1,
+		NULL), 0, "bulk enqueue over capacity succeeded");
+	TEST_ASSERT_EQUAL(rte_soring_enqueue_burst(r, objs, SORING_ELEMS + 1,
+		NULL), SORING_ELEMS, "burst enqueue not limited to capacity");
+	TEST_ASSERT_EQUAL(rte_soring_free_count(r), 0, "ring not full");
+
+	/* nothing is ready for the consumer or the second stage yet */
+	TEST_ASSERT_EQUAL(rte_soring_dequeue_burst(r, buf, 1, NULL), 0,
+		"dequeue before the stages succeeded");
+	TEST_ASSERT_EQUAL(rte_soring_acquire_burst(r, buf, 1, 1, &ft1, NULL),
+		0, "stage 1 acquire before stage 0 succeeded");
+
+	/* acquire two groups and release them out of order */
+	TEST_ASSERT_EQUAL(rte_soring_acquire_bulk(r, buf, 0, 10, &ft1, NULL),
+		10, "stage 0 acquire failed");
+	TEST_ASSERT_EQUAL(rte_soring_acquire_bulk(r, buf + 10, 0, 20, &ft2,
+		NULL), 20, "stage 0 acquire failed");
+	for (i = 0; i != 30; i++)
+		buf[i] += SORING_ELEMS;
+
+	rte_soring_release(r, buf + 10, 0, 20, ft2);
+	TEST_ASSERT_EQUAL(rte_soring_acquire_burst(r, buf, 1, 1, &ft1, NULL),
+		0, "stage 1 acquired elements released out of order");
+	rte_soring_release(r, buf, 0, 10, ft1);
+
+	/* the second stage sees both groups, in order, in place */
+	for (n = 0; n != 30; n += i) {
+		struct rte_ring_zc_data zcd;
+		uint32_t *p;
+
+		i = rte_soring_acquire_zc_burst(r, 1, 30, &zcd, &ft1, NULL);
+		TEST_ASSERT(i != 0, "stage 1 acquire failed");
+		TEST_ASSERT_EQUAL(zcd.n1, i, "unexpected wrap");
+		for (p = zcd.ptr1; p != (uint32_t *)zcd.ptr1 + i; p++)
+			TEST_ASSERT_EQUAL(*p, SORING_ELEMS + n + (p -
+				(uint32_t *)zcd.ptr1), "element out of order");
+		rte_soring_release(r, NULL, 1, i, ft1);
+	}
+
+	TEST_ASSERT_EQUAL(rte_soring_dequeue_bulk(r, buf, 30, NULL), 30,
+		"dequeue failed");
+	for (i = 0; i != 30; i++)
+		TEST_ASSERT_EQUAL(buf[i], SORING_ELEMS + i,
+			"dequeued element out of order");
+	TEST_ASSERT_EQUAL(rte_soring_free_count(r), 30,
+		"unexpected free count");
+
+	/* pass the remaining elements through */
+	for (i = 0; i != SORING_STAGES; i++) {
+		n = rte_soring_acquire_burst(r, NULL, i, SORING_ELEMS, &ft1,
+			NULL);
+		TEST_ASSERT_EQUAL(n, SORING_ELEMS - 30,
+			"acquire of all elements failed");
+		rte_soring_release(r, NULL, i, n, ft1);
+	}
+	TEST_ASSERT_EQUAL(rte_soring_dequeue_burst(r, buf, SORING_ELEMS,
+		NULL), SORING_ELEMS - 30, "dequeue failed");
+	for (i = 0; i != SORING_ELEMS - 30; i++)
+		TEST_ASSERT_EQUAL(buf[i], 30 + i,
+			"dequeued element out of order");
+
+	/* elements wrap around the end of the ring storage */
+	TEST_ASSERT_EQUAL(rte_soring_enqueue_bulk(r, objs, 30, NULL), 30,
+		"enqueue failed");
+	for (i = 0; i != SORING_STAGES; i++) {
+		struct rte_ring_zc_data zcd;
+
+		n = rte_soring_acquire_zc_bulk(r, i, 30, &zcd, &ft1, NULL);
+		TEST_ASSERT_EQUAL(n, 30, "acquire of wrapped elements failed");
+		TEST_ASSERT(zcd.n1 < n && zcd.ptr2 != NULL,
+			"elements do not wrap");
+		rte_soring_release(r, NULL, i, n, ft1);
+	}
+	TEST_ASSERT_EQUAL(rte_soring_dequeue_bulk(r, buf, 30, NULL), 30,
+		"dequeue failed");
+	for (i = 0; i != 30; i++)
+		TEST_ASSERT_EQUAL(buf[i], i, "dequeued element out of order");
+	TEST_ASSERT_EQUAL(rte_soring_count(r), 0, "ring not empty");
+
+	rte_soring_dump(stdout, r);
+	rte_free(r);
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite soring_test_suite = {
+	.suite_name = "soring autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_soring_param),
+		TEST_CASE(test_soring_stages),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_soring(void)
+{
+	return unit_test_suite_runner(&soring_test_suite);
+}
+
+REGISTER_FAST_TEST(soring_autotest, true, true, test_soring);
@@ -83,6 +83,23 @@
  *      - At initialization, timer3 is loaded by the main core, on
  *        another core in "periodical" mode (time = 1 second).
  *      - It is stopped at t=25s by timer2.
+ *
+ * #. Timer wheel tests.
+ *
+ *    These tests check the timer wheel backend of a timer data instance
+ *    allocated with rte_timer_data_alloc_wheel(), with a tick of one timer
+ *    cycle, on the main lcore only.
+ *
+ *    - Expiry order: timers armed close to each other, some with the same
+ *      expiry time, must never run before their expiry time, and must run
+ *      in the order of their expiry time.
+ *    - Levels: timers armed on each wheel level reachable within half a
+ *      second, and on both sides of the level boundaries, must run exactly
+ *      once, in order, after being cascaded down to level 0.
+ *    - Reset and stop: stopped timers must never run, reset timers must run
+ *      once at their new expiry time only, a periodic timer stopped from its
+ *      callback must run the expected number of times, and
+ *      rte_timer_stop_all() must stop every timer left in the wheel.
  */
 
 #include <stdio.h>
@@ -595,3 +612,302 @@ test_timer(void)
 }
 
 REGISTER_FAST_TEST(timer_autotest, false, true, test_timer);
+
+#define WHEEL_NB_TIMERS 256
+#define WHEEL_LVL_BITS 8 /* bits of the tick covered by a wheel level */
+#define WHEEL_NB_LVL 5 /* wheel levels and the overflow list */
+#define WHEEL_PERIOD 1000
+#define WHEEL_PERIODIC_RUNS 5
+
+static struct rte_timer wheel_tims[WHEEL_NB_TIMERS];
+static unsigned int wheel_runs[WHEEL_NB_TIMERS];
+static uint32_t wheel_id;
+static uint64_t wheel_last_expire;
+static int wheel_failed;
+
+/* callback for the wheel tests, checking the expiry time and order */
+static void
+timer_wheel_cb(struct rte_timer *tim)
+{
+	uint64_t cur_time = rte_get_timer_cycles();
+	unsigned int idx = tim - wheel_tims;
+
+	wheel_runs[idx]++;
+
+	if (cur_time < tim->expire) {
+		printf("Timer %u run at %"PRIu64", before its expiry at %"PRIu64"\n",
+		       idx, cur_time, tim->expire);
+		wheel_failed = 1;
+	}
+
+	/* a late periodic timer is reloaded in the past, skip it */
+	if (tim->period != 0) {
+		if (wheel_runs[idx] == WHEEL_PERIODIC_RUNS)
+			rte_timer_alt_stop(wheel_id, tim);
+		return;
+	}
+
+	if (tim->expire < wheel_last_expire) {
+		printf("Timer %u expiring at %"PRIu64" run after a timer expiring at %"PRIu64"\n",
+		       idx, tim->expire, wheel_last_expire);
+		wheel_failed = 1;
+	}
+	wheel_last_expire = tim->expire;
+}
+
+/* pick a delay in timer cycles, handled by the given wheel level */
+static uint64_t
+timer_wheel_delay(unsigned int lvl, uint64_t max_delay)
+{
+	uint64_t lo = (lvl == 0) ? 1 : RTE_BIT64(lvl * WHEEL_LVL_BITS);
+	uint64_t hi = RTE_MIN(RTE_BIT64((lvl + 1) * WHEEL_LVL_BITS), max_delay);
+
+	return lo + rte_rand_max(hi - lo);
+}
+
+/* number of wheel levels reachable with delays up to max_delay */
+static unsigned int
+timer_wheel_nb_lvl(uint64_t max_delay)
+{
+	unsigned int lvl;
+
+	for (lvl = 1; lvl != WHEEL_NB_LVL; lvl++)
+		if (RTE_BIT64(lvl * WHEEL_LVL_BITS) >= max_delay)
+			break;
+
+	return lvl;
+}
+
+static int
+timer_wheel_setup(void)
+{
+	unsigned int i;
+
+	if (rte_timer_data_alloc_wheel(&wheel_id, 1) != 0) {
+		printf("Cannot allocate timer wheel\n");
+		return -1;
+	}
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++)
+		rte_timer_init(&wheel_tims[i]);
+	memset(wheel_runs, 0, sizeof(wheel_runs));
+	wheel_last_expire = 0;
+	wheel_failed = 0;
+
+	return 0;
+}
+
+static int
+timer_wheel_arm(unsigned int idx, uint64_t ticks, enum rte_timer_type type)
+{
+	if (rte_timer_alt_reset(wheel_id, &wheel_tims[idx], ticks, type,
+				rte_lcore_id(), NULL, NULL) != 0) {
+		printf("Cannot arm timer %u\n", idx);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Manage the wheel until the deadline, then check that each timer ran the
+ * expected number of times and that none is left pending.
+ */
+static int
+timer_wheel_run(uint64_t deadline, const unsigned int *expected_runs)
+{
+	unsigned int i;
+	int ret = 0;
+
+	while (rte_get_timer_cycles() < deadline)
+		rte_timer_alt_manage(wheel_id, NULL, 0, timer_wheel_cb);
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		if (wheel_runs[i] != expected_runs[i]) {
+			printf("Timer %u run %u times instead of %u\n",
+			       i, wheel_runs[i], expected_runs[i]);
+			ret = -1;
+		}
+		if (rte_timer_pending(&wheel_tims[i])) {
+			printf("Timer %u still pending\n", i);
+			rte_timer_alt_stop(wheel_id, &wheel_tims[i]);
+			ret = -1;
+		}
+	}
+
+	rte_timer_data_dealloc(wheel_id);
+
+	return (ret != 0 || wheel_failed) ? -1 : 0;
+}
+
+static int
+test_timer_wheel_order(void)
+{
+	unsigned int expected_runs[WHEEL_NB_TIMERS];
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int i;
+
+	if (timer_wheel_setup() < 0)
+		return -1;
+
+	/* a few level 0 and level 1 slots, with several timers each */
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		expected_runs[i] = 1;
+		if (timer_wheel_arm(i, 1 + rte_rand_max(WHEEL_NB_TIMERS * 4),
+				    SINGLE) < 0)
+			expected_runs[i] = 0;
+	}
+
+	return timer_wheel_run(rte_get_timer_cycles() + hz / 100,
+			       expected_runs);
+}
+
+static int
+test_timer_wheel_levels(uint64_t max_delay)
+{
+	unsigned int expected_runs[WHEEL_NB_TIMERS];
+	unsigned int i, lvl, nb_lvl;
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t ticks;
+
+	if (timer_wheel_setup() < 0)
+		return -1;
+
+	nb_lvl = timer_wheel_nb_lvl(max_delay);
+	printf("Checking %u wheel levels\n", nb_lvl);
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		lvl = i % nb_lvl;
+		if (lvl != 0 && i < 4 * nb_lvl) {
+			/* around the start of the level */
+			ticks = RTE_BIT64(lvl * WHEEL_LVL_BITS) + i / nb_lvl - 2;
+		} else {
+			ticks = timer_wheel_delay(lvl, max_delay);
+		}
+		expected_runs[i] = 1;
+		if (timer_wheel_arm(i, ticks, SINGLE) < 0)
+			expected_runs[i] = 0;
+	}
+
+	return timer_wheel_run(rte_get_timer_cycles() + max_delay + hz / 100,
+			       expected_runs);
+}
+
+static void
+timer_wheel_stop_all_cb(struct rte_timer *tim, void *arg)
+{
+	unsigned int *nb_stopped = arg;
+
+	if (rte_timer_pending(tim)) {
+		printf("Timer %u still pending after stop all\n",
+		       (unsigned int)(tim - wheel_tims));
+		wheel_failed = 1;
+	}
+	(*nb_stopped)++;
+}
+
+static int
+test_timer_wheel_reset_stop(uint64_t max_delay)
+{
+	unsigned int expected_runs[WHEEL_NB_TIMERS];
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i, lvl, nb_lvl, nb_stopped;
+	uint64_t hz = rte_get_timer_hz();
+	int ret;
+
+	if (timer_wheel_setup() < 0)
+		return -1;
+
+	nb_lvl = timer_wheel_nb_lvl(max_delay);
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		if (timer_wheel_arm(i, timer_wheel_delay(i % nb_lvl, max_delay),
+				    SINGLE) < 0)
+			return -1;
+	}
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		lvl = i % nb_lvl;
+		expected_runs[i] = 1;
+		switch (i % 4) {
+		case 1:
+			/* stop in the wheel */
+			if (rte_timer_alt_stop(wheel_id, &wheel_tims[i]) != 0)
+				return -1;
+			expected_runs[i] = 0;
+			break;
+		case 2:
+			/* move to another level */
+			if (timer_wheel_arm(i, timer_wheel_delay(
+					(lvl + 1) % nb_lvl, max_delay),
+					SINGLE) < 0)
+				return -1;
+			break;
+		case 3:
+			/* move to another level, then stop */
+			if (timer_wheel_arm(i, timer_wheel_delay(
+					(lvl + nb_lvl - 1) % nb_lvl, max_delay),
+					SINGLE) < 0 ||
+			    rte_timer_alt_stop(wheel_id, &wheel_tims[i]) != 0)
+				return -1;
+			expected_runs[i] = 0;
+			break;
+		}
+	}
+
+	/* replace the first timer by a periodic one, stopped by its callback */
+	if (rte_timer_alt_stop(wheel_id, &wheel_tims[0]) != 0 ||
+	    timer_wheel_arm(0, WHEEL_PERIOD, PERIODICAL) < 0)
+		return -1;
+	expected_runs[0] = WHEEL_PERIODIC_RUNS;
+
+	ret = timer_wheel_run(rte_get_timer_cycles() + max_delay + hz / 100,
+			      expected_runs);
+	if (ret < 0)
+		return ret;
+
+	/* stop all the timers left in the wheel, on every level */
+	if (timer_wheel_setup() < 0)
+		return -1;
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		expected_runs[i] = 0;
+		if (timer_wheel_arm(i, hz + timer_wheel_delay(i % nb_lvl,
+				max_delay), SINGLE) < 0)
+			return -1;
+	}
+
+	nb_stopped = 0;
+	rte_timer_stop_all(wheel_id, &lcore_id, 1, timer_wheel_stop_all_cb,
+			   &nb_stopped);
+	if (nb_stopped != WHEEL_NB_TIMERS) {
+		printf("Stop all stopped %u timers instead of %u\n",
+		       nb_stopped, WHEEL_NB_TIMERS);
+		wheel_failed = 1;
+	}
+
+	return timer_wheel_run(rte_get_timer_cycles() + hz / 100,
+			       expected_runs);
+}
+
+static int
+test_timer_wheel(void)
+{
+	uint64_t max_delay = rte_get_timer_hz() / 2;
+
+	printf("Start timer wheel expiry order test\n");
+	if (test_timer_wheel_order() < 0)
+		return TEST_FAILED;
+
+	printf("Start timer wheel levels test\n");
+	if (test_timer_wheel_levels(max_delay) < 0)
+		return TEST_FAILED;
+
+	printf("Start timer wheel reset and stop test\n");
+	if (test_timer_wheel_reset_stop(max_delay) < 0)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_FAST_TEST(timer_wheel_autotest, true, true, test_timer_wheel);
@@ -16,6 +16,8 @@
 #include <rte_pause.h>
 
 #define MAX_ITERATIONS 1000000
+#define MAX_BACKEND_TIMERS 10000000
+#define WHEEL_RESOLUTION_US 10
 
 int outstanding_count = 0;
 
@@ -33,6 +35,108 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+static void
+timer_alt_cb(struct rte_timer *t __rte_unused)
+{
+	outstanding_count--;
+}
+
+/* arm, expire and report n timers on the given timer data instance */
+static int
+measure_backend(const char *name, uint32_t data_id, struct rte_timer *tms,
+		unsigned int n, uint64_t ticks)
+{
+	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
+	uint64_t start_tsc, end_tsc, delay_start;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		rte_timer_init(&tms[i]);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < n; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand() % ticks,
+				SINGLE, lcore_id, NULL, NULL);
+	end_tsc = rte_rdtsc();
+	printf("%-8s %9u timers: reset %"PRIu64" cycles/timer (%"PRIu64"ms), ",
+			name, n, (end_tsc - start_tsc) / n,
+			(end_tsc - start_tsc + ticks_per_ms/2) / ticks_per_ms);
+	outstanding_count = n;
+
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	rte_timer_alt_manage(data_id, NULL, 0, timer_alt_cb);
+	end_tsc = rte_rdtsc();
+	printf("expire %"PRIu64" cycles/timer (%"PRIu64"ms)\n",
+			(end_tsc - start_tsc) / n,
+			(end_tsc - start_tsc + ticks_per_ms/2) / ticks_per_ms);
+
+	if (outstanding_count != 0) {
+		printf("Error: %s outstanding callback count = %d\n", name,
+				outstanding_count);
+		return -1;
+	}
+
+	/* cost of polling with only far away timers pending */
+	rte_timer_alt_reset(data_id, &tms[0], ticks * 100, SINGLE, lcore_id,
+			NULL, NULL);
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < MAX_ITERATIONS; i++)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_alt_cb);
+	end_tsc = rte_rdtsc();
+	rte_timer_alt_stop(data_id, &tms[0]);
+	printf("%-8s rte_timer_alt_manage with zero callbacks: %"PRIu64" cycles\n",
+			name, (end_tsc - start_tsc + MAX_ITERATIONS/2) / MAX_ITERATIONS);
+
+	return 0;
+}
+
+/* compare the skiplist and timer wheel backends with large timer counts */
+static int
+test_timer_perf_backends(void)
+{
+	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
+	uint64_t resolution = rte_get_timer_hz() / US_PER_S * WHEEL_RESOLUTION_US;
+	uint32_t list_id, wheel_id;
+	struct rte_timer *tms;
+	unsigned int n;
+	int ret = 0;
+
+	tms = rte_malloc(NULL, sizeof(*tms) * MAX_BACKEND_TIMERS, 0);
+	if (tms == NULL) {
+		printf("Not enough memory for %u timers, skipping backend comparison\n",
+				MAX_BACKEND_TIMERS);
+		return 0;
+	}
+
+	if (rte_timer_data_alloc(&list_id) != 0) {
+		rte_free(tms);
+		return -1;
+	}
+	if (rte_timer_data_alloc_wheel(&wheel_id, RTE_MAX(resolution, UINT64_C(1))) != 0) {
+		rte_timer_data_dealloc(list_id);
+		rte_free(tms);
+		return -1;
+	}
+
+	printf("\nSkiplist vs timer wheel (resolution %u us)\n",
+			WHEEL_RESOLUTION_US);
+	for (n = MAX_ITERATIONS; n <= MAX_BACKEND_TIMERS && ret == 0; n *= 10) {
+		ret = measure_backend("skiplist", list_id, tms, n, ticks);
+		if (ret == 0)
+			ret = measure_backend("wheel", wheel_id, tms, n, ticks);
+	}
+
+	rte_timer_data_dealloc(wheel_id);
+	rte_timer_data_dealloc(list_id);
+	rte_free(tms);
+	return ret;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -128,7 +232,8 @@ test_timer_perf(void)
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	rte_free(tms);
-	return 0;
+
+	return test_timer_perf_backends();
 }
 
 REGISTER_PERF_TEST(timer_perf_autotest, test_timer_perf);
@@ -35,9 +35,13 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCK_TMO_ARG	"blk_tmo"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+/* the kernel keeps the TPACKET_V3 block timeout on 16 bits */
+#define MAX_BLOCK_TMO		UINT16_MAX
 
 struct pkt_rx_queue {
 	int sockfd;
@@ -51,6 +55,10 @@ struct pkt_rx_queue {
 	uint16_t in_port;
 	uint8_t vlan_strip;
 
+	/* TPACKET_V3 only: rd and framecount/framenum describe blocks */
+	struct tpacket3_hdr *next_frame;
+	uint32_t frames_left;
+
 	volatile unsigned long rx_pkts;
 	volatile unsigned long rx_bytes;
 };
@@ -77,6 +85,7 @@ struct pmd_internals {
 	struct rte_ether_addr eth_addr;
 
 	struct tpacket_req req;
+	uint8_t tpacket_v3;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -90,6 +99,8 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCK_TMO_ARG,
 	NULL
 };
 
@@ -173,6 +184,102 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Copy one TPACKET_V3 frame into an already allocated mbuf
+ */
+static inline void
+rx_v3_frame_copy(struct pkt_rx_queue *pkt_q, struct tpacket3_hdr *ppd,
+		struct rte_mbuf *mbuf)
+{
+	uint32_t len = ppd->tp_snaplen;
+
+	/*
+	 * Unlike TPACKET_V2, frames are not bounded by the frame size,
+	 * truncate what does not fit in the mbuf as the kernel would.
+	 */
+	if (unlikely(len > rte_pktmbuf_tailroom(mbuf)))
+		len = rte_pktmbuf_tailroom(mbuf);
+
+	rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) = len;
+	memcpy(rte_pktmbuf_mtod(mbuf, void *), (uint8_t *)ppd + ppd->tp_mac, len);
+
+	/* check for vlan info */
+	if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+		mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+		mbuf->ol_flags |= (RTE_MBUF_F_RX_VLAN | RTE_MBUF_F_RX_VLAN_STRIPPED);
+
+		if (!pkt_q->vlan_strip && rte_vlan_insert(&mbuf))
+			PMD_LOG(ERR, "Failed to reinsert VLAN tag");
+	}
+	mbuf->port = pkt_q->in_port;
+}
+
+/*
+ * TPACKET_V3 receive: the kernel hands over whole blocks of frames once they
+ * are full or their timeout expired, so only one status check is needed per
+ * block and the frames of a block are consumed with a single mbuf bulk
+ * allocation per burst.
+ */
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_rx_queue *pkt_q = queue;
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	unsigned int blocknum = pkt_q->framenum;
+	unsigned long num_rx_bytes = 0;
+	uint16_t num_rx = 0;
+	uint32_t i, n;
+
+	while (num_rx < nb_pkts) {
+		pbd = pkt_q->rd[blocknum].iov_base;
+
+		if (pkt_q->frames_left == 0) {
+			/* wait for the kernel to retire the current block */
+			if ((pbd->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+				break;
+			rte_atomic_thread_fence(rte_memory_order_acquire);
+
+			pkt_q->frames_left = pbd->hdr.bh1.num_pkts;
+			pkt_q->next_frame = (struct tpacket3_hdr *)((uint8_t *)pbd +
+					pbd->hdr.bh1.offset_to_first_pkt);
+		}
+
+		n = RTE_MIN(pkt_q->frames_left, (uint32_t)(nb_pkts - num_rx));
+		if (n != 0 && rte_pktmbuf_alloc_bulk(pkt_q->mb_pool,
+				&bufs[num_rx], n) != 0)
+			break;
+
+		ppd = pkt_q->next_frame;
+		for (i = 0; i < n; i++) {
+			struct tpacket3_hdr *next = (struct tpacket3_hdr *)
+				((uint8_t *)ppd + ppd->tp_next_offset);
+
+			rte_prefetch0(next);
+			rx_v3_frame_copy(pkt_q, ppd, bufs[num_rx]);
+			num_rx_bytes += bufs[num_rx]->pkt_len;
+			num_rx++;
+			ppd = next;
+		}
+		pkt_q->next_frame = ppd;
+		pkt_q->frames_left -= n;
+
+		if (pkt_q->frames_left != 0)
+			break;
+
+		/* release the whole block and advance to the next one */
+		rte_atomic_thread_fence(rte_memory_order_release);
+		pbd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		if (++blocknum >= pkt_q->framecount)
+			blocknum = 0;
+	}
+
+	pkt_q->framenum = blocknum;
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	return num_rx;
+}
+
 /*
  * Check if there is an available frame in the ring
  */
@@ -456,8 +563,15 @@ eth_dev_close(struct rte_eth_dev *dev)
 	internals = dev->data->dev_private;
 	req = &internals->req;
 	for (q = 0; q < internals->nb_queues; q++) {
-		munmap(internals->rx_queue[q].map,
-			2 * req->tp_block_size * req->tp_block_nr);
+		if (internals->tpacket_v3) {
+			munmap(internals->rx_queue[q].map,
+				req->tp_block_size * req->tp_block_nr);
+			munmap(internals->tx_queue[q].map,
+				req->tp_block_size * req->tp_block_nr);
+		} else {
+			munmap(internals->rx_queue[q].map,
+				2 * req->tp_block_size * req->tp_block_nr);
+		}
 		rte_free(internals->rx_queue[q].rd);
 		rte_free(internals->tx_queue[q].rd);
 	}
@@ -667,6 +781,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       unsigned int tpacket_v3,
+		       unsigned int blk_tmo,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -680,11 +796,13 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
 	struct tpacket_req *req;
+	struct tpacket_req3 req3;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
 	int rc, tpver, discard;
 	int qsockfd = -1;
-	unsigned int i, q, rdsize;
+	int txsockfd = -1;
+	unsigned int i, q, rdsize, mapsize;
 #if defined(PACKET_FANOUT)
 	int fanout_arg;
 #endif
@@ -736,6 +854,14 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_block_nr = blockcnt;
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
+	(*internals)->tpacket_v3 = !!tpacket_v3;
+
+	memset(&req3, 0, sizeof(req3));
+	req3.tp_block_size = blocksize;
+	req3.tp_block_nr = blockcnt;
+	req3.tp_frame_size = framesize;
+	req3.tp_frame_nr = framecnt;
+	req3.tp_retire_blk_tov = blk_tmo;
 
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
@@ -776,6 +902,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 #endif
 
 	for (q = 0; q < nb_queues; q++) {
+		txsockfd = -1;
+
 		/* Open an AF_PACKET socket for this queue... */
 		qsockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
 		if (qsockfd == -1) {
@@ -785,7 +913,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
+		tpver = tpacket_v3 ? TPACKET_V3 : TPACKET_V2;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -795,8 +923,35 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
+		if (tpacket_v3) {
+			/*
+			 * The ring version applies to both rings of a socket
+			 * and Tx stays on TPACKET_V2, so use a second socket
+			 * which is never hooked to receive anything for Tx.
+			 */
+			txsockfd = socket(AF_PACKET, SOCK_RAW, 0);
+			if (txsockfd == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not open AF_PACKET Tx socket",
+					name);
+				goto error;
+			}
+
+			tpver = TPACKET_V2;
+			rc = setsockopt(txsockfd, SOL_PACKET, PACKET_VERSION,
+					&tpver, sizeof(tpver));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_VERSION on AF_PACKET Tx socket for %s",
+					name, pair->value);
+				goto error;
+			}
+		} else {
+			txsockfd = qsockfd;
+		}
+
 		discard = 1;
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_LOSS,
+		rc = setsockopt(txsockfd, SOL_PACKET, PACKET_LOSS,
 				&discard, sizeof(discard));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
@@ -807,7 +962,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 
 		if (qdisc_bypass) {
 #if defined(PACKET_QDISC_BYPASS)
-			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
+			rc = setsockopt(txsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
 					&qdisc_bypass, sizeof(qdisc_bypass));
 			if (rc == -1) {
 				PMD_LOG_ERRNO(ERR,
@@ -818,7 +973,12 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 #endif
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
+		if (tpacket_v3)
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					&req3, sizeof(req3));
+		else
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					req, sizeof(*req));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
@@ -826,7 +986,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+		rc = setsockopt(txsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_TX_RING on AF_PACKET "
@@ -835,9 +995,17 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		}
 
 		rx_queue = &((*internals)->rx_queue[q]);
-		rx_queue->framecount = req->tp_frame_nr;
 
-		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
+		/* with TPACKET_V3, the Rx ring is consumed block by block */
+		if (tpacket_v3) {
+			rx_queue->framecount = req->tp_block_nr;
+			mapsize = req->tp_block_size * req->tp_block_nr;
+		} else {
+			rx_queue->framecount = req->tp_frame_nr;
+			mapsize = 2 * req->tp_block_size * req->tp_block_nr;
+		}
+
+		rx_queue->map = mmap(NULL, mapsize,
 				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
 				    qsockfd, 0);
 		if (rx_queue->map == MAP_FAILED) {
@@ -847,15 +1015,20 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		/* rdsize is same for both Tx and Rx */
-		rdsize = req->tp_frame_nr * sizeof(*(rx_queue->rd));
-
+		rdsize = rx_queue->framecount * sizeof(*(rx_queue->rd));
 		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (rx_queue->rd == NULL)
 			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+		for (i = 0; i < rx_queue->framecount; ++i) {
+			if (tpacket_v3) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * blocksize);
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+			} else {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 		}
 		rx_queue->sockfd = qsockfd;
 
@@ -865,8 +1038,23 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
 			sizeof(struct sockaddr_ll);
 
-		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
+		if (tpacket_v3) {
+			tx_queue->map = mmap(NULL,
+					req->tp_block_size * req->tp_block_nr,
+					PROT_READ | PROT_WRITE,
+					MAP_SHARED | MAP_LOCKED, txsockfd, 0);
+			if (tx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET Tx socket for %s",
+					name, pair->value);
+				goto error;
+			}
+		} else {
+			tx_queue->map = rx_queue->map +
+				req->tp_block_size * req->tp_block_nr;
+		}
 
+		rdsize = req->tp_frame_nr * sizeof(*(tx_queue->rd));
 		tx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (tx_queue->rd == NULL)
 			goto error;
@@ -874,7 +1062,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			tx_queue->rd[i].iov_base = tx_queue->map + (i * framesize);
 			tx_queue->rd[i].iov_len = req->tp_frame_size;
 		}
-		tx_queue->sockfd = qsockfd;
+		tx_queue->sockfd = txsockfd;
 
 		rc = bind(qsockfd, (const struct sockaddr*)&sockaddr, sizeof(sockaddr));
 		if (rc == -1) {
@@ -884,6 +1072,21 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
+		if (tpacket_v3) {
+			struct sockaddr_ll txaddr = sockaddr;
+
+			/* a null protocol keeps the Tx socket from receiving */
+			txaddr.sll_protocol = 0;
+			rc = bind(txsockfd, (const struct sockaddr *)&txaddr,
+					sizeof(txaddr));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not bind AF_PACKET Tx socket to %s",
+					name, pair->value);
+				goto error;
+			}
+		}
+
 #if defined(PACKET_FANOUT)
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_FANOUT,
 				&fanout_arg, sizeof(fanout_arg));
@@ -926,16 +1129,25 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 error:
 	if (qsockfd != -1)
 		close(qsockfd);
+	if (txsockfd != -1 && txsockfd != qsockfd)
+		close(txsockfd);
 	for (q = 0; q < nb_queues; q++) {
 		if ((*internals)->rx_queue[q].map != MAP_FAILED)
-			munmap((*internals)->rx_queue[q].map,
+			munmap((*internals)->rx_queue[q].map, tpacket_v3 ?
+			       req->tp_block_size * req->tp_block_nr :
 			       2 * req->tp_block_size * req->tp_block_nr);
+		if (tpacket_v3 && (*internals)->tx_queue[q].map != MAP_FAILED)
+			munmap((*internals)->tx_queue[q].map,
+			       req->tp_block_size * req->tp_block_nr);
 
 		rte_free((*internals)->rx_queue[q].rd);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
 			close((*internals)->rx_queue[q].sockfd);
+		if (tpacket_v3 && ((*internals)->tx_queue[q].sockfd >= 0) &&
+			((*internals)->tx_queue[q].sockfd != txsockfd))
+			close((*internals)->tx_queue[q].sockfd);
 	}
 free_internals:
 	rte_free((*internals)->rx_queue);
@@ -961,6 +1173,8 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int blk_tmo = 0;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
@@ -1023,6 +1237,26 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCK_TMO_ARG) != NULL) {
+			blk_tmo = atoi(pair->value);
+			if (blk_tmo == 0 || blk_tmo > MAX_BLOCK_TMO) {
+				PMD_LOG(ERR,
+					"%s: invalid blk_tmo value",
+					name);
+				return -1;
+			}
+			continue;
+		}
 	}
 
 	if (framesize > blocksize) {
@@ -1044,16 +1278,22 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	if (tpacket_v3)
+		PMD_LOG(INFO, "%s:\tTPACKET_V3 Rx, block timeout %u ms%s",
+			name, blk_tmo, blk_tmo ? "" : " (kernel default)");
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
-				   qdisc_bypass,
+				   qdisc_bypass, tpacket_v3, blk_tmo,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	if (internals->tpacket_v3)
+		eth_dev->rx_pkt_burst = eth_af_packet_rx_v3;
+	else
+		eth_dev->rx_pkt_burst = eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1145,4 +1385,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"blk_tmo=<int>");
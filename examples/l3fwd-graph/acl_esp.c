@@ -0,0 +1,514 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_acl.h>
+#include <rte_common.h>
+#include <rte_cryptodev.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_ip.h>
+#include <rte_ipsec.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_node_acl_api.h>
+#include <rte_node_esp_api.h>
+#include <rte_node_eth_api.h>
+#include <rte_string_fns.h>
+
+#include "acl_esp.h"
+
+/*
+ * The firewall and the ESP tunnel run on IPv4 packets received by the
+ * ethdev_rx nodes, before pkt_cls:
+ *
+ *   ethdev_rx -> acl_classify -> pkt_cls -> ip4_lookup -> ...
+ *                     |-> pkt_drop
+ *                     |-> esp_inbound  -> ip4_lookup -> ...
+ *                     `-> esp_outbound -> ip4_lookup -> ...
+ *
+ * The tunnel uses NULL cipher and authentication algorithms on the first
+ * crypto device, e.g. --vdev crypto_null.
+ */
+
+#define ACL_DENY_MAX 16
+#define ACL_RULE_MAX (ACL_DENY_MAX + 2)
+
+#define ESP_QP_DESC 2048
+#define ESP_COP_CACHE_SIZE 256
+
+/* Edges of acl_classify added by the application */
+enum {
+	ACL_NEXT_PKT_CLS = RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP + 1,
+	ACL_NEXT_ESP_INBOUND,
+	ACL_NEXT_ESP_OUTBOUND,
+};
+
+/* Priorities of the ACL rules, deny rules first */
+enum {
+	ACL_PRIO_ESP_OUTBOUND = 1,
+	ACL_PRIO_ESP_INBOUND,
+	ACL_PRIO_DENY,
+};
+
+/* Fields of the ACL rules, offsets are from the Ethernet header */
+enum {
+	ACL_FIELD_PROTO,
+	ACL_FIELD_ETHER_TYPE,
+	ACL_FIELD_VHL_TOS,
+	ACL_FIELD_SRC,
+	ACL_FIELD_DST,
+	ACL_FIELD_SPI,
+	ACL_FIELD_NUM,
+};
+
+#define IP4_OFFSET(field) \
+	(sizeof(struct rte_ether_hdr) + offsetof(struct rte_ipv4_hdr, field))
+
+static const struct rte_acl_field_def acl_field_defs[ACL_FIELD_NUM] = {
+	[ACL_FIELD_PROTO] = {
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint8_t),
+		.field_index = ACL_FIELD_PROTO,
+		.input_index = 0,
+		.offset = IP4_OFFSET(next_proto_id),
+	},
+	[ACL_FIELD_ETHER_TYPE] = {
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint16_t),
+		.field_index = ACL_FIELD_ETHER_TYPE,
+		.input_index = 1,
+		.offset = offsetof(struct rte_ether_hdr, ether_type),
+	},
+	[ACL_FIELD_VHL_TOS] = {
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint16_t),
+		.field_index = ACL_FIELD_VHL_TOS,
+		.input_index = 1,
+		.offset = IP4_OFFSET(version_ihl),
+	},
+	[ACL_FIELD_SRC] = {
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = ACL_FIELD_SRC,
+		.input_index = 2,
+		.offset = IP4_OFFSET(src_addr),
+	},
+	[ACL_FIELD_DST] = {
+		.type = RTE_ACL_FIELD_TYPE_MASK,
+		.size = sizeof(uint32_t),
+		.field_index = ACL_FIELD_DST,
+		.input_index = 3,
+		.offset = IP4_OFFSET(dst_addr),
+	},
+	/* ESP header right after an IPv4 header without options */
+	[ACL_FIELD_SPI] = {
+		.type = RTE_ACL_FIELD_TYPE_BITMASK,
+		.size = sizeof(uint32_t),
+		.field_index = ACL_FIELD_SPI,
+		.input_index = 4,
+		.offset = sizeof(struct rte_ether_hdr) + sizeof(struct rte_ipv4_hdr),
+	},
+};
+
+RTE_ACL_RULE_DEF(acl_esp_rule, ACL_FIELD_NUM);
+
+struct acl_esp_prefix {
+	uint32_t ip;
+	uint8_t depth;
+};
+
+static struct acl_esp_prefix acl_deny[ACL_DENY_MAX];
+static uint16_t nb_acl_deny;
+
+static struct {
+	bool enabled;
+	uint32_t spi;
+	uint32_t local;
+	uint32_t remote;
+	struct acl_esp_prefix protect;
+} esp_tunnel;
+
+static struct rte_ipsec_session esp_sessions[2];
+static struct rte_ipsec_session *esp_inbound_sessions[1] = {&esp_sessions[0]};
+static struct rte_ipsec_session *esp_outbound_sessions[1] = {&esp_sessions[1]};
+
+static int
+parse_prefix(const char *arg, struct acl_esp_prefix *prefix)
+{
+	char buf[INET_ADDRSTRLEN];
+	struct in_addr in;
+	const char *p;
+	char *end;
+	long depth;
+
+	p = strchr(arg, '/');
+	if (p == NULL || (size_t)(p - arg) >= sizeof(buf))
+		return -EINVAL;
+	memcpy(buf, arg, p - arg);
+	buf[p - arg] = '\0';
+	if (inet_pton(AF_INET, buf, &in) != 1)
+		return -EINVAL;
+
+	errno = 0;
+	depth = strtol(p + 1, &end, 10);
+	if (errno != 0 || *end != '\0' || end == p + 1 || depth < 0 || depth > 32)
+		return -EINVAL;
+
+	prefix->ip = ntohl(in.s_addr);
+	prefix->depth = depth;
+
+	return 0;
+}
+
+int
+acl_esp_parse_deny(const char *arg)
+{
+	if (nb_acl_deny == ACL_DENY_MAX)
+		return -ENOSPC;
+	if (parse_prefix(arg, &acl_deny[nb_acl_deny]) != 0)
+		return -EINVAL;
+	nb_acl_deny++;
+
+	return 0;
+}
+
+int
+acl_esp_parse_tunnel(const char *arg)
+{
+	char buf[128], *tok[4], *end;
+	struct in_addr in;
+	unsigned long spi;
+
+	if (strlen(arg) >= sizeof(buf))
+		return -EINVAL;
+	strcpy(buf, arg);
+	if (rte_strsplit(buf, sizeof(buf), tok, RTE_DIM(tok), ',') != RTE_DIM(tok))
+		return -EINVAL;
+
+	errno = 0;
+	spi = strtoul(tok[0], &end, 0);
+	if (errno != 0 || *end != '\0' || spi == 0 || spi > UINT32_MAX)
+		return -EINVAL;
+	esp_tunnel.spi = spi;
+
+	if (inet_pton(AF_INET, tok[1], &in) != 1)
+		return -EINVAL;
+	esp_tunnel.local = ntohl(in.s_addr);
+	if (inet_pton(AF_INET, tok[2], &in) != 1)
+		return -EINVAL;
+	esp_tunnel.remote = ntohl(in.s_addr);
+	if (parse_prefix(tok[3], &esp_tunnel.protect) != 0)
+		return -EINVAL;
+
+	esp_tunnel.enabled = true;
+
+	return 0;
+}
+
+bool
+acl_esp_enabled(void)
+{
+	return nb_acl_deny != 0 || esp_tunnel.enabled;
+}
+
+bool
+acl_esp_tunnel_enabled(void)
+{
+	return esp_tunnel.enabled;
+}
+
+static void
+acl_rule_init(struct acl_esp_rule *rule, uint32_t next, int32_t priority)
+{
+	memset(rule, 0, sizeof(*rule));
+	rule->data.category_mask = 1;
+	rule->data.priority = priority;
+	rule->data.userdata = RTE_NODE_ACL_CLASSIFY_USERDATA(next, 0);
+
+	/* IPv4 packets only, the other fields match all the values */
+	rule->field[ACL_FIELD_ETHER_TYPE].value.u16 = RTE_ETHER_TYPE_IPV4;
+	rule->field[ACL_FIELD_ETHER_TYPE].mask_range.u16 = UINT16_MAX;
+}
+
+static struct rte_acl_ctx *
+acl_build(int socket_id)
+{
+	struct acl_esp_rule rules[ACL_RULE_MAX];
+	struct rte_acl_config cfg;
+	struct rte_acl_param prm;
+	struct rte_acl_ctx *acl;
+	uint32_t nb_rules = 0;
+	uint16_t i;
+
+	for (i = 0; i < nb_acl_deny; i++) {
+		acl_rule_init(&rules[nb_rules], RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP,
+			      ACL_PRIO_DENY);
+		rules[nb_rules].field[ACL_FIELD_SRC].value.u32 = acl_deny[i].ip;
+		rules[nb_rules].field[ACL_FIELD_SRC].mask_range.u32 = acl_deny[i].depth;
+		nb_rules++;
+	}
+
+	if (esp_tunnel.enabled) {
+		/* ESP packets of the tunnel are decapsulated, with the session 0 */
+		acl_rule_init(&rules[nb_rules], ACL_NEXT_ESP_INBOUND, ACL_PRIO_ESP_INBOUND);
+		rules[nb_rules].field[ACL_FIELD_PROTO].value.u8 = IPPROTO_ESP;
+		rules[nb_rules].field[ACL_FIELD_PROTO].mask_range.u8 = UINT8_MAX;
+		rules[nb_rules].field[ACL_FIELD_VHL_TOS].value.u16 = RTE_IPV4_VHL_DEF << 8;
+		rules[nb_rules].field[ACL_FIELD_VHL_TOS].mask_range.u16 = 0xff00;
+		rules[nb_rules].field[ACL_FIELD_DST].value.u32 = esp_tunnel.local;
+		rules[nb_rules].field[ACL_FIELD_DST].mask_range.u32 = 32;
+		rules[nb_rules].field[ACL_FIELD_SPI].value.u32 = esp_tunnel.spi;
+		rules[nb_rules].field[ACL_FIELD_SPI].mask_range.u32 = UINT32_MAX;
+		nb_rules++;
+
+		/* Packets to the protected prefix are encapsulated */
+		acl_rule_init(&rules[nb_rules], ACL_NEXT_ESP_OUTBOUND, ACL_PRIO_ESP_OUTBOUND);
+		rules[nb_rules].field[ACL_FIELD_DST].value.u32 = esp_tunnel.protect.ip;
+		rules[nb_rules].field[ACL_FIELD_DST].mask_range.u32 = esp_tunnel.protect.depth;
+		nb_rules++;
+	}
+
+	prm.name = "l3fwd_graph_acl";
+	prm.socket_id = socket_id;
+	prm.rule_size = RTE_ACL_RULE_SZ(ACL_FIELD_NUM);
+	prm.max_rule_num = ACL_RULE_MAX;
+
+	acl = rte_acl_create(&prm);
+	if (acl == NULL)
+		return NULL;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.num_categories = 1;
+	cfg.num_fields = ACL_FIELD_NUM;
+	memcpy(cfg.defs, acl_field_defs, sizeof(acl_field_defs));
+
+	if (rte_acl_add_rules(acl, (struct rte_acl_rule *)rules, nb_rules) != 0 ||
+	    rte_acl_build(acl, &cfg) != 0) {
+		rte_acl_free(acl);
+		return NULL;
+	}
+
+	return acl;
+}
+
+static int
+esp_session_create(struct rte_ipsec_session *ss, uint8_t dev_id, bool inbound,
+		   struct rte_mempool *sess_pool, int socket_id)
+{
+	struct rte_crypto_sym_xform cipher = {
+		.type = RTE_CRYPTO_SYM_XFORM_CIPHER,
+		.cipher = {
+			.op = inbound ? RTE_CRYPTO_CIPHER_OP_DECRYPT :
+					RTE_CRYPTO_CIPHER_OP_ENCRYPT,
+			.algo = RTE_CRYPTO_CIPHER_NULL,
+		},
+	};
+	struct rte_crypto_sym_xform auth = {
+		.type = RTE_CRYPTO_SYM_XFORM_AUTH,
+		.auth = {
+			.op = inbound ? RTE_CRYPTO_AUTH_OP_VERIFY :
+					RTE_CRYPTO_AUTH_OP_GENERATE,
+			.algo = RTE_CRYPTO_AUTH_NULL,
+		},
+	};
+	struct rte_ipv4_hdr tun_hdr = {
+		.version_ihl = RTE_IPV4_VHL_DEF,
+		.time_to_live = IPDEFTTL,
+		.next_proto_id = IPPROTO_ESP,
+		.src_addr = rte_cpu_to_be_32(esp_tunnel.local),
+		.dst_addr = rte_cpu_to_be_32(esp_tunnel.remote),
+	};
+	struct rte_ipsec_sa_prm prm;
+	struct rte_ipsec_sa *sa;
+	int rc, sz;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.ipsec_xform.spi = esp_tunnel.spi;
+	prm.ipsec_xform.direction = inbound ? RTE_SECURITY_IPSEC_SA_DIR_INGRESS :
+					      RTE_SECURITY_IPSEC_SA_DIR_EGRESS;
+	prm.ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	prm.ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	prm.ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+	prm.ipsec_xform.tunnel.ipv4.src_ip.s_addr = tun_hdr.src_addr;
+	prm.ipsec_xform.tunnel.ipv4.dst_ip.s_addr = tun_hdr.dst_addr;
+	prm.tun.hdr = &tun_hdr;
+	prm.tun.hdr_len = sizeof(tun_hdr);
+	prm.tun.next_proto = IPPROTO_IPIP;
+
+	/* Inbound SAs authenticate then decrypt, outbound ones do the reverse */
+	if (inbound) {
+		auth.next = &cipher;
+		prm.crypto_xform = &auth;
+	} else {
+		cipher.next = &auth;
+		prm.crypto_xform = &cipher;
+	}
+
+	sz = rte_ipsec_sa_size(&prm);
+	if (sz < 0)
+		return sz;
+	sa = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE, socket_id);
+	if (sa == NULL)
+		return -ENOMEM;
+	rc = rte_ipsec_sa_init(sa, &prm, sz);
+	if (rc < 0)
+		goto free_sa;
+
+	memset(ss, 0, sizeof(*ss));
+	ss->sa = sa;
+	ss->type = RTE_SECURITY_ACTION_TYPE_NONE;
+	ss->crypto.dev_id = dev_id;
+	ss->crypto.ses = rte_cryptodev_sym_session_create(dev_id, prm.crypto_xform,
+							  sess_pool);
+	if (ss->crypto.ses == NULL) {
+		rc = -rte_errno;
+		goto free_sa;
+	}
+
+	rc = rte_ipsec_session_prepare(ss);
+	if (rc == 0)
+		return 0;
+
+	rte_cryptodev_sym_session_free(dev_id, ss->crypto.ses);
+free_sa:
+	rte_free(sa);
+	return rc;
+}
+
+static int
+esp_setup(int socket_id)
+{
+	struct rte_cryptodev_qp_conf qp_conf;
+	struct rte_cryptodev_config dev_conf;
+	struct rte_cryptodev_info dev_info;
+	struct rte_mempool *sess_pool, *cop_pool;
+	struct rte_node_esp_cfg cfg;
+	const uint8_t dev_id = 0;
+	uint16_t nb_qps, qp;
+	int rc;
+
+	if (rte_cryptodev_count() == 0) {
+		fprintf(stderr, "No crypto device for the ESP tunnel\n");
+		return -ENODEV;
+	}
+
+	/* The nodes of each graph use their own queue pairs */
+	rte_cryptodev_info_get(dev_id, &dev_info);
+	nb_qps = 2 * rte_lcore_count();
+	if (nb_qps > dev_info.max_nb_queue_pairs) {
+		fprintf(stderr, "Crypto device has less than %u queue pairs\n", nb_qps);
+		return -ENOSPC;
+	}
+
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.socket_id = socket_id;
+	dev_conf.nb_queue_pairs = nb_qps;
+	rc = rte_cryptodev_configure(dev_id, &dev_conf);
+	if (rc < 0)
+		return rc;
+
+	sess_pool = rte_cryptodev_sym_session_pool_create("l3fwd_graph_sess",
+			RTE_DIM(esp_sessions), rte_cryptodev_sym_get_private_session_size(dev_id),
+			0, 0, socket_id);
+	cop_pool = rte_crypto_op_pool_create("l3fwd_graph_cop", RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+			nb_qps * ESP_QP_DESC, ESP_COP_CACHE_SIZE, 0, socket_id);
+	if (sess_pool == NULL || cop_pool == NULL)
+		return -ENOMEM;
+
+	qp_conf.nb_descriptors = ESP_QP_DESC;
+	qp_conf.mp_session = sess_pool;
+	for (qp = 0; qp < nb_qps; qp++) {
+		rc = rte_cryptodev_queue_pair_setup(dev_id, qp, &qp_conf, socket_id);
+		if (rc < 0)
+			return rc;
+	}
+
+	rc = rte_cryptodev_start(dev_id);
+	if (rc < 0)
+		return rc;
+
+	rc = esp_session_create(&esp_sessions[0], dev_id, true, sess_pool, socket_id);
+	if (rc < 0)
+		return rc;
+	rc = esp_session_create(&esp_sessions[1], dev_id, false, sess_pool, socket_id);
+	if (rc < 0)
+		return rc;
+
+	cfg.cop_pool = cop_pool;
+	cfg.dev_id = dev_id;
+	cfg.nb_sessions = 1;
+
+	cfg.sessions = esp_inbound_sessions;
+	cfg.qp_id = 0;
+	cfg.node_id = rte_node_from_name("esp_inbound");
+	rc = rte_node_esp_inbound_configure(&cfg, 1);
+	if (rc < 0)
+		return rc;
+
+	cfg.sessions = esp_outbound_sessions;
+	cfg.qp_id = nb_qps / 2;
+	cfg.node_id = rte_node_from_name("esp_outbound");
+	return rte_node_esp_outbound_configure(&cfg, 1);
+}
+
+int
+acl_esp_setup(int socket_id)
+{
+	const char *acl_next[] = {"pkt_cls", "esp_inbound", "esp_outbound"};
+	const char *esp_next = "ip4_lookup";
+	struct rte_node_acl_classify_cfg cfg;
+	uint16_t nb_next;
+	rte_node_t id;
+	int rc;
+
+	if (esp_tunnel.enabled) {
+		rc = esp_setup(socket_id);
+		if (rc < 0)
+			return rc;
+
+		id = rte_node_from_name("esp_inbound");
+		if (rte_node_edge_update(id, RTE_NODE_ESP_NEXT_PKT_DROP + 1, &esp_next, 1) != 1)
+			return -EINVAL;
+		id = rte_node_from_name("esp_outbound");
+		if (rte_node_edge_update(id, RTE_NODE_ESP_NEXT_PKT_DROP + 1, &esp_next, 1) != 1)
+			return -EINVAL;
+	}
+
+	cfg.ctx = acl_build(socket_id);
+	if (cfg.ctx == NULL)
+		return -ENOMEM;
+	cfg.data_offset = 0;
+	cfg.default_next = ACL_NEXT_PKT_CLS;
+	cfg.node_id = rte_node_from_name("acl_classify");
+
+	/* The ESP nodes are only added to the graphs with the tunnel */
+	nb_next = esp_tunnel.enabled ? RTE_DIM(acl_next) : 1;
+	if (rte_node_edge_update(cfg.node_id, ACL_NEXT_PKT_CLS, acl_next, nb_next) != nb_next)
+		return -EINVAL;
+
+	return rte_node_acl_classify_configure(&cfg, 1);
+}
+
+int
+acl_esp_rx_node_update(const char *rx_node_name)
+{
+	const char *next = "acl_classify";
+	rte_node_t id;
+
+	id = rte_node_from_name(rx_node_name);
+	if (id == RTE_NODE_ID_INVALID)
+		return -EINVAL;
+	if (rte_node_edge_update(id, RTE_EDGE_ID_INVALID, &next, 1) != 1)
+		return -EINVAL;
+
+	return rte_node_ethdev_rx_next_update(id, next);
+}
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __L3FWD_GRAPH_ACL_ESP_H__
+#define __L3FWD_GRAPH_ACL_ESP_H__
+
+#include <stdbool.h>
+
+/* Parse an IPv4 source prefix to deny, A.B.C.D/DEPTH. */
+int acl_esp_parse_deny(const char *arg);
+
+/* Parse the ESP tunnel, SPI,LOCAL,REMOTE,A.B.C.D/DEPTH. */
+int acl_esp_parse_tunnel(const char *arg);
+
+/* Check if a firewall or an ESP tunnel is configured. */
+bool acl_esp_enabled(void);
+
+/* Check if an ESP tunnel is configured, its graphs need the esp_poll node. */
+bool acl_esp_tunnel_enabled(void);
+
+/*
+ * Build the ACL rules, create the ESP sessions and configure the nodes.
+ * Must be called before the creation of the graphs.
+ */
+int acl_esp_setup(int socket_id);
+
+/* Send the packets received by an ethdev_rx node to acl_classify. */
+int acl_esp_rx_node_update(const char *rx_node_name);
+
+#endif /* __L3FWD_GRAPH_ACL_ESP_H__ */
@@ -40,6 +40,8 @@
 #include <cmdline_parse.h>
 #include <cmdline_parse_etheraddr.h>
 
+#include "acl_esp.h"
+
 /* Log type */
 #define RTE_LOGTYPE_L3FWD_GRAPH RTE_LOGTYPE_USER1
 
@@ -317,7 +319,9 @@ print_usage(const char *prgname)
 		" [--max-pkt-len PKTLEN]"
 		" [--no-numa]"
 		" [--per-port-pool]"
-		" [--num-pkt-cap]\n\n"
+		" [--num-pkt-cap]"
+		" [--acl-deny A.B.C.D/DEPTH]"
+		" [--esp-tunnel SPI,LOCAL,REMOTE,A.B.C.D/DEPTH]\n\n"
 
 		"  -p PORTMASK: Hexadecimal bitmask of ports to configure\n"
 		"  -P : Enable promiscuous mode\n"
@@ -330,7 +334,11 @@ print_usage(const char *prgname)
 		"  --per-port-pool: Use separate buffer pool per port\n"
 		"  --pcap-enable: Enables pcap capture\n"
 		"  --pcap-num-cap NUMPKT: Number of packets to capture\n"
-		"  --pcap-file-name NAME: Pcap file name\n\n",
+		"  --pcap-file-name NAME: Pcap file name\n"
+		"  --acl-deny A.B.C.D/DEPTH: Drop IPv4 packets from the prefix\n"
+		"  --esp-tunnel SPI,LOCAL,REMOTE,A.B.C.D/DEPTH: ESP tunnel, with NULL\n"
+		"    algorithms on the first crypto device, of the IPv4 packets to\n"
+		"    the prefix\n\n",
 		prgname);
 }
 
@@ -502,6 +510,8 @@ static const char short_options[] = "p:" /* portmask */
 #define CMD_LINE_OPT_NUM_PKT_CAP   "pcap-num-cap"
 #define CMD_LINE_OPT_PCAP_FILENAME "pcap-file-name"
 #define CMD_LINE_OPT_WORKER_MODEL  "model"
+#define CMD_LINE_OPT_ACL_DENY      "acl-deny"
+#define CMD_LINE_OPT_ESP_TUNNEL    "esp-tunnel"
 
 enum {
 	/* Long options mapped to a short option */
@@ -519,6 +529,8 @@ enum {
 	CMD_LINE_OPT_PARSE_NUM_PKT_CAP,
 	CMD_LINE_OPT_PCAP_FILENAME_CAP,
 	CMD_LINE_OPT_WORKER_MODEL_TYPE,
+	CMD_LINE_OPT_ACL_DENY_NUM,
+	CMD_LINE_OPT_ESP_TUNNEL_NUM,
 };
 
 static const struct option lgopts[] = {
@@ -531,6 +543,8 @@ static const struct option lgopts[] = {
 	{CMD_LINE_OPT_NUM_PKT_CAP, 1, 0, CMD_LINE_OPT_PARSE_NUM_PKT_CAP},
 	{CMD_LINE_OPT_PCAP_FILENAME, 1, 0, CMD_LINE_OPT_PCAP_FILENAME_CAP},
 	{CMD_LINE_OPT_WORKER_MODEL, 1, 0, CMD_LINE_OPT_WORKER_MODEL_TYPE},
+	{CMD_LINE_OPT_ACL_DENY, 1, 0, CMD_LINE_OPT_ACL_DENY_NUM},
+	{CMD_LINE_OPT_ESP_TUNNEL, 1, 0, CMD_LINE_OPT_ESP_TUNNEL_NUM},
 	{NULL, 0, 0, 0},
 };
 
@@ -627,6 +641,22 @@ parse_args(int argc, char **argv)
 			parse_worker_model(optarg);
 			break;
 
+		case CMD_LINE_OPT_ACL_DENY_NUM:
+			if (acl_esp_parse_deny(optarg) != 0) {
+				fprintf(stderr, "Invalid ACL deny prefix\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
+		case CMD_LINE_OPT_ESP_TUNNEL_NUM:
+			if (acl_esp_parse_tunnel(optarg) != 0) {
+				fprintf(stderr, "Invalid ESP tunnel\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -1256,6 +1286,25 @@ main(int argc, char **argv)
 	if (ret)
 		rte_exit(EXIT_FAILURE, "rte_node_eth_config: err=%d\n", ret);
 
+	/* Firewall and ESP tunnel config, before the graph creation */
+	if (acl_esp_enabled()) {
+		ret = acl_esp_setup(rte_socket_id());
+		if (ret)
+			rte_exit(EXIT_FAILURE, "acl_esp_setup: err=%d\n", ret);
+
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			qconf = &lcore_conf[lcore_id];
+			for (queue = 0; queue < qconf->n_rx_queue; queue++) {
+				ret = acl_esp_rx_node_update(
+					qconf->rx_queue_list[queue].node_name);
+				if (ret)
+					rte_exit(EXIT_FAILURE,
+						 "acl_esp_rx_node_update: err=%d\n",
+						 ret);
+			}
+		}
+	}
+
 	/* Start ports */
 	RTE_ETH_FOREACH_DEV(portid)
 	{
@@ -1285,13 +1334,17 @@ main(int argc, char **argv)
 
 	/* Graph Initialization */
 	nb_patterns = RTE_DIM(default_patterns);
-	node_patterns = malloc((MAX_RX_QUEUE_PER_LCORE + nb_patterns) *
+	node_patterns = malloc((MAX_RX_QUEUE_PER_LCORE + nb_patterns + 1) *
 			       sizeof(*node_patterns));
 	if (!node_patterns)
 		return -ENOMEM;
 	memcpy(node_patterns, default_patterns,
 	       nb_patterns * sizeof(*node_patterns));
 
+	/* Finish the crypto operations of the ESP nodes on each graph walk */
+	if (acl_esp_tunnel_enabled())
+		node_patterns[nb_patterns++] = "esp_poll";
+
 	memset(&graph_conf, 0, sizeof(graph_conf));
 	graph_conf.node_patterns = node_patterns;
 	graph_conf.nb_node_patterns = nb_patterns;
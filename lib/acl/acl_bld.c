@@ -4,6 +4,7 @@
 
 #include <rte_acl.h>
 #include <rte_log.h>
+#include <rte_thread.h>
 
 #include "tb_mem.h"
 #include "acl.h"
@@ -91,6 +92,21 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* tries rebuilt on other threads */
+	uint32_t                  max_jobs;
+	uint32_t                  num_jobs;
+	struct acl_build_job      *jobs[RTE_ACL_MAX_TRIES];
+};
+
+/* Rebuild of one trie, performed by a control thread with its own context */
+struct acl_build_job {
+	rte_thread_t              thread;
+	struct rte_acl_build_rule *head;
+	uint32_t                  n;
+	int32_t                   rc;
+	int32_t                   joined;
+	struct acl_build_context  bcx;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1344,10 +1360,131 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static uint32_t
+acl_build_job_run(void *arg)
+{
+	int32_t rc;
+	struct acl_build_job *job;
+	struct rte_acl_build_rule *last;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+
+	job = arg;
+
+	/* rebuild runs out of memory. */
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+	if (rc != 0) {
+		job->rc = rc;
+		return 0;
+	}
+
+	rule_sets[job->n] = job->head;
+	last = build_one_trie(&job->bcx, rule_sets, job->n, INT32_MAX);
+	if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL)
+		job->rc = -ENOMEM;
+
+	return 0;
+}
+
+/*
+ * Wait for the given rebuild to complete and take over its trie.
+ * The trie memory stays in the job pool until acl_build_jobs_free().
+ */
+static int
+acl_build_job_join(struct acl_build_context *context,
+	struct acl_build_job *job)
+{
+	uint32_t n;
+
+	if (job->joined != 0)
+		return job->rc;
+
+	rte_thread_join(job->thread, NULL);
+	job->joined = 1;
+
+	if (job->rc != 0) {
+		ACL_LOG(ERR, "Build of %u-th trie failed", job->n);
+		return job->rc;
+	}
+
+	n = job->n;
+	context->tries[n] = job->bcx.tries[n];
+	memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+		sizeof(context->data_indexes[n]));
+	context->tries[n].data_index = context->data_indexes[n];
+	context->bld_tries[n] = job->bcx.bld_tries[n];
+	context->num_nodes += job->bcx.num_nodes;
+
+	return 0;
+}
+
+/*
+ * Start the rebuild of the n-th trie on a control thread.
+ * Returns a positive value if no thread could be started,
+ * in that case the caller should rebuild the trie itself.
+ */
+static int
+acl_build_job_start(struct acl_build_context *context,
+	struct rte_acl_build_rule *head, uint32_t n)
+{
+	int32_t rc;
+	struct acl_build_job *job;
+
+	/* wait for the oldest rebuild if all threads are busy. */
+	if (context->num_jobs >= context->max_jobs) {
+		rc = acl_build_job_join(context,
+			context->jobs[context->num_jobs - context->max_jobs]);
+		if (rc != 0)
+			return rc;
+	}
+
+	job = calloc(1, sizeof(*job));
+	if (job == NULL)
+		return 1;
+
+	job->head = head;
+	job->n = n;
+	job->bcx.acx = context->acx;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->bcx.cfg = context->cfg;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = context->node_max;
+
+	if (rte_thread_create_internal_control(&job->thread, "acl-bld",
+			acl_build_job_run, job) != 0) {
+		free(job);
+		return 1;
+	}
+
+	context->jobs[context->num_jobs++] = job;
+	return 0;
+}
+
+/*
+ * Wait for all outstanding rebuilds and release their memory.
+ */
+static void
+acl_build_jobs_free(struct acl_build_context *context)
+{
+	uint32_t i;
+	struct acl_build_job *job;
+
+	for (i = 0; i != context->num_jobs; i++) {
+		job = context->jobs[i];
+		if (job->joined == 0)
+			rte_thread_join(job->thread, NULL);
+		tb_free_pool(&job->bcx.pool);
+		free(job);
+	}
+
+	context->num_jobs = 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
+	int32_t rc;
 	uint32_t n, num_tries;
 	struct rte_acl_config *config;
 	struct rte_acl_build_rule *last;
@@ -1406,7 +1543,17 @@ acl_build_tries(struct acl_build_context *context,
 		/*
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
+		 * If possible, do it on another thread, while this one
+		 * keeps splitting the remaining rules.
 		 */
+		if (context->max_jobs != 0) {
+			rc = acl_build_job_start(context, rule_sets[n], n);
+			if (rc < 0)
+				return rc;
+			if (rc == 0)
+				continue;
+		}
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			ACL_LOG(ERR, "Build of %u-th trie failed", n);
@@ -1415,6 +1562,12 @@ acl_build_tries(struct acl_build_context *context,
 
 	}
 
+	for (n = 0; n != context->num_jobs; n++) {
+		rc = acl_build_job_join(context, context->jobs[n]);
+		if (rc != 0)
+			return rc;
+	}
+
 	context->num_tries = num_tries;
 	return 0;
 }
@@ -1423,6 +1576,11 @@ static void
 acl_build_log(const struct acl_build_context *ctx)
 {
 	uint32_t n;
+	size_t alloc;
+
+	alloc = ctx->pool.alloc;
+	for (n = 0; n != ctx->num_jobs; n++)
+		alloc += ctx->jobs[n]->bcx.pool.alloc;
 
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
@@ -1431,7 +1589,7 @@ acl_build_log(const struct acl_build_context *ctx)
 		ctx->acx->name,
 		ctx->node_max,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		alloc);
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1521,6 +1679,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->max_jobs = (ctx->build_threads > 1) ? ctx->build_threads - 1 : 0;
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
@@ -1669,6 +1828,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
+		acl_build_jobs_free(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
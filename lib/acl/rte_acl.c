@@ -285,6 +285,17 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 	return 0;
 }
 
+int
+rte_acl_set_ctx_build_threads(struct rte_acl_ctx *ctx, uint32_t num_threads)
+{
+	if (ctx == NULL || num_threads == 0 ||
+			num_threads > RTE_ACL_MAX_BUILD_THREADS)
+		return -EINVAL;
+
+	ctx->build_threads = num_threads;
+	return 0;
+}
+
 int
 rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories,
@@ -418,6 +429,7 @@ rte_acl_create(const struct rte_acl_param *param)
 		ctx->rule_sz = param->rule_size;
 		ctx->socket_id = param->socket_id;
 		ctx->alg = acl_get_best_alg();
+		ctx->build_threads = 1;
 		strlcpy(ctx->name, param->name, sizeof(ctx->name));
 
 		te->data = (void *) ctx;
@@ -12,6 +12,7 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +25,9 @@ extern "C" {
 #define RTE_ACL_MAX_LEVELS 64
 #define RTE_ACL_MAX_FIELDS 64
 
+/** Max number of threads rte_acl_build() can use. */
+#define RTE_ACL_MAX_BUILD_THREADS 8
+
 union rte_acl_field_types {
 	uint8_t  u8;
 	uint16_t u16;
@@ -340,6 +344,31 @@ extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the number of threads rte_acl_build() may use for the given context.
+ * When a rule set has to be split into several tries, the tries that are
+ * already split off are rebuilt on extra control threads, while the calling
+ * thread goes on splitting the remaining rules.
+ * The resulting run-time structures are the same whatever the number
+ * of threads.
+ *
+ * @param ctx
+ *   ACL context to change the number of build threads for.
+ * @param num_threads
+ *   Number of threads, including the calling one, to use for the build.
+ *   1 (the default) performs the whole build on the calling thread.
+ *   Can't exceed RTE_ACL_MAX_BUILD_THREADS.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_set_ctx_build_threads(struct rte_acl_ctx *ctx, uint32_t num_threads);
+
 /**
  * Dump an ACL context structure to the console.
  *
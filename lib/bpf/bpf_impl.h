@@ -6,6 +6,8 @@
 #define BPF_IMPL_H
 
 #include <rte_bpf.h>
+#include <rte_bpf_map.h>
+#include <rte_spinlock.h>
 #include <sys/mman.h>
 
 #define MAX_BPF_STACK_SIZE	0x200
@@ -13,10 +15,27 @@
 struct rte_bpf {
 	struct rte_bpf_prm prm;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	size_t sz;
 	uint32_t stack_sz;
 };
 
+struct rte_bpf_map {
+	char name[RTE_BPF_MAP_NAMESIZE];
+	enum rte_bpf_map_type type;
+	uint32_t key_size;
+	uint32_t value_size;
+	uint32_t max_entries;
+	uint32_t elem_size;     /* value size aligned to 8 bytes */
+	size_t lcore_size;      /* size of the values of an lcore */
+	struct rte_hash *hash;  /* keys of hash map */
+	rte_spinlock_t lock;    /* serializes hash map insertions/deletions */
+	struct rte_rcu_qsbr_dq *dq; /* deleted hash map elements */
+	uint32_t nb_free;
+	void **free_elems;      /* free values of hash map */
+	uint8_t *values;
+};
+
 /*
  * Use '__rte' prefix for non-static internal functions
  * to avoid potential name conflict with other libraries.
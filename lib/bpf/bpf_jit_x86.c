@@ -96,6 +96,20 @@ enum {
  */
 static const uint32_t save_regs[] = {RBX, R12, R13, R14, R15, RBP};
 
+/*
+ * burst mode: the loop state is kept on the stack right above the eBPF
+ * stack (i.e. at positive offsets from RBP), while R12 (not used by
+ * the eBPF registers mapping) holds the number of contexts left.
+ */
+enum {
+	BURST_CTX_OFS = 0,  /* pointer to the current context in ctx[] */
+	BURST_RC_OFS = 8,   /* pointer to the current return value in rc[] */
+	BURST_NUM_OFS = 16, /* total number of contexts */
+	BURST_STATE_SZ = 24,
+};
+
+#define REG_BURST_LEFT	R12
+
 struct bpf_jit_state {
 	uint32_t idx;
 	size_t sz;
@@ -106,6 +120,12 @@ struct bpf_jit_state {
 	struct {
 		uint32_t stack_ofs;
 	} ldmb;
+	struct {
+		uint32_t on;      /* generate code for a burst of contexts */
+		int32_t loop_off; /* offset of the loop head */
+		int32_t body_off; /* offset of the eBPF code */
+		int32_t done_off; /* offset of the loop end */
+	} burst;
 	uint32_t reguse;
 	int32_t *off;
 	uint8_t *ins;
@@ -690,6 +710,23 @@ emit_call(struct bpf_jit_state *st, uintptr_t trg)
 	emit_modregrm(st, MOD_DIRECT, mods, RAX);
 }
 
+/*
+ * emit prefetcht0 (%<reg>)
+ */
+static void
+emit_prefetch(struct bpf_jit_state *st, uint32_t reg)
+{
+	const uint8_t ops[] = {0x0F, 0x18};
+	const uint8_t mods = 1;
+
+	/* RSP/R12 and RBP/R13 would need a SIB byte or a displacement */
+	RTE_VERIFY((reg & 7) != RSP && (reg & 7) != RBP);
+
+	emit_rex(st, 0, 0, reg);
+	emit_bytes(st, ops, sizeof(ops));
+	emit_modregrm(st, MOD_INDIRECT, mods, reg);
+}
+
 /*
  * emit jmp <ofs>
  * where 'ofs' is the target offset for the native code.
@@ -1190,25 +1227,36 @@ emit_ld_mbuf(struct bpf_jit_state *st, uint32_t op, uint32_t sreg, uint32_t imm)
 	emit_ldmb_fin(st, rg[EBPF_REG_0], opsz, sz);
 }
 
+/*
+ * size of the burst mode loop state on the stack.
+ */
+static int32_t
+burst_state_size(const struct bpf_jit_state *st)
+{
+	return (st->burst.on != 0) ? BURST_STATE_SZ : 0;
+}
+
 static void
 emit_prolog(struct bpf_jit_state *st, int32_t stack_size)
 {
 	uint32_t i;
-	int32_t spil, ofs;
+	int32_t spil, ofs, sofs;
 
 	spil = 0;
 	for (i = 0; i != RTE_DIM(save_regs); i++)
 		spil += INUSE(st->reguse, save_regs[i]);
 
+	sofs = burst_state_size(st);
+
 	/* we can avoid touching the stack at all */
-	if (spil == 0)
+	if (spil == 0 && sofs == 0)
 		return;
 
 
 	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP,
-		spil * sizeof(uint64_t));
+		spil * sizeof(uint64_t) + sofs);
 
-	ofs = 0;
+	ofs = sofs;
 	for (i = 0; i != RTE_DIM(save_regs); i++) {
 		if (INUSE(st->reguse, save_regs[i]) != 0) {
 			emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW,
@@ -1217,6 +1265,18 @@ emit_prolog(struct bpf_jit_state *st, int32_t stack_size)
 		}
 	}
 
+	/* save burst arguments: ctx (RDI), rc (RSI), num (EDX) */
+	if (sofs != 0) {
+		emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDI, RSP,
+			BURST_CTX_OFS);
+		emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RSI, RSP,
+			BURST_RC_OFS);
+		emit_st_reg(st, BPF_STX | BPF_MEM | BPF_W, RDX, RSP,
+			BURST_NUM_OFS);
+		emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, RDX,
+			REG_BURST_LEFT);
+	}
+
 	if (INUSE(st->reguse, RBP) != 0) {
 		emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RSP, RBP);
 		emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP, stack_size);
@@ -1234,32 +1294,28 @@ emit_ret(struct bpf_jit_state *st)
 	emit_bytes(st, &ops, sizeof(ops));
 }
 
+/*
+ * restore callee saved registers and return.
+ */
 static void
-emit_epilog(struct bpf_jit_state *st)
+emit_restore(struct bpf_jit_state *st)
 {
 	uint32_t i;
-	int32_t spil, ofs;
-
-	/* if we already have an epilog generate a jump to it */
-	if (st->exit.num++ != 0) {
-		emit_abs_jmp(st, st->exit.off);
-		return;
-	}
-
-	/* store offset of epilog block */
-	st->exit.off = st->sz;
+	int32_t spil, ofs, sofs;
 
 	spil = 0;
 	for (i = 0; i != RTE_DIM(save_regs); i++)
 		spil += INUSE(st->reguse, save_regs[i]);
 
-	if (spil != 0) {
+	sofs = burst_state_size(st);
+
+	if (spil != 0 || sofs != 0) {
 
 		if (INUSE(st->reguse, RBP) != 0)
 			emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X,
 				RBP, RSP);
 
-		ofs = 0;
+		ofs = sofs;
 		for (i = 0; i != RTE_DIM(save_regs); i++) {
 			if (INUSE(st->reguse, save_regs[i]) != 0) {
 				emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW,
@@ -1269,12 +1325,96 @@ emit_epilog(struct bpf_jit_state *st)
 		}
 
 		emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RSP,
-			spil * sizeof(uint64_t));
+			spil * sizeof(uint64_t) + sofs);
 	}
 
 	emit_ret(st);
 }
 
+/*
+ * burst mode: generates the loop head, that loads the next context into R1
+ * and prefetches the one after it:
+ * loop:
+ *   if (left == 0)
+ *      goto done;
+ *   R1 = *ctx;
+ *   if (left != 1)
+ *      prefetch(ctx[1]);
+ */
+static void
+emit_burst_head(struct bpf_jit_state *st)
+{
+	st->burst.loop_off = st->sz;
+
+	emit_cmp_imm(st, EBPF_ALU64, REG_BURST_LEFT, 0);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->burst.done_off);
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, RAX, BURST_CTX_OFS);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RAX, RDI, 0);
+
+	emit_cmp_imm(st, EBPF_ALU64, REG_BURST_LEFT, 1);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->burst.body_off);
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RAX, RAX,
+		sizeof(void *));
+	emit_prefetch(st, RAX);
+
+	st->burst.body_off = st->sz;
+}
+
+/*
+ * burst mode: generates the code executed on program exit,
+ * that stores the return value and moves to the next context:
+ *   *rc++ = R0;
+ *   ctx++;
+ *   left--;
+ *   goto loop;
+ */
+static void
+emit_burst_next(struct bpf_jit_state *st)
+{
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, RDX, BURST_RC_OFS);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RAX, RDX, 0);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RDX, sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDX, RBP, BURST_RC_OFS);
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, RDX, BURST_CTX_OFS);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RDX, sizeof(void *));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDX, RBP, BURST_CTX_OFS);
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, REG_BURST_LEFT, 1);
+	emit_abs_jmp(st, st->burst.loop_off);
+}
+
+/*
+ * burst mode: generates the loop end, that returns number of contexts.
+ */
+static void
+emit_burst_done(struct bpf_jit_state *st)
+{
+	st->burst.done_off = st->sz;
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | BPF_W, RBP, RAX, BURST_NUM_OFS);
+	emit_restore(st);
+}
+
+static void
+emit_epilog(struct bpf_jit_state *st)
+{
+	/* if we already have an epilog generate a jump to it */
+	if (st->exit.num++ != 0) {
+		emit_abs_jmp(st, st->exit.off);
+		return;
+	}
+
+	/* store offset of epilog block */
+	st->exit.off = st->sz;
+
+	if (st->burst.on != 0)
+		emit_burst_next(st);
+	else
+		emit_restore(st);
+}
+
 /*
  * walk through bpf code and translate them x86_64 one.
  */
@@ -1289,8 +1429,17 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	st->exit.num = 0;
 	st->ldmb.stack_ofs = bpf->stack_sz;
 
+	/* loop state is addressed through RBP and kept in R12 */
+	if (st->burst.on != 0) {
+		USED(st->reguse, RBP);
+		USED(st->reguse, REG_BURST_LEFT);
+	}
+
 	emit_prolog(st, bpf->stack_sz);
 
+	if (st->burst.on != 0)
+		emit_burst_head(st);
+
 	for (i = 0; i != bpf->prm.nb_ins; i++) {
 
 		st->idx = i;
@@ -1483,14 +1632,19 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 		}
 	}
 
+	if (st->burst.on != 0)
+		emit_burst_done(st);
+
 	return 0;
 }
 
 /*
- * produce a native ISA version of the given BPF code.
+ * produce a native ISA version of the given BPF code,
+ * either for one context or for a burst of them.
  */
-int
-__rte_bpf_jit_x86(struct rte_bpf *bpf)
+static int
+bpf_jit_x86_gen(const struct rte_bpf *bpf, uint32_t burst, void **func,
+	size_t *fsz)
 {
 	int32_t rc;
 	uint32_t i;
@@ -1508,6 +1662,11 @@ __rte_bpf_jit_x86(struct rte_bpf *bpf)
 	for (i = 0; i != bpf->prm.nb_ins; i++)
 		st.off[i] = INT32_MAX;
 
+	st.burst.on = burst;
+	st.burst.loop_off = INT32_MAX;
+	st.burst.body_off = INT32_MAX;
+	st.burst.done_off = INT32_MAX;
+
 	/*
 	 * dry runs, used to calculate total code size and valid jump offsets.
 	 * stop when we get minimal possible size
@@ -1535,10 +1694,37 @@ __rte_bpf_jit_x86(struct rte_bpf *bpf)
 	if (rc != 0)
 		munmap(st.ins, st.sz);
 	else {
-		bpf->jit.func = (void *)st.ins;
-		bpf->jit.sz = st.sz;
+		*func = st.ins;
+		*fsz = st.sz;
 	}
 
 	free(st.off);
 	return rc;
 }
+
+int
+__rte_bpf_jit_x86(struct rte_bpf *bpf)
+{
+	int32_t rc;
+	void *func;
+	size_t sz;
+
+	rc = bpf_jit_x86_gen(bpf, 0, &func, &sz);
+	if (rc != 0)
+		return rc;
+
+	bpf->jit.func = func;
+	bpf->jit.sz = sz;
+
+	/* burst version is optional, the single context one is enough */
+	rc = bpf_jit_x86_gen(bpf, 1, &func, &sz);
+	if (rc == 0) {
+		bpf->jit_burst.func = func;
+		bpf->jit_burst.sz = sz;
+	} else
+		RTE_BPF_LOG_LINE(WARNING,
+			"%s(%p): burst JIT failed, error code: %d;",
+			__func__, bpf, rc);
+
+	return 0;
+}
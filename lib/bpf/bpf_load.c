@@ -58,6 +58,9 @@ bpf_check_xsym(const struct rte_bpf_xsym *xsym)
 	if (xsym->type == RTE_BPF_XTYPE_VAR) {
 		if (xsym->var.desc.type == RTE_BPF_ARG_UNDEF)
 			return -EINVAL;
+	} else if (xsym->type == RTE_BPF_XTYPE_MAP) {
+		if (xsym->map.val == NULL)
+			return -EINVAL;
 	} else if (xsym->type == RTE_BPF_XTYPE_FUNC) {
 
 		if (xsym->func.nb_args > EBPF_FUNC_MAX_ARGS)
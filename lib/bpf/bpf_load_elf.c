@@ -58,6 +58,7 @@ resolve_xsym(const char *sn, size_t ofs, struct ebpf_insn *ins, size_t ins_sz,
 	const struct rte_bpf_prm *prm)
 {
 	uint32_t idx, fidx;
+	uintptr_t addr;
 	enum rte_bpf_xtype type;
 
 	if (ofs % sizeof(ins[0]) != 0 || ofs >= ins_sz)
@@ -73,6 +74,13 @@ resolve_xsym(const char *sn, size_t ofs, struct ebpf_insn *ins, size_t ins_sz,
 		return -EINVAL;
 
 	fidx = bpf_find_xsym(sn, type, prm->xsym, prm->nb_xsym);
+
+	/* map is referenced by its address, as a variable */
+	if (fidx == UINT32_MAX && type == RTE_BPF_XTYPE_VAR) {
+		type = RTE_BPF_XTYPE_MAP;
+		fidx = bpf_find_xsym(sn, type, prm->xsym, prm->nb_xsym);
+	}
+
 	if (fidx == UINT32_MAX)
 		return -ENOENT;
 
@@ -90,11 +98,14 @@ resolve_xsym(const char *sn, size_t ofs, struct ebpf_insn *ins, size_t ins_sz,
 			ins[idx].src_reg = EBPF_REG_0;
 		}
 		ins[idx].imm = fidx;
-	/* for variable we need to store its absolute address */
+	/* for variable or map we need to store its absolute address */
 	} else {
-		ins[idx].imm = (uintptr_t)prm->xsym[fidx].var.val;
-		ins[idx + 1].imm =
-			(uint64_t)(uintptr_t)prm->xsym[fidx].var.val >> 32;
+		if (type == RTE_BPF_XTYPE_VAR)
+			addr = (uintptr_t)prm->xsym[fidx].var.val;
+		else
+			addr = (uintptr_t)prm->xsym[fidx].map.val;
+		ins[idx].imm = addr;
+		ins[idx + 1].imm = (uint64_t)addr >> 32;
 	}
 
 	return 0;
@@ -0,0 +1,781 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <sys/queue.h>
+
+#include <rte_common.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_string_fns.h>
+#include <rte_tailq.h>
+#include <rte_telemetry.h>
+
+#include "bpf_impl.h"
+
+TAILQ_HEAD(rte_bpf_map_list, rte_tailq_entry);
+static struct rte_tailq_elem rte_bpf_map_tailq = {
+	.name = "RTE_BPF_MAP",
+};
+EAL_REGISTER_TAILQ(rte_bpf_map_tailq)
+
+/* update the values of all lcores of a per-lcore array */
+#define MAP_ALL_LCORES	RTE_MAX_LCORE
+
+/* minimum size of a hash table, the map size is bounded by its values */
+#define MAP_HASH_MIN_ENTRIES	8u
+
+/* hash map element waiting for the readers to be done with it */
+struct map_dq_entry {
+	void *elem;
+	int32_t pos;
+};
+
+static struct rte_bpf_map *
+map_find(const char *name)
+{
+	struct rte_bpf_map *map;
+	struct rte_tailq_entry *te;
+	struct rte_bpf_map_list *map_list;
+
+	map_list = RTE_TAILQ_CAST(rte_bpf_map_tailq.head, rte_bpf_map_list);
+
+	TAILQ_FOREACH(te, map_list, next) {
+		map = te->data;
+		if (strncmp(name, map->name, RTE_BPF_MAP_NAMESIZE) == 0)
+			return map;
+	}
+
+	return NULL;
+}
+
+static int
+map_check_prm(const struct rte_bpf_map_prm *prm)
+{
+	if (prm == NULL || prm->name == NULL || prm->name[0] == '\0' ||
+			strnlen(prm->name, RTE_BPF_MAP_NAMESIZE) ==
+			RTE_BPF_MAP_NAMESIZE ||
+			prm->key_size == 0 || prm->value_size == 0 ||
+			prm->max_entries == 0)
+		return -EINVAL;
+
+	switch (prm->type) {
+	case RTE_BPF_MAP_TYPE_ARRAY:
+	case RTE_BPF_MAP_TYPE_LCORE_ARRAY:
+		/* arrays are indexed by a 32-bit key */
+		if (prm->key_size != sizeof(uint32_t))
+			return -EINVAL;
+		break;
+	case RTE_BPF_MAP_TYPE_HASH:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static struct rte_hash *
+map_hash_create(const struct rte_bpf_map_prm *prm)
+{
+	char name[RTE_HASH_NAMESIZE];
+	struct rte_hash_parameters hprm = {
+		.name = name,
+		.entries = RTE_MAX(prm->max_entries, MAP_HASH_MIN_ENTRIES),
+		.key_len = prm->key_size,
+		.socket_id = prm->socket_id,
+		/*
+		 * Lookups from the programs are lock-free, insertions
+		 * and deletions are serialized by the map lock.
+		 */
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+			RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+	};
+
+	snprintf(name, sizeof(name), "BPFM_%s", prm->name);
+	return rte_hash_create(&hprm);
+}
+
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm)
+{
+	struct rte_bpf_map *map;
+	struct rte_hash *hash;
+	struct rte_tailq_entry *te;
+	struct rte_bpf_map_list *map_list;
+	uint64_t lcore_size, values_size, sz;
+	uint32_t elem_size, i;
+	int32_t rc;
+
+	rc = map_check_prm(prm);
+	if (rc != 0) {
+		rte_errno = -rc;
+		return NULL;
+	}
+
+	elem_size = RTE_ALIGN_CEIL(prm->value_size, sizeof(uint64_t));
+	lcore_size = (uint64_t)elem_size * prm->max_entries;
+	if (prm->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY) {
+		lcore_size = RTE_ALIGN_CEIL(lcore_size, RTE_CACHE_LINE_SIZE);
+		values_size = lcore_size * RTE_MAX_LCORE;
+	} else
+		values_size = lcore_size;
+
+	/* map header, free values of hash map and values */
+	sz = RTE_ALIGN_CEIL(sizeof(*map), RTE_CACHE_LINE_SIZE);
+	if (prm->type == RTE_BPF_MAP_TYPE_HASH)
+		sz += RTE_ALIGN_CEIL((uint64_t)prm->max_entries *
+			sizeof(map->free_elems[0]), RTE_CACHE_LINE_SIZE);
+	sz += values_size;
+	if (sz > SIZE_MAX) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* the hash table registers itself in the tailq lists */
+	hash = NULL;
+	if (prm->type == RTE_BPF_MAP_TYPE_HASH) {
+		hash = map_hash_create(prm);
+		if (hash == NULL) {
+			RTE_BPF_LOG_LINE(ERR, "%s(%s): failed to create hash table",
+				__func__, prm->name);
+			return NULL;
+		}
+	}
+
+	map_list = RTE_TAILQ_CAST(rte_bpf_map_tailq.head, rte_bpf_map_list);
+
+	rte_mcfg_tailq_write_lock();
+
+	map = NULL;
+	if (map_find(prm->name) != NULL) {
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	te = rte_zmalloc("BPF_MAP_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	map = rte_zmalloc_socket("BPF_MAP", sz, RTE_CACHE_LINE_SIZE,
+		prm->socket_id);
+	if (map == NULL) {
+		RTE_BPF_LOG_LINE(ERR, "%s(%s): failed to allocate %" PRIu64
+			" bytes", __func__, prm->name, sz);
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	rte_strlcpy(map->name, prm->name, sizeof(map->name));
+	map->type = prm->type;
+	map->key_size = prm->key_size;
+	map->value_size = prm->value_size;
+	map->max_entries = prm->max_entries;
+	map->elem_size = elem_size;
+	map->lcore_size = lcore_size;
+	map->hash = hash;
+	rte_spinlock_init(&map->lock);
+	map->values = RTE_PTR_ADD(map, sz - values_size);
+
+	if (prm->type == RTE_BPF_MAP_TYPE_HASH) {
+		map->free_elems = RTE_PTR_ADD(map,
+			RTE_ALIGN_CEIL(sizeof(*map), RTE_CACHE_LINE_SIZE));
+		for (i = 0; i != prm->max_entries; i++)
+			map->free_elems[i] = map->values +
+				(size_t)(prm->max_entries - i - 1) * elem_size;
+		map->nb_free = prm->max_entries;
+	}
+
+	te->data = map;
+	TAILQ_INSERT_TAIL(map_list, te, next);
+
+	rte_mcfg_tailq_write_unlock();
+
+	return map;
+
+exit:
+	rte_mcfg_tailq_write_unlock();
+	rte_hash_free(hash);
+	return NULL;
+}
+
+void
+rte_bpf_map_free(struct rte_bpf_map *map)
+{
+	struct rte_tailq_entry *te;
+	struct rte_bpf_map_list *map_list;
+
+	if (map == NULL)
+		return;
+
+	map_list = RTE_TAILQ_CAST(rte_bpf_map_tailq.head, rte_bpf_map_list);
+
+	rte_mcfg_tailq_write_lock();
+
+	TAILQ_FOREACH(te, map_list, next) {
+		if (te->data == map)
+			break;
+	}
+	if (te != NULL)
+		TAILQ_REMOVE(map_list, te, next);
+
+	rte_mcfg_tailq_write_unlock();
+
+	rte_free(te);
+	rte_rcu_qsbr_dq_delete(map->dq);
+	rte_hash_free(map->hash);
+	rte_free(map);
+}
+
+/* give the key and value of a deleted hash map element back */
+static void
+map_hash_free_elem(struct rte_bpf_map *map, void *elem, int32_t pos)
+{
+	rte_hash_free_key_with_position(map->hash, pos);
+	map->free_elems[map->nb_free++] = elem;
+}
+
+static void
+map_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	const struct map_dq_entry *e = data;
+
+	RTE_SET_USED(n);
+	map_hash_free_elem(p, e->elem, e->pos);
+}
+
+int
+rte_bpf_map_rcu_qsbr_add(struct rte_bpf_map *map, struct rte_rcu_qsbr *v)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (map == NULL || v == NULL || map->type != RTE_BPF_MAP_TYPE_HASH)
+		return -EINVAL;
+
+	if (map->dq != NULL)
+		return -EEXIST;
+
+	/*
+	 * The queue holds every element at most once, so it never fills up.
+	 * The reclamation is triggered by the insertions into a full map.
+	 */
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "BPFM_%s", map->name);
+	params.name = rcu_dq_name;
+	params.size = map->max_entries;
+	params.trigger_reclaim_limit = map->max_entries + 1;
+	params.max_reclaim_size = map->max_entries;
+	params.esize = sizeof(struct map_dq_entry);
+	params.free_fn = map_rcu_qsbr_free_resource;
+	params.p = map;
+	params.v = v;
+	/* the queue is accessed under the map lock */
+	params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+
+	map->dq = rte_rcu_qsbr_dq_create(&params);
+	if (map->dq == NULL) {
+		RTE_BPF_LOG_LINE(ERR, "%s(%s): failed to create defer queue",
+			__func__, map->name);
+		return -rte_errno;
+	}
+
+	return 0;
+}
+
+struct rte_bpf_map *
+rte_bpf_map_find(const char *name)
+{
+	struct rte_bpf_map *map;
+
+	if (name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_mcfg_tailq_read_lock();
+	map = map_find(name);
+	rte_mcfg_tailq_read_unlock();
+
+	if (map == NULL)
+		rte_errno = ENOENT;
+
+	return map;
+}
+
+int
+rte_bpf_map_info_get(const struct rte_bpf_map *map,
+	struct rte_bpf_map_info *info)
+{
+	if (map == NULL || info == NULL)
+		return -EINVAL;
+
+	rte_strlcpy(info->name, map->name, sizeof(info->name));
+	info->type = map->type;
+	info->key_size = map->key_size;
+	info->value_size = map->value_size;
+	info->max_entries = map->max_entries;
+	if (map->type == RTE_BPF_MAP_TYPE_HASH)
+		info->nb_entries = rte_hash_count(map->hash);
+	else
+		info->nb_entries = map->max_entries;
+
+	return 0;
+}
+
+static inline uint8_t *
+map_array_elem(const struct rte_bpf_map *map, uint32_t idx,
+	unsigned int lcore_id)
+{
+	uint8_t *values;
+
+	values = map->values;
+	if (map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY)
+		values += lcore_id * map->lcore_size;
+
+	return values + (size_t)idx * map->elem_size;
+}
+
+static inline void *
+map_lookup(const struct rte_bpf_map *map, const void *key,
+	unsigned int lcore_id)
+{
+	uint32_t idx;
+	void *elem;
+
+	if (map->type == RTE_BPF_MAP_TYPE_HASH) {
+		if (rte_hash_lookup_data(map->hash, key, &elem) < 0)
+			return NULL;
+		return elem;
+	}
+
+	memcpy(&idx, key, sizeof(idx));
+	if (idx >= map->max_entries ||
+			(map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY &&
+			lcore_id >= RTE_MAX_LCORE))
+		return NULL;
+
+	return map_array_elem(map, idx, lcore_id);
+}
+
+static int
+map_hash_insert(struct rte_bpf_map *map, const void *key, const void *value,
+	uint64_t flags)
+{
+	void *elem;
+	int32_t rc;
+
+	rte_spinlock_lock(&map->lock);
+
+	/* the element may have been inserted meanwhile */
+	rc = rte_hash_lookup_data(map->hash, key, &elem);
+	if (rc >= 0) {
+		if (flags == RTE_BPF_MAP_NOEXIST)
+			rc = -EEXIST;
+		else {
+			memcpy(elem, value, map->value_size);
+			rc = 0;
+		}
+		goto exit;
+	}
+
+	/* reclaim the deleted elements the readers are done with */
+	if (map->nb_free == 0 && map->dq != NULL)
+		rte_rcu_qsbr_dq_reclaim(map->dq, map->max_entries,
+			NULL, NULL, NULL);
+
+	if (map->nb_free == 0)
+		rc = -ENOSPC;
+	else {
+		/* fill the value before the key is visible to the lookups */
+		elem = map->free_elems[map->nb_free - 1];
+		memcpy(elem, value, map->value_size);
+		rc = rte_hash_add_key_data(map->hash, key, elem);
+		if (rc == 0)
+			map->nb_free--;
+	}
+
+exit:
+	rte_spinlock_unlock(&map->lock);
+	return rc;
+}
+
+static inline int
+map_update(struct rte_bpf_map *map, const void *key, const void *value,
+	uint64_t flags, unsigned int lcore_id)
+{
+	uint32_t i, idx;
+	void *elem;
+
+	if (flags > RTE_BPF_MAP_EXIST)
+		return -EINVAL;
+
+	if (map->type == RTE_BPF_MAP_TYPE_HASH) {
+		/*
+		 * Update of an existing element by a program is lock-free,
+		 * the program being a reader of the element. The application
+		 * updates the element under the lock, serialized with its
+		 * deletion.
+		 */
+		if (lcore_id != MAP_ALL_LCORES &&
+				flags != RTE_BPF_MAP_NOEXIST &&
+				rte_hash_lookup_data(map->hash, key, &elem) >= 0) {
+			memcpy(elem, value, map->value_size);
+			return 0;
+		}
+		if (flags == RTE_BPF_MAP_EXIST)
+			return -ENOENT;
+		return map_hash_insert(map, key, value, flags);
+	}
+
+	memcpy(&idx, key, sizeof(idx));
+	if (idx >= map->max_entries)
+		return -E2BIG;
+	if (flags == RTE_BPF_MAP_NOEXIST)
+		return -EEXIST;
+
+	if (map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY &&
+			lcore_id == MAP_ALL_LCORES) {
+		for (i = 0; i != RTE_MAX_LCORE; i++)
+			memcpy(map_array_elem(map, idx, i), value,
+				map->value_size);
+		return 0;
+	}
+
+	if (map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY &&
+			lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	memcpy(map_array_elem(map, idx, lcore_id), value, map->value_size);
+	return 0;
+}
+
+static inline int
+map_delete(struct rte_bpf_map *map, const void *key)
+{
+	void *elem;
+	int32_t rc;
+
+	if (map->type != RTE_BPF_MAP_TYPE_HASH)
+		return -EINVAL;
+
+	rte_spinlock_lock(&map->lock);
+
+	rc = rte_hash_lookup_data(map->hash, key, &elem);
+	if (rc >= 0) {
+		/*
+		 * Lock-free hash tables don't free the key on delete.
+		 * The key and value are freed once the readers are done
+		 * with them if a QSBR variable is attached, right away
+		 * otherwise.
+		 */
+		rc = rte_hash_del_key(map->hash, key);
+		if (map->dq == NULL)
+			map_hash_free_elem(map, elem, rc);
+		else if (rte_rcu_qsbr_dq_enqueue(map->dq,
+				&(struct map_dq_entry){ elem, rc }) != 0)
+			RTE_BPF_LOG_LINE(ERR, "%s(%s): failed to defer freeing",
+				__func__, map->name);
+		rc = 0;
+	}
+
+	rte_spinlock_unlock(&map->lock);
+	return rc;
+}
+
+void *
+rte_bpf_map_lookup_elem(const struct rte_bpf_map *map, const void *key)
+{
+	if (map == NULL || key == NULL)
+		return NULL;
+
+	return map_lookup(map, key, rte_lcore_id());
+}
+
+void *
+rte_bpf_map_lookup_lcore_elem(const struct rte_bpf_map *map, const void *key,
+	unsigned int lcore_id)
+{
+	if (map == NULL || key == NULL)
+		return NULL;
+
+	return map_lookup(map, key, lcore_id);
+}
+
+int
+rte_bpf_map_update_elem(struct rte_bpf_map *map, const void *key,
+	const void *value, uint64_t flags)
+{
+	if (map == NULL || key == NULL || value == NULL)
+		return -EINVAL;
+
+	return map_update(map, key, value, flags, MAP_ALL_LCORES);
+}
+
+int
+rte_bpf_map_delete_elem(struct rte_bpf_map *map, const void *key)
+{
+	if (map == NULL || key == NULL)
+		return -EINVAL;
+
+	return map_delete(map, key);
+}
+
+int
+rte_bpf_map_iterate(const struct rte_bpf_map *map, void *key, uint32_t *next)
+{
+	const void *k;
+	void *data;
+	int32_t rc;
+
+	if (map == NULL || key == NULL || next == NULL)
+		return -EINVAL;
+
+	if (map->type == RTE_BPF_MAP_TYPE_HASH) {
+		rc = rte_hash_iterate(map->hash, &k, &data, next);
+		if (rc < 0)
+			return rc;
+		memcpy(key, k, map->key_size);
+		return 0;
+	}
+
+	if (*next >= map->max_entries)
+		return -ENOENT;
+
+	memcpy(key, next, sizeof(*next));
+	(*next)++;
+	return 0;
+}
+
+/*
+ * Helper functions called by the eBPF programs.
+ * The arguments are checked by the verifier, the per-lcore arrays
+ * are accessed for the lcore the program runs on.
+ */
+
+uint64_t
+rte_bpf_map_helper_lookup_elem(uint64_t map, uint64_t key,
+	uint64_t arg3 __rte_unused, uint64_t arg4 __rte_unused,
+	uint64_t arg5 __rte_unused)
+{
+	return (uintptr_t)map_lookup((const struct rte_bpf_map *)(uintptr_t)map,
+		(const void *)(uintptr_t)key, rte_lcore_id());
+}
+
+uint64_t
+rte_bpf_map_helper_update_elem(uint64_t map, uint64_t key, uint64_t value,
+	uint64_t flags, uint64_t arg5 __rte_unused)
+{
+	return (int64_t)map_update((struct rte_bpf_map *)(uintptr_t)map,
+		(const void *)(uintptr_t)key, (const void *)(uintptr_t)value,
+		flags, rte_lcore_id());
+}
+
+uint64_t
+rte_bpf_map_helper_delete_elem(uint64_t map, uint64_t key,
+	uint64_t arg3 __rte_unused, uint64_t arg4 __rte_unused,
+	uint64_t arg5 __rte_unused)
+{
+	return (int64_t)map_delete((struct rte_bpf_map *)(uintptr_t)map,
+		(const void *)(uintptr_t)key);
+}
+
+static const char *
+map_type_name(enum rte_bpf_map_type type)
+{
+	switch (type) {
+	case RTE_BPF_MAP_TYPE_ARRAY:
+		return "array";
+	case RTE_BPF_MAP_TYPE_HASH:
+		return "hash";
+	case RTE_BPF_MAP_TYPE_LCORE_ARRAY:
+		return "lcore_array";
+	}
+	return "unknown";
+}
+
+static int
+map_handle_list(const char *cmd __rte_unused, const char *params __rte_unused,
+	struct rte_tel_data *d)
+{
+	const struct rte_bpf_map *map;
+	struct rte_tailq_entry *te;
+	struct rte_bpf_map_list *map_list;
+
+	map_list = RTE_TAILQ_CAST(rte_bpf_map_tailq.head, rte_bpf_map_list);
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+
+	rte_mcfg_tailq_read_lock();
+	TAILQ_FOREACH(te, map_list, next) {
+		map = te->data;
+		rte_tel_data_add_array_string(d, map->name);
+	}
+	rte_mcfg_tailq_read_unlock();
+
+	return 0;
+}
+
+static int
+map_handle_info(const char *cmd __rte_unused, const char *params,
+	struct rte_tel_data *d)
+{
+	struct rte_bpf_map_info info;
+	const struct rte_bpf_map *map;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	map = rte_bpf_map_find(params);
+	if (map == NULL || rte_bpf_map_info_get(map, &info) != 0)
+		return -EINVAL;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", info.name);
+	rte_tel_data_add_dict_string(d, "type", map_type_name(info.type));
+	rte_tel_data_add_dict_uint(d, "key_size", info.key_size);
+	rte_tel_data_add_dict_uint(d, "value_size", info.value_size);
+	rte_tel_data_add_dict_uint(d, "max_entries", info.max_entries);
+	rte_tel_data_add_dict_uint(d, "nb_entries", info.nb_entries);
+
+	return 0;
+}
+
+/* key of an element as a telemetry name: integer keys in decimal */
+static void
+map_key_name(const struct rte_bpf_map *map, const void *key, char *name,
+	size_t size)
+{
+	const uint8_t *k = key;
+	uint32_t i, n;
+	union {
+		uint8_t u8;
+		uint16_t u16;
+		uint32_t u32;
+		uint64_t u64;
+	} v;
+
+	memcpy(&v, key, RTE_MIN(sizeof(v), map->key_size));
+	switch (map->key_size) {
+	case sizeof(uint8_t):
+		snprintf(name, size, "%u", v.u8);
+		return;
+	case sizeof(uint16_t):
+		snprintf(name, size, "%u", v.u16);
+		return;
+	case sizeof(uint32_t):
+		snprintf(name, size, "%u", v.u32);
+		return;
+	case sizeof(uint64_t):
+		snprintf(name, size, "%" PRIu64, v.u64);
+		return;
+	}
+
+	n = snprintf(name, size, "0x");
+	for (i = 0; i != map->key_size && n + 2 < size; i++)
+		n += snprintf(name + n, size - n, "%02x", k[i]);
+}
+
+/*
+ * Add the value of an element, as 64-bit words summed over
+ * the lcores for per-lcore arrays.
+ */
+static int
+map_add_value(const struct rte_bpf_map *map, const void *key,
+	struct rte_tel_data *d, const char *name, uint64_t *sum, uint64_t *w)
+{
+	struct rte_tel_data *words;
+	const void *value;
+	uint32_t i, j, nb_lcores, nb_words;
+
+	nb_words = map->elem_size / sizeof(uint64_t);
+	memset(sum, 0, map->elem_size);
+
+	nb_lcores = map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY ?
+		RTE_MAX_LCORE : 1;
+	for (i = 0; i != nb_lcores; i++) {
+		if (map->type == RTE_BPF_MAP_TYPE_LCORE_ARRAY &&
+				rte_eal_lcore_role(i) == ROLE_OFF)
+			continue;
+		value = map_lookup(map, key, i);
+		if (value == NULL)
+			return -ENOENT;
+		memset(w, 0, map->elem_size);
+		memcpy(w, value, map->value_size);
+		for (j = 0; j != nb_words; j++)
+			sum[j] += w[j];
+	}
+
+	if (nb_words == 1)
+		return rte_tel_data_add_dict_uint(d, name, sum[0]);
+
+	words = rte_tel_data_alloc();
+	if (words == NULL)
+		return -ENOMEM;
+	rte_tel_data_start_array(words, RTE_TEL_UINT_VAL);
+	for (j = 0; j != nb_words; j++)
+		rte_tel_data_add_array_uint(words, sum[j]);
+
+	return rte_tel_data_add_dict_container(d, name, words, 0);
+}
+
+static int
+map_handle_dump(const char *cmd __rte_unused, const char *params,
+	struct rte_tel_data *d)
+{
+	char name[RTE_TEL_MAX_STRING_LEN];
+	const struct rte_bpf_map *map;
+	uint32_t n, next;
+	uint64_t *sum;
+	void *key;
+
+	if (params == NULL || strlen(params) == 0)
+		return -EINVAL;
+
+	map = rte_bpf_map_find(params);
+	if (map == NULL)
+		return -EINVAL;
+
+	/* key, values sum and one value */
+	key = malloc(RTE_ALIGN_CEIL(map->key_size, sizeof(uint64_t)) +
+		2 * map->elem_size);
+	if (key == NULL)
+		return -ENOMEM;
+	sum = RTE_PTR_ADD(key, RTE_ALIGN_CEIL(map->key_size, sizeof(uint64_t)));
+
+	rte_tel_data_start_dict(d);
+
+	next = 0;
+	for (n = 0; n != RTE_TEL_MAX_DICT_ENTRIES &&
+			rte_bpf_map_iterate(map, key, &next) == 0; n++) {
+		map_key_name(map, key, name, sizeof(name));
+		map_add_value(map, key, d, name, sum,
+			sum + map->elem_size / sizeof(uint64_t));
+	}
+
+	free(key);
+	return 0;
+}
+
+RTE_INIT(bpf_map_init_telemetry)
+{
+	rte_telemetry_register_cmd("/bpf/map/list", map_handle_list,
+		"Returns list of BPF map names.");
+	rte_telemetry_register_cmd("/bpf/map/info", map_handle_info,
+		"Returns BPF map information. Parameters: string map_name");
+	rte_telemetry_register_cmd("/bpf/map/dump", map_handle_dump,
+		"Returns BPF map elements, values are summed over lcores for "
+		"per-lcore arrays. Parameters: string map_name");
+}
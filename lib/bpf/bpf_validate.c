@@ -14,6 +14,8 @@
 #include "bpf_impl.h"
 
 #define BPF_ARG_PTR_STACK RTE_BPF_ARG_RESERVED
+/* map value pointer, can't be dereferenced until checked against NULL */
+#define BPF_ARG_PTR_OR_NULL (RTE_BPF_ARG_RAW + 1)
 
 struct bpf_reg_val {
 	struct rte_bpf_arg v;
@@ -671,6 +673,9 @@ eval_alu(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	if (err != NULL)
 		return err;
 
+	if (op != EBPF_MOV && rd->v.type == BPF_ARG_PTR_OR_NULL)
+		return "arithmetic on pointer that may be NULL";
+
 	if (op == BPF_ADD)
 		eval_add(rd, &rs, msk);
 	else if (op == BPF_SUB)
@@ -969,6 +974,99 @@ eval_func_arg(struct bpf_verifier *bvf, const struct rte_bpf_arg *arg,
 	return err;
 }
 
+/*
+ * find the map whose address is loaded in the register.
+ */
+static const struct rte_bpf_map *
+eval_map_ref(const struct bpf_verifier *bvf, const struct bpf_reg_val *rv)
+{
+	uint32_t i;
+
+	if (rv->v.type != RTE_BPF_ARG_RAW || rv->mask != UINT64_MAX ||
+			rv->u.min != rv->u.max)
+		return NULL;
+
+	for (i = 0; i != bvf->prm->nb_xsym; i++) {
+		if (bvf->prm->xsym[i].type == RTE_BPF_XTYPE_MAP &&
+				(uintptr_t)bvf->prm->xsym[i].map.val ==
+				rv->u.max)
+			return bvf->prm->xsym[i].map.val;
+	}
+
+	return NULL;
+}
+
+/*
+ * check key or value passed to a map helper, which reads it.
+ */
+static const char *
+eval_map_arg(struct bpf_verifier *bvf, const struct bpf_reg_val *rv,
+	uint32_t size)
+{
+	uint32_t i, n;
+	const char *err;
+	struct bpf_reg_val rm;
+
+	if (RTE_BPF_ARG_PTR_TYPE(rv->v.type) == 0)
+		return "map key or value is not a pointer";
+
+	rm = *rv;
+	err = eval_ptr(bvf, &rm, size, 1, 0);
+	if (err != NULL)
+		return err;
+
+	if (rm.v.type == BPF_ARG_PTR_STACK) {
+		n = (rm.u.max + size - 1) / sizeof(uint64_t);
+		for (i = rm.u.max / sizeof(uint64_t); i <= n; i++) {
+			if (bvf->evst->sv[i].v.type == RTE_BPF_ARG_UNDEF)
+				return "undefined map key or value on the stack";
+		}
+	}
+
+	return NULL;
+}
+
+static const char *
+eval_map_call(struct bpf_verifier *bvf, const struct rte_bpf_xsym *xsym)
+{
+	uint32_t i;
+	const char *err;
+	struct bpf_reg_val *rv;
+	const struct rte_bpf_map *map;
+
+	rv = bvf->evst->rv;
+
+	map = eval_map_ref(bvf, rv + EBPF_REG_1);
+	if (map == NULL)
+		return "invalid map reference";
+
+	err = eval_map_arg(bvf, rv + EBPF_REG_2, map->key_size);
+	if (err == NULL && xsym->func.val == rte_bpf_map_helper_update_elem) {
+		err = eval_map_arg(bvf, rv + EBPF_REG_3, map->value_size);
+		if (err == NULL)
+			err = eval_defined(NULL, rv + EBPF_REG_4);
+	}
+	if (err != NULL)
+		return err;
+
+	/* R1-R5 argument/scratch registers */
+	for (i = EBPF_REG_1; i != EBPF_REG_6; i++)
+		rv[i].v.type = RTE_BPF_ARG_UNDEF;
+
+	/* lookup returns pointer to the value or NULL, others an error code */
+	if (xsym->func.val == rte_bpf_map_helper_lookup_elem) {
+		rv[EBPF_REG_0].v.type = BPF_ARG_PTR_OR_NULL;
+		rv[EBPF_REG_0].v.size = map->value_size;
+		eval_fill_imm64(rv + EBPF_REG_0, UINTPTR_MAX, 0);
+	} else {
+		rv[EBPF_REG_0].v.type = RTE_BPF_ARG_RAW;
+		rv[EBPF_REG_0].v.size = sizeof(uint64_t);
+		eval_fill_max_bound(rv + EBPF_REG_0, UINT64_MAX);
+	}
+
+	return NULL;
+}
+
 static const char *
 eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
@@ -989,6 +1087,11 @@ eval_call(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 
 	xsym = bvf->prm->xsym + idx;
 
+	if (xsym->func.val == rte_bpf_map_helper_lookup_elem ||
+			xsym->func.val == rte_bpf_map_helper_update_elem ||
+			xsym->func.val == rte_bpf_map_helper_delete_elem)
+		return eval_map_call(bvf, xsym);
+
 	/* evaluate function arguments */
 	err = NULL;
 	for (i = 0; i != xsym->func.nb_args && err == NULL; i++) {
@@ -1073,6 +1176,17 @@ eval_jslt_jsge(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	trd->s.max = RTE_MIN(trd->s.max, trs->s.max - 1);
 }
 
+static void
+eval_null_check(struct bpf_reg_val *nrd, struct bpf_reg_val *prd)
+{
+	/* branch where the pointer is NULL */
+	nrd->v.type = RTE_BPF_ARG_RAW;
+	eval_fill_imm(nrd, UINT64_MAX, 0);
+
+	/* branch where the pointer is valid */
+	prd->v.type = RTE_BPF_ARG_PTR;
+}
+
 static const char *
 eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
@@ -1125,6 +1239,16 @@ eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 	else if (op == EBPF_JSGE)
 		eval_jslt_jsge(frd, frs, trd, trs);
 
+	/* pointer that may be NULL compared against NULL */
+	if (trd->v.type == BPF_ARG_PTR_OR_NULL) {
+		if (BPF_SRC(ins->code) == BPF_K && ins->imm == 0 &&
+				(op == BPF_JEQ || op == EBPF_JNE)) {
+			eval_null_check(op == BPF_JEQ ? trd : frd,
+				op == BPF_JEQ ? frd : trd);
+		} else
+			return "invalid comparison of pointer that may be NULL";
+	}
+
 	return NULL;
 }
 
@@ -17,6 +17,7 @@
  */
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_mbuf.h>
 #include <bpf_def.h>
 
@@ -59,9 +60,12 @@ struct rte_bpf_arg {
  */
 enum rte_bpf_xtype {
 	RTE_BPF_XTYPE_FUNC, /**< function */
-	RTE_BPF_XTYPE_VAR   /**< variable */
+	RTE_BPF_XTYPE_VAR,  /**< variable */
+	RTE_BPF_XTYPE_MAP   /**< map, see rte_bpf_map.h */
 };
 
+struct rte_bpf_map;
+
 /**
  * Definition for external symbols available in the BPF program.
  */
@@ -81,6 +85,9 @@ struct rte_bpf_xsym {
 			void *val; /**< actual memory location */
 			struct rte_bpf_arg desc; /**< type, size, etc. */
 		} var; /**< external variable */
+		struct {
+			struct rte_bpf_map *val; /**< map handle */
+		} map; /**< map */
 	};
 };
 
@@ -104,6 +111,19 @@ struct rte_bpf_jit {
 	size_t sz;                /**< size of JIT-ed code */
 };
 
+/**
+ * Information about compiled into native ISA eBPF code,
+ * that executes the program over a set of input contexts.
+ * The generated code runs the program for each of the *num* contexts of
+ * the *ctx* array in a loop, stores the return values into the *rc* array
+ * and returns the number of processed contexts.
+ */
+struct rte_bpf_jit_burst {
+	/** JIT-ed native code */
+	uint32_t (*func)(void *ctx[], uint64_t rc[], uint32_t num);
+	size_t sz; /**< size of JIT-ed code */
+};
+
 struct rte_bpf;
 
 /**
@@ -198,6 +218,31 @@ rte_bpf_exec_burst(const struct rte_bpf *bpf, void *ctx[], uint64_t rc[],
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Provide information about natively compiled code for given BPF handle,
+ * that executes the program over a set of input contexts.
+ * Compared to calling the function provided by rte_bpf_get_jit()
+ * for each context, it saves the function prologue and epilogue
+ * for each context, and prefetches the next context.
+ * Only available for X86_64 platforms.
+ *
+ * @param bpf
+ *   handle for the BPF code.
+ * @param jit
+ *   pointer to the rte_bpf_jit_burst structure to be filled with related
+ *   data. The func field is NULL if no such code was generated.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_bpf_get_jit_burst(const struct rte_bpf *bpf,
+		struct rte_bpf_jit_burst *jit);
+
 /**
  * Dump epf instructions to a file.
  *
@@ -0,0 +1,385 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _RTE_BPF_MAP_H_
+#define _RTE_BPF_MAP_H_
+
+/**
+ * @file rte_bpf_map.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * eBPF maps.
+ *
+ * A map is a key/value store shared by the eBPF programs and the
+ * application. A map is made available to a program as an external symbol
+ * of type RTE_BPF_XTYPE_MAP, which the program loads with a 64-bit
+ * immediate load instruction and passes to the map helper functions,
+ * available as external functions too:
+ *
+ * @code
+ * struct rte_bpf_xsym xsym[] = {
+ *	RTE_BPF_MAP_XSYM("counters", map),
+ *	RTE_BPF_MAP_LOOKUP_ELEM_XSYM,
+ * };
+ * @endcode
+ *
+ * The value returned by the lookup helper must be checked against NULL
+ * before it is accessed.
+ *
+ * The lookups of a hash map are lock-free. To delete its elements while
+ * the programs run, a QSBR variable is attached to the map with
+ * rte_bpf_map_rcu_qsbr_add(), and the lcores running the programs report
+ * their quiescent state to it.
+ */
+
+#include <rte_compat.h>
+#include <rte_bpf.h>
+#include <rte_rcu_qsbr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum length of a map name, including the terminating NUL. */
+#define RTE_BPF_MAP_NAMESIZE 16
+
+/**
+ * Possible types of map.
+ */
+enum rte_bpf_map_type {
+	/**
+	 * Array of max_entries values, indexed by a 32-bit key.
+	 * Elements cannot be deleted.
+	 */
+	RTE_BPF_MAP_TYPE_ARRAY,
+	/** Hash table of up to max_entries elements. */
+	RTE_BPF_MAP_TYPE_HASH,
+	/**
+	 * Array of max_entries values per lcore, indexed by a 32-bit key.
+	 * The programs access the values of the lcore they run on, without
+	 * any synchronization. Elements cannot be deleted.
+	 */
+	RTE_BPF_MAP_TYPE_LCORE_ARRAY,
+};
+
+/** Create a new element or update an existing one. */
+#define RTE_BPF_MAP_ANY		0
+/** Create a new element only if it does not exist. */
+#define RTE_BPF_MAP_NOEXIST	1
+/** Update an existing element only. */
+#define RTE_BPF_MAP_EXIST	2
+
+/**
+ * Input parameters for creating a map.
+ */
+struct rte_bpf_map_prm {
+	const char *name;           /**< unique name of the map */
+	enum rte_bpf_map_type type; /**< map type */
+	uint32_t key_size;          /**< key size in bytes */
+	uint32_t value_size;        /**< value size in bytes */
+	uint32_t max_entries;       /**< maximum number of elements */
+	int socket_id;              /**< NUMA socket of the map memory */
+};
+
+/**
+ * Information about a map.
+ */
+struct rte_bpf_map_info {
+	char name[RTE_BPF_MAP_NAMESIZE]; /**< name of the map */
+	enum rte_bpf_map_type type;      /**< map type */
+	uint32_t key_size;               /**< key size in bytes */
+	uint32_t value_size;             /**< value size in bytes */
+	uint32_t max_entries;            /**< maximum number of elements */
+	uint32_t nb_entries;             /**< current number of elements */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a new map.
+ * The values of the array maps are initialized to zero.
+ *
+ * @param prm
+ *   Parameters used to create the map.
+ * @return
+ *   Map handle, or NULL on error, with error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - EEXIST - a map with the same name already exists
+ *   - ENOMEM - can't reserve enough memory
+ */
+__rte_experimental
+struct rte_bpf_map *
+rte_bpf_map_create(const struct rte_bpf_map_prm *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a map. The map must not be used by any loaded eBPF program.
+ *
+ * @param map
+ *   Map handle to free.
+ */
+__rte_experimental
+void
+rte_bpf_map_free(struct rte_bpf_map *map);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Find an existing map by name.
+ *
+ * @param name
+ *   Name of the map.
+ * @return
+ *   Map handle, or NULL if not found, with rte_errno set to ENOENT.
+ */
+__rte_experimental
+struct rte_bpf_map *
+rte_bpf_map_find(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get information about a map.
+ *
+ * @param map
+ *   Map handle.
+ * @param info
+ *   Pointer to the structure to be filled.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_bpf_map_info_get(const struct rte_bpf_map *map,
+		struct rte_bpf_map_info *info);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Look up an element of a map.
+ * For per-lcore arrays, the value of the calling lcore is returned.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @return
+ *   Pointer to the value of the element, or NULL if not found.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup_elem(const struct rte_bpf_map *map, const void *key);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Look up the value of an lcore in a per-lcore array.
+ * For the other map types, the lcore is ignored.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @param lcore_id
+ *   Identifier of the lcore whose value is returned.
+ * @return
+ *   Pointer to the value of the element, or NULL if not found.
+ */
+__rte_experimental
+void *
+rte_bpf_map_lookup_lcore_elem(const struct rte_bpf_map *map, const void *key,
+		unsigned int lcore_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create or update an element of a map.
+ * For per-lcore arrays, the value of every lcore is updated.
+ *
+ * The value is copied without synchronization with the concurrent
+ * lookups of the element. The updates of a hash map are serialized
+ * with its insertions and deletions.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @param value
+ *   Pointer to the value.
+ * @param flags
+ *   RTE_BPF_MAP_ANY, RTE_BPF_MAP_NOEXIST or RTE_BPF_MAP_EXIST.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if RTE_BPF_MAP_NOEXIST is set and the element exists.
+ *   - -ENOENT if RTE_BPF_MAP_EXIST is set and the element does not exist.
+ *   - -E2BIG if the key is out of range of an array.
+ *   - -ENOSPC if the map is full.
+ */
+__rte_experimental
+int
+rte_bpf_map_update_elem(struct rte_bpf_map *map, const void *key,
+		const void *value, uint64_t flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Delete an element of a hash map.
+ *
+ * If a QSBR variable is attached to the map, the key and value of the
+ * deleted element are reused by a new element once all the readers have
+ * reported a quiescent state. Otherwise, they may be reused right away,
+ * while a concurrent lookup of the deleted element still uses them.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Pointer to the key.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid or the map is an array.
+ *   - -ENOENT if the element does not exist.
+ */
+__rte_experimental
+int
+rte_bpf_map_delete_elem(struct rte_bpf_map *map, const void *key);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Associate a QSBR variable with a hash map, to delay the reuse of the
+ * deleted elements until the readers are done with them.
+ *
+ * The readers are the lcores running the programs using the map, and the
+ * application threads using the values returned by the lookups. They must
+ * be registered with the QSBR variable and report their quiescent state,
+ * outside of the programs and the uses of the values.
+ * This should be called right after creating the map.
+ *
+ * @param map
+ *   Map handle.
+ * @param v
+ *   RCU QSBR variable.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid or the map is not a hash map.
+ *   - -EEXIST if a QSBR variable is already attached to the map.
+ *   - -ENOMEM if the defer queue cannot be allocated.
+ */
+__rte_experimental
+int
+rte_bpf_map_rcu_qsbr_add(struct rte_bpf_map *map, struct rte_rcu_qsbr *v);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Iterate over the elements of a map.
+ *
+ * @param map
+ *   Map handle.
+ * @param key
+ *   Buffer of key_size bytes, filled with the key of the next element.
+ * @param next
+ *   Pointer to the iterator, should be 0 to start iterating the map.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if the end of the map is reached.
+ */
+__rte_experimental
+int
+rte_bpf_map_iterate(const struct rte_bpf_map *map, void *key, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Map lookup helper function for eBPF programs:
+ * void *bpf_map_lookup_elem(map, const void *key).
+ * Only meant to be used as an external function, see
+ * RTE_BPF_MAP_LOOKUP_ELEM_XSYM.
+ */
+__rte_experimental
+uint64_t
+rte_bpf_map_helper_lookup_elem(uint64_t map, uint64_t key, uint64_t arg3,
+		uint64_t arg4, uint64_t arg5);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Map update helper function for eBPF programs:
+ * int64_t bpf_map_update_elem(map, const void *key, const void *value,
+ * uint64_t flags).
+ * Only meant to be used as an external function, see
+ * RTE_BPF_MAP_UPDATE_ELEM_XSYM.
+ */
+__rte_experimental
+uint64_t
+rte_bpf_map_helper_update_elem(uint64_t map, uint64_t key, uint64_t value,
+		uint64_t flags, uint64_t arg5);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Map delete helper function for eBPF programs:
+ * int64_t bpf_map_delete_elem(map, const void *key).
+ * Only meant to be used as an external function, see
+ * RTE_BPF_MAP_DELETE_ELEM_XSYM.
+ */
+__rte_experimental
+uint64_t
+rte_bpf_map_helper_delete_elem(uint64_t map, uint64_t key, uint64_t arg3,
+		uint64_t arg4, uint64_t arg5);
+
+/** External symbol for a map, referenced by a 64-bit immediate load. */
+#define RTE_BPF_MAP_XSYM(sym_name, map_ptr) { \
+	.name = (sym_name), \
+	.type = RTE_BPF_XTYPE_MAP, \
+	.map = { .val = (map_ptr), }, \
+}
+
+/** External function for the map lookup helper. */
+#define RTE_BPF_MAP_LOOKUP_ELEM_XSYM { \
+	.name = "bpf_map_lookup_elem", \
+	.type = RTE_BPF_XTYPE_FUNC, \
+	.func = { .val = rte_bpf_map_helper_lookup_elem, }, \
+}
+
+/** External function for the map update helper. */
+#define RTE_BPF_MAP_UPDATE_ELEM_XSYM { \
+	.name = "bpf_map_update_elem", \
+	.type = RTE_BPF_XTYPE_FUNC, \
+	.func = { .val = rte_bpf_map_helper_update_elem, }, \
+}
+
+/** External function for the map delete helper. */
+#define RTE_BPF_MAP_DELETE_ELEM_XSYM { \
+	.name = "bpf_map_delete_elem", \
+	.type = RTE_BPF_XTYPE_FUNC, \
+	.func = { .val = rte_bpf_map_helper_delete_elem, }, \
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_BPF_MAP_H_ */
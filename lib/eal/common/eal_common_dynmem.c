@@ -6,6 +6,7 @@
 #include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <rte_log.h>
 #include <rte_string_fns.h>
@@ -283,6 +284,7 @@ eal_dynmem_hugepage_init(void)
 			struct hugepage_info *hpi = &used_hp[hp_sz_idx];
 			unsigned int num_pages = hpi->num_pages[socket_id];
 			unsigned int num_pages_alloc;
+			struct timespec start, end;
 
 			if (num_pages == 0)
 				continue;
@@ -291,6 +293,7 @@ eal_dynmem_hugepage_init(void)
 				"Allocating %u pages of size %" PRIu64 "M "
 				"on socket %i",
 				num_pages, hpi->hugepage_sz >> 20, socket_id);
+			clock_gettime(CLOCK_MONOTONIC, &start);
 
 			/* we may not be able to allocate all pages in one go,
 			 * because we break up our memory map into multiple
@@ -330,6 +333,14 @@ eal_dynmem_hugepage_init(void)
 
 				num_pages_alloc += cur_pages;
 			} while (num_pages_alloc != num_pages);
+
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			EAL_LOG(DEBUG,
+				"Allocated %u pages of size %" PRIu64 "M "
+				"on socket %i in %.3f ms",
+				num_pages, hpi->hugepage_sz >> 20, socket_id,
+				(end.tv_sec - start.tv_sec) * 1E3 +
+				(end.tv_nsec - start.tv_nsec) / 1E6);
 		}
 	}
 
@@ -105,6 +105,7 @@ eal_long_options[] = {
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
 	{OPT_HUGE_WORKER_STACK, 2, NULL, OPT_HUGE_WORKER_STACK_NUM     },
+	{OPT_HUGE_INIT_THREADS, 1, NULL, OPT_HUGE_INIT_THREADS_NUM     },
 
 	{0,                     0, NULL, 0                        }
 };
@@ -2105,6 +2106,14 @@ eal_check_common_options(struct internal_config *internal_cfg)
 			"be specified together with --"OPT_NO_HUGE);
 		return -1;
 	}
+	if (internal_cfg->huge_init_threads > 1 &&
+			(internal_cfg->no_hugetlbfs || internal_cfg->legacy_mem ||
+			internal_cfg->single_file_segments)) {
+		EAL_LOG(ERR, "Option --"OPT_HUGE_INIT_THREADS" is not "
+			"compatible with --"OPT_NO_HUGE", --"OPT_LEGACY_MEM
+			" or --"OPT_SINGLE_FILE_SEGMENTS);
+		return -1;
+	}
 	if (internal_conf->force_socket_limits && internal_conf->legacy_mem) {
 		EAL_LOG(ERR, "Option --"OPT_SOCKET_LIMIT
 			" is only supported in non-legacy memory mode");
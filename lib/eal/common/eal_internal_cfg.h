@@ -103,6 +103,7 @@ struct internal_config {
 	struct simd_bitwidth max_simd_bitwidth;
 	/**< max simd bitwidth path to use */
 	size_t huge_worker_stack_size; /**< worker thread stack size */
+	unsigned int huge_init_threads; /**< threads mapping hugepages at init */
 };
 
 void eal_reset_internal_config(struct internal_config *internal_cfg);
@@ -2,6 +2,7 @@
  * Copyright(c) 2010-2019 Intel Corporation
  */
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -14,6 +15,7 @@
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
 #include <rte_common.h>
+#include <rte_lcore.h>
 #include <rte_spinlock.h>
 
 #include <eal_trace_internal.h>
@@ -25,19 +27,185 @@
 #include "eal_memcfg.h"
 #include "eal_private.h"
 
+/* Per-lcore caches of small elements, by power of 2 size classes: the class
+ * n holds elements of [2^(n + MIN_SHIFT), 2^(n + MIN_SHIFT + 1)) bytes,
+ * which serve the allocations of up to 2^(n + MIN_SHIFT) bytes.
+ */
+#define MALLOC_CACHE_MIN_SHIFT 6
+#define MALLOC_CACHE_CLASSES 6
+#define MALLOC_CACHE_SIZE 32
+
+struct __rte_cache_aligned malloc_lcore_cache {
+	unsigned int nb_objs; /* in all classes */
+	unsigned int len[MALLOC_CACHE_CLASSES];
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t puts;
+	uint64_t flushes;
+	void *objs[MALLOC_CACHE_CLASSES][MALLOC_CACHE_SIZE];
+};
+
+/* process local, elements are cached by the process which frees them */
+static bool malloc_lcore_cache_enabled;
+static struct malloc_lcore_cache malloc_lcore_caches[RTE_MAX_LCORE];
+
+static void
+malloc_lcore_cache_flush_class(struct malloc_lcore_cache *cache,
+		unsigned int cls, unsigned int n)
+{
+	struct malloc_elem *elem;
+
+	while (n-- > 0) {
+		elem = malloc_elem_from_data(cache->objs[cls][--cache->len[cls]]);
+		if (malloc_heap_free(elem) < 0)
+			EAL_LOG(ERR, "Error: Invalid memory");
+		cache->nb_objs--;
+	}
+	cache->flushes++;
+}
+
+static void
+malloc_lcore_cache_flush(struct malloc_lcore_cache *cache)
+{
+	unsigned int cls;
+
+	for (cls = 0; cls < MALLOC_CACHE_CLASSES; cls++)
+		if (cache->len[cls] != 0)
+			malloc_lcore_cache_flush_class(cache, cls,
+					cache->len[cls]);
+}
+
+/* Size class serving an allocation from the cache of the calling lcore,
+ * or -1 if the allocation cannot use it.
+ */
+static inline int
+malloc_lcore_cache_class(size_t size, unsigned int align, int socket_arg)
+{
+#if defined(RTE_MALLOC_DEBUG) || defined(RTE_MALLOC_ASAN)
+	RTE_SET_USED(size);
+	RTE_SET_USED(align);
+	RTE_SET_USED(socket_arg);
+	return -1;
+#else
+	if (!malloc_lcore_cache_enabled || rte_lcore_id() == LCORE_ID_ANY ||
+			size > RTE_BIT64(MALLOC_CACHE_MIN_SHIFT +
+				MALLOC_CACHE_CLASSES - 1) ||
+			align > RTE_CACHE_LINE_SIZE ||
+			(socket_arg != SOCKET_ID_ANY &&
+			 socket_arg != (int)rte_socket_id()))
+		return -1;
+
+	if (size <= RTE_BIT64(MALLOC_CACHE_MIN_SHIFT))
+		return 0;
+	return rte_fls_u64(size - 1) - MALLOC_CACHE_MIN_SHIFT;
+#endif
+}
+
+static inline void *
+malloc_lcore_cache_get(int cls)
+{
+	struct malloc_lcore_cache *cache = &malloc_lcore_caches[rte_lcore_id()];
+	void *ptr;
+
+	if (cache->len[cls] == 0) {
+		cache->misses++;
+		return NULL;
+	}
+
+	ptr = cache->objs[cls][--cache->len[cls]];
+	cache->nb_objs--;
+	cache->hits++;
+
+	return ptr;
+}
+
+/* Keep a freed element in the cache of the calling lcore if it fits in a
+ * size class and comes from the lcore socket. Returns false if the element
+ * is to be freed back to the heap.
+ */
+static inline bool
+malloc_lcore_cache_put(void *addr, struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int lcore_id = rte_lcore_id();
+	size_t size;
+	int cls;
+
+	if (lcore_id == LCORE_ID_ANY)
+		return false;
+
+	cache = &malloc_lcore_caches[lcore_id];
+	if (!malloc_lcore_cache_enabled) {
+		/* flush what was cached before the caches were disabled */
+		if (unlikely(cache->nb_objs != 0))
+			malloc_lcore_cache_flush(cache);
+		return false;
+	}
+
+	if (elem == NULL || elem->state != ELEM_BUSY ||
+			elem->heap->socket_id != rte_socket_id())
+		return false;
+
+	size = elem->size - elem->pad - MALLOC_ELEM_OVERHEAD;
+	if (size < RTE_BIT64(MALLOC_CACHE_MIN_SHIFT) ||
+			size >= RTE_BIT64(MALLOC_CACHE_MIN_SHIFT +
+				MALLOC_CACHE_CLASSES))
+		return false;
+	cls = rte_fls_u64(size) - 1 - MALLOC_CACHE_MIN_SHIFT;
+
+	/* make room, keeping the most recently freed elements */
+	if (cache->len[cls] == MALLOC_CACHE_SIZE)
+		malloc_lcore_cache_flush_class(cache, cls,
+				MALLOC_CACHE_SIZE / 2);
+
+	/* the element is not zeroed, for rte_zmalloc() */
+	elem->dirty = 1;
+	cache->objs[cls][cache->len[cls]++] = addr;
+	cache->nb_objs++;
+	cache->puts++;
+
+	return true;
+}
 
 /* Free the memory space back to heap */
 static void
 mem_free(void *addr, const bool trace_ena)
 {
+	struct malloc_elem *elem;
+
 	if (trace_ena)
 		rte_eal_trace_mem_free(addr);
 
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+#if !defined(RTE_MALLOC_DEBUG) && !defined(RTE_MALLOC_ASAN)
+	if (malloc_lcore_cache_put(addr, elem))
+		return;
+#endif
+	if (malloc_heap_free(elem) < 0)
 		EAL_LOG(ERR, "Error: Invalid memory");
 }
 
+int
+rte_malloc_lcore_cache_set(bool enable)
+{
+#if defined(RTE_MALLOC_DEBUG) || defined(RTE_MALLOC_ASAN)
+	if (enable)
+		return -ENOTSUP;
+#endif
+	malloc_lcore_cache_enabled = enable;
+	return 0;
+}
+
+void
+rte_malloc_lcore_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (lcore_id != LCORE_ID_ANY)
+		malloc_lcore_cache_flush(&malloc_lcore_caches[lcore_id]);
+}
+
 void
 rte_free(void *addr)
 {
@@ -55,11 +223,21 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 		int socket_arg, const bool trace_ena)
 {
 	void *ptr;
+	int cls;
 
 	/* return NULL if size is 0 or alignment is not power-of-2 */
 	if (size == 0 || (align && !rte_is_power_of_2(align)))
 		return NULL;
 
+	cls = malloc_lcore_cache_class(size, align, socket_arg);
+	if (cls >= 0) {
+		ptr = malloc_lcore_cache_get(cls);
+		if (ptr != NULL)
+			goto out;
+		/* allocate the whole class, for the element to be cached */
+		size = RTE_BIT64(cls + MALLOC_CACHE_MIN_SHIFT);
+	}
+
 	/* if there are no hugepages and if we are not allocating from an
 	 * external heap, use memory from any socket available. checking for
 	 * socket being external may return -1 in case of invalid socket, but
@@ -72,6 +250,7 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
 			align == 0 ? 1 : align, 0, false);
 
+out:
 	if (trace_ena)
 		rte_eal_trace_mem_malloc(type, size, align, socket_arg, ptr);
 	return ptr;
@@ -330,7 +509,7 @@ void
 rte_malloc_dump_stats(FILE *f, __rte_unused const char *type)
 {
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
-	unsigned int heap_id;
+	unsigned int heap_id, lcore_id;
 	struct rte_malloc_socket_stats sock_stats;
 
 	/* Iterate through all initialised heaps */
@@ -349,6 +528,27 @@ rte_malloc_dump_stats(FILE *f, __rte_unused const char *type)
 		fprintf(f, "\tAlloc_count:%u,\n",sock_stats.alloc_count);
 		fprintf(f, "\tFree_count:%u,\n", sock_stats.free_count);
 	}
+
+	/* Iterate through the lcore caches which were used */
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct malloc_lcore_cache *cache =
+			&malloc_lcore_caches[lcore_id];
+		unsigned int cls;
+
+		if (cache->hits + cache->misses + cache->puts == 0)
+			continue;
+
+		fprintf(f, "Lcore cache:%u\n", lcore_id);
+		fprintf(f, "\tCached_count:%u,\n", cache->nb_objs);
+		for (cls = 0; cls < MALLOC_CACHE_CLASSES; cls++)
+			fprintf(f, "\tCached_count_%zu:%u,\n",
+				(size_t)RTE_BIT64(cls + MALLOC_CACHE_MIN_SHIFT),
+				cache->len[cls]);
+		fprintf(f, "\tHit_count:%" PRIu64 ",\n", cache->hits);
+		fprintf(f, "\tMiss_count:%" PRIu64 ",\n", cache->misses);
+		fprintf(f, "\tPut_count:%" PRIu64 ",\n", cache->puts);
+		fprintf(f, "\tFlush_count:%" PRIu64 ",\n", cache->flushes);
+	}
 	return;
 }
 
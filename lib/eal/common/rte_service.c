@@ -31,6 +31,16 @@
 #define RUNSTATE_STOPPED 0
 #define RUNSTATE_RUNNING 1
 
+/* max backoff of an idle service on dynamic lcores, as a power of 2 of the
+ * cycles of its idle call
+ */
+#define SERVICE_IDLE_SHIFT_MAX 6
+
+/* weight of a call in the average cycles of the calls of a service on dynamic
+ * lcores, as a power of 2
+ */
+#define SERVICE_CYCLES_SHIFT 3
+
 /* internal representation of a service */
 struct __rte_cache_aligned rte_service_spec_impl {
 	/* public part of the struct */
@@ -53,11 +63,28 @@ struct __rte_cache_aligned rte_service_spec_impl {
 	 * on currently.
 	 */
 	RTE_ATOMIC(uint32_t) num_mapped_cores;
+
+	/* Run queue state, only written by dynamic lcores. It sits on its own
+	 * cache line so that these writes do not disturb the other lcores
+	 * reading the runstates above.
+	 * last_run is the TSC of the last run start on a dynamic lcore,
+	 * run_cycles the moving average of the cycles of its calls there, and
+	 * the service is not run before idle_until after idle_streak
+	 * consecutive idle calls.
+	 */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint64_t) last_run;
+	RTE_ATOMIC(uint64_t) run_cycles;
+	RTE_ATOMIC(uint64_t) idle_until;
+	RTE_ATOMIC(uint32_t) idle_streak;
 };
 
 struct service_stats {
 	RTE_ATOMIC(uint64_t) calls;
 	RTE_ATOMIC(uint64_t) cycles;
+	RTE_ATOMIC(uint64_t) idle_calls;
+	/* TSC of the last run start, and max TSC delta between two runs */
+	RTE_ATOMIC(uint64_t) last_run;
+	RTE_ATOMIC(uint64_t) max_run_delay;
 };
 
 /* the internal values of a service core */
@@ -67,6 +94,7 @@ struct __rte_cache_aligned core_state {
 	RTE_ATOMIC(uint8_t) runstate; /* running or stopped */
 	RTE_ATOMIC(uint8_t) thread_active; /* indicates when thread is in service_run() */
 	uint8_t is_service_core; /* set if core is currently a service core */
+	uint8_t dynamic; /* set if core pulls services from the run queue */
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	RTE_ATOMIC(uint64_t) loops;
 	RTE_ATOMIC(uint64_t) cycles;
@@ -78,6 +106,11 @@ static struct rte_service_spec_impl *rte_services;
 static struct core_state *lcore_states;
 static uint32_t rte_service_library_initialized;
 
+/* run queue of dynamic lcores: a set bit means the service is not claimed.
+ * MT unsafe services are claimed by the dynamic lcore running them.
+ */
+static RTE_ATOMIC(uint64_t) service_unclaimed = UINT64_MAX;
+
 int32_t
 rte_service_init(void)
 {
@@ -369,6 +402,72 @@ rte_service_runstate_get(uint32_t id)
 
 }
 
+/* Track the delay between two runs of the service on this lcore. The lcore
+ * is the only writer, as for the other service_stats.
+ */
+static inline void
+service_run_delay_update(struct service_stats *service_stats, uint64_t start)
+{
+	uint64_t last = service_stats->last_run;
+
+	rte_atomic_store_explicit(&service_stats->last_run, start,
+		rte_memory_order_relaxed);
+	if (last != 0 && start > last &&
+			start - last > service_stats->max_run_delay)
+		rte_atomic_store_explicit(&service_stats->max_run_delay,
+			start - last, rte_memory_order_relaxed);
+}
+
+/* Back off a service returning -EAGAIN on dynamic lcores: after n idle calls
+ * in a row, it is not polled again before 2^n times the cycles of the last
+ * idle call, so an idle service costs a dynamic lcore at most 1/2^n of its
+ * cycles. A call doing work resets the backoff.
+ */
+static inline void
+service_idle_update(struct rte_service_spec_impl *s, int rc,
+		    uint64_t end, uint64_t cycles)
+{
+	uint32_t streak;
+
+	if (likely(rc != -EAGAIN)) {
+		if (rte_atomic_load_explicit(&s->idle_streak,
+				rte_memory_order_relaxed) != 0) {
+			rte_atomic_store_explicit(&s->idle_streak, 0,
+				rte_memory_order_relaxed);
+			rte_atomic_store_explicit(&s->idle_until, 0,
+				rte_memory_order_relaxed);
+		}
+		return;
+	}
+
+	streak = rte_atomic_load_explicit(&s->idle_streak,
+		rte_memory_order_relaxed);
+	if (streak < SERVICE_IDLE_SHIFT_MAX)
+		rte_atomic_store_explicit(&s->idle_streak, ++streak,
+			rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&s->idle_until, end + (cycles << streak),
+		rte_memory_order_relaxed);
+}
+
+/* Average the cycles of the calls of a service on dynamic lcores. Concurrent
+ * updates of a multi-thread safe service may lose a sample, which only delays
+ * the average.
+ */
+static inline void
+service_cycles_update(struct rte_service_spec_impl *s, uint64_t cycles)
+{
+	uint64_t avg = rte_atomic_load_explicit(&s->run_cycles,
+		rte_memory_order_relaxed);
+
+	if (avg == 0)
+		avg = cycles;
+	else
+		avg = avg - (avg >> SERVICE_CYCLES_SHIFT) +
+			(cycles >> SERVICE_CYCLES_SHIFT);
+	rte_atomic_store_explicit(&s->run_cycles, avg,
+		rte_memory_order_relaxed);
+}
+
 static inline void
 service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
@@ -376,31 +475,47 @@ service_runner_do_callback(struct rte_service_spec_impl *s,
 	rte_eal_trace_service_run_begin(service_idx, rte_lcore_id());
 	void *userdata = s->spec.callback_userdata;
 
-	if (service_stats_enabled(s)) {
+	if (service_stats_enabled(s) || cs->dynamic) {
 		uint64_t start = rte_rdtsc();
 		int rc = s->spec.callback(userdata);
+		uint64_t end = rte_rdtsc();
+		uint64_t cycles = end - start;
 
-		/* The lcore service worker thread is the only writer,
-		 * and thus only a non-atomic load and an atomic store
-		 * is needed, and not the more expensive atomic
-		 * add.
-		 */
-		struct service_stats *service_stats =
-			&cs->service_stats[service_idx];
-
-		if (likely(rc != -EAGAIN)) {
-			uint64_t end = rte_rdtsc();
-			uint64_t cycles = end - start;
-
-			rte_atomic_store_explicit(&cs->cycles, cs->cycles + cycles,
-				rte_memory_order_relaxed);
-			rte_atomic_store_explicit(&service_stats->cycles,
-				service_stats->cycles + cycles,
+		if (cs->dynamic) {
+			rte_atomic_store_explicit(&s->last_run, start,
 				rte_memory_order_relaxed);
+			service_cycles_update(s, cycles);
+			service_idle_update(s, rc, end, cycles);
 		}
 
-		rte_atomic_store_explicit(&service_stats->calls,
-			service_stats->calls + 1, rte_memory_order_relaxed);
+		if (service_stats_enabled(s)) {
+			/* The lcore service worker thread is the only writer,
+			 * and thus only a non-atomic load and an atomic store
+			 * is needed, and not the more expensive atomic
+			 * add.
+			 */
+			struct service_stats *service_stats =
+				&cs->service_stats[service_idx];
+
+			service_run_delay_update(service_stats, start);
+
+			if (likely(rc != -EAGAIN)) {
+				rte_atomic_store_explicit(&cs->cycles,
+					cs->cycles + cycles,
+					rte_memory_order_relaxed);
+				rte_atomic_store_explicit(&service_stats->cycles,
+					service_stats->cycles + cycles,
+					rte_memory_order_relaxed);
+			} else {
+				rte_atomic_store_explicit(&service_stats->idle_calls,
+					service_stats->idle_calls + 1,
+					rte_memory_order_relaxed);
+			}
+
+			rte_atomic_store_explicit(&service_stats->calls,
+				service_stats->calls + 1,
+				rte_memory_order_relaxed);
+		}
 	} else {
 		s->spec.callback(userdata);
 	}
@@ -481,6 +596,95 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 	return ret;
 }
 
+/* Pick the service that waits for the longest time relative to the average
+ * cycles of its calls, among the services of the mask which are running, not
+ * claimed, not busy and not backing off. A service is thus run at a rate
+ * inverse to the cycles of its calls, and the services get the same share of
+ * the cycles of the dynamic lcores.
+ */
+static int32_t
+service_dynamic_pick(struct core_state *cs, uint64_t service_mask)
+{
+	uint64_t mask = service_mask & rte_atomic_load_explicit(&service_unclaimed,
+		rte_memory_order_relaxed);
+	uint64_t now = rte_rdtsc();
+	uint64_t best_wait = 0, best_cost = 1;
+	struct rte_service_spec_impl *s;
+	uint64_t last, wait, cost;
+	int32_t id = -1;
+	uint32_t i;
+
+	while (mask != 0) {
+		i = rte_ctz64(mask);
+		mask &= mask - 1;
+		s = service_get(i);
+
+		if (rte_atomic_load_explicit(&s->comp_runstate, rte_memory_order_acquire) !=
+				RUNSTATE_RUNNING ||
+		    rte_atomic_load_explicit(&s->app_runstate, rte_memory_order_acquire) !=
+				RUNSTATE_RUNNING) {
+			cs->service_active_on_lcore[i] = 0;
+			continue;
+		}
+
+		if (now < rte_atomic_load_explicit(&s->idle_until,
+				rte_memory_order_relaxed))
+			continue;
+
+		/* running on a statically mapped lcore or an app lcore */
+		if (!service_mt_safe(s) && rte_spinlock_is_locked(&s->execute_lock))
+			continue;
+
+		/* both values are capped to compare the ratios without
+		 * overflow, a service never run having the largest wait
+		 */
+		last = rte_atomic_load_explicit(&s->last_run,
+			rte_memory_order_relaxed);
+		wait = RTE_MIN(now > last ? now - last : 0, UINT32_MAX);
+		cost = rte_atomic_load_explicit(&s->run_cycles,
+			rte_memory_order_relaxed);
+		cost = RTE_MIN(RTE_MAX(cost, UINT64_C(1)), UINT32_MAX);
+		if (id < 0 || wait * best_cost > best_wait * cost) {
+			best_wait = wait;
+			best_cost = cost;
+			id = i;
+		}
+	}
+
+	return id;
+}
+
+/* Run one service from the run queue shared by dynamic lcores. */
+static void
+service_dynamic_run(struct core_state *cs, uint64_t service_mask)
+{
+	struct rte_service_spec_impl *s;
+	uint64_t sid_mask;
+	int32_t id;
+
+	id = service_dynamic_pick(cs, service_mask);
+	if (id < 0)
+		return;
+
+	s = service_get(id);
+	if (service_mt_safe(s)) {
+		service_run(id, cs, service_mask, s, 1);
+		return;
+	}
+
+	/* Another dynamic lcore may have claimed the service meanwhile */
+	sid_mask = UINT64_C(1) << id;
+	if (!(rte_atomic_fetch_and_explicit(&service_unclaimed, ~sid_mask,
+			rte_memory_order_acquire) & sid_mask))
+		return;
+
+	/* the execute lock still serializes with the other lcores */
+	service_run(id, cs, service_mask, s, 1);
+
+	rte_atomic_fetch_or_explicit(&service_unclaimed, sid_mask,
+		rte_memory_order_release);
+}
+
 static int32_t
 service_runner_func(void *arg)
 {
@@ -505,12 +709,16 @@ service_runner_func(void *arg)
 		if (service_mask == 0)
 			continue;
 
-		start_id = rte_ctz64(service_mask);
-		end_id = 64 - rte_clz64(service_mask);
+		if (cs->dynamic) {
+			service_dynamic_run(cs, service_mask);
+		} else {
+			start_id = rte_ctz64(service_mask);
+			end_id = 64 - rte_clz64(service_mask);
 
-		for (i = start_id; i < end_id; i++) {
-			/* return value ignored as no change to code flow */
-			service_run(i, cs, service_mask, service_get(i), 1);
+			for (i = start_id; i < end_id; i++) {
+				/* return value ignored as no change to code flow */
+				service_run(i, cs, service_mask, service_get(i), 1);
+			}
 		}
 
 		rte_atomic_store_explicit(&cs->loops, cs->loops + 1, rte_memory_order_relaxed);
@@ -704,6 +912,7 @@ rte_service_lcore_reset_all(void)
 	for (i = 0; i < RTE_MAX_LCORE; i++) {
 		if (lcore_states[i].is_service_core) {
 			lcore_states[i].service_mask = 0;
+			lcore_states[i].dynamic = 0;
 			set_lcore_state(i, ROLE_RTE);
 			/* runstate act as guard variable Use
 			 * store-release memory order here to synchronize
@@ -732,6 +941,7 @@ rte_service_lcore_add(uint32_t lcore)
 
 	/* ensure that after adding a core the mask and state are defaults */
 	lcore_states[lcore].service_mask = 0;
+	lcore_states[lcore].dynamic = 0;
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
@@ -765,6 +975,38 @@ rte_service_lcore_del(uint32_t lcore)
 	return 0;
 }
 
+int32_t
+rte_service_lcore_dynamic_set(uint32_t lcore, uint32_t enabled)
+{
+	if (lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	struct core_state *cs = &lcore_states[lcore];
+	if (!cs->is_service_core)
+		return -EINVAL;
+
+	/* runstate act as the guard variable. Use load-acquire
+	 * memory order here to synchronize with store-release
+	 * in runstate update functions.
+	 */
+	if (rte_atomic_load_explicit(&cs->runstate, rte_memory_order_acquire) !=
+			RUNSTATE_STOPPED ||
+	    rte_atomic_load_explicit(&cs->thread_active, rte_memory_order_acquire))
+		return -EBUSY;
+
+	cs->dynamic = enabled > 0;
+	return 0;
+}
+
+int32_t
+rte_service_lcore_dynamic_get(uint32_t lcore)
+{
+	if (lcore >= RTE_MAX_LCORE || !lcore_states[lcore].is_service_core)
+		return -EINVAL;
+
+	return lcore_states[lcore].dynamic;
+}
+
 int32_t
 rte_service_lcore_start(uint32_t lcore)
 {
@@ -905,6 +1147,68 @@ attr_get_service_cycles(uint32_t service_id)
 	return attr_get(service_id, lcore_attr_get_service_cycles);
 }
 
+static uint64_t
+lcore_attr_get_service_idle_calls(uint32_t service_id, unsigned int lcore)
+{
+	struct core_state *cs = &lcore_states[lcore];
+
+	return rte_atomic_load_explicit(&cs->service_stats[service_id].idle_calls,
+		rte_memory_order_relaxed);
+}
+
+static uint64_t
+attr_get_service_idle_calls(uint32_t service_id)
+{
+	return attr_get(service_id, lcore_attr_get_service_idle_calls);
+}
+
+static uint64_t
+attr_get_max(uint32_t id, lcore_attr_get_fun lcore_attr_get)
+{
+	unsigned int lcore;
+	uint64_t max = 0;
+
+	for (lcore = 0; lcore < RTE_MAX_LCORE; lcore++) {
+		if (lcore_states[lcore].is_service_core)
+			max = RTE_MAX(max, lcore_attr_get(id, lcore));
+	}
+
+	return max;
+}
+
+static uint64_t
+lcore_attr_get_service_last_run(uint32_t service_id, unsigned int lcore)
+{
+	struct core_state *cs = &lcore_states[lcore];
+
+	return rte_atomic_load_explicit(&cs->service_stats[service_id].last_run,
+		rte_memory_order_relaxed);
+}
+
+static uint64_t
+attr_get_service_run_delay(uint32_t service_id)
+{
+	uint64_t last = attr_get_max(service_id, lcore_attr_get_service_last_run);
+	uint64_t now = rte_rdtsc();
+
+	return last != 0 && now > last ? now - last : 0;
+}
+
+static uint64_t
+lcore_attr_get_service_run_delay_max(uint32_t service_id, unsigned int lcore)
+{
+	struct core_state *cs = &lcore_states[lcore];
+
+	return rte_atomic_load_explicit(&cs->service_stats[service_id].max_run_delay,
+		rte_memory_order_relaxed);
+}
+
+static uint64_t
+attr_get_service_run_delay_max(uint32_t service_id)
+{
+	return attr_get_max(service_id, lcore_attr_get_service_run_delay_max);
+}
+
 int32_t
 rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 {
@@ -921,6 +1225,15 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CYCLES:
 		*attr_value = attr_get_service_cycles(id);
 		return 0;
+	case RTE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = attr_get_service_idle_calls(id);
+		return 0;
+	case RTE_SERVICE_ATTR_RUN_DELAY:
+		*attr_value = attr_get_service_run_delay(id);
+		return 0;
+	case RTE_SERVICE_ATTR_RUN_DELAY_MAX:
+		*attr_value = attr_get_service_run_delay_max(id);
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -1002,9 +1315,12 @@ service_dump_one(FILE *f, uint32_t id)
 	s = service_get(id);
 
 	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tcycles %"
-		PRIu64"\tavg: %"PRIu64"\n",
+		PRIu64"\tavg: %"PRIu64"\tidle calls %"PRIu64
+		"\trun delay %"PRIu64"\tmax %"PRIu64"\n",
 		s->spec.name, service_stats_enabled(s), service_calls,
-		service_cycles, service_cycles / service_calls);
+		service_cycles, service_cycles / service_calls,
+		attr_get_service_idle_calls(id), attr_get_service_run_delay(id),
+		attr_get_service_run_delay_max(id));
 }
 
 static void
@@ -11,8 +11,10 @@
  * from hugepages.
  */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <rte_compat.h>
 #include <rte_memory.h>
 
 #ifdef __cplusplus
@@ -520,6 +522,45 @@ rte_malloc_dump_stats(FILE *f, const char *type);
 void
 rte_malloc_dump_heaps(FILE *f);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the per-lcore caches of small elements.
+ *
+ * When enabled, rte_free() called from an lcore keeps the elements of
+ * 64 bytes to 4 KB, allocated from the heap of the lcore socket, in a cache
+ * of this lcore, sorted by power of 2 size classes. rte_malloc() and its
+ * variants called from the lcore for up to 2 KB, with an alignment of at
+ * most a cache line, on any socket or on the lcore socket, take an element
+ * of the size class from the cache, without taking the heap lock.
+ * The elements in the caches are accounted as allocated in the heap stats.
+ *
+ * When disabled, an lcore flushes its cache back to the heap on its next
+ * call to rte_free() or to rte_malloc_lcore_cache_flush().
+ *
+ * The caches are disabled by default.
+ *
+ * @param enable
+ *   Whether the per-lcore caches are enabled.
+ * @return
+ *   0 on success, -ENOTSUP if the caches are not supported, as in debug
+ *   and ASan builds.
+ */
+__rte_experimental
+int
+rte_malloc_lcore_cache_set(bool enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free the elements kept in the cache of the calling lcore back to the heap.
+ */
+__rte_experimental
+void
+rte_malloc_lcore_cache_flush(void);
+
 /**
  * Return the IO address of a virtual address obtained through
  * rte_malloc
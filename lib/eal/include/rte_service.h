@@ -30,6 +30,7 @@ extern "C" {
 #include<stdio.h>
 #include <stdint.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_lcore.h>
 
@@ -227,6 +228,48 @@ int32_t rte_service_set_runstate_mapped_check(uint32_t id, int32_t enable);
 int32_t rte_service_run_iter_on_app_lcore(uint32_t id,
 		uint32_t serialize_multithread_unsafe);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable or disable the dynamic scheduling of a service core.
+ *
+ * A service core runs by default all the services mapped to it in turn, in
+ * each loop. A dynamic service core instead runs a single service per loop,
+ * pulled from a run queue shared by all dynamic service cores: the running
+ * service mapped to it which waits for the longest time relative to the
+ * average cycles of its calls, so that the services get the same share of the
+ * cycles. The multi-thread unsafe services being run by another core are
+ * skipped, rather than contended for. A service returning -EAGAIN is polled
+ * less and less often by the dynamic service cores, relative to the cycles of
+ * its idle calls, until it does some work again.
+ *
+ * Mapping the services to several dynamic service cores thus balances their
+ * load across these cores.
+ *
+ * @param lcore Id of the service core.
+ * @param enabled Whether the service core is dynamic.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid lcore provided, or it is not a service core.
+ * @retval -EBUSY The service core is not stopped.
+ */
+__rte_experimental
+int32_t rte_service_lcore_dynamic_set(uint32_t lcore, uint32_t enabled);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get whether a service core is dynamic.
+ *
+ * @param lcore Id of the service core.
+ * @retval 1 The service core is dynamic.
+ * @retval 0 The service core is not dynamic.
+ * @retval -EINVAL Invalid lcore provided, or it is not a service core.
+ */
+__rte_experimental
+int32_t rte_service_lcore_dynamic_get(uint32_t lcore);
+
 /**
  * Start a service core.
  *
@@ -383,6 +426,25 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the count of invocations of this service function which returned
+ * -EAGAIN, meaning no work was done
+ */
+#define RTE_SERVICE_ATTR_IDLE_CALL_COUNT 2
+
+/**
+ * Returns the number of TSC cycles since the service last started running on
+ * a service core. Only the runs with statistics enabled count.
+ */
+#define RTE_SERVICE_ATTR_RUN_DELAY 3
+
+/**
+ * Returns the maximum number of TSC cycles between the starts of two runs of
+ * the service on a same service core. Only the runs with statistics enabled
+ * count.
+ */
+#define RTE_SERVICE_ATTR_RUN_DELAY_MAX 4
+
 /**
  * Get an attribute from a service.
  *
@@ -20,6 +20,7 @@
 #include <limits.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <time.h>
 #if defined(RTE_ARCH_X86)
 #include <sys/io.h>
 #endif
@@ -457,6 +458,8 @@ eal_usage(const char *prgname)
 	       "                      Allocate worker thread stacks from hugepage memory.\n"
 	       "                      Size is in units of kbytes and defaults to system\n"
 	       "                      thread stack size if not specified.\n"
+	       "  --"OPT_HUGE_INIT_THREADS" Number of threads mapping hugepages\n"
+	       "                      of each socket in parallel at init\n"
 	       "\n");
 	/* Allow the application to print its usage message too if hook is set */
 	if (hook) {
@@ -622,6 +625,38 @@ eal_parse_huge_worker_stack(const char *arg)
 	return 0;
 }
 
+static int
+eal_parse_huge_init_threads(const char *arg)
+{
+	struct internal_config *cfg = eal_get_internal_configuration();
+	unsigned long n_threads;
+	char *end;
+
+	errno = 0;
+	n_threads = strtoul(arg, &end, 10);
+	if (errno || *arg == '\0' || *end != '\0' || n_threads == 0 ||
+			n_threads > RTE_MAX_LCORE)
+		return -1;
+
+	cfg->huge_init_threads = n_threads;
+	return 0;
+}
+
+/* Return the time elapsed since the start of a step of the init, in ms */
+static double
+eal_init_step_time(struct timespec *start)
+{
+	struct timespec now;
+	double ms;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ms = (now.tv_sec - start->tv_sec) * 1E3 +
+		(now.tv_nsec - start->tv_nsec) / 1E6;
+	*start = now;
+
+	return ms;
+}
+
 /* Parse the argument given in the command line of the application */
 static int
 eal_parse_args(int argc, char **argv)
@@ -769,6 +804,16 @@ eal_parse_args(int argc, char **argv)
 			}
 			break;
 
+		case OPT_HUGE_INIT_THREADS_NUM:
+			if (eal_parse_huge_init_threads(optarg) < 0) {
+				EAL_LOG(ERR, "invalid parameter for --"
+					OPT_HUGE_INIT_THREADS);
+				eal_usage(prgname);
+				ret = -1;
+				goto out;
+			}
+			break;
+
 		default:
 			if (opt < OPT_LONG_MIN_NUM && isprint(opt)) {
 				EAL_LOG(ERR, "Option %c is not supported "
@@ -971,6 +1016,8 @@ rte_eal_init(int argc, char **argv)
 	uint32_t has_run = 0;
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 	char thread_name[RTE_THREAD_NAME_SIZE];
+	double hugepage_info_ms = 0, memory_ms, heap_ms;
+	struct timespec step_start;
 	bool phys_addrs;
 	const struct rte_config *config = rte_eal_get_configuration();
 	struct internal_config *internal_conf =
@@ -1118,6 +1165,7 @@ rte_eal_init(int argc, char **argv)
 		rte_eal_iova_mode() == RTE_IOVA_PA ? "PA" : "VA");
 
 	if (internal_conf->no_hugetlbfs == 0) {
+		clock_gettime(CLOCK_MONOTONIC, &step_start);
 		/* rte_config isn't initialized yet */
 		ret = internal_conf->process_type == RTE_PROC_PRIMARY ?
 				eal_hugepage_info_init() :
@@ -1128,6 +1176,7 @@ rte_eal_init(int argc, char **argv)
 			rte_atomic_store_explicit(&run_once, 0, rte_memory_order_relaxed);
 			return -1;
 		}
+		hugepage_info_ms = eal_init_step_time(&step_start);
 	}
 
 	if (internal_conf->memory == 0 && internal_conf->force_sockets == 0) {
@@ -1166,6 +1215,7 @@ rte_eal_init(int argc, char **argv)
 	 * not present in primary processes, so to avoid any potential issues,
 	 * initialize memzones first.
 	 */
+	clock_gettime(CLOCK_MONOTONIC, &step_start);
 	if (rte_eal_memzone_init() < 0) {
 		rte_eal_init_alert("Cannot init memzone");
 		rte_errno = ENODEV;
@@ -1183,6 +1233,7 @@ rte_eal_init(int argc, char **argv)
 
 	/* the directories are locked during eal_hugepage_info_init */
 	eal_hugedirs_unlock();
+	memory_ms = eal_init_step_time(&step_start);
 
 	if (rte_eal_malloc_heap_init() < 0) {
 		rte_mcfg_mem_read_unlock();
@@ -1198,6 +1249,11 @@ rte_eal_init(int argc, char **argv)
 		rte_errno = ENODEV;
 		return -1;
 	}
+	heap_ms = eal_init_step_time(&step_start);
+
+	EAL_LOG(DEBUG, "Memory init time: hugepage info %.3f ms, "
+		"memory %.3f ms, malloc heap %.3f ms",
+		hugepage_info_ms, memory_ms, heap_ms);
 
 	/* register multi-process action callbacks for hotplug after memory init */
 	if (eal_mp_dev_hotplug_init() < 0) {
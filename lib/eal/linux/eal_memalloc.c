@@ -31,12 +31,17 @@
 #include <rte_log.h>
 #include <rte_eal.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
+#include <rte_spinlock.h>
+#include <rte_stdatomic.h>
+#include <rte_thread.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -97,11 +102,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* pages may be mapped from several threads at init */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -110,11 +116,14 @@ static void huge_sigbus_handler(int signo __rte_unused)
  */
 static int huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
 static int huge_need_recover;
+/* the handler is installed while any thread is mapping a page */
+static unsigned int huge_sigbus_users;
+static rte_spinlock_t huge_sigbus_lock = RTE_SPINLOCK_INITIALIZER;
 
 static void
 huge_register_sigbus(void)
@@ -122,22 +131,28 @@ huge_register_sigbus(void)
 	sigset_t mask;
 	struct sigaction action;
 
-	sigemptyset(&mask);
-	sigaddset(&mask, SIGBUS);
-	action.sa_flags = 0;
-	action.sa_mask = mask;
-	action.sa_handler = huge_sigbus_handler;
+	rte_spinlock_lock(&huge_sigbus_lock);
+	if (huge_sigbus_users++ == 0) {
+		sigemptyset(&mask);
+		sigaddset(&mask, SIGBUS);
+		action.sa_flags = 0;
+		action.sa_mask = mask;
+		action.sa_handler = huge_sigbus_handler;
 
-	huge_need_recover = !sigaction(SIGBUS, &action, &huge_action_old);
+		huge_need_recover = !sigaction(SIGBUS, &action, &huge_action_old);
+	}
+	rte_spinlock_unlock(&huge_sigbus_lock);
 }
 
 static void
 huge_recover_sigbus(void)
 {
-	if (huge_need_recover) {
+	rte_spinlock_lock(&huge_sigbus_lock);
+	if (--huge_sigbus_users == 0 && huge_need_recover) {
 		sigaction(SIGBUS, &huge_action_old, NULL);
 		huge_need_recover = 0;
 	}
+	rte_spinlock_unlock(&huge_sigbus_lock);
 }
 
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
@@ -620,6 +635,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 	if (va != addr) {
 		EAL_LOG(DEBUG, "%s(): wrong mmap() address", __func__);
 		munmap(va, alloc_sz);
+		huge_recover_sigbus();
 		goto resized;
 	}
 
@@ -742,8 +758,11 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
-	/* erase page data */
-	memset(ms->addr, 0, ms->len);
+	/* erase page data, unless the page is given back to the kernel,
+	 * which clears it before it is mapped again.
+	 */
+	if (!internal_conf->in_memory)
+		memset(ms->addr, 0, ms->len);
 
 	if (mmap(ms->addr, ms->len, PROT_NONE,
 			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) ==
@@ -807,9 +826,122 @@ struct alloc_walk_param {
 	size_t page_sz;
 	unsigned int segs_allocated;
 	unsigned int n_segs;
+	unsigned int n_threads;
 	int socket;
 	bool exact;
 };
+
+struct alloc_thread_param {
+	struct alloc_walk_param *wa;
+	struct rte_memseg_list *msl;
+	unsigned int msl_idx;
+	int start_idx;
+	unsigned int need;
+	RTE_ATOMIC(unsigned int) next; /**< next page to map */
+	RTE_ATOMIC(unsigned int) failed; /**< first page which was not mapped */
+};
+
+static uint32_t
+alloc_seg_thread(void *arg)
+{
+	struct alloc_thread_param *param = arg;
+	struct alloc_walk_param *wa = param->wa;
+	struct rte_memseg_list *msl = param->msl;
+	unsigned int i, failed;
+	int seg_idx;
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	if (check_numa())
+		numa_set_preferred(wa->socket);
+#endif
+
+	for (;;) {
+		i = rte_atomic_fetch_add_explicit(&param->next, 1,
+				rte_memory_order_relaxed);
+		if (i >= param->need || i > rte_atomic_load_explicit(
+				&param->failed, rte_memory_order_relaxed))
+			break;
+
+		seg_idx = param->start_idx + i;
+		if (alloc_seg(rte_fbarray_get(&msl->memseg_arr, seg_idx),
+				RTE_PTR_ADD(msl->base_va, seg_idx * msl->page_sz),
+				wa->socket, wa->hi, param->msl_idx, seg_idx) == 0)
+			continue;
+
+		failed = rte_atomic_load_explicit(&param->failed,
+				rte_memory_order_relaxed);
+		while (i < failed && !rte_atomic_compare_exchange_weak_explicit(
+				&param->failed, &failed, i,
+				rte_memory_order_relaxed, rte_memory_order_relaxed))
+			;
+	}
+
+	return 0;
+}
+
+/*
+ * Map pages of a memseg list from several threads running on the CPUs of
+ * the socket, for the kernel to fault and clear the pages in parallel.
+ * On return, the pages are mapped up to the first failure, like when mapped
+ * in order.
+ */
+static void
+alloc_seg_parallel(struct alloc_walk_param *wa, struct rte_memseg_list *msl,
+		unsigned int msl_idx, int start_idx, unsigned int need)
+{
+	rte_thread_t threads[RTE_MAX_LCORE];
+	struct alloc_thread_param param;
+	unsigned int i, n_threads, failed;
+	rte_thread_attr_t attr;
+	rte_cpuset_t cpuset;
+	struct rte_memseg *ms;
+
+	param.wa = wa;
+	param.msl = msl;
+	param.msl_idx = msl_idx;
+	param.start_idx = start_idx;
+	param.need = need;
+	rte_atomic_store_explicit(&param.next, 0, rte_memory_order_relaxed);
+	rte_atomic_store_explicit(&param.failed, need, rte_memory_order_relaxed);
+
+	CPU_ZERO(&cpuset);
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		if (eal_cpu_detected(i) &&
+				eal_cpu_socket_id(i) == (unsigned int)wa->socket)
+			CPU_SET(i, &cpuset);
+
+	rte_thread_attr_init(&attr);
+	if (CPU_COUNT(&cpuset) > 0)
+		rte_thread_attr_set_affinity(&attr, &cpuset);
+
+	/* the calling thread maps pages too */
+	n_threads = RTE_MIN(wa->n_threads, need) - 1;
+	for (i = 0; i < n_threads; i++) {
+		if (rte_thread_create(&threads[i], &attr, alloc_seg_thread,
+				&param) != 0) {
+			EAL_LOG(DEBUG, "%s(): cannot create thread: %s",
+				__func__, strerror(errno));
+			break;
+		}
+	}
+	n_threads = i;
+
+	alloc_seg_thread(&param);
+
+	for (i = 0; i < n_threads; i++)
+		rte_thread_join(threads[i], NULL);
+
+	/* release the pages mapped after the first failure */
+	failed = rte_atomic_load_explicit(&param.failed,
+			rte_memory_order_relaxed);
+	for (i = failed + 1; i < need; i++) {
+		ms = rte_fbarray_get(&msl->memseg_arr, start_idx + i);
+		if (ms->addr != NULL &&
+				free_seg(ms, wa->hi, msl_idx, start_idx + i))
+			EAL_LOG(DEBUG, "Cannot free page");
+	}
+}
+
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -819,6 +951,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	size_t page_sz;
 	int cur_idx, start_idx, j, dir_fd = -1;
 	unsigned int msl_idx, need, i;
+	bool parallel;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
@@ -886,6 +1019,10 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
+	parallel = wa->n_threads > 1 && need > 1;
+	if (parallel)
+		alloc_seg_parallel(wa, cur_msl, msl_idx, start_idx, need);
+
 	for (i = 0; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
@@ -894,8 +1031,9 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		map_addr = RTE_PTR_ADD(cur_msl->base_va,
 				cur_idx * page_sz);
 
-		if (alloc_seg(cur, map_addr, wa->socket, wa->hi,
-				msl_idx, cur_idx)) {
+		if (parallel ? cur->addr == NULL :
+				alloc_seg(cur, map_addr, wa->socket, wa->hi,
+					msl_idx, cur_idx)) {
 			EAL_LOG(DEBUG, "attempted to allocate %i segments, but only %i were allocated",
 				need, i);
 
@@ -1057,6 +1195,9 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 	wa.page_sz = page_sz;
 	wa.socket = socket;
 	wa.segs_allocated = 0;
+	/* pages are mapped in parallel at init only */
+	wa.n_threads = internal_conf->init_complete ? 1 :
+			internal_conf->huge_init_threads;
 
 	/* memalloc is locked, so it's safe to use thread-unsafe version */
 	ret = rte_memseg_list_walk_thread_unsafe(alloc_seg_walk, &wa);
@@ -399,6 +399,13 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	if (graph_has_isolated_node(graph))
 		goto graph_cleanup;
 
+	/* Histogram sampling period must be a power of 2 */
+	if (prm->hist_sample_period != 0 &&
+	    !rte_is_power_of_2(prm->hist_sample_period))
+		SET_ERR_JMP(EINVAL, graph_cleanup,
+			    "Invalid histogram sample period %u",
+			    prm->hist_sample_period);
+
 	/* Initialize pcap config. */
 	graph_pcap_enable(prm->pcap_enable);
 
@@ -412,6 +419,10 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph->num_pkt_to_capture = prm->num_pkt_to_capture;
 	if (prm->pcap_filename)
 		rte_strscpy(graph->pcap_filename, prm->pcap_filename, RTE_GRAPH_PCAP_FILE_SZ);
+	graph->hist_enable = prm->hist_enable;
+	graph->hist_sample_mask = (prm->hist_sample_period != 0 ?
+				   prm->hist_sample_period :
+				   RTE_GRAPH_HIST_SAMPLE_PERIOD) - 1;
 
 	/* Allocate the Graph fast path memory and populate the data */
 	if (graph_fp_mem_create(graph))
@@ -455,6 +466,9 @@ rte_graph_destroy(rte_graph_t id)
 			if (rte_graph_worker_model_get(graph->graph) ==
 			    RTE_GRAPH_MODEL_MCORE_DISPATCH)
 				graph_sched_wq_destroy(graph);
+			else if (rte_graph_worker_model_get(graph->graph) ==
+				 RTE_GRAPH_MODEL_WORK_STEAL)
+				graph_steal_wq_destroy(graph);
 
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
@@ -520,6 +534,8 @@ graph_clone(struct graph *parent_graph, const char *name, struct rte_graph_param
 	graph->parent_id = parent_graph->id;
 	graph->lcore_id = parent_graph->lcore_id;
 	graph->socket = parent_graph->socket;
+	graph->hist_enable = parent_graph->hist_enable;
+	graph->hist_sample_mask = parent_graph->hist_sample_mask;
 	graph->id = graph_id;
 
 	/* Allocate the Graph fast path memory and populate the data */
@@ -534,6 +550,11 @@ graph_clone(struct graph *parent_graph, const char *name, struct rte_graph_param
 	    graph_sched_wq_create(graph, parent_graph, prm))
 		goto graph_mem_destroy;
 
+	/* Create the graph work queue for stealing streams */
+	if (rte_graph_worker_model_get(graph->graph) == RTE_GRAPH_MODEL_WORK_STEAL &&
+	    graph_steal_wq_create(graph, parent_graph, prm))
+		goto graph_mem_destroy;
+
 	/* Call init() of the all the nodes in the graph */
 	if (graph_node_init(graph))
 		goto graph_mem_destroy;
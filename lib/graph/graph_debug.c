@@ -56,6 +56,8 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  cir_mask=0x%" PRIx32 "\n", g->cir_mask);
 	fprintf(f, "  nb_nodes=%" PRId32 "\n", g->nb_nodes);
 	fprintf(f, "  socket=%d\n", g->socket);
+	fprintf(f, "  hist_enable=%u\n", g->hist_enable);
+	fprintf(f, "  hist_sample_mask=0x%" PRIx16 "\n", g->hist_sample_mask);
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
@@ -79,6 +81,12 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 				n->dispatch.total_sched_objs);
 			fprintf(f, "       total_sched_fail=%" PRId64 "\n",
 				n->dispatch.total_sched_fail);
+		} else if (rte_graph_worker_model_get(g) == RTE_GRAPH_MODEL_WORK_STEAL) {
+			fprintf(f, "       steal_mode=%d\n", n->steal.mode);
+			fprintf(f, "       total_sched_objs=%" PRId64 "\n",
+				n->steal.total_sched_objs);
+			fprintf(f, "       total_stolen_objs=%" PRId64 "\n",
+				n->steal.total_stolen_objs);
 		}
 		fprintf(f, "       total_calls=%" PRId64 "\n", n->total_calls);
 		for (i = 0; i < n->nb_edges; i++)
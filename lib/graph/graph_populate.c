@@ -38,6 +38,13 @@ graph_fp_mem_calc_size(struct graph *graph)
 		sz += sizeof(struct rte_node);
 		/* Pointer to next nodes(edges) */
 		sz += sizeof(struct rte_node *) * graph_node->node->nb_edges;
+		/* Node histograms */
+		if (graph->hist_enable)
+			sz += sizeof(struct rte_node_hist);
+		/* Node specific xstats counters */
+		if (graph_node->node->xstats != NULL)
+			sz += sizeof(uint64_t) *
+			      graph_node->node->xstats->nb_xstats;
 	}
 
 	graph->mem_sz = sz;
@@ -57,6 +64,8 @@ graph_header_popluate(struct graph *_graph)
 	graph->nodes_start = _graph->nodes_start;
 	graph->socket = _graph->socket;
 	graph->id = _graph->id;
+	graph->hist_enable = _graph->hist_enable;
+	graph->hist_sample_mask = _graph->hist_sample_mask;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
 	graph->fence = RTE_GRAPH_FENCE;
 }
@@ -67,6 +76,7 @@ graph_nodes_populate(struct graph *_graph)
 	rte_graph_off_t off = _graph->nodes_start;
 	struct rte_graph *graph = _graph->graph;
 	struct graph_node *graph_node;
+	struct rte_node_xstats *xstats;
 	rte_edge_t count, nb_edges;
 	const char *parent;
 	rte_node_t pid;
@@ -100,6 +110,17 @@ graph_nodes_populate(struct graph *_graph)
 						     ->node->name[0];
 
 		off += sizeof(struct rte_node *) * nb_edges;
+		if (_graph->hist_enable) {
+			memset(RTE_PTR_ADD(graph, off), 0, sizeof(struct rte_node_hist));
+			off += sizeof(struct rte_node_hist);
+		}
+		xstats = graph_node->node->xstats;
+		if (xstats != NULL) {
+			node->xstat_off = off - node->off;
+			memset(RTE_PTR_ADD(graph, off), 0,
+			       sizeof(uint64_t) * xstats->nb_xstats);
+			off += sizeof(uint64_t) * xstats->nb_xstats;
+		}
 		off = RTE_ALIGN(off, RTE_CACHE_LINE_SIZE);
 		node->next = off;
 		__rte_node_stream_alloc(graph, node);
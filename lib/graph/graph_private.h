@@ -55,9 +55,12 @@ struct node {
 	uint64_t flags;		      /**< Node configuration flag. */
 	unsigned int lcore_id;
 	/**< Node runs on the Lcore ID used for mcore dispatch model. */
+	uint8_t steal_mode;
+	/**< Node stream stealing mode used for work-steal model. */
 	rte_node_process_t process;   /**< Node process function. */
 	rte_node_init_t init;         /**< Node init function. */
 	rte_node_fini_t fini;	      /**< Node fini function. */
+	struct rte_node_xstats *xstats; /**< Node specific xstats. */
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
@@ -76,6 +79,44 @@ struct __rte_cache_aligned graph_mcore_dispatch_wq_node {
 	void *objs[RTE_GRAPH_BURST_SIZE];
 };
 
+/**
+ * @internal
+ *
+ * Structure that holds a stream queued on a graph work queue.
+ * Used for work-steal model.
+ */
+struct __rte_cache_aligned graph_work_steal_task {
+	struct rte_node *owner;	  /**< Node of the graph which queued the stream. */
+	rte_graph_off_t node_off; /**< Offset of the node in the graph reel. */
+	uint16_t seq;		  /**< Sequence number of the stream in the node. */
+	uint16_t nb_objs;	  /**< Number of objects in the stream. */
+	bool ordered;		  /**< Streams of the node are processed in order. */
+	void *objs[RTE_GRAPH_BURST_SIZE];
+};
+
+/**
+ * @internal
+ *
+ * Structure that holds the graph work queue for work-steal model.
+ * Only the graph owning the work queue pushes streams, at the bottom, while
+ * any graph of the group takes them from the top.
+ */
+struct rte_graph_work_steal_wq {
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) top;
+	/**< Index of the next stream to take. */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) bottom;
+	/**< Index of the next stream to push. */
+	uint32_t mask;		  /**< Mask of the work queue size. */
+	uint32_t nb_deferred;	  /**< Number of nodes deferred to the next walk. */
+	rte_graph_off_t *deferred; /**< Offsets of the nodes deferred to the next walk. */
+	struct rte_mempool *mp;	  /**< Pool of the queued streams. */
+	struct rte_graph *victim; /**< Next graph to steal a stream from. */
+	void **stream;		  /**< Spare stream to process the taken streams in. */
+	uint16_t stream_size;	  /**< Size of the spare stream. */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(struct graph_work_steal_task *) tasks[];
+	/**< Ring of the queued streams. */
+};
+
 /**
  * @internal
  *
@@ -126,6 +167,10 @@ struct graph {
 	/**< Number of packets to be captured per core. */
 	char pcap_filename[RTE_GRAPH_PCAP_FILE_SZ];
 	/**< pcap file name/path. */
+	uint8_t hist_enable;
+	/**< Node histograms are collected. */
+	uint16_t hist_sample_mask;
+	/**< Mask of node calls sampled in histograms. */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
 };
@@ -445,4 +490,35 @@ int graph_sched_wq_create(struct graph *_graph, struct graph *_parent_graph,
  */
 void graph_sched_wq_destroy(struct graph *_graph);
 
+/**
+ * @internal
+ *
+ * Create the graph work queue for work-steal model.
+ * All cloned graphs attached to the parent graph MUST be destroyed together
+ * for fast schedule design limitation.
+ *
+ * @param _graph
+ *   The graph object
+ * @param _parent_graph
+ *   The parent graph object which holds the run-queue head.
+ * @param prm
+ *   Graph parameter, includes model-specific parameters in this graph.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Graph work queue related error.
+ */
+int graph_steal_wq_create(struct graph *_graph, struct graph *_parent_graph,
+			  struct rte_graph_param *prm);
+
+/**
+ * @internal
+ *
+ * Destroy the graph work queue for work-steal model.
+ *
+ * @param _graph
+ *   The graph object
+ */
+void graph_steal_wq_destroy(struct graph *_graph);
+
 #endif /* _RTE_GRAPH_PRIVATE_H_ */
@@ -9,6 +9,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -20,12 +21,26 @@ struct cluster {
 	struct graph **graphs;
 };
 
+/* Node of a graph of the cluster */
+struct cluster_graph_node {
+	struct rte_node *node;
+	/* NULL if the graph does not collect histograms */
+	struct rte_node_hist *hist;
+};
+
 /* Capture same node ID across cluster  */
 struct cluster_node {
 	struct rte_graph_cluster_node_stats stat;
 	rte_node_t nb_nodes;
 
-	struct rte_node *nodes[];
+	struct cluster_graph_node nodes[];
+};
+
+/* Percentiles reported, in units of 0.001% */
+static const uint32_t hist_pct_q[RTE_GRAPH_HIST_PCT_MAX] = {
+	[RTE_GRAPH_HIST_P50] = 50000,
+	[RTE_GRAPH_HIST_P99] = 99000,
+	[RTE_GRAPH_HIST_P999] = 99900,
 };
 
 struct __rte_cache_aligned rte_graph_cluster_stats {
@@ -73,12 +88,28 @@ print_banner_dispatch(FILE *f)
 	boarder_model_dispatch();
 }
 
+static inline void
+print_banner_steal(FILE *f)
+{
+	boarder_model_dispatch();
+	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-16s%-16s%-16s\n",
+		"|Node", "|calls",
+		"|objs", "|queued objs", "|stolen objs",
+		"|realloc_count", "|objs/call", "|objs/sec(10E6)",
+		"|cycles/call|");
+	boarder_model_dispatch();
+}
+
 static inline void
 print_banner(FILE *f)
 {
-	if (rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph) ==
-	    RTE_GRAPH_MODEL_MCORE_DISPATCH)
+	int model;
+
+	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
+	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 		print_banner_dispatch(f);
+	else if (model == RTE_GRAPH_MODEL_WORK_STEAL)
+		print_banner_steal(f);
 	else
 		print_banner_default(f);
 }
@@ -93,6 +124,7 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	const uint64_t calls = stat->calls;
 	const uint64_t objs = stat->objs;
 	uint64_t call_delta;
+	int model;
 
 	call_delta = calls - prev_calls;
 	objs_per_call =
@@ -104,8 +136,8 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	objs_per_sec = ts_per_hz ? (objs - prev_objs) / ts_per_hz : 0;
 	objs_per_sec /= 1000000;
 
-	if (rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph) ==
-	    RTE_GRAPH_MODEL_MCORE_DISPATCH) {
+	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
+	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 		fprintf(f,
 			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
 			"|%-15" PRIu64 "|%-15" PRIu64
@@ -113,6 +145,14 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 			stat->name, calls, objs, stat->dispatch.sched_objs,
 			stat->dispatch.sched_fail, stat->realloc_count, objs_per_call,
 			objs_per_sec, cycles_per_call);
+	} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+		fprintf(f,
+			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
+			"|%-15" PRIu64 "|%-15" PRIu64
+			"|%-15.3f|%-15.6f|%-11.4f|\n",
+			stat->name, calls, objs, stat->steal.queued_objs,
+			stat->steal.stolen_objs, stat->realloc_count, objs_per_call,
+			objs_per_sec, cycles_per_call);
 	} else {
 		fprintf(f,
 			"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
@@ -122,6 +162,32 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	}
 }
 
+static inline void
+print_xstats(FILE *f, const struct rte_graph_cluster_node_stats *stat)
+{
+	uint16_t i;
+
+	for (i = 0; i < stat->xstat_cntrs; i++)
+		fprintf(f, "|  %-29s|%-15" PRIu64 "|\n", stat->xstat_desc[i],
+			stat->xstat_count[i]);
+}
+
+static inline void
+print_hist(FILE *f, const struct rte_graph_cluster_node_stats *stat)
+{
+	if (stat->hist_samples == 0)
+		return;
+
+	fprintf(f, "|  %-29s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64 "|\n",
+		"objs/call p50/p99/p99.9", stat->objs_pct[RTE_GRAPH_HIST_P50],
+		stat->objs_pct[RTE_GRAPH_HIST_P99],
+		stat->objs_pct[RTE_GRAPH_HIST_P999]);
+	fprintf(f, "|  %-29s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64 "|\n",
+		"cycles/call p50/p99/p99.9", stat->cycles_pct[RTE_GRAPH_HIST_P50],
+		stat->cycles_pct[RTE_GRAPH_HIST_P99],
+		stat->cycles_pct[RTE_GRAPH_HIST_P999]);
+}
+
 static int
 graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
 		       const struct rte_graph_cluster_node_stats *stat)
@@ -133,10 +199,14 @@ graph_cluster_stats_cb(bool is_first, bool is_last, void *cookie,
 
 	if (unlikely(is_first))
 		print_banner(f);
-	if (stat->objs)
+	if (stat->objs) {
 		print_node(f, stat);
+		print_xstats(f, stat);
+		print_hist(f, stat);
+	}
 	if (unlikely(is_last)) {
-		if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH)
+		if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH ||
+		    model == RTE_GRAPH_MODEL_WORK_STEAL)
 			boarder_model_dispatch();
 		else
 			boarder();
@@ -162,7 +232,7 @@ stats_mem_init(struct cluster *cluster,
 
 	cluster_node_size = sizeof(struct cluster_node);
 	/* For a given cluster, max nodes will be the max number of graphs */
-	cluster_node_size += cluster->nb_graphs * sizeof(struct rte_node *);
+	cluster_node_size += cluster->nb_graphs * sizeof(struct cluster_graph_node);
 	cluster_node_size = RTE_ALIGN(cluster_node_size, RTE_CACHE_LINE_SIZE);
 
 	stats = realloc(NULL, sz);
@@ -179,6 +249,63 @@ stats_mem_init(struct cluster *cluster,
 	return stats;
 }
 
+static void
+stats_mem_xstats_free(struct rte_graph_cluster_stats *stats)
+{
+	struct cluster_node *cluster;
+	rte_node_t count;
+
+	if (stats == NULL)
+		return;
+
+	cluster = stats->clusters;
+	for (count = 0; count < stats->max_nodes; count++) {
+		rte_free(cluster->stat.xstat_desc);
+		rte_free(cluster->stat.xstat_count);
+		cluster = RTE_PTR_ADD(cluster, stats->cluster_node_size);
+	}
+}
+
+static int
+stats_mem_xstats_alloc(struct rte_graph_cluster_stats *stats,
+		       struct cluster_node *cluster,
+		       const struct rte_node_xstats *xstats)
+{
+	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
+	uint16_t nb_xstats = xstats->nb_xstats;
+
+	stat->xstat_desc = rte_zmalloc_socket(NULL,
+			nb_xstats * RTE_NODE_XSTAT_DESC_SIZE, 0,
+			stats->socket_id);
+	stat->xstat_count = rte_zmalloc_socket(NULL,
+			nb_xstats * sizeof(uint64_t), 0, stats->socket_id);
+	if (stat->xstat_desc == NULL || stat->xstat_count == NULL)
+		SET_ERR_JMP(ENOMEM, err, "Failed to alloc xstats of node %s",
+			    stat->name);
+
+	memcpy(stat->xstat_desc, xstats->xstat_desc,
+	       nb_xstats * RTE_NODE_XSTAT_DESC_SIZE);
+	stat->xstat_cntrs = nb_xstats;
+
+	return 0;
+err:
+	rte_free(stat->xstat_desc);
+	rte_free(stat->xstat_count);
+	stat->xstat_desc = NULL;
+	stat->xstat_count = NULL;
+	return -rte_errno;
+}
+
+static void
+cluster_graph_node_add(struct cluster_node *cluster, struct rte_graph *graph,
+		       struct rte_node *node)
+{
+	struct cluster_graph_node *gnode = &cluster->nodes[cluster->nb_nodes++];
+
+	gnode->node = node;
+	gnode->hist = graph->hist_enable ? __rte_node_hist_get(node) : NULL;
+}
+
 static int
 stats_mem_populate(struct rte_graph_cluster_stats **stats_in,
 		   struct rte_graph *graph, struct graph_node *graph_node)
@@ -202,7 +329,7 @@ stats_mem_populate(struct rte_graph_cluster_stats **stats_in,
 					"Failed to find node %s in graph %s",
 					graph_node->node->name, graph->name);
 
-			cluster->nodes[cluster->nb_nodes++] = node;
+			cluster_graph_node_add(cluster, graph, node);
 			return 0;
 		}
 		cluster = RTE_PTR_ADD(cluster, stats->cluster_node_size);
@@ -224,14 +351,19 @@ stats_mem_populate(struct rte_graph_cluster_stats **stats_in,
 	if (node == NULL)
 		SET_ERR_JMP(ENOENT, free, "Failed to find node %s in graph %s",
 			    graph_node->node->name, graph->name);
-	cluster->nodes[cluster->nb_nodes++] = node;
+	cluster_graph_node_add(cluster, graph, node);
 
 	stats->sz += stats->cluster_node_size;
 	stats->max_nodes++;
 	*stats_in = stats;
 
+	if (graph_node->node->xstats != NULL)
+		return stats_mem_xstats_alloc(stats, cluster,
+					      graph_node->node->xstats);
+
 	return 0;
 free:
+	stats_mem_xstats_free(stats);
 	free(stats);
 err:
 	return -rte_errno;
@@ -360,6 +492,8 @@ rte_graph_cluster_stats_create(const struct rte_graph_cluster_stats_param *prm)
 		SET_ERR_JMP(ENOMEM, realloc_fail, "rte_malloc failed");
 
 realloc_fail:
+	if (rc == NULL)
+		stats_mem_xstats_free(stats);
 	stats_mem_fini(stats);
 bad_pattern:
 	graph_spinlock_unlock();
@@ -371,32 +505,114 @@ rte_graph_cluster_stats_create(const struct rte_graph_cluster_stats_param *prm)
 void
 rte_graph_cluster_stats_destroy(struct rte_graph_cluster_stats *stat)
 {
+	stats_mem_xstats_free(stat);
 	return rte_free(stat);
 }
 
+/*
+ * Value below which the given fraction of the samples are, interpolated
+ * linearly within the log2 bucket holding it.
+ */
+static uint64_t
+hist_percentile(const uint64_t *buckets, unsigned int nb_buckets,
+		uint64_t samples, uint32_t q)
+{
+	uint64_t rank, cum = 0, low;
+	unsigned int i;
+
+	rank = RTE_MAX((samples * q + 99999) / 100000, UINT64_C(1));
+	for (i = 0; i < nb_buckets; i++) {
+		if (cum + buckets[i] >= rank)
+			break;
+		cum += buckets[i];
+	}
+
+	if (i == 0)
+		return 0;
+	low = RTE_BIT64(i - 1);
+	/* The last bucket is open-ended */
+	if (i >= nb_buckets - 1)
+		return low;
+
+	return low + (uint64_t)((double)low * (rank - cum - 1) / buckets[i]);
+}
+
+static inline void
+cluster_node_arregate_hist(struct cluster_node *cluster)
+{
+	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
+	const struct rte_node_hist *hist;
+	rte_node_t count;
+	unsigned int i;
+
+	memset(&stat->hist, 0, sizeof(stat->hist));
+	for (count = 0; count < cluster->nb_nodes; count++) {
+		hist = cluster->nodes[count].hist;
+		if (hist == NULL)
+			continue;
+
+		for (i = 0; i < RTE_NODE_HIST_OBJS_BUCKETS; i++)
+			stat->hist.objs[i] += hist->objs[i];
+		for (i = 0; i < RTE_NODE_HIST_CYCLES_BUCKETS; i++)
+			stat->hist.cycles[i] += hist->cycles[i];
+	}
+
+	/* Both histograms count every sample */
+	stat->hist_samples = 0;
+	for (i = 0; i < RTE_NODE_HIST_OBJS_BUCKETS; i++)
+		stat->hist_samples += stat->hist.objs[i];
+
+	for (i = 0; i < RTE_GRAPH_HIST_PCT_MAX; i++) {
+		if (stat->hist_samples == 0) {
+			stat->objs_pct[i] = 0;
+			stat->cycles_pct[i] = 0;
+			continue;
+		}
+		stat->objs_pct[i] = hist_percentile(stat->hist.objs,
+						    RTE_NODE_HIST_OBJS_BUCKETS,
+						    stat->hist_samples, hist_pct_q[i]);
+		stat->cycles_pct[i] = hist_percentile(stat->hist.cycles,
+						      RTE_NODE_HIST_CYCLES_BUCKETS,
+						      stat->hist_samples, hist_pct_q[i]);
+	}
+}
+
 static inline void
 cluster_node_arregate_stats(struct cluster_node *cluster)
 {
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
 	uint64_t sched_objs = 0, sched_fail = 0;
+	uint64_t queued_objs = 0, stolen_objs = 0;
 	struct rte_node *node;
 	rte_node_t count;
+	uint64_t *xstat;
+	uint16_t i;
 	int model;
 
+	for (i = 0; i < stat->xstat_cntrs; i++)
+		stat->xstat_count[i] = 0;
+
 	model = rte_graph_worker_model_get(STAILQ_FIRST(graph_list_head_get())->graph);
 	for (count = 0; count < cluster->nb_nodes; count++) {
-		node = cluster->nodes[count];
+		node = cluster->nodes[count].node;
 
 		if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 			sched_objs += node->dispatch.total_sched_objs;
 			sched_fail += node->dispatch.total_sched_fail;
+		} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+			queued_objs += node->steal.total_sched_objs;
+			stolen_objs += node->steal.total_stolen_objs;
 		}
 
 		calls += node->total_calls;
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+
+		xstat = RTE_PTR_ADD(node, node->xstat_off);
+		for (i = 0; i < stat->xstat_cntrs; i++)
+			stat->xstat_count[i] += xstat[i];
 	}
 
 	stat->calls = calls;
@@ -406,10 +622,15 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	if (model == RTE_GRAPH_MODEL_MCORE_DISPATCH) {
 		stat->dispatch.sched_objs = sched_objs;
 		stat->dispatch.sched_fail = sched_fail;
+	} else if (model == RTE_GRAPH_MODEL_WORK_STEAL) {
+		stat->steal.queued_objs = queued_objs;
+		stat->steal.stolen_objs = stolen_objs;
 	}
 
 	stat->ts = rte_get_timer_cycles();
 	stat->realloc_count = realloc_count;
+
+	cluster_node_arregate_hist(cluster);
 }
 
 static inline void
@@ -449,6 +670,7 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 {
 	struct cluster_node *cluster;
 	rte_node_t count;
+	uint16_t i;
 
 	cluster = stat->clusters;
 
@@ -464,6 +686,105 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		for (i = 0; i < node->xstat_cntrs; i++)
+			node->xstat_count[i] = 0;
+		node->hist_samples = 0;
+		memset(&node->hist, 0, sizeof(node->hist));
+		memset(node->objs_pct, 0, sizeof(node->objs_pct));
+		memset(node->cycles_pct, 0, sizeof(node->cycles_pct));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static int
+graph_handle_list(const char *cmd __rte_unused,
+		  const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static int
+graph_tel_node_stats_cb(bool is_first __rte_unused, bool is_last __rte_unused,
+			void *cookie, const struct rte_graph_cluster_node_stats *stat)
+{
+	static const char * const pct_names[RTE_GRAPH_HIST_PCT_MAX] = {
+		[RTE_GRAPH_HIST_P50] = "p50",
+		[RTE_GRAPH_HIST_P99] = "p99",
+		[RTE_GRAPH_HIST_P999] = "p999",
+	};
+	char name[RTE_TEL_MAX_STRING_LEN];
+	struct rte_tel_data *d = cookie;
+	struct rte_tel_data *c;
+	unsigned int i;
+
+	c = rte_tel_data_alloc();
+	if (c == NULL)
+		return -ENOMEM;
+
+	rte_tel_data_start_dict(c);
+	rte_tel_data_add_dict_uint(c, "calls", stat->calls);
+	rte_tel_data_add_dict_uint(c, "objs", stat->objs);
+	rte_tel_data_add_dict_uint(c, "cycles", stat->cycles);
+	rte_tel_data_add_dict_uint(c, "realloc_count", stat->realloc_count);
+	rte_tel_data_add_dict_uint(c, "hist_samples", stat->hist_samples);
+	for (i = 0; stat->hist_samples != 0 && i < RTE_GRAPH_HIST_PCT_MAX; i++) {
+		snprintf(name, sizeof(name), "objs_%s", pct_names[i]);
+		rte_tel_data_add_dict_uint(c, name, stat->objs_pct[i]);
+		snprintf(name, sizeof(name), "cycles_%s", pct_names[i]);
+		rte_tel_data_add_dict_uint(c, name, stat->cycles_pct[i]);
+	}
+
+	if (rte_tel_data_add_dict_container(d, stat->name, c, 0) != 0)
+		rte_tel_data_free(c);
+
+	return 0;
+}
+
+static int
+graph_handle_node_stats(const char *cmd __rte_unused, const char *params,
+			struct rte_tel_data *d)
+{
+	struct rte_graph_cluster_stats_param prm;
+	struct rte_graph_cluster_stats *stats;
+	const char *pattern;
+
+	if (!params || strlen(params) == 0)
+		return -EINVAL;
+
+	if (!rte_graph_has_stats_feature())
+		return -ENOTSUP;
+
+	memset(&prm, 0, sizeof(prm));
+	pattern = params;
+	prm.graph_patterns = &pattern;
+	prm.nb_graph_patterns = 1;
+	prm.socket_id = SOCKET_ID_ANY;
+	prm.fn = graph_tel_node_stats_cb;
+	prm.cookie = d;
+
+	stats = rte_graph_cluster_stats_create(&prm);
+	if (stats == NULL)
+		return -EINVAL;
+
+	rte_tel_data_start_dict(d);
+	rte_graph_cluster_stats_get(stats, false);
+	rte_graph_cluster_stats_destroy(stats);
+
+	return 0;
+}
+
+RTE_INIT(graph_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_handle_list,
+		"Returns list of available graphs. Takes no parameters");
+	rte_telemetry_register_cmd("/graph/node_stats", graph_handle_node_stats,
+		"Returns node stats and histograms of graphs. Parameters: graph name or pattern");
+}
@@ -115,12 +115,61 @@ __rte_node_register(const struct rte_node_register *reg)
 	return RTE_NODE_ID_INVALID;
 }
 
+static int
+node_xstats_set(struct node *node, const struct rte_node_xstats *xstats)
+{
+	struct rte_node_xstats *copy;
+	uint16_t i;
+
+	if (node->xstats != NULL)
+		return -EEXIST;
+
+	copy = calloc(1, sizeof(*copy) +
+		      xstats->nb_xstats * RTE_NODE_XSTAT_DESC_SIZE);
+	if (copy == NULL)
+		return -ENOMEM;
+
+	copy->nb_xstats = xstats->nb_xstats;
+	for (i = 0; i < xstats->nb_xstats; i++) {
+		if (rte_strscpy(copy->xstat_desc[i], xstats->xstat_desc[i],
+				RTE_NODE_XSTAT_DESC_SIZE) < 0) {
+			free(copy);
+			return -EINVAL;
+		}
+	}
+
+	node->xstats = copy;
+	return 0;
+}
+
+int
+rte_node_xstats_register(rte_node_t id, const struct rte_node_xstats *xstats)
+{
+	struct node *node;
+	int rc = -EINVAL;
+
+	if (xstats == NULL || xstats->nb_xstats == 0)
+		return -EINVAL;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(node, &node_list, next) {
+		if (node->id == id) {
+			rc = node_xstats_set(node, xstats);
+			break;
+		}
+	}
+	graph_spinlock_unlock();
+
+	return rc;
+}
+
 static rte_node_t
 node_clone(struct node *node, const char *name)
 {
 	rte_node_t rc = RTE_NODE_ID_INVALID;
 	struct rte_node_register *reg;
 	rte_edge_t i;
+	int ret;
 
 	/* Don't allow to clone a node from a cloned node */
 	if (node->parent_id != RTE_NODE_ID_INVALID) {
@@ -150,6 +199,13 @@ node_clone(struct node *node, const char *name)
 		goto free;
 
 	rc = __rte_node_register(reg);
+	if (rc != RTE_NODE_ID_INVALID && node->xstats != NULL) {
+		ret = rte_node_xstats_register(rc, node->xstats);
+		if (ret < 0) {
+			rte_errno = -ret;
+			rc = RTE_NODE_ID_INVALID;
+		}
+	}
 free:
 	free(reg);
 fail:
@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,10 @@ extern "C" {
 #define RTE_GRAPH_NAMESIZE 64 /**< Max length of graph name. */
 #define RTE_NODE_NAMESIZE 64  /**< Max length of node name. */
 #define RTE_GRAPH_PCAP_FILE_SZ 64 /**< Max length of pcap file name. */
+#define RTE_NODE_XSTAT_DESC_SIZE 64 /**< Max length of node xstat description. */
+#define RTE_NODE_HIST_OBJS_BUCKETS 17 /**< Buckets of node objs per call histogram. */
+#define RTE_NODE_HIST_CYCLES_BUCKETS 32 /**< Buckets of node cycles per call histogram. */
+#define RTE_GRAPH_HIST_SAMPLE_PERIOD 16 /**< Default sampling period of node histograms. */
 #define RTE_GRAPH_OFF_INVALID UINT32_MAX /**< Invalid graph offset. */
 #define RTE_NODE_ID_INVALID UINT32_MAX   /**< Invalid node id. */
 #define RTE_EDGE_ID_INVALID UINT16_MAX   /**< Invalid edge id. */
@@ -171,7 +176,15 @@ struct rte_graph_param {
 			uint32_t wq_size_max; /**< Maximum size of workqueue for dispatch model. */
 			uint32_t mp_capacity; /**< Capacity of memory pool for dispatch model. */
 		} dispatch;
+		struct {
+			uint32_t wq_size; /**< Size of workqueue for work-steal model. */
+			uint32_t mp_capacity; /**< Capacity of memory pool for work-steal model. */
+		} steal;
 	};
+
+	bool hist_enable; /**< Collect node histograms, with the graph stats feature. */
+	uint16_t hist_sample_period;
+	/**< Power of 2 number of node calls per histogram sample, 0 for default. */
 };
 
 /**
@@ -195,6 +208,30 @@ struct rte_graph_cluster_stats_param {
 	/**< Array of graph patterns based on shell pattern. */
 };
 
+/**
+ * Node histograms.
+ *
+ * Bucket 0 counts the sampled calls of the node with a value of 0, and
+ * bucket i > 0 the calls with a value in [2^(i - 1), 2^i). The last bucket
+ * counts all the greater values.
+ *
+ * @see struct rte_graph_param::hist_enable
+ */
+struct rte_node_hist {
+	uint64_t objs[RTE_NODE_HIST_OBJS_BUCKETS];
+	/**< Sampled calls per number of objs processed. */
+	uint64_t cycles[RTE_NODE_HIST_CYCLES_BUCKETS];
+	/**< Sampled calls per number of cycles spent. */
+};
+
+/** Percentiles of node histograms reported by the cluster stats. */
+enum rte_graph_hist_pct {
+	RTE_GRAPH_HIST_P50,  /**< Median. */
+	RTE_GRAPH_HIST_P99,  /**< 99th percentile. */
+	RTE_GRAPH_HIST_P999, /**< 99.9th percentile. */
+	RTE_GRAPH_HIST_PCT_MAX, /**< Number of percentiles. */
+};
+
 /**
  * Node cluster stats data structure.
  *
@@ -218,6 +255,12 @@ struct __rte_cache_aligned rte_graph_cluster_node_stats {
 			uint64_t sched_fail;
 			/**< Previous number of failed schedule objs for dispatch model. */
 		} dispatch;
+		struct {
+			uint64_t queued_objs;
+			/**< Current number of queued objs for work-steal model. */
+			uint64_t stolen_objs;
+			/**< Current number of stolen objs for work-steal model. */
+		} steal;
 	};
 
 	uint64_t realloc_count; /**< Realloc count. */
@@ -225,6 +268,19 @@ struct __rte_cache_aligned rte_graph_cluster_node_stats {
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+
+	uint16_t xstat_cntrs;	/**< Number of node specific xstats. */
+	char (*xstat_desc)[RTE_NODE_XSTAT_DESC_SIZE];
+	/**< Names of the node specific xstats. */
+	uint64_t *xstat_count;	/**< Current values of the node specific xstats. */
+
+	uint64_t hist_samples;
+	/**< Current number of sampled calls, 0 when histograms are disabled. */
+	struct rte_node_hist hist; /**< Current node histograms. */
+	uint64_t objs_pct[RTE_GRAPH_HIST_PCT_MAX];
+	/**< Percentiles of the objs processed per call. */
+	uint64_t cycles_pct[RTE_GRAPH_HIST_PCT_MAX];
+	/**< Percentiles of the cycles spent per call. */
 };
 
 /**
@@ -460,6 +516,19 @@ void rte_graph_cluster_stats_get(struct rte_graph_cluster_stats *stat,
  */
 void rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat);
 
+/**
+ * Structure defines the node specific extended statistics.
+ *
+ * The node increments them with rte_node_xstat_increment() and the graph
+ * cluster stats aggregate and report them along with the generic node stats.
+ *
+ * @see rte_node_xstats_register(), RTE_NODE_XSTATS_REGISTER()
+ */
+struct rte_node_xstats {
+	uint16_t nb_xstats; /**< Number of xstats. */
+	char xstat_desc[][RTE_NODE_XSTAT_DESC_SIZE]; /**< Names of xstats. */
+};
+
 /**
  * Structure defines the node registration parameters.
  *
@@ -509,6 +578,50 @@ rte_node_t __rte_node_register(const struct rte_node_register *node);
 		node.id = __rte_node_register(&node);                          \
 	}
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Register the node specific xstats of a node.
+ *
+ * The xstats must be registered before creating a graph using the node,
+ * and before cloning it for the clones to inherit them.
+ *
+ * @param id
+ *   Node id.
+ * @param xstats
+ *   Node specific xstats, copied by the library.
+ *
+ * @return
+ *   0 on success, negative errno otherwise:
+ *   - -EINVAL: invalid node id or xstats.
+ *   - -EEXIST: the node already has xstats.
+ *   - -ENOMEM: no memory to copy the xstats.
+ */
+__rte_experimental
+int rte_node_xstats_register(rte_node_t id,
+			     const struct rte_node_xstats *xstats);
+
+/**
+ * Register a static node with node specific xstats.
+ *
+ * Same as RTE_NODE_REGISTER(), registering the xstats of the node
+ * with rte_node_xstats_register() once the node is registered.
+ *
+ * @param node
+ *   Valid node pointer with name, process function, and next_nodes.
+ * @param xstats
+ *   Node specific xstats.
+ */
+#define RTE_NODE_XSTATS_REGISTER(node, xstats)                                 \
+	RTE_INIT(rte_node_register_##node)                                     \
+	{                                                                      \
+		node.parent_id = RTE_NODE_ID_INVALID;                          \
+		node.id = __rte_node_register(&node);                          \
+		if (node.id != RTE_NODE_ID_INVALID)                            \
+			rte_node_xstats_register(node.id, &xstats);            \
+	}
+
 /**
  * Clone a node from static node(node created from RTE_NODE_REGISTER).
  *
@@ -0,0 +1,304 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+
+#include "graph_private.h"
+#include "rte_graph_model_work_steal.h"
+
+/* Sequence numbers of the streams of a node must not wrap while queued */
+#define WORK_STEAL_WQ_SIZE_MAX RTE_BIT32(15)
+/* Maximum number of own streams processed per walk */
+#define WORK_STEAL_BURST 32
+
+int
+graph_steal_wq_create(struct graph *_graph, struct graph *_parent_graph,
+		      struct rte_graph_param *prm)
+{
+	struct rte_graph *parent_graph = _parent_graph->graph;
+	struct rte_graph *graph = _graph->graph;
+	struct rte_graph_work_steal_wq *wq;
+	struct graph_node *graph_node;
+	uint32_t wq_size, mp_size;
+	struct rte_node *node;
+
+	wq_size = prm->steal.wq_size;
+	if (wq_size == 0)
+		wq_size = graph->nb_nodes * RTE_GRAPH_WORK_STEAL_WQ_SIZE_MULTIPLIER;
+	wq_size = rte_align32pow2(wq_size);
+	if (wq_size > WORK_STEAL_WQ_SIZE_MAX)
+		SET_ERR_JMP(EINVAL, fail, "Graph WQ size %u exceeds %u", wq_size,
+			    WORK_STEAL_WQ_SIZE_MAX);
+
+	wq = rte_zmalloc_socket(graph->name, sizeof(*wq) + wq_size * sizeof(wq->tasks[0]),
+				RTE_CACHE_LINE_SIZE, graph->socket);
+	if (wq == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to allocate graph WQ");
+
+	wq->mask = wq_size - 1;
+	wq->deferred = rte_malloc_socket(graph->name,
+					 graph->nb_nodes * sizeof(rte_graph_off_t), 0,
+					 graph->socket);
+	wq->stream = rte_malloc_socket(graph->name, RTE_GRAPH_BURST_SIZE * sizeof(void *),
+				       RTE_CACHE_LINE_SIZE, graph->socket);
+	if (wq->deferred == NULL || wq->stream == NULL)
+		SET_ERR_JMP(ENOMEM, fail_mem, "Failed to allocate graph WQ stream");
+	wq->stream_size = RTE_GRAPH_BURST_SIZE;
+
+	mp_size = wq_size;
+	if (prm->steal.mp_capacity > 0)
+		mp_size = RTE_MIN(mp_size, prm->steal.mp_capacity);
+
+	/* Streams are put back by the graph which processed them */
+	wq->mp = rte_mempool_create(graph->name, mp_size,
+				    sizeof(struct graph_work_steal_task),
+				    0, 0, NULL, NULL, NULL, NULL,
+				    graph->socket, MEMPOOL_F_SC_GET);
+	if (wq->mp == NULL)
+		SET_ERR_JMP(EIO, fail_mem, "Failed to allocate graph WQ stream pool");
+
+	STAILQ_FOREACH(graph_node, &_graph->node_list, next) {
+		node = graph_node_id_to_ptr(graph, graph_node->node->id);
+		memset(&node->steal, 0, sizeof(node->steal));
+		node->steal.mode = graph_node->node->steal_mode;
+	}
+
+	if (parent_graph->steal.rq == NULL) {
+		parent_graph->steal.rq = &parent_graph->steal.rq_head;
+		SLIST_INIT(parent_graph->steal.rq);
+	}
+
+	graph->steal.rq = parent_graph->steal.rq;
+	SLIST_INSERT_HEAD(graph->steal.rq, graph, next);
+	graph->steal.wq = wq;
+
+	return 0;
+
+fail_mem:
+	rte_free(wq->stream);
+	rte_free(wq->deferred);
+	rte_free(wq);
+fail:
+	return -rte_errno;
+}
+
+void
+graph_steal_wq_destroy(struct graph *_graph)
+{
+	struct rte_graph *graph = _graph->graph;
+	struct rte_graph_work_steal_wq *wq;
+
+	if (graph == NULL || graph->steal.wq == NULL)
+		return;
+
+	wq = graph->steal.wq;
+	graph->steal.wq = NULL;
+
+	rte_mempool_free(wq->mp);
+	rte_free(wq->stream);
+	rte_free(wq->deferred);
+	rte_free(wq);
+}
+
+bool __rte_noinline
+__rte_graph_work_steal_node_push(struct rte_graph *graph, struct rte_node *node)
+{
+	const bool ordered = node->steal.mode == RTE_GRAPH_WORK_STEAL_NODE_ORDERED;
+	struct rte_graph_work_steal_wq *wq = graph->steal.wq;
+	struct graph_work_steal_task *task;
+	uint32_t top, bottom;
+	uint16_t off = 0;
+	uint16_t size;
+
+	bottom = rte_atomic_load_explicit(&wq->bottom, rte_memory_order_relaxed);
+	top = rte_atomic_load_explicit(&wq->top, rte_memory_order_acquire);
+
+	while (node->idx > 0) {
+		if (bottom - top > wq->mask) {
+			top = rte_atomic_load_explicit(&wq->top, rte_memory_order_acquire);
+			if (bottom - top > wq->mask)
+				break;
+		}
+
+		if (rte_mempool_get(wq->mp, (void **)&task) < 0)
+			break;
+
+		size = RTE_MIN(node->idx, RTE_DIM(task->objs));
+		task->owner = node;
+		task->node_off = node->off;
+		task->seq = node->steal.seq++;
+		task->nb_objs = size;
+		task->ordered = ordered;
+		rte_memcpy(task->objs, &node->objs[off], size * sizeof(void *));
+		rte_atomic_store_explicit(&wq->tasks[bottom & wq->mask], task,
+					  rte_memory_order_relaxed);
+		bottom++;
+
+		off += size;
+		node->steal.total_sched_objs += size;
+		node->idx -= size;
+	}
+
+	/* Publish the streams to the other graphs */
+	if (off != 0)
+		rte_atomic_store_explicit(&wq->bottom, bottom, rte_memory_order_release);
+
+	if (node->idx == 0)
+		return true;
+
+	if (off != 0)
+		memmove(&node->objs[0], &node->objs[off], node->idx * sizeof(void *));
+
+	/* Older streams of an ordered node are not processed yet, retry on next walk */
+	if (ordered && node->steal.seq !=
+	    rte_atomic_load_explicit(&node->steal.done, rte_memory_order_acquire)) {
+		wq->deferred[wq->nb_deferred++] = node->off;
+		return true;
+	}
+
+	return false;
+}
+
+static struct graph_work_steal_task *
+graph_steal_task_take(struct rte_graph_work_steal_wq *wq)
+{
+	struct graph_work_steal_task *task;
+	uint32_t top, bottom;
+
+	top = rte_atomic_load_explicit(&wq->top, rte_memory_order_acquire);
+	do {
+		bottom = rte_atomic_load_explicit(&wq->bottom, rte_memory_order_acquire);
+		if ((int32_t)(bottom - top) <= 0)
+			return NULL;
+
+		/*
+		 * The stream may be taken, and its memory reused, by another
+		 * graph meanwhile, in which case the top moved and the CAS fails.
+		 */
+		task = rte_atomic_load_explicit(&wq->tasks[top & wq->mask],
+						rte_memory_order_relaxed);
+
+		/* Wait for the older streams of an ordered node to be processed */
+		if (task->ordered && task->seq != rte_atomic_load_explicit(&task->owner->steal.done,
+									     rte_memory_order_acquire))
+			return NULL;
+	} while (!rte_atomic_compare_exchange_strong_explicit(&wq->top, &top, top + 1,
+							       rte_memory_order_acquire,
+							       rte_memory_order_acquire));
+
+	return task;
+}
+
+static void
+graph_steal_task_run(struct rte_graph *graph, struct rte_graph_work_steal_wq *owner_wq,
+		     struct graph_work_steal_task *task)
+{
+	struct rte_graph_work_steal_wq *wq = graph->steal.wq;
+	struct rte_node *node = RTE_PTR_ADD(graph, task->node_off);
+	const uint16_t size = node->size;
+	const uint16_t idx = node->idx;
+	void **objs = node->objs;
+
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+
+	/* Process the stream in the spare stream, the pending one stays as is */
+	node->objs = wq->stream;
+	node->size = wq->stream_size;
+	rte_memcpy(node->objs, task->objs, task->nb_objs * sizeof(void *));
+	node->idx = task->nb_objs;
+
+	__rte_node_process(graph, node);
+
+	/* The process function may have moved the spare stream to a next node */
+	wq->stream = node->objs;
+	wq->stream_size = node->size;
+	node->objs = objs;
+	node->size = size;
+	node->idx = idx;
+
+	if (task->owner != node)
+		node->steal.total_stolen_objs += task->nb_objs;
+
+	if (task->ordered)
+		rte_atomic_store_explicit(&task->owner->steal.done, task->seq + 1,
+					  rte_memory_order_release);
+
+	rte_mempool_put(owner_wq->mp, task);
+}
+
+void
+__rte_graph_work_steal_wq_process(struct rte_graph *graph)
+{
+	struct rte_graph_work_steal_wq *wq = graph->steal.wq;
+	struct rte_graph *victim, *next, *first;
+	struct graph_work_steal_task *task;
+	struct rte_node *node;
+	unsigned int i;
+
+	/* Walk again the nodes whose stream was deferred by the last walk */
+	for (i = 0; i < wq->nb_deferred; i++) {
+		node = RTE_PTR_ADD(graph, wq->deferred[i]);
+		__rte_node_enqueue_tail_update(graph, node);
+	}
+	wq->nb_deferred = 0;
+
+	for (i = 0; i < WORK_STEAL_BURST; i++) {
+		task = graph_steal_task_take(wq);
+		if (task == NULL)
+			break;
+		graph_steal_task_run(graph, wq, task);
+	}
+
+	if (i != 0)
+		return;
+
+	/* Nothing to process, steal a stream from the other graphs in turn */
+	victim = wq->victim != NULL ? wq->victim : SLIST_FIRST(graph->steal.rq);
+	first = victim;
+	do {
+		next = SLIST_NEXT(victim, next);
+		if (next == NULL)
+			next = SLIST_FIRST(graph->steal.rq);
+
+		if (victim != graph && victim->steal.wq != NULL) {
+			task = graph_steal_task_take(victim->steal.wq);
+			if (task != NULL) {
+				wq->victim = next;
+				graph_steal_task_run(graph, victim->steal.wq, task);
+				return;
+			}
+		}
+
+		victim = next;
+	} while (victim != first);
+}
+
+int
+rte_graph_model_work_steal_node_mode_set(const char *name,
+					 enum rte_graph_work_steal_node_mode mode)
+{
+	struct node *node;
+	int ret = -EINVAL;
+
+	if (mode > RTE_GRAPH_WORK_STEAL_NODE_ORDERED)
+		return ret;
+
+	graph_spinlock_lock();
+
+	STAILQ_FOREACH(node, node_list_head_get(), next) {
+		if (strncmp(node->name, name, RTE_NODE_NAMESIZE) == 0) {
+			/* Source nodes are walked by every graph */
+			if (!(node->flags & RTE_NODE_SOURCE_F)) {
+				node->steal_mode = mode;
+				ret = 0;
+			}
+			break;
+		}
+	}
+
+	graph_spinlock_unlock();
+
+	return ret;
+}
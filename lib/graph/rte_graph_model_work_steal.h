@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell International Ltd.
+ */
+
+#ifndef _RTE_GRAPH_MODEL_WORK_STEAL_H_
+#define _RTE_GRAPH_MODEL_WORK_STEAL_H_
+
+/**
+ * @file rte_graph_model_work_steal.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * These APIs allow to mark the nodes whose streams can be stolen by idle
+ * graphs and are only used for work-steal model.
+ *
+ * In work-steal model, the graphs cloned from the same parent graph form a
+ * group. When a graph has a pending stream for a stealable node, it queues
+ * the stream on its own work queue instead of processing it. At the start
+ * of each walk, a graph processes the streams from its own work queue, or,
+ * when it is empty, steals a stream from the work queue of another graph of
+ * the group. A hot node is thus processed by all the lcores which have spare
+ * cycles, rather than by the lcore that received its objects only.
+ *
+ * The objects a stolen stream enqueues to next nodes are processed by the
+ * graph which stole the stream.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_compat.h>
+
+#include "rte_graph_worker_common.h"
+
+/** Default number of queued streams per node in a graph work queue. */
+#define RTE_GRAPH_WORK_STEAL_WQ_SIZE_MULTIPLIER 8
+
+/**
+ * Stream stealing mode of a node, used for work-steal model.
+ */
+enum rte_graph_work_steal_node_mode {
+	/** Streams are processed by the graph they are enqueued in. */
+	RTE_GRAPH_WORK_STEAL_NODE_NONE,
+	/** Streams can be processed by any graph, in any order. */
+	RTE_GRAPH_WORK_STEAL_NODE_UNORDERED,
+	/**
+	 * Streams can be processed by any graph. The streams queued by a
+	 * graph are processed one at a time, in the order they were queued.
+	 */
+	RTE_GRAPH_WORK_STEAL_NODE_ORDERED,
+};
+
+/**
+ * @internal
+ *
+ * Queue the stream of the node on the graph's work queue for work-steal
+ * model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   True if the stream is queued or deferred to the next walk, false if the
+ *   remaining objects of the stream must be processed by the caller.
+ *
+ * @note
+ * This implementation is used by work-steal model only and user application
+ * should not call it directly.
+ */
+__rte_experimental
+bool __rte_noinline __rte_graph_work_steal_node_push(struct rte_graph *graph,
+						     struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Process the streams queued on the graph's work queue, or steal some from
+ * the other graphs when it is empty, for work-steal model.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ *
+ * @note
+ * This implementation is used by work-steal model only and user application
+ * should not call it directly.
+ */
+__rte_experimental
+void __rte_graph_work_steal_wq_process(struct rte_graph *graph);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the stream stealing mode of the node used for work-steal model.
+ * Source nodes cannot be stolen. The mode is applied to the graphs cloned
+ * after this call.
+ *
+ * @param name
+ *   Valid node name. In the case of the cloned node, the name will be
+ * "parent node name" + "-" + name.
+ * @param mode
+ *   The stream stealing mode.
+ *
+ * @return
+ *   0 on success, error otherwise.
+ */
+__rte_experimental
+int rte_graph_model_work_steal_node_mode_set(const char *name,
+					     enum rte_graph_work_steal_node_mode mode);
+
+/**
+ * Perform graph walk on the circular buffer and invoke the process function
+ * of the nodes and collect the stats.
+ *
+ * @param graph
+ *   Graph pointer returned from rte_graph_lookup function.
+ *
+ * @see rte_graph_lookup()
+ */
+static inline void
+rte_graph_walk_work_steal(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+
+	if (graph->steal.wq != NULL)
+		__rte_graph_work_steal_wq_process(graph);
+
+	while (likely(head != graph->tail)) {
+		node = (struct rte_node *)RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+		head = likely((int32_t)head > 0) ? head & mask : head;
+
+		/* Queue the stream for any graph of the group to process it */
+		if (graph->steal.wq != NULL &&
+		    node->steal.mode != RTE_GRAPH_WORK_STEAL_NODE_NONE &&
+		    __rte_graph_work_steal_node_push(graph, node))
+			continue;
+
+		__rte_node_process(graph, node);
+	}
+
+	graph->tail = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRAPH_MODEL_WORK_STEAL_H_ */
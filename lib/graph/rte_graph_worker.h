@@ -12,6 +12,7 @@ extern "C" {
 
 #include "rte_graph_model_rtc.h"
 #include "rte_graph_model_mcore_dispatch.h"
+#include "rte_graph_model_work_steal.h"
 
 /**
  * Perform graph walk on the circular buffer and invoke the process function
@@ -29,11 +30,16 @@ rte_graph_walk(struct rte_graph *graph)
 	rte_graph_walk_rtc(graph);
 #elif defined(RTE_GRAPH_MODEL_SELECT) && (RTE_GRAPH_MODEL_SELECT == RTE_GRAPH_MODEL_MCORE_DISPATCH)
 	rte_graph_walk_mcore_dispatch(graph);
+#elif defined(RTE_GRAPH_MODEL_SELECT) && (RTE_GRAPH_MODEL_SELECT == RTE_GRAPH_MODEL_WORK_STEAL)
+	rte_graph_walk_work_steal(graph);
 #else
 	switch (rte_graph_worker_model_no_check_get(graph)) {
 	case RTE_GRAPH_MODEL_MCORE_DISPATCH:
 		rte_graph_walk_mcore_dispatch(graph);
 		break;
+	case RTE_GRAPH_MODEL_WORK_STEAL:
+		rte_graph_walk_work_steal(graph);
+		break;
 	default:
 		rte_graph_walk_rtc(graph);
 	}
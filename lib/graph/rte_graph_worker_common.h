@@ -14,11 +14,14 @@
 
 #include <stdalign.h>
 
+#include <rte_bitops.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_cycles.h>
 #include <rte_prefetch.h>
 #include <rte_memcpy.h>
 #include <rte_memory.h>
+#include <rte_stdatomic.h>
 
 #include "rte_graph.h"
 
@@ -31,6 +34,8 @@ extern "C" {
 #define RTE_GRAPH_MODEL_RTC 0 /**< Run-To-Completion model. It is the default model. */
 #define RTE_GRAPH_MODEL_MCORE_DISPATCH 1
 /**< Dispatch model to support cross-core dispatching within core affinity. */
+#define RTE_GRAPH_MODEL_WORK_STEAL 2
+/**< Work-stealing model to let idle cores process the streams queued by busy ones. */
 #define RTE_GRAPH_MODEL_DEFAULT RTE_GRAPH_MODEL_RTC /**< Default graph model. */
 
 /**
@@ -40,6 +45,9 @@ extern "C" {
  */
 SLIST_HEAD(rte_graph_rq_head, rte_graph);
 
+/* Opaque work queue of the work-steal model */
+struct rte_graph_work_steal_wq;
+
 /**
  * @internal
  *
@@ -54,8 +62,8 @@ struct __rte_cache_aligned rte_graph {
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	uint8_t model;		     /**< graph model */
-	uint8_t reserved1;	     /**< Reserved for future use. */
-	uint16_t reserved2;	     /**< Reserved for future use. */
+	uint8_t hist_enable;	     /**< Node histograms are collected. */
+	uint16_t hist_sample_mask;   /**< Mask of node calls sampled in histograms. */
 	union {
 		/* Fast schedule area for mcore dispatch model */
 		struct {
@@ -67,6 +75,15 @@ struct __rte_cache_aligned rte_graph {
 			struct rte_ring *wq;    /**< The work-queue for pending streams. */
 			struct rte_mempool *mp; /**< The mempool for scheduling streams. */
 		} dispatch; /** Only used by dispatch model */
+		/* Fast schedule area for work-steal model */
+		struct {
+			alignas(RTE_CACHE_LINE_SIZE) struct rte_graph_rq_head *rq;
+				/* The run-queue of the graphs stealing from each other */
+			struct rte_graph_rq_head rq_head; /* The head for run-queue list */
+
+			struct rte_graph_work_steal_wq *wq;
+			/**< The work-queue for pending streams. */
+		} steal; /** Only used by work-steal model */
 	};
 	SLIST_ENTRY(rte_graph) next;   /* The next for rte_graph list */
 	/* End of Fast path area.*/
@@ -98,6 +115,7 @@ struct __rte_cache_aligned rte_node {
 
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+	rte_graph_off_t xstat_off; /**< Offset to the node xstats counters. */
 
 	/** Original process function when pcap is enabled. */
 	rte_node_process_t original_process;
@@ -109,6 +127,16 @@ struct __rte_cache_aligned rte_node {
 			uint64_t total_sched_objs; /**< Number of objects scheduled. */
 			uint64_t total_sched_fail; /**< Number of scheduled failure. */
 		} dispatch;
+		/* Fast schedule area for work-steal model */
+		struct {
+			uint16_t mode; /**< Stream stealing mode of the node. */
+			uint16_t seq; /**< Sequence number of the next queued stream. */
+			RTE_ATOMIC(uint16_t) done;
+			/**< Sequence number of the next queued stream to process. */
+			uint16_t reserved; /**< Reserved for future use. */
+			uint64_t total_sched_objs; /**< Number of objects queued. */
+			uint64_t total_stolen_objs; /**< Number of objects stolen. */
+		} steal;
 	};
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
@@ -163,6 +191,55 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 
 /* Fast path helper functions */
 
+/**
+ * @internal
+ *
+ * Get the histograms of a node, stored after its edges in the graph reel.
+ *
+ * @param node
+ *   Pointer to node object.
+ *
+ * @return
+ *   Pointer to the node histograms, valid if the graph collects them only.
+ */
+static __rte_always_inline struct rte_node_hist *
+__rte_node_hist_get(struct rte_node *node)
+{
+	return RTE_PTR_ADD(node, sizeof(struct rte_node) +
+			   node->nb_edges * sizeof(struct rte_node *));
+}
+
+/**
+ * @internal
+ *
+ * Record a call of a node in its histograms, one call every sampling period.
+ * Histograms are per graph, hence updated without atomics.
+ *
+ * @param graph
+ *   Pointer Graph object.
+ * @param node
+ *   Pointer to node object, after its total_calls was updated.
+ * @param objs
+ *   Number of objects processed by the call.
+ * @param cycles
+ *   Number of cycles spent by the call.
+ */
+static __rte_always_inline void
+__rte_node_hist_record(struct rte_graph *graph, struct rte_node *node,
+		       uint16_t objs, uint64_t cycles)
+{
+	struct rte_node_hist *hist;
+
+	if (node->total_calls & graph->hist_sample_mask)
+		return;
+
+	hist = __rte_node_hist_get(node);
+	hist->objs[RTE_MIN(rte_fls_u32(objs),
+			   RTE_NODE_HIST_OBJS_BUCKETS - 1U)]++;
+	hist->cycles[RTE_MIN(rte_fls_u64(cycles),
+			     RTE_NODE_HIST_CYCLES_BUCKETS - 1U)]++;
+}
+
 /**
  * @internal
  *
@@ -176,7 +253,7 @@ void __rte_node_stream_alloc_size(struct rte_graph *graph,
 static __rte_always_inline void
 __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 {
-	uint64_t start;
+	uint64_t start, cycles;
 	uint16_t rc;
 	void **objs;
 
@@ -187,9 +264,12 @@ __rte_node_process(struct rte_graph *graph, struct rte_node *node)
 	if (rte_graph_has_stats_feature()) {
 		start = rte_rdtsc();
 		rc = node->process(graph, node, objs, node->idx);
-		node->total_cycles += rte_rdtsc() - start;
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
 		node->total_calls++;
 		node->total_objs += rc;
+		if (unlikely(graph->hist_enable))
+			__rte_node_hist_record(graph, node, rc, cycles);
 	} else {
 		node->process(graph, node, objs, node->idx);
 	}
@@ -571,6 +651,35 @@ uint8_t rte_graph_worker_model_no_check_get(struct rte_graph *graph)
 	return graph->model;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Increment a node specific xstat.
+ *
+ * The xstat is counted only when the graph stats feature is enabled.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param xstat_id
+ *   Index of the xstat in the node xstats.
+ * @param value
+ *   Value to add to the xstat.
+ *
+ * @see rte_node_xstats_register()
+ */
+__rte_experimental
+static inline void
+rte_node_xstat_increment(struct rte_node *node, uint16_t xstat_id,
+			 uint64_t value)
+{
+	if (rte_graph_has_stats_feature()) {
+		uint64_t *xstat = (uint64_t *)RTE_PTR_ADD(node, node->xstat_off);
+
+		xstat[xstat_id] += value;
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
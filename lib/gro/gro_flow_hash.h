@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _GRO_FLOW_HASH_H_
+#define _GRO_FLOW_HASH_H_
+
+#include <rte_common.h>
+#include <rte_jhash.h>
+#include <rte_malloc.h>
+
+#include "rte_gro.h"
+
+#ifndef INVALID_ARRAY_INDEX
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+#endif
+
+/*
+ * Hash index over the flow array of a reassembly table. Every used flow
+ * is linked into the bucket selected by the hash of its key, so looking
+ * up the flow of a packet walks one short bucket chain rather than
+ * comparing the key against every flow in the table.
+ */
+struct gro_flow_hash {
+	/* the first flow index of each bucket */
+	uint32_t *buckets;
+	/* the next flow index in the same bucket, indexed by flow */
+	uint32_t *next;
+	/* the key hash of each flow, indexed by flow */
+	uint32_t *sigs;
+	/* the bucket number minus 1 */
+	uint32_t mask;
+};
+
+/*
+ * Storage of the hash index used by the on-stack tables of
+ * rte_gro_reassemble_burst().
+ */
+struct gro_flow_hash_burst {
+	uint32_t buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t next[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t sigs[RTE_GRO_MAX_BURST_ITEM_NUM];
+};
+
+static inline void
+gro_flow_hash_reset(struct gro_flow_hash *h)
+{
+	uint32_t i;
+
+	for (i = 0; i <= h->mask; i++)
+		h->buckets[i] = INVALID_ARRAY_INDEX;
+}
+
+/*
+ * Allocate the hash index for a table of max_flow_num flows. The bucket
+ * number is the flow number rounded up to a power of 2, so the average
+ * chain length stays below 1.
+ */
+static inline int
+gro_flow_hash_create(struct gro_flow_hash *h, uint32_t max_flow_num,
+		uint16_t socket_id)
+{
+	uint32_t nb_buckets = rte_align32pow2(max_flow_num);
+
+	h->buckets = rte_malloc_socket(__func__,
+			sizeof(uint32_t) * nb_buckets,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	h->next = rte_malloc_socket(__func__,
+			sizeof(uint32_t) * max_flow_num,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	h->sigs = rte_malloc_socket(__func__,
+			sizeof(uint32_t) * max_flow_num,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (h->buckets == NULL || h->next == NULL || h->sigs == NULL) {
+		rte_free(h->buckets);
+		rte_free(h->next);
+		rte_free(h->sigs);
+		return -1;
+	}
+	h->mask = nb_buckets - 1;
+	gro_flow_hash_reset(h);
+
+	return 0;
+}
+
+static inline void
+gro_flow_hash_destroy(struct gro_flow_hash *h)
+{
+	rte_free(h->buckets);
+	rte_free(h->next);
+	rte_free(h->sigs);
+}
+
+static inline void
+gro_flow_hash_init_burst(struct gro_flow_hash *h,
+		struct gro_flow_hash_burst *mem,
+		uint32_t max_flow_num)
+{
+	h->buckets = mem->buckets;
+	h->next = mem->next;
+	h->sigs = mem->sigs;
+	h->mask = rte_align32pow2(max_flow_num) - 1;
+	gro_flow_hash_reset(h);
+}
+
+/* Link a newly inserted flow into its bucket. */
+static inline void
+gro_flow_hash_add(struct gro_flow_hash *h, uint32_t flow_idx, uint32_t sig)
+{
+	uint32_t *head = &h->buckets[sig & h->mask];
+
+	h->sigs[flow_idx] = sig;
+	h->next[flow_idx] = *head;
+	*head = flow_idx;
+}
+
+/* Unlink a flow, which has become empty, from its bucket. */
+static inline void
+gro_flow_hash_del(struct gro_flow_hash *h, uint32_t flow_idx)
+{
+	uint32_t *cur = &h->buckets[h->sigs[flow_idx] & h->mask];
+
+	while (*cur != INVALID_ARRAY_INDEX) {
+		if (*cur == flow_idx) {
+			*cur = h->next[flow_idx];
+			return;
+		}
+		cur = &h->next[*cur];
+	}
+}
+
+/*
+ * Return 'flow_idx' or the first flow after it in the bucket chain,
+ * whose key hash equals 'sig'.
+ */
+static inline uint32_t
+gro_flow_hash_match(const struct gro_flow_hash *h, uint32_t flow_idx,
+		uint32_t sig)
+{
+	while (flow_idx != INVALID_ARRAY_INDEX && h->sigs[flow_idx] != sig)
+		flow_idx = h->next[flow_idx];
+	return flow_idx;
+}
+
+/*
+ * Iterate over the flows whose key hash equals 'sig'. The caller still
+ * needs to compare the keys, since different keys may share a hash.
+ */
+#define GRO_FLOW_HASH_FOREACH(h, sig, flow_idx) \
+	for (flow_idx = gro_flow_hash_match(h, \
+				(h)->buckets[(sig) & (h)->mask], sig); \
+			flow_idx != INVALID_ARRAY_INDEX; \
+			flow_idx = gro_flow_hash_match(h, \
+				(h)->next[flow_idx], sig))
+
+/* Hash an IPv4 address pair and a pair of 16-bit ports or IDs. */
+static inline uint32_t
+gro_flow_hash_ipv4(uint32_t src_addr, uint32_t dst_addr, uint32_t extra)
+{
+	return rte_jhash_3words(src_addr, dst_addr, extra, 0);
+}
+
+/* Hash an IPv6 address pair and a pair of 16-bit ports or IDs. */
+static inline uint32_t
+gro_flow_hash_ipv6(const uint8_t *src_addr, const uint8_t *dst_addr,
+		uint32_t extra)
+{
+	uint32_t words[8];
+
+	memcpy(&words[0], src_addr, 16);
+	memcpy(&words[4], dst_addr, 16);
+	return rte_jhash_32b(words, RTE_DIM(words), extra);
+}
+
+#endif
@@ -52,6 +52,12 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
+	if (gro_flow_hash_create(&tbl->hash, entries_num, socket_id) < 0) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
 	/* INVALID_ARRAY_INDEX indicates an empty flow */
 	for (i = 0; i < entries_num; i++)
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
@@ -68,6 +74,7 @@ gro_tcp4_tbl_destroy(void *tbl)
 	if (tcp_tbl) {
 		rte_free(tcp_tbl->items);
 		rte_free(tcp_tbl->flows);
+		gro_flow_hash_destroy(&tcp_tbl->hash);
 	}
 	rte_free(tcp_tbl);
 }
@@ -87,7 +94,8 @@ find_an_empty_flow(struct gro_tcp4_tbl *tbl)
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
-		uint32_t item_idx)
+		uint32_t item_idx,
+		uint32_t sig)
 {
 	struct tcp4_flow_key *dst;
 	uint32_t flow_idx;
@@ -104,6 +112,7 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 	dst->ip_dst_addr = src->ip_dst_addr;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	gro_flow_hash_add(&tbl->hash, flow_idx, sig);
 	tbl->flow_num++;
 
 	return flow_idx;
@@ -124,7 +133,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct tcp4_flow_key key;
 	uint32_t item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	uint8_t find;
 	uint32_t item_start_idx;
 
@@ -174,17 +183,13 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
+	sig = tcp4_flow_hash(&key);
 	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				item_start_idx = tbl->flows[i].start_index;
-				break;
-			}
-			remaining_flow_num--;
+	GRO_FLOW_HASH_FOREACH(&tbl->hash, sig, i) {
+		if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
+			find = 1;
+			item_start_idx = tbl->flows[i].start_index;
+			break;
 		}
 	}
 
@@ -217,7 +222,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 						is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, item_idx, sig) ==
 			INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -274,8 +279,10 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				j = delete_tcp_item(tbl->items, j,
 							&tbl->item_num, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(&tbl->hash, i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -41,6 +41,8 @@ struct gro_tcp4_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/* hash index of the flow array */
+	struct gro_flow_hash hash;
 };
 
 /**
@@ -144,4 +146,16 @@ is_same_tcp4_flow(struct tcp4_flow_key k1, struct tcp4_flow_key k2)
 			is_same_common_tcp_key(&k1.cmn_key, &k2.cmn_key));
 }
 
+/*
+ * Calculate the hash of a TCP/IPv4 flow key, which is used to index
+ * the flow in the reassembly table.
+ */
+static inline uint32_t
+tcp4_flow_hash(const struct tcp4_flow_key *k)
+{
+	return gro_flow_hash_ipv4(k->ip_src_addr, k->ip_dst_addr,
+			((uint32_t)k->cmn_key.src_port << 16) |
+			k->cmn_key.dst_port);
+}
+
 #endif
@@ -42,6 +42,8 @@ struct gro_tcp6_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/* hash index of the flow array */
+	struct gro_flow_hash hash;
 };
 
 /**
@@ -157,4 +159,16 @@ is_same_tcp6_flow(struct tcp6_flow_key *k1, struct tcp6_flow_key *k2)
 	return is_same_common_tcp_key(&k1->cmn_key, &k2->cmn_key);
 }
 
+/*
+ * Calculate the hash of a TCP/IPv6 flow key, which is used to index
+ * the flow in the reassembly table.
+ */
+static inline uint32_t
+tcp6_flow_hash(const struct tcp6_flow_key *k)
+{
+	return gro_flow_hash_ipv6(k->src_addr, k->dst_addr,
+			((uint32_t)k->cmn_key.src_port << 16) |
+			k->cmn_key.dst_port);
+}
+
 #endif
@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _GRO_TUNNEL_H_
+#define _GRO_TUNNEL_H_
+
+#include <rte_ip.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+#include <rte_geneve.h>
+
+/*
+ * Tunnel type bits kept in the flow keys of the VxLAN tables. The
+ * tables handle VxLAN and GENEVE, over outer IPv4 or IPv6 headers.
+ * Both tunnels have an 8-byte base header that carries the VNI, so
+ * the base header is kept as a struct rte_vxlan_hdr in the flow key.
+ */
+#define GRO_TUNNEL_OUTER_IPV6 0x1
+#define GRO_TUNNEL_GENEVE 0x2
+
+/* The length of an IPv6 address in bytes */
+#define GRO_IPV6_ADDR_LEN 16
+
+static inline uint8_t
+gro_tunnel_type(uint32_t ptype)
+{
+	uint8_t tunnel_type = 0;
+
+	if (RTE_ETH_IS_IPV6_HDR(ptype))
+		tunnel_type |= GRO_TUNNEL_OUTER_IPV6;
+	if ((ptype & RTE_PTYPE_TUNNEL_MASK) == RTE_PTYPE_TUNNEL_GENEVE)
+		tunnel_type |= GRO_TUNNEL_GENEVE;
+
+	return tunnel_type;
+}
+
+/*
+ * The length of the tunnel options following the base tunnel header.
+ * VxLAN has no options.
+ */
+static inline uint16_t
+gro_tunnel_opt_len(uint8_t tunnel_type, const struct rte_vxlan_hdr *tun_hdr)
+{
+	const struct rte_geneve_hdr *geneve_hdr;
+
+	if ((tunnel_type & GRO_TUNNEL_GENEVE) == 0)
+		return 0;
+	geneve_hdr = (const struct rte_geneve_hdr *)tun_hdr;
+	return geneve_hdr->opt_len * 4;
+}
+
+/* Return the base tunnel header, which follows the outer UDP header. */
+static inline struct rte_vxlan_hdr *
+gro_tunnel_hdr(struct rte_mbuf *pkt)
+{
+	return rte_pktmbuf_mtod_offset(pkt, struct rte_vxlan_hdr *,
+			pkt->outer_l2_len + pkt->outer_l3_len +
+			sizeof(struct rte_udp_hdr));
+}
+
+/*
+ * Check if the tunnel options of a packet are the same as the ones of
+ * the first packet stored in an item. Packets carrying different
+ * options can't be merged, since the options of the tail packet are
+ * removed.
+ */
+static inline int
+gro_tunnel_same_opts(struct rte_mbuf *pkt_orig,
+		const struct rte_vxlan_hdr *tun_hdr,
+		uint16_t opt_len)
+{
+	if (opt_len == 0)
+		return 1;
+	return memcmp(gro_tunnel_hdr(pkt_orig) + 1, tun_hdr + 1, opt_len) == 0;
+}
+
+/*
+ * Copy the outer IP addresses into a flow key. IPv4 addresses are
+ * stored in the first 4 bytes and the remaining bytes are zeroed, so
+ * the keys of both outer IP versions can be compared in the same way.
+ */
+static inline void
+gro_tunnel_outer_addr(const char *outer_ip_hdr, uint8_t tunnel_type,
+		uint8_t *src_addr, uint8_t *dst_addr)
+{
+	const struct rte_ipv4_hdr *ipv4_hdr;
+	const struct rte_ipv6_hdr *ipv6_hdr;
+
+	if (tunnel_type & GRO_TUNNEL_OUTER_IPV6) {
+		ipv6_hdr = (const struct rte_ipv6_hdr *)outer_ip_hdr;
+		memcpy(src_addr, ipv6_hdr->src_addr, GRO_IPV6_ADDR_LEN);
+		memcpy(dst_addr, ipv6_hdr->dst_addr, GRO_IPV6_ADDR_LEN);
+		return;
+	}
+
+	ipv4_hdr = (const struct rte_ipv4_hdr *)outer_ip_hdr;
+	memset(src_addr, 0, GRO_IPV6_ADDR_LEN);
+	memset(dst_addr, 0, GRO_IPV6_ADDR_LEN);
+	memcpy(src_addr, &ipv4_hdr->src_addr, sizeof(ipv4_hdr->src_addr));
+	memcpy(dst_addr, &ipv4_hdr->dst_addr, sizeof(ipv4_hdr->dst_addr));
+}
+
+/*
+ * Update the length fields of the outer IP and UDP headers for the
+ * flushed packet, and return the outer UDP header.
+ */
+static inline struct rte_udp_hdr *
+gro_tunnel_update_outer_header(struct rte_mbuf *pkt)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	char *outer_ip_hdr;
+	uint16_t len;
+
+	outer_ip_hdr = rte_pktmbuf_mtod_offset(pkt, char *,
+			pkt->outer_l2_len);
+	len = pkt->pkt_len - pkt->outer_l2_len;
+	if (RTE_ETH_IS_IPV6_HDR(pkt->packet_type)) {
+		ipv6_hdr = (struct rte_ipv6_hdr *)outer_ip_hdr;
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(len -
+				sizeof(struct rte_ipv6_hdr));
+	} else {
+		ipv4_hdr = (struct rte_ipv4_hdr *)outer_ip_hdr;
+		ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+	}
+
+	len -= pkt->outer_l3_len;
+	udp_hdr = (struct rte_udp_hdr *)(outer_ip_hdr + pkt->outer_l3_len);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+
+	return udp_hdr;
+}
+
+#endif
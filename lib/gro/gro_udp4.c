@@ -51,6 +51,12 @@ gro_udp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
+	if (gro_flow_hash_create(&tbl->hash, entries_num, socket_id) < 0) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
 	/* INVALID_ARRAY_INDEX indicates an empty flow */
 	for (i = 0; i < entries_num; i++)
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
@@ -67,6 +73,7 @@ gro_udp4_tbl_destroy(void *tbl)
 	if (udp_tbl) {
 		rte_free(udp_tbl->items);
 		rte_free(udp_tbl->flows);
+		gro_flow_hash_destroy(&udp_tbl->hash);
 	}
 	rte_free(udp_tbl);
 }
@@ -146,7 +153,8 @@ delete_item(struct gro_udp4_tbl *tbl, uint32_t item_idx,
 static inline uint32_t
 insert_new_flow(struct gro_udp4_tbl *tbl,
 		struct udp4_flow_key *src,
-		uint32_t item_idx)
+		uint32_t item_idx,
+		uint32_t sig)
 {
 	struct udp4_flow_key *dst;
 	uint32_t flow_idx;
@@ -164,6 +172,7 @@ insert_new_flow(struct gro_udp4_tbl *tbl,
 	dst->ip_id = src->ip_id;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	gro_flow_hash_add(&tbl->hash, flow_idx, sig);
 	tbl->flow_num++;
 
 	return flow_idx;
@@ -206,7 +215,7 @@ gro_udp4_reassemble(struct rte_mbuf *pkt,
 
 	struct udp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	int cmp;
 	uint8_t find;
 
@@ -248,16 +257,12 @@ gro_udp4_reassemble(struct rte_mbuf *pkt,
 	key.ip_id = ip_id;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
+	sig = udp4_flow_hash(&key);
 	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_udp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
+	GRO_FLOW_HASH_FOREACH(&tbl->hash, sig, i) {
+		if (is_same_udp4_flow(tbl->flows[i].key, key)) {
+			find = 1;
+			break;
 		}
 	}
 
@@ -271,7 +276,7 @@ gro_udp4_reassemble(struct rte_mbuf *pkt,
 				is_last_frag);
 		if (unlikely(item_idx == INVALID_ARRAY_INDEX))
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, item_idx, sig) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -405,8 +410,10 @@ gro_udp4_tbl_timeout_flush(struct gro_udp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(&tbl->hash, i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
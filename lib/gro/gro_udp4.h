@@ -7,6 +7,8 @@
 
 #include <rte_ip.h>
 
+#include "gro_flow_hash.h"
+
 #define INVALID_ARRAY_INDEX 0xffffffffUL
 #define GRO_UDP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
 
@@ -82,6 +84,8 @@ struct gro_udp4_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/* hash index of the flow array */
+	struct gro_flow_hash hash;
 };
 
 /**
@@ -183,6 +187,16 @@ is_same_udp4_flow(struct udp4_flow_key k1, struct udp4_flow_key k2)
 			(k1.ip_id == k2.ip_id));
 }
 
+/*
+ * Calculate the hash of a UDP/IPv4 flow key, which is used to index
+ * the flow in the reassembly table.
+ */
+static inline uint32_t
+udp4_flow_hash(const struct udp4_flow_key *k)
+{
+	return gro_flow_hash_ipv4(k->ip_src_addr, k->ip_dst_addr, k->ip_id);
+}
+
 /*
  * Merge two UDP/IPv4 packets without updating checksums.
  * If cmp is larger than 0, append the new packet to the
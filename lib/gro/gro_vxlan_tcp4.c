@@ -53,6 +53,12 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		return NULL;
 	}
 
+	if (gro_flow_hash_create(&tbl->hash, entries_num, socket_id) < 0) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
 	for (i = 0; i < entries_num; i++)
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
@@ -68,6 +74,7 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		gro_flow_hash_destroy(&vxlan_tbl->hash);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -152,7 +159,8 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 		struct vxlan_tcp4_flow_key *src,
-		uint32_t item_idx)
+		uint32_t item_idx,
+		uint32_t sig)
 {
 	struct vxlan_tcp4_flow_key *dst;
 	uint32_t flow_idx;
@@ -169,14 +177,18 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 
 	dst->vxlan_hdr.vx_flags = src->vxlan_hdr.vx_flags;
 	dst->vxlan_hdr.vx_vni = src->vxlan_hdr.vx_vni;
+	dst->tunnel_type = src->tunnel_type;
 	rte_ether_addr_copy(&(src->outer_eth_saddr), &(dst->outer_eth_saddr));
 	rte_ether_addr_copy(&(src->outer_eth_daddr), &(dst->outer_eth_daddr));
-	dst->outer_ip_src_addr = src->outer_ip_src_addr;
-	dst->outer_ip_dst_addr = src->outer_ip_dst_addr;
+	memcpy(dst->outer_ip_src_addr, src->outer_ip_src_addr,
+			sizeof(dst->outer_ip_src_addr));
+	memcpy(dst->outer_ip_dst_addr, src->outer_ip_dst_addr,
+			sizeof(dst->outer_ip_dst_addr));
 	dst->outer_src_port = src->outer_src_port;
 	dst->outer_dst_port = src->outer_dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	gro_flow_hash_add(&tbl->hash, flow_idx, sig);
 	tbl->flow_num++;
 
 	return flow_idx;
@@ -190,8 +202,11 @@ is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 					&k2.outer_eth_saddr) &&
 			rte_is_same_ether_addr(&k1.outer_eth_daddr,
 				&k2.outer_eth_daddr) &&
-			(k1.outer_ip_src_addr == k2.outer_ip_src_addr) &&
-			(k1.outer_ip_dst_addr == k2.outer_ip_dst_addr) &&
+			(k1.tunnel_type == k2.tunnel_type) &&
+			!memcmp(k1.outer_ip_src_addr, k2.outer_ip_src_addr,
+				sizeof(k1.outer_ip_src_addr)) &&
+			!memcmp(k1.outer_ip_dst_addr, k2.outer_ip_dst_addr,
+				sizeof(k1.outer_ip_dst_addr)) &&
 			(k1.outer_src_port == k2.outer_src_port) &&
 			(k1.outer_dst_port == k2.outer_dst_port) &&
 			(k1.vxlan_hdr.vx_flags == k2.vxlan_hdr.vx_flags) &&
@@ -199,6 +214,17 @@ is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 			is_same_tcp4_flow(k1.inner_key, k2.inner_key));
 }
 
+/*
+ * The inner TCP/IPv4 flow and the VNI tell VxLAN flows apart, so the
+ * outer header fields are left out of the hash.
+ */
+static inline uint32_t
+vxlan_tcp4_flow_hash(const struct vxlan_tcp4_flow_key *k)
+{
+	return rte_jhash_1word(k->vxlan_hdr.vx_vni,
+			tcp4_flow_hash(&k->inner_key));
+}
+
 static inline int
 check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 		struct rte_tcp_hdr *tcp_hdr,
@@ -207,6 +233,8 @@ check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 		uint16_t ip_id,
 		uint16_t tcp_hl,
 		uint16_t tcp_dl,
+		const struct rte_vxlan_hdr *tun_hdr,
+		uint16_t tun_opt_len,
 		uint8_t outer_is_atomic,
 		uint8_t is_atomic)
 {
@@ -218,6 +246,10 @@ check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 	if (unlikely(item->outer_is_atomic ^ outer_is_atomic))
 		return 0;
 
+	/* Don't merge packets whose tunnel options are different. */
+	if (!gro_tunnel_same_opts(pkt, tun_hdr, tun_opt_len))
+		return 0;
+
 	l2_offset = pkt->outer_l2_len + pkt->outer_l3_len;
 	cmp = check_seq_option(&item->inner_item, tcp_hdr, sent_seq, ip_id,
 			tcp_hl, tcp_dl, l2_offset, is_atomic);
@@ -262,16 +294,9 @@ update_vxlan_header(struct gro_vxlan_tcp4_item *item)
 	struct rte_mbuf *pkt = item->inner_item.firstseg;
 	uint16_t len;
 
-	/* Update the outer IPv4 header. */
-	len = pkt->pkt_len - pkt->outer_l2_len;
-	ipv4_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv4_hdr *,
-					   pkt->outer_l2_len);
-	ipv4_hdr->total_length = rte_cpu_to_be_16(len);
-
-	/* Update the outer UDP header. */
-	len -= pkt->outer_l3_len;
-	udp_hdr = (struct rte_udp_hdr *)((char *)ipv4_hdr + pkt->outer_l3_len);
-	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+	/* Update the outer IP and UDP headers. */
+	udp_hdr = gro_tunnel_update_outer_header(pkt);
+	len = pkt->pkt_len - pkt->outer_l2_len - pkt->outer_l3_len;
 
 	/* Update the inner IPv4 header. */
 	len -= pkt->l2_len;
@@ -289,14 +314,15 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	struct rte_tcp_hdr *tcp_hdr;
 	struct rte_udp_hdr *udp_hdr;
 	struct rte_vxlan_hdr *vxlan_hdr;
+	char *outer_ip_hdr;
 	uint32_t sent_seq;
 	int32_t tcp_dl;
-	uint16_t frag_off, outer_ip_id, ip_id;
-	uint8_t outer_is_atomic, is_atomic;
+	uint16_t frag_off, outer_ip_id, ip_id, tun_opt_len;
+	uint8_t outer_is_atomic, is_atomic, tunnel_type;
 
 	struct vxlan_tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	int cmp;
 	uint16_t hdr_len;
 	uint8_t find;
@@ -308,15 +334,15 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	if (unlikely(INVALID_TCP_HDRLEN(pkt->l4_len)))
 		return -1;
 
+	tunnel_type = gro_tunnel_type(pkt->packet_type);
 	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
-	outer_ipv4_hdr = (struct rte_ipv4_hdr *)((char *)outer_eth_hdr +
-			pkt->outer_l2_len);
-	udp_hdr = (struct rte_udp_hdr *)((char *)outer_ipv4_hdr +
-			pkt->outer_l3_len);
+	outer_ip_hdr = (char *)outer_eth_hdr + pkt->outer_l2_len;
+	udp_hdr = (struct rte_udp_hdr *)(outer_ip_hdr + pkt->outer_l3_len);
 	vxlan_hdr = (struct rte_vxlan_hdr *)((char *)udp_hdr +
 			sizeof(struct rte_udp_hdr));
+	tun_opt_len = gro_tunnel_opt_len(tunnel_type, vxlan_hdr);
 	eth_hdr = (struct rte_ether_hdr *)((char *)vxlan_hdr +
-			sizeof(struct rte_vxlan_hdr));
+			sizeof(struct rte_vxlan_hdr) + tun_opt_len);
 	ipv4_hdr = (struct rte_ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
 	tcp_hdr = (struct rte_tcp_hdr *)((char *)ipv4_hdr + pkt->l3_len);
 
@@ -339,13 +365,20 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	/*
 	 * Save IPv4 ID for the packet whose DF bit is 0. For the packet
-	 * whose DF bit is 1, IPv4 ID is ignored.
+	 * whose DF bit is 1, IPv4 ID is ignored. An outer IPv6 header has
+	 * no ID to check, as IPv6 routers never fragment.
 	 */
-	frag_off = rte_be_to_cpu_16(outer_ipv4_hdr->fragment_offset);
-	outer_is_atomic =
-		(frag_off & RTE_IPV4_HDR_DF_FLAG) == RTE_IPV4_HDR_DF_FLAG;
-	outer_ip_id = outer_is_atomic ? 0 :
-		rte_be_to_cpu_16(outer_ipv4_hdr->packet_id);
+	if (tunnel_type & GRO_TUNNEL_OUTER_IPV6) {
+		outer_is_atomic = 1;
+		outer_ip_id = 0;
+	} else {
+		outer_ipv4_hdr = (struct rte_ipv4_hdr *)outer_ip_hdr;
+		frag_off = rte_be_to_cpu_16(outer_ipv4_hdr->fragment_offset);
+		outer_is_atomic =
+			(frag_off & RTE_IPV4_HDR_DF_FLAG) == RTE_IPV4_HDR_DF_FLAG;
+		outer_ip_id = outer_is_atomic ? 0 :
+			rte_be_to_cpu_16(outer_ipv4_hdr->packet_id);
+	}
 	frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
 	is_atomic = (frag_off & RTE_IPV4_HDR_DF_FLAG) == RTE_IPV4_HDR_DF_FLAG;
 	ip_id = is_atomic ? 0 : rte_be_to_cpu_16(ipv4_hdr->packet_id);
@@ -362,24 +395,21 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
 	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	key.tunnel_type = tunnel_type;
 	rte_ether_addr_copy(&(outer_eth_hdr->src_addr), &(key.outer_eth_saddr));
 	rte_ether_addr_copy(&(outer_eth_hdr->dst_addr), &(key.outer_eth_daddr));
-	key.outer_ip_src_addr = outer_ipv4_hdr->src_addr;
-	key.outer_ip_dst_addr = outer_ipv4_hdr->dst_addr;
+	gro_tunnel_outer_addr(outer_ip_hdr, tunnel_type,
+			key.outer_ip_src_addr, key.outer_ip_dst_addr);
 	key.outer_src_port = udp_hdr->src_port;
 	key.outer_dst_port = udp_hdr->dst_port;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
+	sig = vxlan_tcp4_flow_hash(&key);
 	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
+	GRO_FLOW_HASH_FOREACH(&tbl->hash, sig, i) {
+		if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
+			find = 1;
+			break;
 		}
 	}
 
@@ -393,7 +423,7 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 				ip_id, outer_is_atomic, is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, item_idx, sig) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -411,7 +441,8 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	do {
 		cmp = check_vxlan_seq_option(&(tbl->items[cur_idx]), tcp_hdr,
 				sent_seq, outer_ip_id, ip_id, pkt->l4_len,
-				tcp_dl, outer_is_atomic, is_atomic);
+				tcp_dl, vxlan_hdr, tun_opt_len,
+				outer_is_atomic, is_atomic);
 		if (cmp) {
 			if (merge_two_vxlan_tcp4_packets(&(tbl->items[cur_idx]),
 						pkt, cmp, sent_seq, tcp_hdr->tcp_flags,
@@ -470,8 +501,10 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(&tbl->hash, i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
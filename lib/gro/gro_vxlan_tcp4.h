@@ -6,19 +6,24 @@
 #define _GRO_VXLAN_TCP4_H_
 
 #include "gro_tcp4.h"
+#include "gro_tunnel.h"
 
 #define GRO_VXLAN_TCP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
 
 /* Header fields representing a VxLAN flow */
 struct vxlan_tcp4_flow_key {
 	struct tcp4_flow_key inner_key;
+	/* VxLAN header or GENEVE base header */
 	struct rte_vxlan_hdr vxlan_hdr;
+	/* GRO_TUNNEL_* flags */
+	uint8_t tunnel_type;
 
 	struct rte_ether_addr outer_eth_saddr;
 	struct rte_ether_addr outer_eth_daddr;
 
-	uint32_t outer_ip_src_addr;
-	uint32_t outer_ip_dst_addr;
+	/* IPv4 addresses only use the first 4 bytes */
+	uint8_t outer_ip_src_addr[GRO_IPV6_ADDR_LEN];
+	uint8_t outer_ip_dst_addr[GRO_IPV6_ADDR_LEN];
 
 	/* Outer UDP ports */
 	uint16_t outer_src_port;
@@ -44,8 +49,8 @@ struct gro_vxlan_tcp4_item {
 };
 
 /*
- * VxLAN (with an outer IPv4 header and an inner TCP/IPv4 packet)
- * reassembly table structure
+ * VxLAN or GENEVE (with an outer IPv4/IPv6 header and an inner TCP/IPv4
+ * packet) reassembly table structure
  */
 struct gro_vxlan_tcp4_tbl {
 	/* item array */
@@ -60,11 +65,14 @@ struct gro_vxlan_tcp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/* hash index of the flow array */
+	struct gro_flow_hash hash;
 };
 
 /**
  * This function creates a VxLAN reassembly table for VxLAN packets
- * which have an outer IPv4 header and an inner TCP/IPv4 packet.
+ * which have an outer IPv4/IPv6 header and an inner TCP/IPv4 packet.
+ * The table also keeps GENEVE packets.
  *
  * @param socket_id
  *  Socket index for allocating the table
@@ -90,10 +98,11 @@ void *gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 void gro_vxlan_tcp4_tbl_destroy(void *tbl);
 
 /**
- * This function merges a VxLAN packet which has an outer IPv4 header and
- * an inner TCP/IPv4 packet. It doesn't process the packet, whose TCP
- * header has SYN, FIN, RST, PSH, CWR, ECE or URG bit set, or which
- * doesn't have payload.
+ * This function merges a VxLAN or GENEVE packet which has an outer IPv4
+ * or IPv6 header and an inner TCP/IPv4 packet. It doesn't process the
+ * packet, whose TCP header has SYN, FIN, RST, PSH, CWR, ECE or URG bit
+ * set, or which doesn't have payload. GENEVE packets are merged only if
+ * they carry the same options.
  *
  * This function doesn't check if the packet has correct checksums and
  * doesn't re-calculate checksums for the merged packet. Additionally,
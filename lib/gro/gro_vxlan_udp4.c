@@ -53,6 +53,12 @@ gro_vxlan_udp4_tbl_create(uint16_t socket_id,
 		return NULL;
 	}
 
+	if (gro_flow_hash_create(&tbl->hash, entries_num, socket_id) < 0) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
 	for (i = 0; i < entries_num; i++)
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
@@ -68,6 +74,7 @@ gro_vxlan_udp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		gro_flow_hash_destroy(&vxlan_tbl->hash);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -146,7 +153,8 @@ delete_item(struct gro_vxlan_udp4_tbl *tbl,
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_udp4_tbl *tbl,
 		struct vxlan_udp4_flow_key *src,
-		uint32_t item_idx)
+		uint32_t item_idx,
+		uint32_t sig)
 {
 	struct vxlan_udp4_flow_key *dst;
 	uint32_t flow_idx;
@@ -167,13 +175,17 @@ insert_new_flow(struct gro_vxlan_udp4_tbl *tbl,
 
 	dst->vxlan_hdr.vx_flags = src->vxlan_hdr.vx_flags;
 	dst->vxlan_hdr.vx_vni = src->vxlan_hdr.vx_vni;
+	dst->tunnel_type = src->tunnel_type;
 	rte_ether_addr_copy(&(src->outer_eth_saddr), &(dst->outer_eth_saddr));
 	rte_ether_addr_copy(&(src->outer_eth_daddr), &(dst->outer_eth_daddr));
-	dst->outer_ip_src_addr = src->outer_ip_src_addr;
-	dst->outer_ip_dst_addr = src->outer_ip_dst_addr;
+	memcpy(dst->outer_ip_src_addr, src->outer_ip_src_addr,
+			sizeof(dst->outer_ip_src_addr));
+	memcpy(dst->outer_ip_dst_addr, src->outer_ip_dst_addr,
+			sizeof(dst->outer_ip_dst_addr));
 	dst->outer_dst_port = src->outer_dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	gro_flow_hash_add(&tbl->hash, flow_idx, sig);
 	tbl->flow_num++;
 
 	return flow_idx;
@@ -193,24 +205,44 @@ is_same_vxlan_udp4_flow(struct vxlan_udp4_flow_key k1,
 					&k2.outer_eth_saddr) &&
 			rte_is_same_ether_addr(&k1.outer_eth_daddr,
 				&k2.outer_eth_daddr) &&
-			(k1.outer_ip_src_addr == k2.outer_ip_src_addr) &&
-			(k1.outer_ip_dst_addr == k2.outer_ip_dst_addr) &&
+			(k1.tunnel_type == k2.tunnel_type) &&
+			!memcmp(k1.outer_ip_src_addr, k2.outer_ip_src_addr,
+				sizeof(k1.outer_ip_src_addr)) &&
+			!memcmp(k1.outer_ip_dst_addr, k2.outer_ip_dst_addr,
+				sizeof(k1.outer_ip_dst_addr)) &&
 			(k1.outer_dst_port == k2.outer_dst_port) &&
 			(k1.vxlan_hdr.vx_flags == k2.vxlan_hdr.vx_flags) &&
 			(k1.vxlan_hdr.vx_vni == k2.vxlan_hdr.vx_vni) &&
 			is_same_udp4_flow(k1.inner_key, k2.inner_key));
 }
 
+/*
+ * The inner UDP/IPv4 flow and the VNI tell VxLAN flows apart, so the
+ * outer header fields are left out of the hash.
+ */
+static inline uint32_t
+vxlan_udp4_flow_hash(const struct vxlan_udp4_flow_key *k)
+{
+	return rte_jhash_1word(k->vxlan_hdr.vx_vni,
+			udp4_flow_hash(&k->inner_key));
+}
+
 static inline int
 udp4_check_vxlan_neighbor(struct gro_vxlan_udp4_item *item,
 		uint16_t frag_offset,
-		uint16_t ip_dl)
+		uint16_t ip_dl,
+		const struct rte_vxlan_hdr *tun_hdr,
+		uint16_t tun_opt_len)
 {
 	struct rte_mbuf *pkt = item->inner_item.firstseg;
 	int cmp;
 	uint16_t l2_offset;
 	int ret = 0;
 
+	/* Don't merge packets whose tunnel options are different. */
+	if (!gro_tunnel_same_opts(pkt, tun_hdr, tun_opt_len))
+		return 0;
+
 	/* Note: if outer DF bit is set, i.e outer_is_atomic is 0,
 	 * we needn't compare outer_ip_id because they are same,
 	 * for the case outer_is_atomic is 1, we also have no way
@@ -257,16 +289,9 @@ update_vxlan_header(struct gro_vxlan_udp4_item *item)
 	uint16_t len;
 	uint16_t frag_offset;
 
-	/* Update the outer IPv4 header. */
-	len = pkt->pkt_len - pkt->outer_l2_len;
-	ipv4_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv4_hdr *,
-					   pkt->outer_l2_len);
-	ipv4_hdr->total_length = rte_cpu_to_be_16(len);
-
-	/* Update the outer UDP header. */
-	len -= pkt->outer_l3_len;
-	udp_hdr = (struct rte_udp_hdr *)((char *)ipv4_hdr + pkt->outer_l3_len);
-	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+	/* Update the outer IP and UDP headers. */
+	udp_hdr = gro_tunnel_update_outer_header(pkt);
+	len = pkt->pkt_len - pkt->outer_l2_len - pkt->outer_l3_len;
 
 	/* Update the inner IPv4 header. */
 	len -= pkt->l2_len;
@@ -287,31 +312,32 @@ gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
 		uint64_t start_time)
 {
 	struct rte_ether_hdr *outer_eth_hdr, *eth_hdr;
-	struct rte_ipv4_hdr *outer_ipv4_hdr, *ipv4_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_udp_hdr *udp_hdr;
 	struct rte_vxlan_hdr *vxlan_hdr;
-	uint16_t frag_offset;
-	uint8_t is_last_frag;
+	char *outer_ip_hdr;
+	uint16_t frag_offset, tun_opt_len;
+	uint8_t is_last_frag, tunnel_type;
 	int16_t ip_dl;
 	uint16_t ip_id;
 
 	struct vxlan_udp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, sig;
 	int cmp;
 	uint16_t hdr_len;
 	uint8_t find;
 
+	tunnel_type = gro_tunnel_type(pkt->packet_type);
 	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
-	outer_ipv4_hdr = (struct rte_ipv4_hdr *)((char *)outer_eth_hdr +
-			pkt->outer_l2_len);
+	outer_ip_hdr = (char *)outer_eth_hdr + pkt->outer_l2_len;
 
-	udp_hdr = (struct rte_udp_hdr *)((char *)outer_ipv4_hdr +
-			pkt->outer_l3_len);
+	udp_hdr = (struct rte_udp_hdr *)(outer_ip_hdr + pkt->outer_l3_len);
 	vxlan_hdr = (struct rte_vxlan_hdr *)((char *)udp_hdr +
 			sizeof(struct rte_udp_hdr));
+	tun_opt_len = gro_tunnel_opt_len(tunnel_type, vxlan_hdr);
 	eth_hdr = (struct rte_ether_hdr *)((char *)vxlan_hdr +
-			sizeof(struct rte_vxlan_hdr));
+			sizeof(struct rte_vxlan_hdr) + tun_opt_len);
 	/* l2_len = outer udp hdr len + vxlan hdr len + inner l2 len */
 	ipv4_hdr = (struct rte_ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
 
@@ -345,26 +371,23 @@ gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
 
 	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
 	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	key.tunnel_type = tunnel_type;
 	rte_ether_addr_copy(&(outer_eth_hdr->src_addr), &(key.outer_eth_saddr));
 	rte_ether_addr_copy(&(outer_eth_hdr->dst_addr), &(key.outer_eth_daddr));
-	key.outer_ip_src_addr = outer_ipv4_hdr->src_addr;
-	key.outer_ip_dst_addr = outer_ipv4_hdr->dst_addr;
+	gro_tunnel_outer_addr(outer_ip_hdr, tunnel_type,
+			key.outer_ip_src_addr, key.outer_ip_dst_addr);
 	/* Note: It is unnecessary to save outer_src_port here because it can
 	 * be different for VxLAN UDP fragments from the same flow.
 	 */
 	key.outer_dst_port = udp_hdr->dst_port;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
+	sig = vxlan_udp4_flow_hash(&key);
 	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_udp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
+	GRO_FLOW_HASH_FOREACH(&tbl->hash, sig, i) {
+		if (is_same_vxlan_udp4_flow(tbl->flows[i].key, key)) {
+			find = 1;
+			break;
 		}
 	}
 
@@ -378,7 +401,7 @@ gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
 				is_last_frag);
 		if (unlikely(item_idx == INVALID_ARRAY_INDEX))
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, item_idx, sig) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -395,7 +418,7 @@ gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
 	prev_idx = cur_idx;
 	do {
 		cmp = udp4_check_vxlan_neighbor(&(tbl->items[cur_idx]),
-				frag_offset, ip_dl);
+				frag_offset, ip_dl, vxlan_hdr, tun_opt_len);
 		if (cmp) {
 			if (merge_two_vxlan_udp4_packets(
 						&(tbl->items[cur_idx]),
@@ -453,9 +476,10 @@ gro_vxlan_udp4_merge_items(struct gro_vxlan_udp4_tbl *tbl,
 	uint8_t is_last_frag;
 	int16_t ip_dl;
 	struct rte_mbuf *pkt;
+	struct rte_vxlan_hdr *tun_hdr;
 	int cmp;
 	uint32_t item_idx;
-	uint16_t hdr_len;
+	uint16_t hdr_len, tun_opt_len;
 
 	item_idx = tbl->items[start_idx].inner_item.next_pkt_idx;
 	while (item_idx != INVALID_ARRAY_INDEX) {
@@ -465,8 +489,12 @@ gro_vxlan_udp4_merge_items(struct gro_vxlan_udp4_tbl *tbl,
 		ip_dl = pkt->pkt_len - hdr_len;
 		frag_offset = tbl->items[item_idx].inner_item.frag_offset;
 		is_last_frag = tbl->items[item_idx].inner_item.is_last_frag;
+		tun_hdr = gro_tunnel_hdr(pkt);
+		tun_opt_len = gro_tunnel_opt_len(
+				gro_tunnel_type(pkt->packet_type), tun_hdr);
 		cmp = udp4_check_vxlan_neighbor(&(tbl->items[start_idx]),
-					frag_offset, ip_dl);
+					frag_offset, ip_dl, tun_hdr,
+					tun_opt_len);
 		if (cmp) {
 			if (merge_two_vxlan_udp4_packets(
 					&(tbl->items[start_idx]),
@@ -513,8 +541,10 @@ gro_vxlan_udp4_tbl_timeout_flush(struct gro_vxlan_udp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
+					gro_flow_hash_del(&tbl->hash, i);
 					tbl->flow_num--;
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
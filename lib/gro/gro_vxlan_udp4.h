@@ -6,19 +6,24 @@
 #define _GRO_VXLAN_UDP4_H_
 
 #include "gro_udp4.h"
+#include "gro_tunnel.h"
 
 #define GRO_VXLAN_UDP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
 
 /* Header fields representing a VxLAN flow */
 struct vxlan_udp4_flow_key {
 	struct udp4_flow_key inner_key;
+	/* VxLAN header or GENEVE base header */
 	struct rte_vxlan_hdr vxlan_hdr;
+	/* GRO_TUNNEL_* flags */
+	uint8_t tunnel_type;
 
 	struct rte_ether_addr outer_eth_saddr;
 	struct rte_ether_addr outer_eth_daddr;
 
-	uint32_t outer_ip_src_addr;
-	uint32_t outer_ip_dst_addr;
+	/* IPv4 addresses only use the first 4 bytes */
+	uint8_t outer_ip_src_addr[GRO_IPV6_ADDR_LEN];
+	uint8_t outer_ip_dst_addr[GRO_IPV6_ADDR_LEN];
 
 	/* Note: It is unnecessary to save outer_src_port here because it can
 	 * be different for VxLAN UDP fragments from the same flow.
@@ -45,8 +50,8 @@ struct gro_vxlan_udp4_item {
 };
 
 /*
- * VxLAN (with an outer IPv4 header and an inner UDP/IPv4 packet)
- * reassembly table structure
+ * VxLAN or GENEVE (with an outer IPv4/IPv6 header and an inner UDP/IPv4
+ * packet) reassembly table structure
  */
 struct gro_vxlan_udp4_tbl {
 	/* item array */
@@ -61,11 +66,14 @@ struct gro_vxlan_udp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/* hash index of the flow array */
+	struct gro_flow_hash hash;
 };
 
 /**
  * This function creates a VxLAN reassembly table for VxLAN packets
- * which have an outer IPv4 header and an inner UDP/IPv4 packet.
+ * which have an outer IPv4/IPv6 header and an inner UDP/IPv4 packet.
+ * The table also keeps GENEVE packets.
  *
  * @param socket_id
  *  Socket index for allocating the table
@@ -91,9 +99,10 @@ void *gro_vxlan_udp4_tbl_create(uint16_t socket_id,
 void gro_vxlan_udp4_tbl_destroy(void *tbl);
 
 /**
- * This function merges a VxLAN packet which has an outer IPv4 header and
- * an inner UDP/IPv4 packet. It does not process the packet which does not
- * have payload.
+ * This function merges a VxLAN or GENEVE packet which has an outer IPv4
+ * or IPv6 header and an inner UDP/IPv4 packet. It does not process the
+ * packet which does not have payload. GENEVE packets are merged only if
+ * they carry the same options.
  *
  * This function does not check if the packet has correct checksums and
  * does not re-calculate checksums for the merged packet. It returns the
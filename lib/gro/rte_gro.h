@@ -23,7 +23,7 @@ extern "C" {
  */
 #define RTE_GRO_TYPE_MAX_NUM 64
 /**< the max number of supported GRO types */
-#define RTE_GRO_TYPE_SUPPORT_NUM 2
+#define RTE_GRO_TYPE_SUPPORT_NUM 10
 /**< the number of currently supported GRO types */
 
 #define RTE_GRO_TCP_IPV4_INDEX 0
@@ -41,6 +41,21 @@ extern "C" {
 #define RTE_GRO_TCP_IPV6_INDEX 4
 #define RTE_GRO_TCP_IPV6 (1ULL << RTE_GRO_TCP_IPV6_INDEX)
 /**< TCP/IPv6 GRO flag. */
+#define RTE_GRO_UDP_IPV6_INDEX 5
+#define RTE_GRO_UDP_IPV6 (1ULL << RTE_GRO_UDP_IPV6_INDEX)
+/**< UDP/IPv6 GRO flag. */
+#define RTE_GRO_IPV6_VXLAN_TCP_IPV4_INDEX 6
+#define RTE_GRO_IPV6_VXLAN_TCP_IPV4 (1ULL << RTE_GRO_IPV6_VXLAN_TCP_IPV4_INDEX)
+/**< VxLAN TCP/IPv4 GRO flag, for VxLAN with an outer IPv6 header. */
+#define RTE_GRO_IPV6_VXLAN_UDP_IPV4_INDEX 7
+#define RTE_GRO_IPV6_VXLAN_UDP_IPV4 (1ULL << RTE_GRO_IPV6_VXLAN_UDP_IPV4_INDEX)
+/**< VxLAN UDP/IPv4 GRO flag, for VxLAN with an outer IPv6 header. */
+#define RTE_GRO_IPV6_GENEVE_TCP_IPV4_INDEX 8
+#define RTE_GRO_IPV6_GENEVE_TCP_IPV4 (1ULL << RTE_GRO_IPV6_GENEVE_TCP_IPV4_INDEX)
+/**< GENEVE TCP/IPv4 GRO flag, for GENEVE with an outer IPv6 header. */
+#define RTE_GRO_IPV6_GENEVE_UDP_IPV4_INDEX 9
+#define RTE_GRO_IPV6_GENEVE_UDP_IPV4 (1ULL << RTE_GRO_IPV6_GENEVE_UDP_IPV4_INDEX)
+/**< GENEVE UDP/IPv4 GRO flag, for GENEVE with an outer IPv6 header. */
 
 /**
  * Structure used to create GRO context objects or used to pass
@@ -38,6 +38,47 @@
 #define IS_IPV4_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4)) == \
 		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4))
 
+#define IS_IPV6_TCP(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6 | \
+				RTE_MBUF_F_TX_TUNNEL_MASK)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6))
+
+#define IS_IPV6_UDP(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6 | \
+				RTE_MBUF_F_TX_TUNNEL_MASK)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV6))
+
+/* VxLAN and GENEVE tunnels, which both carry an outer UDP header. */
+#define IS_UDP_TUNNEL(flag) \
+	((((flag) & RTE_MBUF_F_TX_TUNNEL_MASK) == RTE_MBUF_F_TX_TUNNEL_VXLAN) || \
+	 (((flag) & RTE_MBUF_F_TX_TUNNEL_MASK) == RTE_MBUF_F_TX_TUNNEL_GENEVE))
+
+#define IS_IPV4_GENEVE_TCP4(flag) (((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | \
+				RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_TUNNEL_MASK)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV4 | \
+		 RTE_MBUF_F_TX_TUNNEL_GENEVE))
+
+#define IS_IPV4_GENEVE_UDP4(flag) (((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | \
+				RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_TUNNEL_MASK)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV4 | \
+		 RTE_MBUF_F_TX_TUNNEL_GENEVE))
+
+/* VxLAN or GENEVE with an outer IPv6 header and an inner TCP/IPv4 packet */
+#define IS_IPV6_UDP_TUNNEL_TCP4(flag) (IS_UDP_TUNNEL(flag) && \
+		((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | \
+			   RTE_MBUF_F_TX_OUTER_IPV6)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV6))
+
+/* VxLAN or GENEVE with an outer IPv6 header and an inner UDP/IPv4 packet */
+#define IS_IPV6_UDP_TUNNEL_UDP4(flag) (IS_UDP_TUNNEL(flag) && \
+		((flag) & (RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | \
+			   RTE_MBUF_F_TX_OUTER_IPV6)) == \
+		(RTE_MBUF_F_TX_UDP_SEG | RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_OUTER_IPV6))
+
+/* VxLAN or GENEVE with an outer IPv4/IPv6 header and an inner TCP/IPv6 packet */
+#define IS_UDP_TUNNEL_TCP6(flag) (IS_UDP_TUNNEL(flag) && \
+		((flag) & (RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6)) == \
+		(RTE_MBUF_F_TX_TCP_SEG | RTE_MBUF_F_TX_IPV6) && \
+		((flag) & (RTE_MBUF_F_TX_OUTER_IPV4 | RTE_MBUF_F_TX_OUTER_IPV6)) != 0)
+
 /**
  * Internal function which updates the UDP header of a packet, following
  * segmentation. This is required to update the header's datagram length field.
@@ -110,6 +151,70 @@ update_ipv4_header(struct rte_mbuf *pkt, uint16_t l3_offset, uint16_t id)
 	ipv4_hdr->packet_id = rte_cpu_to_be_16(id);
 }
 
+/**
+ * Internal function which updates the IPv6 header of a packet, following
+ * segmentation. This is required to update the header's 'payload_len'
+ * field, to reflect the reduced length of the now-segmented packet.
+ *
+ * @param pkt
+ *  The packet containing the IPv6 header.
+ * @param l3_offset
+ *  The offset of the IPv6 header from the start of the packet.
+ */
+static inline void
+update_ipv6_header(struct rte_mbuf *pkt, uint16_t l3_offset)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+					   l3_offset);
+	ipv6_hdr->payload_len = rte_cpu_to_be_16(pkt->pkt_len - l3_offset -
+			sizeof(struct rte_ipv6_hdr));
+}
+
+/**
+ * Internal function which updates the outer IP header of a tunneling
+ * packet, following segmentation. The outer header is either an IPv4
+ * header, whose ID is updated, or an IPv6 header.
+ *
+ * @param pkt
+ *  The packet containing the outer IP header.
+ * @param l3_offset
+ *  The offset of the outer IP header from the start of the packet.
+ * @param id
+ *  The new ID of the packet, if the outer header is an IPv4 header.
+ */
+static inline void
+update_outer_ip_header(struct rte_mbuf *pkt, uint16_t l3_offset, uint16_t id)
+{
+	if (pkt->ol_flags & RTE_MBUF_F_TX_OUTER_IPV6)
+		update_ipv6_header(pkt, l3_offset);
+	else
+		update_ipv4_header(pkt, l3_offset, id);
+}
+
+/**
+ * Internal function which gets the ID of the outer IP header of a
+ * tunneling packet. Outer IPv6 headers have no ID, so 0 is returned.
+ *
+ * @param pkt
+ *  The packet containing the outer IP header.
+ *
+ * @return
+ *  The ID in host byte order.
+ */
+static inline uint16_t
+outer_ip_id(struct rte_mbuf *pkt)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+
+	if (pkt->ol_flags & RTE_MBUF_F_TX_OUTER_IPV6)
+		return 0;
+	ipv4_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv4_hdr *,
+					   pkt->outer_l2_len);
+	return rte_be_to_cpu_16(ipv4_hdr->packet_id);
+}
+
 /**
  * Internal function which divides the input packet into small segments.
  * Each of the newly-created segments is organized as a two-segment MBUF,
@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#include <errno.h>
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+/*
+ * Insert a fragment header after the IPv6 header of a GSO segment. The
+ * header segment is a direct MBUF with headroom, so the L2 and IPv6
+ * headers are moved forward rather than copying the whole header again.
+ */
+static inline int
+insert_ipv6_frag_hdr(struct rte_mbuf *seg, uint16_t l3_offset,
+		uint16_t frag_offset, uint8_t is_mf, uint32_t id)
+{
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	char *hdr;
+
+	hdr = rte_pktmbuf_prepend(seg, RTE_IPV6_FRAG_HDR_SIZE);
+	if (unlikely(hdr == NULL))
+		return -1;
+	memmove(hdr, hdr + RTE_IPV6_FRAG_HDR_SIZE,
+			l3_offset + sizeof(struct rte_ipv6_hdr));
+
+	ipv6_hdr = (struct rte_ipv6_hdr *)(hdr + l3_offset);
+	frag_hdr = (struct rte_ipv6_fragment_ext *)(ipv6_hdr + 1);
+	frag_hdr->next_header = ipv6_hdr->proto;
+	frag_hdr->reserved = 0;
+	frag_hdr->frag_data = rte_cpu_to_be_16(
+			RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf));
+	frag_hdr->id = id;
+	ipv6_hdr->proto = IPPROTO_FRAGMENT;
+
+	seg->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+	update_ipv6_header(seg, l3_offset);
+
+	return 0;
+}
+
+static inline int
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	uint16_t l3_offset = pkt->l2_len;
+	uint16_t hdr_offset = l3_offset + pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, frag_offset = 0, length, i;
+	uint32_t id;
+
+	/*
+	 * All output segments are fragments of the same datagram, so they
+	 * share the fragment ID. Use an unpredictable ID (RFC 7739).
+	 */
+	id = (uint32_t)rte_rand();
+
+	for (i = 0; i < nb_segs; i++) {
+		length = segs[i]->pkt_len - hdr_offset;
+		if (insert_ipv6_frag_hdr(segs[i], l3_offset, frag_offset,
+					i < tail_idx, id) < 0)
+			return -1;
+		frag_offset += length;
+	}
+
+	return 0;
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	uint16_t pyld_unit_size, hdr_offset, i;
+	int ret;
+
+	/*
+	 * The fragment header has to follow the IPv6 header, so don't
+	 * process the packet which has extension headers (including the
+	 * fragmented packet).
+	 */
+	if (unlikely(pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* The headers may not fit in a segment of the minimum size */
+	if (unlikely(hdr_offset + RTE_IPV6_FRAG_HDR_SIZE +
+				RTE_IPV6_EHDR_FO_ALIGN > gso_size))
+		return -EINVAL;
+
+	/* pyld_unit_size must be a multiple of 8 because frag_off
+	 * uses 8 bytes as unit.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~7U;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1 && update_ipv6_udp_headers(pkt, pkts_out, ret) < 0) {
+		/* No headroom in the direct MBUFs for the fragment header */
+		for (i = 0; i < ret; i++)
+			rte_pktmbuf_free(pkts_out[i]);
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
@@ -10,9 +10,12 @@
 #include "rte_gso.h"
 #include "gso_common.h"
 #include "gso_tcp4.h"
+#include "gso_tcp6.h"
 #include "gso_tunnel_tcp4.h"
+#include "gso_tunnel_tcp6.h"
 #include "gso_tunnel_udp4.h"
 #include "gso_udp4.h"
+#include "gso_udp6.h"
 
 #define ILLEGAL_UDP_GSO_CTX(ctx) \
 	((((ctx)->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO) == 0) || \
@@ -21,9 +24,17 @@
 #define ILLEGAL_TCP_GSO_CTX(ctx) \
 	((((ctx)->gso_types & (RTE_ETH_TX_OFFLOAD_TCP_TSO | \
 		RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO | \
-		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO)) == 0) || \
+		RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO | \
+		RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO)) == 0) || \
 		(ctx)->gso_size < RTE_GSO_SEG_SIZE_MIN)
 
+/* Check if GSO is enabled for the VxLAN or GENEVE tunnel of a packet. */
+#define UDP_TUNNEL_GSO_ENABLED(flag, ctx) \
+	((((flag) & RTE_MBUF_F_TX_TUNNEL_MASK) == RTE_MBUF_F_TX_TUNNEL_VXLAN && \
+	  ((ctx)->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO)) || \
+	 (((flag) & RTE_MBUF_F_TX_TUNNEL_MASK) == RTE_MBUF_F_TX_TUNNEL_GENEVE && \
+	  ((ctx)->gso_types & RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO)))
+
 int
 rte_gso_segment(struct rte_mbuf *pkt,
 		const struct rte_gso_ctx *gso_ctx,
@@ -56,13 +67,27 @@ rte_gso_segment(struct rte_mbuf *pkt,
 	if ((IS_IPV4_VXLAN_TCP4(pkt->ol_flags) &&
 			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO)) ||
 			((IS_IPV4_GRE_TCP4(pkt->ol_flags) &&
-			 (gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO)))) {
+			 (gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_GRE_TNL_TSO))) ||
+			(IS_IPV4_GENEVE_TCP4(pkt->ol_flags) &&
+			 (gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO)) ||
+			(IS_IPV6_UDP_TUNNEL_TCP4(pkt->ol_flags) &&
+			 UDP_TUNNEL_GSO_ENABLED(pkt->ol_flags, gso_ctx))) {
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
 		ret = gso_tunnel_tcp4_segment(pkt, gso_size, ipid_delta,
 				direct_pool, indirect_pool,
 				pkts_out, nb_pkts_out);
-	} else if (IS_IPV4_VXLAN_UDP4(pkt->ol_flags) &&
-			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO) &&
+	} else if (IS_UDP_TUNNEL_TCP6(pkt->ol_flags) &&
+			UDP_TUNNEL_GSO_ENABLED(pkt->ol_flags, gso_ctx)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
+		ret = gso_tunnel_tcp6_segment(pkt, gso_size, ipid_delta,
+				direct_pool, indirect_pool,
+				pkts_out, nb_pkts_out);
+	} else if (((IS_IPV4_VXLAN_UDP4(pkt->ol_flags) &&
+			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_VXLAN_TNL_TSO)) ||
+			(IS_IPV4_GENEVE_UDP4(pkt->ol_flags) &&
+			 (gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_GENEVE_TNL_TSO)) ||
+			(IS_IPV6_UDP_TUNNEL_UDP4(pkt->ol_flags) &&
+			 UDP_TUNNEL_GSO_ENABLED(pkt->ol_flags, gso_ctx))) &&
 			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO)) {
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
 		ret = gso_tunnel_udp4_segment(pkt, gso_size,
@@ -79,6 +104,16 @@ rte_gso_segment(struct rte_mbuf *pkt,
 		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
 		ret = gso_udp4_segment(pkt, gso_size, direct_pool,
 				indirect_pool, pkts_out, nb_pkts_out);
+	} else if (IS_IPV6_TCP(pkt->ol_flags) &&
+			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_TCP_TSO)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_TCP_SEG);
+		ret = gso_tcp6_segment(pkt, gso_size, direct_pool,
+				indirect_pool, pkts_out, nb_pkts_out);
+	} else if (IS_IPV6_UDP(pkt->ol_flags) &&
+			(gso_ctx->gso_types & RTE_ETH_TX_OFFLOAD_UDP_TSO)) {
+		pkt->ol_flags &= (~RTE_MBUF_F_TX_UDP_SEG);
+		ret = gso_udp6_segment(pkt, gso_size, direct_pool,
+				indirect_pool, pkts_out, nb_pkts_out);
 	} else {
 		ret = -ENOTSUP;	/* only UDP or TCP allowed */
 	}
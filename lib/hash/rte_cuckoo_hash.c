@@ -39,7 +39,8 @@ RTE_LOG_REGISTER_DEFAULT(hash_logtype, INFO);
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_GROWABLE)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -135,6 +136,69 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/* Get the primary and secondary buckets of a hash value in a bucket table
+ * of a growable hash table.
+ */
+static inline void
+get_grow_buckets(const struct rte_hash_grow_tbl *tbl, const hash_sig_t hash,
+		struct rte_hash_bucket **prim_bkt,
+		struct rte_hash_bucket **sec_bkt)
+{
+	uint32_t prim_bucket_idx = hash & tbl->bucket_bitmask;
+
+	*prim_bkt = &tbl->buckets[prim_bucket_idx];
+	*sec_bkt = &tbl->buckets[(prim_bucket_idx ^ get_short_sig(hash)) &
+				 tbl->bucket_bitmask];
+}
+
+static struct rte_hash_grow_tbl *
+rte_hash_grow_tbl_alloc(uint32_t num_buckets, int socket_id)
+{
+	struct rte_hash_grow_tbl *tbl;
+
+	tbl = rte_zmalloc_socket(NULL, sizeof(*tbl), 0, socket_id);
+	if (tbl == NULL)
+		return NULL;
+
+	tbl->buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, socket_id);
+	if (tbl->buckets == NULL) {
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->num_buckets = num_buckets;
+	tbl->bucket_bitmask = num_buckets - 1;
+
+	return tbl;
+}
+
+static void
+rte_hash_grow_tbl_free(struct rte_hash_grow_tbl *tbl)
+{
+	if (tbl == NULL)
+		return;
+	rte_free(tbl->buckets);
+	rte_free(tbl);
+}
+
+/* Free the bucket table being migrated and the retired ones.
+ * Readers must not be referencing the hash table.
+ */
+static void
+rte_hash_grow_tbl_free_all(struct rte_hash *h)
+{
+	struct rte_hash_grow_tbl *tbl;
+
+	rte_hash_grow_tbl_free(h->grow_old);
+	h->grow_old = NULL;
+	while (h->grow_retired != NULL) {
+		tbl = h->grow_retired;
+		h->grow_retired = tbl->next;
+		rte_hash_grow_tbl_free(tbl);
+	}
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -159,6 +223,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	RTE_ATOMIC(uint32_t) *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int growable_support = 0;
+	struct rte_hash_grow_tbl *grow_tbl = NULL;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -194,6 +260,14 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_GROWABLE) &&
+	    (params->extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE)) {
+		rte_errno = EINVAL;
+		HASH_LOG(ERR, "%s: choose growable or extendable bucket table",
+			__func__);
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -223,6 +297,12 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_GROWABLE) {
+		growable_support = 1;
+		/* Resizing may be done by any writer or a service core */
+		writer_takes_lock = 1;
+	}
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -246,6 +326,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 
 	const uint32_t num_buckets = rte_align32pow2(params->entries) /
 						RTE_HASH_BUCKET_ENTRIES;
+	/* A growable table starts small and doubles up to num_buckets */
+	const uint32_t init_buckets = growable_support ?
+		RTE_MIN(num_buckets, (uint32_t)RTE_HASH_GROW_MIN_BUCKETS) :
+		num_buckets;
 
 	/* Create ring for extendable buckets. */
 	if (ext_table_support) {
@@ -295,7 +379,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	}
 
 	buckets = rte_zmalloc_socket(NULL,
-				num_buckets * sizeof(struct rte_hash_bucket),
+				init_buckets * sizeof(struct rte_hash_bucket),
 				RTE_CACHE_LINE_SIZE, params->socket_id);
 
 	if (buckets == NULL) {
@@ -303,6 +387,18 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (growable_support) {
+		grow_tbl = rte_zmalloc_socket(NULL, sizeof(*grow_tbl), 0,
+					params->socket_id);
+		if (grow_tbl == NULL) {
+			HASH_LOG(ERR, "bucket table memory allocation failed");
+			goto err_unlock;
+		}
+		grow_tbl->buckets = buckets;
+		grow_tbl->num_buckets = init_buckets;
+		grow_tbl->bucket_bitmask = init_buckets - 1;
+	}
+
 	/* Allocate same number of extendable buckets */
 	if (ext_table_support) {
 		buckets_ext = rte_zmalloc_socket(NULL,
@@ -416,7 +512,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->key_entry_size = key_entry_size;
 	h->hash_func_init_val = params->hash_func_init_val;
 
-	h->num_buckets = num_buckets;
+	h->num_buckets = init_buckets;
 	h->bucket_bitmask = h->num_buckets - 1;
 	h->buckets = buckets;
 	h->buckets_ext = buckets_ext;
@@ -436,6 +532,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->growable_support = growable_support;
+	h->grow_cur = grow_tbl;
+	h->grow_max_buckets = num_buckets;
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
@@ -479,6 +579,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(local_free_slots);
 	rte_free(h);
 	rte_free(buckets);
+	rte_free(grow_tbl);
 	rte_free(buckets_ext);
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
@@ -524,6 +625,11 @@ rte_hash_free(struct rte_hash *h)
 	rte_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
+	if (h->growable_support) {
+		rte_hash_grow_tbl_free_all(h);
+		/* The current bucket array is h->buckets */
+		rte_free(h->grow_cur);
+	}
 	rte_free(h->buckets);
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
@@ -642,6 +748,13 @@ rte_hash_reset(struct rte_hash *h)
 			HASH_LOG(ERR, "RCU reclaim all resources failed");
 	}
 
+	/* The bucket array keeps its current size */
+	if (h->growable_support) {
+		rte_hash_grow_tbl_free_all(h);
+		h->grow_pos = 0;
+		h->grow_cnt = 0;
+	}
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
@@ -799,52 +912,19 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
 }
 
 /* Shift buckets along provided cuckoo_path (@leaf and @leaf_slot) and fill
- * the path head with new entry (sig, alt_hash, new_idx)
- * return 1 if matched key found, return -1 if cuckoo path invalided and fail,
- * return 0 if succeeds.
+ * the path head with new entry (sig, new_idx).
+ * Writer holds the lock before calling this.
+ * return -1 if cuckoo path invalided and fail, return 0 if succeeds.
  */
 static inline int
-rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
-			struct rte_hash_bucket *bkt,
-			struct rte_hash_bucket *alt_bkt,
-			const struct rte_hash_key *key, void *data,
+rte_hash_cuckoo_shift_path(const struct rte_hash *h,
 			struct queue_node *leaf, uint32_t leaf_slot,
-			uint16_t sig, uint32_t new_idx,
-			int32_t *ret_val)
+			uint16_t sig, uint32_t new_idx)
 {
 	uint32_t prev_alt_bkt_idx;
-	struct rte_hash_bucket *cur_bkt;
 	struct queue_node *prev_node, *curr_node = leaf;
 	struct rte_hash_bucket *prev_bkt, *curr_bkt = leaf->bkt;
 	uint32_t prev_slot, curr_slot = leaf_slot;
-	int32_t ret;
-
-	__hash_rw_writer_lock(h);
-
-	/* In case empty slot was gone before entering protected region */
-	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT) {
-		__hash_rw_writer_unlock(h);
-		return -1;
-	}
-
-	/* Check if key was inserted after last check but before this
-	 * protected region.
-	 */
-	ret = search_and_update(h, data, key, bkt, sig);
-	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
-		*ret_val = ret;
-		return 1;
-	}
-
-	FOR_EACH_BUCKET(cur_bkt, alt_bkt) {
-		ret = search_and_update(h, data, key, cur_bkt, sig);
-		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
-			*ret_val = ret;
-			return 1;
-		}
-	}
 
 	while (likely(curr_node->prev != NULL)) {
 		prev_node = curr_node->prev;
@@ -861,7 +941,6 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			rte_atomic_store_explicit(&curr_bkt->key_idx[curr_slot],
 				EMPTY_SLOT,
 				rte_memory_order_release);
-			__hash_rw_writer_unlock(h);
 			return -1;
 		}
 
@@ -919,15 +998,64 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			 new_idx,
 			 rte_memory_order_release);
 
-	__hash_rw_writer_unlock(h);
-
 	return 0;
+}
+
+/* Shift buckets along provided cuckoo_path (@leaf and @leaf_slot) and fill
+ * the path head with new entry (sig, alt_hash, new_idx)
+ * return 1 if matched key found, return -1 if cuckoo path invalided and fail,
+ * return 0 if succeeds.
+ */
+static inline int
+rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
+			struct rte_hash_bucket *bkt,
+			struct rte_hash_bucket *alt_bkt,
+			const struct rte_hash_key *key, void *data,
+			struct queue_node *leaf, uint32_t leaf_slot,
+			uint16_t sig, uint32_t new_idx,
+			int32_t *ret_val)
+{
+	struct rte_hash_bucket *cur_bkt;
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
 
+	/* In case empty slot was gone before entering protected region */
+	if (leaf->bkt->key_idx[leaf_slot] != EMPTY_SLOT) {
+		__hash_rw_writer_unlock(h);
+		return -1;
+	}
+
+	/* Check if key was inserted after last check but before this
+	 * protected region.
+	 */
+	ret = search_and_update(h, data, key, bkt, sig);
+	if (ret != -1) {
+		__hash_rw_writer_unlock(h);
+		*ret_val = ret;
+		return 1;
+	}
+
+	FOR_EACH_BUCKET(cur_bkt, alt_bkt) {
+		ret = search_and_update(h, data, key, cur_bkt, sig);
+		if (ret != -1) {
+			__hash_rw_writer_unlock(h);
+			*ret_val = ret;
+			return 1;
+		}
+	}
+
+	ret = rte_hash_cuckoo_shift_path(h, leaf, leaf_slot, sig, new_idx);
+
+	__hash_rw_writer_unlock(h);
+
+	return ret;
 }
 
 /*
  * Make space for new key, using bfs Cuckoo Search and Multi-Writer safe
- * Cuckoo
+ * Cuckoo. If @locked is set, the writer already holds the lock and has
+ * checked that the key is not present.
  */
 static inline int
 rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
@@ -935,7 +1063,7 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			struct rte_hash_bucket *sec_bkt,
 			const struct rte_hash_key *key, void *data,
 			uint16_t sig, uint32_t bucket_idx,
-			uint32_t new_idx, int32_t *ret_val)
+			uint32_t new_idx, int32_t *ret_val, int locked)
 {
 	unsigned int i;
 	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
@@ -958,7 +1086,13 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 		cur_idx = tail->cur_bkt_idx;
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 			if (curr_bkt->key_idx[i] == EMPTY_SLOT) {
-				int32_t ret = rte_hash_cuckoo_move_insert_mw(h,
+				int32_t ret;
+
+				if (locked)
+					ret = rte_hash_cuckoo_shift_path(h,
+						tail, i, sig, new_idx);
+				else
+					ret = rte_hash_cuckoo_move_insert_mw(h,
 						bkt, sec_bkt, key, data,
 						tail, i, sig,
 						new_idx, ret_val);
@@ -982,6 +1116,72 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 	return -ENOSPC;
 }
 
+/* Insert a key index in the first empty entry of the secondary bucket
+ * or of its extendable buckets, linking a new extendable bucket if they
+ * are all full. Writer holds the lock before calling this.
+ * return 0 if succeeds, return -ENOSPC if no extendable bucket is left.
+ */
+static inline int
+rte_hash_ext_bkt_insert(const struct rte_hash *h,
+		struct rte_hash_bucket *sec_bkt, uint16_t sig, uint32_t new_idx)
+{
+	struct rte_hash_bucket *cur_bkt, *last;
+	uint32_t ext_bkt_id = 0;
+	unsigned int i;
+
+	/* Search sec and ext buckets to find an empty entry to insert. */
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			/* Check if slot is available */
+			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
+				cur_bkt->sig_current[i] = sig;
+				/* Store to signature and key should not
+				 * leak after the store to key_idx. i.e.
+				 * key_idx is the guard variable for signature
+				 * and key.
+				 */
+				rte_atomic_store_explicit(&cur_bkt->key_idx[i],
+						 new_idx,
+						 rte_memory_order_release);
+				return 0;
+			}
+		}
+	}
+
+	/* Failed to get an empty entry from extendable buckets. Link a new
+	 * extendable bucket. We first get a free bucket from ring.
+	 */
+	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
+						sizeof(uint32_t)) != 0 ||
+					ext_bkt_id == 0) {
+		if (h->dq) {
+			if (rte_rcu_qsbr_dq_reclaim(h->dq,
+					h->hash_rcu_cfg->max_reclaim_size,
+					NULL, NULL, NULL) == 0) {
+				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
+							 &ext_bkt_id,
+							 sizeof(uint32_t));
+			}
+		}
+		if (ext_bkt_id == 0)
+			return -ENOSPC;
+	}
+
+	/* Use the first location of the new bucket */
+	(h->buckets_ext[ext_bkt_id - 1]).sig_current[0] = sig;
+	/* Store to signature and key should not leak after
+	 * the store to key_idx. i.e. key_idx is the guard variable
+	 * for signature and key.
+	 */
+	rte_atomic_store_explicit(&(h->buckets_ext[ext_bkt_id - 1]).key_idx[0],
+			 new_idx,
+			 rte_memory_order_release);
+	/* Link the new bucket to sec bucket linked list */
+	last = rte_hash_get_last_bkt(sec_bkt);
+	last->next = &h->buckets_ext[ext_bkt_id - 1];
+	return 0;
+}
+
 static inline uint32_t
 alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 {
@@ -1014,6 +1214,393 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+/* Inform the readers of a growable hash table that keys moved between
+ * bucket tables. Writer holds the lock before calling this.
+ */
+static inline void
+rte_hash_grow_tbl_changed(const struct rte_hash *h)
+{
+	rte_atomic_store_explicit(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+			rte_memory_order_release);
+	/* The stores to the bucket tables should not move above
+	 * the store to tbl_chng_cnt.
+	 */
+	rte_atomic_thread_fence(rte_memory_order_release);
+}
+
+/* Insert a key index in the current bucket table of a growable hash
+ * table, pushing other entries around if needed.
+ * Writer holds the lock before calling this.
+ */
+static inline int
+rte_hash_grow_insert(const struct rte_hash *h, hash_sig_t sig,
+		uint32_t key_idx)
+{
+	uint16_t short_sig = get_short_sig(sig);
+	uint32_t prim_bucket_idx = get_prim_bucket_index(h, sig);
+	uint32_t sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						short_sig);
+	struct rte_hash_bucket *prim_bkt = &h->buckets[prim_bucket_idx];
+	struct rte_hash_bucket *sec_bkt = &h->buckets[sec_bucket_idx];
+	struct rte_hash_bucket *cur_bkt;
+	int32_t ret_val;
+	unsigned int i, j;
+
+	for (j = 0, cur_bkt = prim_bkt; j < 2; j++, cur_bkt = sec_bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (cur_bkt->key_idx[i] == EMPTY_SLOT) {
+				cur_bkt->sig_current[i] = short_sig;
+				/* key_idx is the guard variable for
+				 * signature and key.
+				 */
+				rte_atomic_store_explicit(&cur_bkt->key_idx[i],
+						key_idx,
+						rte_memory_order_release);
+				return 0;
+			}
+		}
+	}
+
+	if (rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, NULL, NULL,
+			short_sig, prim_bucket_idx, key_idx, &ret_val, 1) == 0)
+		return 0;
+
+	return rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, NULL, NULL,
+			short_sig, sec_bucket_idx, key_idx, &ret_val, 1);
+}
+
+/* Free the retired bucket tables no reader can reference anymore */
+static void
+rte_hash_grow_reclaim(struct rte_hash *h)
+{
+	struct rte_hash_grow_tbl **prev = &h->grow_retired;
+	struct rte_hash_grow_tbl *tbl;
+
+	if (h->hash_rcu_cfg == NULL)
+		return;
+
+	while ((tbl = *prev) != NULL) {
+		if (tbl->rcu_token != 0 &&
+				rte_rcu_qsbr_check(h->hash_rcu_cfg->v,
+					tbl->rcu_token, false) == 1) {
+			*prev = tbl->next;
+			rte_hash_grow_tbl_free(tbl);
+		} else
+			prev = &tbl->next;
+	}
+}
+
+/* Retire a fully migrated bucket table. Concurrent readers might still
+ * reference it, so it is freed once an RCU grace period has elapsed if
+ * RCU is configured, or else when the hash table is freed or reset.
+ */
+static void
+rte_hash_grow_retire(struct rte_hash *h, struct rte_hash_grow_tbl *tbl)
+{
+	if (!h->readwrite_concur_support && !h->readwrite_concur_lf_support) {
+		rte_hash_grow_tbl_free(tbl);
+		return;
+	}
+
+	if (h->hash_rcu_cfg != NULL)
+		tbl->rcu_token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+	tbl->next = h->grow_retired;
+	h->grow_retired = tbl;
+}
+
+/* Start doubling the bucket array of a growable hash table.
+ * Writer holds the lock before calling this.
+ */
+static int
+rte_hash_grow_start(struct rte_hash *h)
+{
+	struct rte_hash_grow_tbl *cur, *tbl;
+
+	if (h->grow_old != NULL || h->num_buckets >= h->grow_max_buckets)
+		return -ENOSPC;
+
+	tbl = rte_hash_grow_tbl_alloc(h->num_buckets << 1, h->socket_id);
+	if (tbl == NULL) {
+		HASH_LOG(ERR, "%s: bucket table memory allocation failed",
+			h->name);
+		return -ENOMEM;
+	}
+
+	cur = rte_atomic_load_explicit(&h->grow_cur, rte_memory_order_relaxed);
+	h->grow_pos = 0;
+	/* Readers load the current table first, so they must find the
+	 * table it replaces as the old one.
+	 */
+	rte_atomic_store_explicit(&h->grow_old, cur, rte_memory_order_release);
+	rte_atomic_store_explicit(&h->grow_cur, tbl, rte_memory_order_release);
+
+	h->buckets = tbl->buckets;
+	h->num_buckets = tbl->num_buckets;
+	h->bucket_bitmask = tbl->bucket_bitmask;
+	rte_hash_grow_tbl_changed(h);
+
+	return 0;
+}
+
+/* Migrate up to @n buckets of the old bucket table to the current one.
+ * Writer holds the lock before calling this.
+ * Return the number of buckets left to migrate, or -ENOSPC.
+ */
+static int32_t
+rte_hash_grow_migrate(struct rte_hash *h, uint32_t n)
+{
+	struct rte_hash_grow_tbl *old;
+	struct rte_hash_bucket *bkt;
+	struct rte_hash_key *k;
+	uint32_t moved;
+	unsigned int i;
+	int ret = 0;
+
+	rte_hash_grow_reclaim(h);
+
+	old = rte_atomic_load_explicit(&h->grow_old, rte_memory_order_relaxed);
+	if (old == NULL)
+		return 0;
+
+	for (; n > 0 && h->grow_pos < old->num_buckets; n--) {
+		bkt = &old->buckets[h->grow_pos];
+		moved = 0;
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt->key_idx[i] == EMPTY_SLOT)
+				continue;
+			k = (struct rte_hash_key *) ((char *)h->key_store +
+					bkt->key_idx[i] * h->key_entry_size);
+			ret = rte_hash_grow_insert(h, rte_hash_hash(h, k->key),
+					bkt->key_idx[i]);
+			if (ret != 0)
+				break;
+			moved |= 1 << i;
+		}
+
+		/* Readers searching the current table before the keys were
+		 * inserted and the old one after they were removed must
+		 * re-do the lookup.
+		 */
+		if (moved != 0)
+			rte_hash_grow_tbl_changed(h);
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if ((moved & (1 << i)) == 0)
+				continue;
+			bkt->sig_current[i] = NULL_SIGNATURE;
+			rte_atomic_store_explicit(&bkt->key_idx[i], EMPTY_SLOT,
+					rte_memory_order_release);
+		}
+
+		if (ret != 0)
+			return -ENOSPC;
+		h->grow_pos++;
+	}
+
+	if (h->grow_pos < old->num_buckets)
+		return old->num_buckets - h->grow_pos;
+
+	rte_atomic_store_explicit(&h->grow_old, NULL, rte_memory_order_release);
+	rte_hash_grow_tbl_changed(h);
+	rte_hash_grow_retire(h, old);
+
+	return 0;
+}
+
+/* Search a key in the bucket tables of a growable hash table and update
+ * its data. Writer holds the lock before calling this.
+ */
+static inline int32_t
+rte_hash_grow_search_and_update(const struct rte_hash *h, void *data,
+		const void *key, hash_sig_t sig)
+{
+	const struct rte_hash_grow_tbl *tbls[2];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig = get_short_sig(sig);
+	unsigned int t;
+	int32_t ret;
+
+	tbls[0] = rte_atomic_load_explicit(&h->grow_cur,
+			rte_memory_order_relaxed);
+	tbls[1] = rte_atomic_load_explicit(&h->grow_old,
+			rte_memory_order_relaxed);
+
+	for (t = 0; t < RTE_DIM(tbls) && tbls[t] != NULL; t++) {
+		get_grow_buckets(tbls[t], sig, &prim_bkt, &sec_bkt);
+		ret = search_and_update(h, data, key, prim_bkt, short_sig);
+		if (ret != -1)
+			return ret;
+		ret = search_and_update(h, data, key, sec_bkt, short_sig);
+		if (ret != -1)
+			return ret;
+	}
+
+	return -1;
+}
+
+/* Add a key to a growable hash table.
+ * Writer holds the lock before calling this.
+ */
+static int32_t
+__rte_hash_add_key_grow_locked(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, void *data,
+		struct lcore_cache *cached_free_slots)
+{
+	struct rte_hash *hw = (struct rte_hash *)(uintptr_t)h;
+	struct rte_hash_key *new_k;
+	uint32_t slot_id, capacity;
+	int32_t ret;
+
+	rte_hash_grow_migrate(hw, RTE_HASH_GROW_STEP);
+
+	ret = rte_hash_grow_search_and_update(h, data, key, sig);
+	if (ret != -1)
+		return ret;
+
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT && h->dq) {
+		if (rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->max_reclaim_size,
+				NULL, NULL, NULL) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
+	}
+	if (slot_id == EMPTY_SLOT)
+		return -ENOSPC;
+
+	new_k = RTE_PTR_ADD(h->key_store, slot_id * h->key_entry_size);
+	/* The store to application data at *data should not leak after
+	 * the store of pdata in the key store.
+	 */
+	rte_atomic_store_explicit(&new_k->pdata, data,
+			rte_memory_order_release);
+	memcpy(new_k->key, key, h->key_len);
+
+	/* Start a resize before cuckoo displacements become expensive */
+	capacity = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	if (h->grow_cnt >= capacity - (capacity >> RTE_HASH_GROW_LOAD_SHIFT))
+		rte_hash_grow_start(hw);
+
+	ret = rte_hash_grow_insert(h, sig, slot_id);
+	if (ret != 0 && rte_hash_grow_migrate(hw, UINT32_MAX) == 0 &&
+			rte_hash_grow_start(hw) == 0)
+		ret = rte_hash_grow_insert(h, sig, slot_id);
+	if (ret != 0) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		return -ENOSPC;
+	}
+
+	hw->grow_cnt++;
+	return slot_id - 1;
+}
+
+static int32_t
+__rte_hash_add_key_with_hash_grow(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	struct lcore_cache *cached_free_slots = NULL;
+	int32_t ret;
+
+	if (h->use_local_cache)
+		cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+
+	/* Unlike the default path, the lock is held for the whole
+	 * insertion, as the bucket tables may be swapped by a resize.
+	 */
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_add_key_grow_locked(h, key, sig, data,
+			cached_free_slots);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+/* Add a key with the writer lock held for the whole insertion, so that
+ * a burst of keys takes the lock only once. The cuckoo search is then
+ * done under the lock, instead of being retried when a concurrent writer
+ * invalidated the cuckoo path.
+ * Writer holds the lock before calling this.
+ */
+static inline int32_t
+__rte_hash_add_key_locked(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, void *data,
+		struct lcore_cache *cached_free_slots)
+{
+	uint16_t short_sig;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
+	struct rte_hash_key *new_k;
+	uint32_t slot_id;
+	int32_t ret, ret_val;
+	unsigned int i;
+
+	if (h->growable_support)
+		return __rte_hash_add_key_grow_locked(h, key, sig, data,
+				cached_free_slots);
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+
+	/* Check if key is already inserted */
+	ret = search_and_update(h, data, key, prim_bkt, short_sig);
+	if (ret != -1)
+		return ret;
+
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		ret = search_and_update(h, data, key, cur_bkt, short_sig);
+		if (ret != -1)
+			return ret;
+	}
+
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT && h->dq) {
+		if (rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->max_reclaim_size,
+				NULL, NULL, NULL) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
+	}
+	if (slot_id == EMPTY_SLOT)
+		return -ENOSPC;
+
+	new_k = RTE_PTR_ADD(h->key_store, slot_id * h->key_entry_size);
+	/* The store to application data at *data should not leak after
+	 * the store of pdata in the key store.
+	 */
+	rte_atomic_store_explicit(&new_k->pdata, data,
+			rte_memory_order_release);
+	memcpy(new_k->key, key, h->key_len);
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = short_sig;
+			/* key_idx is the guard variable for signature
+			 * and key.
+			 */
+			rte_atomic_store_explicit(&prim_bkt->key_idx[i],
+					slot_id, rte_memory_order_release);
+			return slot_id - 1;
+		}
+	}
+
+	/* Primary bucket full, need to make space for new entry */
+	if (rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
+			short_sig, prim_bucket_idx, slot_id, &ret_val, 1) == 0)
+		return slot_id - 1;
+
+	if (rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
+			short_sig, sec_bucket_idx, slot_id, &ret_val, 1) == 0)
+		return slot_id - 1;
+
+	if (h->ext_table_support &&
+			rte_hash_ext_bkt_insert(h, sec_bkt, short_sig,
+				slot_id) == 0)
+		return slot_id - 1;
+
+	enqueue_slot_back(h, cached_free_slots, slot_id);
+	return -ENOSPC;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1022,14 +1609,14 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
 	struct rte_hash_key *new_k, *keys = h->key_store;
-	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
 	unsigned lcore_id;
-	unsigned int i;
 	struct lcore_cache *cached_free_slots = NULL;
 	int32_t ret_val;
-	struct rte_hash_bucket *last;
+
+	if (h->growable_support)
+		return __rte_hash_add_key_with_hash_grow(h, key, sig, data);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1101,7 +1688,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
-				short_sig, prim_bucket_idx, slot_id, &ret_val);
+				short_sig, prim_bucket_idx, slot_id, &ret_val, 0);
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
@@ -1111,7 +1698,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Also search secondary bucket to get better occupancy */
 	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
-				short_sig, sec_bucket_idx, slot_id, &ret_val);
+				short_sig, sec_bucket_idx, slot_id, &ret_val, 0);
 
 	if (ret == 0)
 		return slot_id - 1;
@@ -1140,65 +1727,15 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, short_sig);
 		if (ret != -1) {
-			enqueue_slot_back(h, cached_free_slots, slot_id);
-			goto failure;
-		}
-	}
-
-	/* Search sec and ext buckets to find an empty entry to insert. */
-	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
-		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-			/* Check if slot is available */
-			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
-				cur_bkt->sig_current[i] = short_sig;
-				/* Store to signature and key should not
-				 * leak after the store to key_idx. i.e.
-				 * key_idx is the guard variable for signature
-				 * and key.
-				 */
-				rte_atomic_store_explicit(&cur_bkt->key_idx[i],
-						 slot_id,
-						 rte_memory_order_release);
-				__hash_rw_writer_unlock(h);
-				return slot_id - 1;
-			}
-		}
-	}
-
-	/* Failed to get an empty entry from extendable buckets. Link a new
-	 * extendable bucket. We first get a free bucket from ring.
-	 */
-	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
-						sizeof(uint32_t)) != 0 ||
-					ext_bkt_id == 0) {
-		if (h->dq) {
-			if (rte_rcu_qsbr_dq_reclaim(h->dq,
-					h->hash_rcu_cfg->max_reclaim_size,
-					NULL, NULL, NULL) == 0) {
-				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
-							 &ext_bkt_id,
-							 sizeof(uint32_t));
-			}
-		}
-		if (ext_bkt_id == 0) {
-			ret = -ENOSPC;
-			goto failure;
-		}
-	}
-
-	/* Use the first location of the new bucket */
-	(h->buckets_ext[ext_bkt_id - 1]).sig_current[0] = short_sig;
-	/* Store to signature and key should not leak after
-	 * the store to key_idx. i.e. key_idx is the guard variable
-	 * for signature and key.
-	 */
-	rte_atomic_store_explicit(&(h->buckets_ext[ext_bkt_id - 1]).key_idx[0],
-			 slot_id,
-			 rte_memory_order_release);
-	/* Link the new bucket to sec bucket linked list */
-	last = rte_hash_get_last_bkt(sec_bkt);
-	last->next = &h->buckets_ext[ext_bkt_id - 1];
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			goto failure;
+		}
+	}
+
+	ret = rte_hash_ext_bkt_insert(h, sec_bkt, short_sig, slot_id);
 	__hash_rw_writer_unlock(h);
+	if (ret != 0)
+		return ret;
 	return slot_id - 1;
 
 failure:
@@ -1419,10 +1956,81 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search a key in the primary and secondary buckets of a bucket table
+ * of a growable hash table.
+ */
+static inline int32_t
+search_grow_tbl(const struct rte_hash *h, const struct rte_hash_grow_tbl *tbl,
+		const void *key, hash_sig_t sig, void **data)
+{
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig = get_short_sig(sig);
+	int32_t ret;
+
+	get_grow_buckets(tbl, sig, &prim_bkt, &sec_bkt);
+	if (h->readwrite_concur_lf_support) {
+		ret = search_one_bucket_lf(h, key, short_sig, data, prim_bkt);
+		if (ret == -1)
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+						sec_bkt);
+	} else {
+		ret = search_one_bucket_l(h, key, short_sig, data, prim_bkt);
+		if (ret == -1)
+			ret = search_one_bucket_l(h, key, short_sig, data,
+						sec_bkt);
+	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash_grow(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_grow_tbl *tbls[2];
+	uint32_t cnt_b, cnt_a;
+	unsigned int t;
+	int32_t ret;
+
+	__hash_rw_reader_lock(h);
+	do {
+		/* Keys moving from the old table to the current one, or a
+		 * resize starting, bump the table change counter.
+		 */
+		cnt_b = rte_atomic_load_explicit(h->tbl_chng_cnt,
+				rte_memory_order_acquire);
+
+		/* The old table is published before the current one */
+		tbls[0] = rte_atomic_load_explicit(&h->grow_cur,
+				rte_memory_order_acquire);
+		tbls[1] = rte_atomic_load_explicit(&h->grow_old,
+				rte_memory_order_acquire);
+
+		for (t = 0; t < RTE_DIM(tbls) && tbls[t] != NULL; t++) {
+			ret = search_grow_tbl(h, tbls[t], key, sig, data);
+			if (ret != -1) {
+				__hash_rw_reader_unlock(h);
+				return ret;
+			}
+		}
+
+		/* The loads of sig_current in search_grow_tbl
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+		cnt_a = rte_atomic_load_explicit(h->tbl_chng_cnt,
+				rte_memory_order_acquire);
+	} while (cnt_b != cnt_a);
+	__hash_rw_reader_unlock(h);
+
+	return -ENOENT;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
+	if (h->growable_support)
+		return __rte_hash_lookup_with_hash_grow(h, key, sig, data);
 	if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
@@ -1686,8 +2294,77 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Free the key index and ext bucket of a deleted key using the
+ * internal RCU QSBR, if configured.
+ * Writer holds the lock before calling this.
+ */
+static inline void
+__rte_hash_rcu_free_key(const struct rte_hash *h, int32_t position,
+			uint32_t ext_bkt_idx)
+{
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	/* Using internal RCU QSBR */
+	if (h->hash_rcu_cfg) {
+		/* Key index where key is stored, adding the first dummy index */
+		rcu_dq_entry.key_idx = position + 1;
+		rcu_dq_entry.ext_bkt_idx = ext_bkt_idx;
+		if (h->dq == NULL) {
+			/* Wait for quiescent state change if using
+			 * RTE_HASH_QSBR_MODE_SYNC
+			 */
+			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+						 RTE_QSBR_THRID_INVALID);
+			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+						      &rcu_dq_entry, 1);
+		} else if (h->dq)
+			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
+			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
+				HASH_LOG(ERR, "Failed to push QSBR FIFO");
+	}
+}
+
+/* Remove a key from a growable hash table.
+ * Writer holds the lock before calling this.
+ */
+static int32_t
+__rte_hash_del_key_grow_locked(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	struct rte_hash *hw = (struct rte_hash *)(uintptr_t)h;
+	const struct rte_hash_grow_tbl *tbls[2];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig = get_short_sig(sig);
+	unsigned int t;
+	int32_t ret = -1;
+	int pos;
+
+	rte_hash_grow_migrate(hw, RTE_HASH_GROW_STEP);
+
+	tbls[0] = rte_atomic_load_explicit(&h->grow_cur,
+			rte_memory_order_relaxed);
+	tbls[1] = rte_atomic_load_explicit(&h->grow_old,
+			rte_memory_order_relaxed);
+
+	for (t = 0; t < RTE_DIM(tbls) && tbls[t] != NULL && ret == -1; t++) {
+		get_grow_buckets(tbls[t], sig, &prim_bkt, &sec_bkt);
+		ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key, sec_bkt, short_sig,
+						&pos);
+	}
+
+	if (ret == -1)
+		return -ENOENT;
+
+	hw->grow_cnt--;
+	__rte_hash_rcu_free_key(h, ret, EMPTY_SLOT);
+	return ret;
+}
+
+/* Writer holds the lock before calling this. */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+__rte_hash_del_key_locked(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
@@ -1697,14 +2374,15 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret, i;
 	uint16_t short_sig;
 	uint32_t index = EMPTY_SLOT;
-	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	if (h->growable_support)
+		return __rte_hash_del_key_grow_locked(h, key, sig);
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1727,7 +2405,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1769,25 +2446,20 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	}
 
 return_key:
-	/* Using internal RCU QSBR */
-	if (h->hash_rcu_cfg) {
-		/* Key index where key is stored, adding the first dummy index */
-		rcu_dq_entry.key_idx = ret + 1;
-		rcu_dq_entry.ext_bkt_idx = index;
-		if (h->dq == NULL) {
-			/* Wait for quiescent state change if using
-			 * RTE_HASH_QSBR_MODE_SYNC
-			 */
-			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
-						 RTE_QSBR_THRID_INVALID);
-			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
-						      &rcu_dq_entry, 1);
-		} else if (h->dq)
-			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				HASH_LOG(ERR, "Failed to push QSBR FIFO");
-	}
+	__rte_hash_rcu_free_key(h, ret, index);
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_locked(h, key, sig);
 	__hash_rw_writer_unlock(h);
+
 	return ret;
 }
 
@@ -2240,6 +2912,84 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		*hit_mask = hits;
 }
 
+static inline void
+__rte_hash_lookup_with_hash_bulk_grow(const struct rte_hash *h,
+			const void **keys, hash_sig_t *prim_hash,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_grow_tbl *cur, *old;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint64_t hits;
+	uint32_t cnt_b, cnt_a;
+	int32_t i, ret;
+
+	for (i = 0; i < num_keys; i++) {
+		rte_prefetch0(keys[i]);
+		sig[i] = get_short_sig(prim_hash[i]);
+	}
+
+	do {
+		/* Keys moving from the old table to the current one, or a
+		 * resize starting, bump the table change counter.
+		 */
+		cnt_b = rte_atomic_load_explicit(h->tbl_chng_cnt,
+				rte_memory_order_acquire);
+
+		/* The old table is published before the current one */
+		cur = rte_atomic_load_explicit(&h->grow_cur,
+				rte_memory_order_acquire);
+		old = rte_atomic_load_explicit(&h->grow_old,
+				rte_memory_order_acquire);
+
+		for (i = 0; i < num_keys; i++) {
+			get_grow_buckets(cur, prim_hash[i], &prim_bkt, &sec_bkt);
+			primary_bkt[i] = prim_bkt;
+			secondary_bkt[i] = sec_bkt;
+			rte_prefetch0(prim_bkt);
+			rte_prefetch0(sec_bkt);
+		}
+
+		hits = 0;
+		if (h->readwrite_concur_lf_support)
+			__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt,
+				sig, num_keys, positions, &hits, data);
+		else
+			__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt,
+				sig, num_keys, positions, &hits, data);
+
+		/* Keys not migrated yet are found in the old table */
+		if (old != NULL && hits != ((1ULL << num_keys) - 1)) {
+			__hash_rw_reader_lock(h);
+			for (i = 0; i < num_keys; i++) {
+				if ((hits & (1ULL << i)) != 0)
+					continue;
+				ret = search_grow_tbl(h, old, keys[i],
+					prim_hash[i],
+					data != NULL ? &data[i] : NULL);
+				if (ret != -1) {
+					positions[i] = ret;
+					hits |= 1ULL << i;
+				}
+			}
+			__hash_rw_reader_unlock(h);
+		}
+
+		/* The loads of sig_current should not move below
+		 * the load from tbl_chng_cnt.
+		 */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+		cnt_a = rte_atomic_load_explicit(h->tbl_chng_cnt,
+				rte_memory_order_acquire);
+	} while (cnt_b != cnt_a);
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 #define PREFETCH_OFFSET 4
 static inline void
 __bulk_lookup_prefetching_loop(const struct rte_hash *h,
@@ -2331,7 +3081,15 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->growable_support) {
+		hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+		int32_t i;
+
+		for (i = 0; i < num_keys; i++)
+			prim_hash[i] = rte_hash_hash(h, keys[i]);
+		__rte_hash_lookup_with_hash_bulk_grow(h, keys, prim_hash,
+				num_keys, positions, hit_mask, data);
+	} else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2443,7 +3201,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->growable_support)
+		__rte_hash_lookup_with_hash_bulk_grow(h, keys, prim_hash,
+				num_keys, positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2484,6 +3245,134 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return rte_popcount64(*hit_mask);
 }
 
+/* Compute the hash values of a burst of keys to add or remove, and
+ * prefetch their buckets before the writer lock is taken.
+ */
+static inline void
+__bulk_write_prefetch(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, hash_sig_t *prim_hash)
+{
+	uint32_t i, prim_index, sec_index;
+	uint16_t sig;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		prim_hash[i] = rte_hash_hash(h, keys[i]);
+
+		/* The bucket array of a growable table may be replaced
+		 * until the writer lock is taken.
+		 */
+		if (h->growable_support)
+			continue;
+
+		sig = get_short_sig(prim_hash[i]);
+		prim_index = get_prim_bucket_index(h, prim_hash[i]);
+		sec_index = get_alt_bucket_index(h, prim_index, sig);
+
+		rte_prefetch0(&h->buckets[prim_index]);
+		rte_prefetch0(&h->buckets[sec_index]);
+	}
+}
+
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void *data[], uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	struct lcore_cache *cached_free_slots = NULL;
+	uint32_t i;
+	int added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (data == NULL) ||
+			(num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	__bulk_write_prefetch(h, keys, num_keys, prim_hash);
+
+	if (h->use_local_cache)
+		cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_add_key_locked(h, keys[i],
+				prim_hash[i], data[i], cached_free_slots);
+		if (positions[i] >= 0)
+			added++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return added;
+}
+
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i;
+	int deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	__bulk_write_prefetch(h, keys, num_keys, prim_hash);
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_locked(h, keys[i],
+				prim_hash[i]);
+		if (positions[i] >= 0)
+			deleted++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return deleted;
+}
+
+/* Iterate the bucket table being migrated, after the current one */
+static int32_t
+__rte_hash_iterate_grow_old(const struct rte_hash *h, const void **key,
+		void **data, uint32_t *next, uint32_t total_entries_main)
+{
+	const struct rte_hash_grow_tbl *old;
+	struct rte_hash_key *next_key;
+	uint32_t position, idx;
+
+	__hash_rw_reader_lock(h);
+	old = rte_atomic_load_explicit(&h->grow_old, rte_memory_order_acquire);
+	do {
+		idx = *next - total_entries_main;
+		if (old == NULL ||
+				idx >= old->num_buckets * RTE_HASH_BUCKET_ENTRIES) {
+			__hash_rw_reader_unlock(h);
+			return -ENOENT;
+		}
+		position = rte_atomic_load_explicit(
+			&old->buckets[idx / RTE_HASH_BUCKET_ENTRIES].key_idx[
+				idx % RTE_HASH_BUCKET_ENTRIES],
+			rte_memory_order_acquire);
+		(*next)++;
+	} while (position == EMPTY_SLOT);
+
+	next_key = (struct rte_hash_key *) ((char *)h->key_store +
+				position * h->key_entry_size);
+	/* Return key and data */
+	*key = next_key->key;
+	*data = next_key->pdata;
+
+	__hash_rw_reader_unlock(h);
+
+	return position - 1;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2531,6 +3420,10 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	if (h->growable_support)
+		return __rte_hash_iterate_grow_old(h, key, data, next,
+						total_entries_main);
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -2559,3 +3452,18 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+int32_t
+rte_hash_grow_step(struct rte_hash *h, uint32_t n)
+{
+	int32_t ret;
+
+	if (h == NULL || !h->growable_support)
+		return -EINVAL;
+
+	__hash_rw_writer_lock(h);
+	ret = rte_hash_grow_migrate(h, n);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
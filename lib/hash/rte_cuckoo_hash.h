@@ -119,6 +119,15 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/* Initial number of buckets of a growable hash table */
+#define RTE_HASH_GROW_MIN_BUCKETS	64
+
+/* A growable hash table starts a resize once its load exceeds 3/4 */
+#define RTE_HASH_GROW_LOAD_SHIFT	2
+
+/* Number of buckets migrated by each add/delete during a resize */
+#define RTE_HASH_GROW_STEP		4
+
 struct __rte_cache_aligned lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -153,6 +162,20 @@ struct __rte_cache_aligned rte_hash_bucket {
 	void *next;
 };
 
+/**
+ * Bucket table of a growable hash table. A descriptor is never modified
+ * once published, so that lock free readers get a consistent view of
+ * the bucket array and its bitmask with a single pointer load.
+ */
+struct rte_hash_grow_tbl {
+	struct rte_hash_bucket *buckets; /**< Bucket array. */
+	uint32_t num_buckets;            /**< Number of buckets in array. */
+	uint32_t bucket_bitmask;         /**< Bitmask for bucket index. */
+	uint64_t rcu_token;
+	/**< QSBR token taken when the table was retired. */
+	struct rte_hash_grow_tbl *next;  /**< Next retired table. */
+};
+
 /** A hash table structure. */
 struct __rte_cache_aligned rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -193,6 +216,8 @@ struct __rte_cache_aligned rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t growable_support;
+	/**< If the bucket array is resized on demand */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -222,6 +247,21 @@ struct __rte_cache_aligned rte_hash {
 	uint32_t *ext_bkt_to_free;
 	RTE_ATOMIC(uint32_t) *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+
+	/* Fields used by growable hash tables */
+	RTE_ATOMIC(struct rte_hash_grow_tbl *) grow_cur;
+	/**< Bucket table new keys are added to. */
+	RTE_ATOMIC(struct rte_hash_grow_tbl *) grow_old;
+	/**< Bucket table being migrated, NULL if no resize is in progress. */
+	struct rte_hash_grow_tbl *grow_retired;
+	/**< Tables waiting for readers to stop referencing them. */
+	uint32_t grow_pos;
+	/**< Next bucket of the old table to migrate. */
+	uint32_t grow_max_buckets;
+	/**< Number of buckets the table is allowed to grow to. */
+	uint32_t grow_cnt;
+	/**< Number of keys stored in the bucket tables. */
+	int socket_id;                  /**< NUMA socket used for allocation. */
 };
 
 struct queue_node {
@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <rte_compat.h>
 #include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
@@ -55,6 +56,16 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to start with a small bucket array which is doubled online when
+ * the table fills up. The 'entries' parameter gives the maximum number
+ * of keys. Buckets are migrated to the new array incrementally by the
+ * writers or by rte_hash_grow_step(), while lookups keep running.
+ * The hash values passed to the rte_hash_xxx_with_hash APIs must be the
+ * ones returned by rte_hash_hash(), as migrated keys are rehashed.
+ * Cannot be combined with RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ */
+#define RTE_HASH_EXTRA_FLAGS_GROWABLE 0x40
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -217,6 +228,28 @@ rte_hash_count(const struct rte_hash *h);
 int32_t
 rte_hash_max_key_id(const struct rte_hash *h);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Migrate buckets of an ongoing resize of a growable hash table.
+ * Writers already migrate a few buckets on every add and delete;
+ * this function allows a service core to complete the resize faster.
+ * It is multi-thread safe with the writers and the readers.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_GROWABLE.
+ * @param n
+ *   Maximum number of buckets to migrate. 0 only queries the progress.
+ * @return
+ *   - Number of buckets left to migrate, 0 if no resize is in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if a key could not be migrated to the new bucket array.
+ */
+__rte_experimental
+int32_t
+rte_hash_grow_step(struct rte_hash *h, uint32_t n);
+
 /**
  * Add a key-value pair to an existing hash table.
  * This operation is not multi-thread safe
@@ -380,6 +413,64 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add multiple key-value pairs to an existing hash table.
+ * The buckets of all the keys are prefetched up front and the writer lock
+ * is taken once for the whole burst, instead of once or more per key.
+ * Thread safety and the handling of existing keys are the same as
+ * for rte_hash_add_key_data().
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A pointer to a list of data to add, one per key.
+ * @param num_keys
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys.
+ *   For each key added or updated, the value is the same as returned by
+ *   rte_hash_add_key(). Otherwise it is -ENOSPC.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added or updated.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void *data[], uint32_t num_keys, int32_t *positions);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove multiple keys from an existing hash table.
+ * The buckets of all the keys are prefetched up front and the writer lock
+ * is taken once for the whole burst.
+ * Thread safety and the freeing of key indexes are the same as
+ * for rte_hash_del_key().
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys.
+ *   For each key removed, the value is the same as returned by
+ *   rte_hash_del_key(). If a key was not found, the value is -ENOENT.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -543,7 +634,7 @@ rte_hash_hash(const struct rte_hash *h, const void *key);
  * @param keys
  *   A pointer to a list of keys to look for.
  * @param num_keys
- *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
  * @param hit_mask
  *   Output containing a bitmask with all successful lookups.
  * @param data
@@ -568,7 +659,7 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
  * @param sig
  *   A pointer to a list of precomputed hash values for keys.
  * @param num_keys
- *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
  * @param positions
  *   Output containing a list of values, corresponding to the list of keys that
  *   can be used by the caller as an offset into an array of user data. These
@@ -595,7 +686,7 @@ rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
  * @param sig
  *   A pointer to a list of precomputed hash values for keys.
  * @param num_keys
- *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
  * @param hit_mask
  *   Output containing a bitmask with all successful lookups.
  * @param data
@@ -619,7 +710,7 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
  * @param keys
  *   A pointer to a list of keys to look for.
  * @param num_keys
- *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
  * @param positions
  *   Output containing a list of values, corresponding to the list of keys that
  *   can be used by the caller as an offset into an array of user data. These
@@ -2,7 +2,9 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <ctype.h>
 #include <math.h>
+#include <stdlib.h>
 
 #include <rte_string_fns.h>
 #include <rte_mbuf_dyn.h>
@@ -12,6 +14,7 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
 
@@ -19,7 +22,7 @@
 #define NS_PER_SEC 1E9
 
 /** Clock cycles per nano second */
-static uint64_t
+static double
 latencystat_cycles_per_ns(void)
 {
 	return rte_get_timer_hz() / NS_PER_SEC;
@@ -43,15 +46,46 @@ timestamp_dynfield(struct rte_mbuf *mbuf)
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
 static uint64_t samp_intvl;
-static uint64_t timer_tsc;
-static uint64_t prev_tsc;
+
+/*
+ * The latencies are counted in a log-linear histogram: each power of 2
+ * range of cycles is split in linear sub-buckets, so that the relative
+ * error of the percentiles is bounded by the sub-bucket width.
+ */
+#define LATENCY_HIST_SUB_BITS 4
+#define LATENCY_HIST_SUB RTE_BIT32(LATENCY_HIST_SUB_BITS)
+/** Latencies are capped to 2^40 cycles, several minutes */
+#define LATENCY_HIST_MAX_BITS 40
+#define LATENCY_HIST_BUCKETS \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS)
+
+/**
+ * Latency stats of a Tx queue, in cycles, only updated by the lcore
+ * transmitting on the queue.
+ */
+struct latency_stats_queue {
+	uint64_t samples; /**< Number of latency samples */
+	float min_latency; /**< Minimum latency */
+	float avg_latency; /**< Average latency */
+	float max_latency; /**< Maximum latency */
+	float jitter; /**< Latency variation */
+	float prev_latency; /**< Latency of the previous sample */
+	uint64_t hist[LATENCY_HIST_BUCKETS]; /**< Latency histogram */
+} __rte_cache_aligned;
+
+/** Sampling state of an Rx queue, only updated by the lcore polling it */
+struct latency_samp_queue {
+	uint64_t timer_tsc; /**< Cycles since the last sample */
+	uint64_t prev_tsc; /**< Time of the previous burst */
+} __rte_cache_aligned;
 
 struct rte_latency_stats {
-	float min_latency; /**< Minimum latency in nano seconds */
-	float avg_latency; /**< Average latency in nano seconds */
-	float max_latency; /**< Maximum latency in nano seconds */
-	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	uint32_t tx_queue_first[RTE_MAX_ETHPORTS]; /**< First Tx queue of ports */
+	uint16_t nb_tx_queues[RTE_MAX_ETHPORTS]; /**< Tx queues of ports */
+	uint32_t nb_tx_queues_total; /**< Number of Tx queue stats */
+	uint32_t nb_rx_queues_total; /**< Number of Rx queue states */
+	/** Tx queue stats, followed by Rx queue sampling states */
+	struct latency_stats_queue queues[];
 };
 
 static struct rte_latency_stats *glob_stats;
@@ -68,30 +102,162 @@ struct latency_stats_nameoff {
 	unsigned int offset;
 };
 
-static const struct latency_stats_nameoff lat_stats_strings[] = {
-	{"min_latency_ns", offsetof(struct rte_latency_stats, min_latency)},
-	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
-	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
-	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+/* Order of the latency stats values */
+enum latency_stats_id {
+	LATENCY_STATS_MIN,
+	LATENCY_STATS_AVG,
+	LATENCY_STATS_MAX,
+	LATENCY_STATS_JITTER,
+	LATENCY_STATS_P50,
+	LATENCY_STATS_P99,
+	LATENCY_STATS_P999,
+	LATENCY_STATS_P9999,
+	NUM_LATENCY_STATS
+};
+
+static const char * const lat_stats_strings[] = {
+	[LATENCY_STATS_MIN] = "min_latency_ns",
+	[LATENCY_STATS_AVG] = "avg_latency_ns",
+	[LATENCY_STATS_MAX] = "max_latency_ns",
+	[LATENCY_STATS_JITTER] = "jitter_ns",
+	[LATENCY_STATS_P50] = "p50_latency_ns",
+	[LATENCY_STATS_P99] = "p99_latency_ns",
+	[LATENCY_STATS_P999] = "p999_latency_ns",
+	[LATENCY_STATS_P9999] = "p9999_latency_ns",
+};
+
+static const double lat_stats_pct[] = {
+	[LATENCY_STATS_P50 - LATENCY_STATS_P50] = 0.5,
+	[LATENCY_STATS_P99 - LATENCY_STATS_P50] = 0.99,
+	[LATENCY_STATS_P999 - LATENCY_STATS_P50] = 0.999,
+	[LATENCY_STATS_P9999 - LATENCY_STATS_P50] = 0.9999,
 };
 
-#define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
-				sizeof(lat_stats_strings[0]))
+static inline unsigned int
+latency_hist_index(uint64_t latency)
+{
+	unsigned int shift;
+
+	if (latency < LATENCY_HIST_SUB)
+		return latency;
+	if (latency >= RTE_BIT64(LATENCY_HIST_MAX_BITS))
+		return LATENCY_HIST_BUCKETS - 1;
+
+	shift = rte_fls_u64(latency) - 1 - LATENCY_HIST_SUB_BITS;
+	return ((shift + 1) << LATENCY_HIST_SUB_BITS) |
+		((latency >> shift) & (LATENCY_HIST_SUB - 1));
+}
+
+/* Lowest latency counted in a histogram bucket */
+static uint64_t
+latency_hist_value(unsigned int index)
+{
+	unsigned int shift;
+
+	if (index < LATENCY_HIST_SUB)
+		return index;
+
+	shift = (index >> LATENCY_HIST_SUB_BITS) - 1;
+	return (uint64_t)(LATENCY_HIST_SUB | (index & (LATENCY_HIST_SUB - 1))) << shift;
+}
+
+/*
+ * Merge the stats of Tx queues, and compute the latency percentiles
+ * from the merged histogram, interpolating within the buckets.
+ */
+static void
+latencystats_collect(const struct latency_stats_queue *queues,
+		unsigned int nb_queues, uint64_t values[NUM_LATENCY_STATS])
+{
+	const double cycles_per_ns = latencystat_cycles_per_ns();
+	double avg = 0, jitter = 0, min = 0, max = 0;
+	uint64_t count, total, rank, low, high;
+	unsigned int i, q, pct;
+	uint64_t *hist;
+
+	memset(values, 0, NUM_LATENCY_STATS * sizeof(values[0]));
+
+	hist = calloc(LATENCY_HIST_BUCKETS, sizeof(*hist));
+	if (hist == NULL)
+		return;
+
+	total = 0;
+	for (q = 0; q < nb_queues; q++) {
+		const struct latency_stats_queue *stats = &queues[q];
+
+		if (stats->samples == 0)
+			continue;
+
+		if (total == 0 || stats->min_latency < min)
+			min = stats->min_latency;
+		if (stats->max_latency > max)
+			max = stats->max_latency;
+		avg += (double)stats->avg_latency * stats->samples;
+		jitter += (double)stats->jitter * stats->samples;
+		total += stats->samples;
+		for (i = 0; i < LATENCY_HIST_BUCKETS; i++)
+			hist[i] += stats->hist[i];
+	}
+
+	if (total == 0 || cycles_per_ns == 0)
+		goto out;
+
+	values[LATENCY_STATS_MIN] = floor(min / cycles_per_ns);
+	values[LATENCY_STATS_AVG] = floor(avg / total / cycles_per_ns);
+	values[LATENCY_STATS_MAX] = floor(max / cycles_per_ns);
+	values[LATENCY_STATS_JITTER] = floor(jitter / total / cycles_per_ns);
+
+	/* the histogram may be updated meanwhile, use its own total */
+	total = 0;
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		total += hist[i];
+
+	count = 0;
+	i = 0;
+	for (pct = 0; pct < RTE_DIM(lat_stats_pct); pct++) {
+		rank = ceil(lat_stats_pct[pct] * total);
+		while (i < LATENCY_HIST_BUCKETS - 1 && count + hist[i] < rank)
+			count += hist[i++];
+
+		low = latency_hist_value(i);
+		high = i < LATENCY_HIST_BUCKETS - 1 ?
+			latency_hist_value(i + 1) : low + 1;
+		values[LATENCY_STATS_P50 + pct] = floor(RTE_MIN(max,
+			low + (double)(high - low) * (rank - count) /
+			RTE_MAX(hist[i], 1ULL)) / cycles_per_ns);
+	}
+
+out:
+	free(hist);
+}
+
+/* Get the latency stats memzone, when initialized by the primary process */
+static int
+latencystats_lookup(void)
+{
+	const struct rte_memzone *mz;
+
+	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
+		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
+		if (mz == NULL) {
+			LATENCY_STATS_LOG(ERR,
+				"Latency stats memzone not found");
+			return -ENOMEM;
+		}
+		glob_stats = mz->addr;
+	}
+
+	return glob_stats != NULL ? 0 : -ENOMEM;
+}
 
 int32_t
 rte_latencystats_update(void)
 {
-	unsigned int i;
-	float *stats_ptr = NULL;
-	uint64_t values[NUM_LATENCY_STATS] = {0};
+	uint64_t values[NUM_LATENCY_STATS];
 	int ret;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
-		values[i] = (uint64_t)floor((*stats_ptr)/
-				latencystat_cycles_per_ns());
-	}
+	latencystats_collect(glob_stats->queues, glob_stats->nb_tx_queues_total,
+			values);
 
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
@@ -103,17 +269,17 @@ rte_latencystats_update(void)
 }
 
 static void
-rte_latencystats_fill_values(struct rte_metric_value *values)
+rte_latencystats_fill_values(struct rte_metric_value *values,
+		const struct latency_stats_queue *queues, unsigned int nb_queues)
 {
+	uint64_t stats[NUM_LATENCY_STATS];
 	unsigned int i;
-	float *stats_ptr = NULL;
+
+	latencystats_collect(queues, nb_queues, stats);
 
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
-						latencystat_cycles_per_ns());
+		values[i].value = stats[i];
 	}
 }
 
@@ -123,28 +289,31 @@ add_time_stamps(uint16_t pid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		uint16_t max_pkts __rte_unused,
-		void *user_cb __rte_unused)
+		void *user_param)
 {
+	struct latency_samp_queue *samp = user_param;
 	unsigned int i;
-	uint64_t diff_tsc, now;
+	uint64_t now;
 
 	/*
 	 * For every sample interval,
 	 * time stamp is marked on one received packet.
+	 * The packets of a burst are received at the same time,
+	 * so at most one of them is marked.
 	 */
 	now = rte_rdtsc();
-	for (i = 0; i < nb_pkts; i++) {
-		diff_tsc = now - prev_tsc;
-		timer_tsc += diff_tsc;
+	samp->timer_tsc += now - samp->prev_tsc;
+	samp->prev_tsc = now;
+	if (samp->timer_tsc < samp_intvl)
+		return nb_pkts;
 
-		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0
-				&& (timer_tsc >= samp_intvl)) {
+	for (i = 0; i < nb_pkts; i++) {
+		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0) {
 			*timestamp_dynfield(pkts[i]) = now;
 			pkts[i]->ol_flags |= timestamp_dynflag;
-			timer_tsc = 0;
+			samp->timer_tsc = 0;
+			break;
 		}
-		prev_tsc = now;
-		now = rte_rdtsc();
 	}
 
 	return nb_pkts;
@@ -155,12 +324,13 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *user_param)
 {
+	struct latency_stats_queue *stats = user_param;
 	unsigned int i, cnt = 0;
 	uint64_t now;
-	float latency[nb_pkts];
-	static float prev_latency;
+	uint64_t latency[nb_pkts];
+	float lat;
 	/*
 	 * Alpha represents degree of weighting decrease in EWMA,
 	 * a constant smoothing factor between 0 and 1. The value
@@ -174,8 +344,9 @@ calc_latency(uint16_t pid __rte_unused,
 			latency[cnt++] = now - *timestamp_dynfield(pkts[i]);
 	}
 
-	rte_spinlock_lock(&glob_stats->lock);
+	/* the stats of the queue are only updated by this lcore */
 	for (i = 0; i < cnt; i++) {
+		lat = latency[i];
 		/*
 		 * The jitter is calculated as statistical mean of interpacket
 		 * delay variation. The "jitter estimate" is computed by taking
@@ -187,37 +358,36 @@ calc_latency(uint16_t pid __rte_unused,
 		 * Reference: Calculated as per RFC 5481, sec 4.1,
 		 * RFC 3393 sec 4.5, RFC 1889 sec.
 		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency[i])
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] < glob_stats->min_latency)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] > glob_stats->max_latency)
-			glob_stats->max_latency = latency[i];
+		stats->jitter +=  (fabsf(stats->prev_latency - lat)
+					- stats->jitter)/16;
+		if (stats->min_latency == 0 || lat < stats->min_latency)
+			stats->min_latency = lat;
+		if (lat > stats->max_latency)
+			stats->max_latency = lat;
 		/*
 		 * The average latency is measured using exponential moving
 		 * average, i.e. using EWMA
 		 * https://en.wikipedia.org/wiki/Moving_average
 		 */
-		glob_stats->avg_latency +=
-			alpha * (latency[i] - glob_stats->avg_latency);
-		prev_latency = latency[i];
+		stats->avg_latency +=
+			alpha * (lat - stats->avg_latency);
+		stats->prev_latency = lat;
+		stats->hist[latency_hist_index(latency[i])]++;
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
+	stats->samples += cnt;
 
 	return nb_pkts;
 }
 
 int
 rte_latencystats_init(uint64_t app_samp_intvl,
-		rte_latency_stats_flow_type_fn user_cb)
+		rte_latency_stats_flow_type_fn user_cb __rte_unused)
 {
-	unsigned int i;
+	struct latency_samp_queue *samp_queues;
+	uint32_t nb_tx = 0, nb_rx = 0;
 	uint16_t pid;
 	uint16_t qid;
 	struct rxtx_cbs *cbs = NULL;
-	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
 	int ret;
@@ -225,9 +395,27 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/** Count the queues which get their own stats */
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+
+		ret = rte_eth_dev_info_get(pid, &dev_info);
+		if (ret != 0) {
+			LATENCY_STATS_LOG(INFO,
+				"Error during getting device (port %u) info: %s",
+				pid, strerror(-ret));
+
+			continue;
+		}
+		nb_rx += dev_info.nb_rx_queues;
+		nb_tx += dev_info.nb_tx_queues;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
-					rte_socket_id(), flags);
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats) +
+			nb_tx * sizeof(glob_stats->queues[0]) +
+			nb_rx * sizeof(*samp_queues),
+			rte_socket_id(), flags);
 	if (mz == NULL) {
 		LATENCY_STATS_LOG(ERR, "Cannot reserve memory: %s:%d",
 			__func__, __LINE__);
@@ -235,14 +423,12 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
+	memset(glob_stats, 0, mz->len);
+	samp_queues = (void *)&glob_stats->queues[nb_tx];
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
-	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		ptr_strings[i] = lat_stats_strings[i].name;
-
-	latency_stats_index = rte_metrics_reg_names(ptr_strings,
+	latency_stats_index = rte_metrics_reg_names(lat_stats_strings,
 							NUM_LATENCY_STATS);
 	if (latency_stats_index < 0) {
 		LATENCY_STATS_LOG(DEBUG,
@@ -259,7 +445,7 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 		return -rte_errno;
 	}
 
-	/** Register Rx/Tx callbacks */
+	/** Register Rx/Tx callbacks, with the stats of their queue */
 	RTE_ETH_FOREACH_DEV(pid) {
 		struct rte_eth_dev_info dev_info;
 
@@ -272,24 +458,31 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 			continue;
 		}
 
-		for (qid = 0; qid < dev_info.nb_rx_queues; qid++) {
+		for (qid = 0; qid < dev_info.nb_rx_queues &&
+				glob_stats->nb_rx_queues_total < nb_rx; qid++) {
 			cbs = &rx_cbs[pid][qid];
 			cbs->cb = rte_eth_add_first_rx_callback(pid, qid,
-					add_time_stamps, user_cb);
+					add_time_stamps,
+					&samp_queues[glob_stats->nb_rx_queues_total++]);
 			if (!cbs->cb)
 				LATENCY_STATS_LOG(INFO, "Failed to "
 					"register Rx callback for pid=%d, "
 					"qid=%d", pid, qid);
 		}
-		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+
+		glob_stats->tx_queue_first[pid] = glob_stats->nb_tx_queues_total;
+		for (qid = 0; qid < dev_info.nb_tx_queues &&
+				glob_stats->nb_tx_queues_total < nb_tx; qid++) {
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency,
+					&glob_stats->queues[glob_stats->nb_tx_queues_total++]);
 			if (!cbs->cb)
 				LATENCY_STATS_LOG(INFO, "Failed to "
 					"register Tx callback for pid=%d, "
 					"qid=%d", pid, qid);
 		}
+		glob_stats->nb_tx_queues[pid] = qid;
 	}
 	return 0;
 }
@@ -338,6 +531,7 @@ rte_latencystats_uninit(void)
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -351,7 +545,7 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 		return NUM_LATENCY_STATS;
 
 	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		strlcpy(names[i].name, lat_stats_strings[i].name,
+		strlcpy(names[i].name, lat_stats_strings[i],
 			sizeof(names[i].name));
 
 	return NUM_LATENCY_STATS;
@@ -363,19 +557,100 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 	if (size < NUM_LATENCY_STATS || values == NULL)
 		return NUM_LATENCY_STATS;
 
-	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
-		const struct rte_memzone *mz;
-		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
-		if (mz == NULL) {
-			LATENCY_STATS_LOG(ERR,
-				"Latency stats memzone not found");
-			return -ENOMEM;
-		}
-		glob_stats =  mz->addr;
-	}
+	if (latencystats_lookup() < 0)
+		return -ENOMEM;
 
 	/* Retrieve latency stats */
-	rte_latencystats_fill_values(values);
+	rte_latencystats_fill_values(values, glob_stats->queues,
+			glob_stats->nb_tx_queues_total);
+
+	return NUM_LATENCY_STATS;
+}
+
+int
+rte_latencystats_queue_get(uint16_t port_id, uint16_t queue_id,
+		struct rte_metric_value *values, uint16_t size)
+{
+	if (size < NUM_LATENCY_STATS || values == NULL)
+		return NUM_LATENCY_STATS;
+
+	if (latencystats_lookup() < 0)
+		return -ENOMEM;
+
+	if (port_id >= RTE_MAX_ETHPORTS ||
+			queue_id >= glob_stats->nb_tx_queues[port_id])
+		return -EINVAL;
+
+	/* Retrieve latency stats of the queue */
+	rte_latencystats_fill_values(values,
+			&glob_stats->queues[glob_stats->tx_queue_first[port_id] +
+				queue_id], 1);
 
 	return NUM_LATENCY_STATS;
 }
+
+static int
+latencystats_tel_dict(struct rte_tel_data *d, const struct rte_metric_value *values)
+{
+	unsigned int i;
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		rte_tel_data_add_dict_uint(d, lat_stats_strings[i],
+				values[i].value);
+
+	return 0;
+}
+
+static int
+latencystats_handle_stats(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	struct rte_metric_value values[NUM_LATENCY_STATS];
+
+	if (rte_latencystats_get(values, NUM_LATENCY_STATS) < 0)
+		return -EINVAL;
+
+	return latencystats_tel_dict(d, values);
+}
+
+static int
+latencystats_handle_queue_stats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_metric_value values[NUM_LATENCY_STATS];
+	unsigned long port_id, queue_id;
+	char *end_param;
+
+	if (params == NULL || !isdigit(*params))
+		return -EINVAL;
+
+	port_id = strtoul(params, &end_param, 0);
+	if (*end_param != ',' || !isdigit(end_param[1]))
+		return -EINVAL;
+
+	queue_id = strtoul(end_param + 1, &end_param, 0);
+	if (*end_param != '\0')
+		LATENCY_STATS_LOG(NOTICE,
+			"Extra parameters passed to latencystats telemetry command, ignoring");
+	if (port_id >= RTE_MAX_ETHPORTS || queue_id > UINT16_MAX)
+		return -EINVAL;
+
+	if (rte_latencystats_queue_get(port_id, queue_id, values,
+			NUM_LATENCY_STATS) < 0)
+		return -EINVAL;
+
+	return latencystats_tel_dict(d, values);
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats/stats",
+		latencystats_handle_stats,
+		"Returns the latency stats of all the Tx queues. Takes no parameters");
+	rte_telemetry_register_cmd("/latencystats/queue_stats",
+		latencystats_handle_queue_stats,
+		"Returns the latency stats of a Tx queue. Parameters: int port_id,int queue_id");
+}
@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_metrics.h>
 #include <rte_mbuf.h>
 
@@ -43,9 +44,13 @@ typedef uint16_t (*rte_latency_stats_flow_type_fn)(struct rte_mbuf *pkt,
 /**
  *  Registers Rx/Tx callbacks for each active port, queue.
  *
+ *  The latency stats of each Tx queue are updated by the lcore transmitting
+ *  on the queue only, and merged when they are retrieved.
+ *
  * @param samp_intvl
  *  Sampling time period in nano seconds, at which packet
- *  should be marked with time stamp.
+ *  should be marked with time stamp. At most one packet per Rx burst
+ *  is marked.
  * @param user_cb
  *  Note: This param is for future flow based latency stats
  *  implementation.
@@ -121,6 +126,40 @@ int rte_latencystats_get_names(struct rte_metric_name *names,
 int rte_latencystats_get(struct rte_metric_value *values,
 			uint16_t size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the latency statistics of a Tx queue.
+ *
+ * The statistics have the same names as the ones of all the queues,
+ * returned by rte_latencystats_get_names().
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The index of the Tx queue.
+ * @param values
+ *   A pointer to a table of structure of type *rte_metric_value*
+ *   to be filled with latency statistics ids and values.
+ *   This parameter can be set to NULL if size is 0.
+ * @param size
+ *   The size of the stats table, which should be large enough to store
+ *   all the latency stats.
+ * @return
+ *   - positive value lower or equal to size: success. The return value
+ *     is the number of entries filled in the stats table.
+ *   - positive value higher than size: error, the given statistics table
+ *     is too small. The return value corresponds to the size that should
+ *     be given to succeed. The entries in the table are not valid and
+ *     shall not be used by the caller.
+ *   -EINVAL: The queue has no latency statistics.
+ *   -ENOMEM: On failure.
+ */
+__rte_experimental
+int rte_latencystats_queue_get(uint16_t port_id, uint16_t queue_id,
+			struct rte_metric_value *values, uint16_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2010-2014 Intel Corporation
+ */
+
+#ifndef _LPM6_H_
+#define _LPM6_H_
+
+#include <stdint.h>
+
+#include "rte_lpm6.h"
+
+#define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
+#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
+#define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
+
+#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
+#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
+#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
+
+#define ADD_FIRST_BYTE                            3
+#define LOOKUP_FIRST_BYTE                         4
+#define BYTE_SIZE                                 8
+#define BYTES2_SIZE                              16
+
+/* Number of addresses walked together by the bulk lookup */
+#define LPM6_LOOKUP_INTERLEAVE                    8
+
+#ifdef CC_LPM6_AVX2_SUPPORT
+/*
+ * Looks up groups of LPM6_LOOKUP_INTERLEAVE addresses using AVX2 gathers.
+ * tbl points to the tbl24 array, tbl8_off is the offset in entries of the
+ * tbl8 array from tbl. Returns the number of addresses looked up, the
+ * caller is responsible for the remaining (n % LPM6_LOOKUP_INTERLEAVE) ones.
+ */
+unsigned int
+lpm6_lookup_bulk_avx2(const void *tbl, int32_t tbl8_off,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, unsigned int n);
+#endif
+
+#endif /* _LPM6_H_ */
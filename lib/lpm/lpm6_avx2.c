@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2010-2014 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "lpm6.h"
+
+/*
+ * Walks LPM6_LOOKUP_INTERLEAVE addresses through the tables, one gather
+ * per level. Lanes that hit a non extended entry drop out of the gather
+ * mask and keep their result.
+ */
+static __rte_always_inline void
+lookup_x8(const void *tbl, int32_t tbl8_off,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	const __m256i ext_msk =
+		_mm256_set1_epi32((int)RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m256i hit_msk = _mm256_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS);
+	const __m256i nh_msk = _mm256_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m256i tbl8_base = _mm256_set1_epi32(tbl8_off);
+	const __m256i miss = _mm256_set1_epi32(-1);
+	__m256i idx, ent, ext, hit, done, nh, res, active, bytes;
+	uint32_t i;
+
+#define TBL24_IDX(k)	((ips[k][0] << BYTES2_SIZE) | \
+			(ips[k][1] << BYTE_SIZE) | ips[k][2])
+	idx = _mm256_set_epi32(TBL24_IDX(7), TBL24_IDX(6), TBL24_IDX(5),
+		TBL24_IDX(4), TBL24_IDX(3), TBL24_IDX(2), TBL24_IDX(1),
+		TBL24_IDX(0));
+#undef TBL24_IDX
+
+	ent = _mm256_i32gather_epi32(tbl, idx, sizeof(uint32_t));
+	res = miss;
+	active = miss;
+
+	for (i = LOOKUP_FIRST_BYTE - 1; ; i++) {
+		/* valid and extended entries go on to the next level */
+		ext = _mm256_cmpeq_epi32(_mm256_and_si256(ent, ext_msk),
+			ext_msk);
+		ext = _mm256_and_si256(ext, active);
+
+		/* the rest of the active lanes are done */
+		done = _mm256_andnot_si256(ext, active);
+		hit = _mm256_cmpeq_epi32(_mm256_and_si256(ent, hit_msk),
+			hit_msk);
+		nh = _mm256_blendv_epi8(miss, _mm256_and_si256(ent, nh_msk),
+			hit);
+		res = _mm256_blendv_epi8(res, nh, done);
+
+		active = ext;
+		if (_mm256_testz_si256(active, active))
+			break;
+
+		bytes = _mm256_set_epi32(ips[7][i], ips[6][i], ips[5][i],
+			ips[4][i], ips[3][i], ips[2][i], ips[1][i], ips[0][i]);
+		idx = _mm256_add_epi32(tbl8_base, _mm256_add_epi32(bytes,
+			_mm256_slli_epi32(_mm256_and_si256(ent, nh_msk), 8)));
+		ent = _mm256_mask_i32gather_epi32(ent, tbl, idx, active,
+			sizeof(uint32_t));
+	}
+
+	_mm256_storeu_si256((__m256i *)next_hops, res);
+}
+
+unsigned int
+lpm6_lookup_bulk_avx2(const void *tbl, int32_t tbl8_off,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i + LPM6_LOOKUP_INTERLEAVE <= n;
+			i += LPM6_LOOKUP_INTERLEAVE)
+		lookup_x8(tbl, tbl8_off, &ips[i], &next_hops[i]);
+
+	return i;
+}
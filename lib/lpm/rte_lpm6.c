@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdalign.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <stdio.h>
 #include <sys/queue.h>
@@ -19,23 +20,15 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_vect.h>
+#include <rte_cpuflags.h>
+#include <rte_prefetch.h>
+#include <rte_bitops.h>
 
 #include "rte_lpm6.h"
+#include "lpm6.h"
 #include "lpm_log.h"
 
-#define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
-#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
-#define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
-
-#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
-#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
-#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
-
-#define ADD_FIRST_BYTE                            3
-#define LOOKUP_FIRST_BYTE                         4
-#define BYTE_SIZE                                 8
-#define BYTES2_SIZE                              16
-
 #define RULE_HASH_TABLE_EXTRA_SPACE              64
 #define TBL24_IND                        UINT32_MAX
 
@@ -968,6 +961,66 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const uint8_t *ip,
 	return status;
 }
 
+#ifdef CC_LPM6_AVX2_SUPPORT
+/* Set once at startup, the tables may be shared with secondary processes */
+static bool lpm6_avx2_supported;
+
+RTE_INIT(lpm6_init_lookup)
+{
+	lpm6_avx2_supported = rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) > 0;
+}
+#endif
+
+/*
+ * Walks up to LPM6_LOOKUP_INTERLEAVE addresses through the tables together.
+ * All lanes advance by one level per round, and the entry for the next level
+ * of every lane still in flight is prefetched before any of them is read, so
+ * the memory accesses of the different addresses overlap.
+ */
+static inline void
+lookup_bulk_interleave(const struct rte_lpm6 *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n)
+{
+	const struct rte_lpm6_tbl_entry *tbl[LPM6_LOOKUP_INTERLEAVE];
+	uint32_t tbl8_index, tbl24_index, tbl_entry, active;
+	unsigned int i, k;
+	uint8_t byte;
+
+	for (k = 0; k < n; k++) {
+		tbl24_index = (ips[k][0] << BYTES2_SIZE) |
+				(ips[k][1] << BYTE_SIZE) | ips[k][2];
+		tbl[k] = &lpm->tbl24[tbl24_index];
+		rte_prefetch0(tbl[k]);
+	}
+
+	active = RTE_LEN2MASK(n, uint32_t);
+
+	for (byte = LOOKUP_FIRST_BYTE - 1; active != 0; byte++) {
+		for (i = active; i != 0; i &= i - 1) {
+			k = rte_ctz32(i);
+
+			/* Take the integer value from the pointer. */
+			tbl_entry = *(const uint32_t *)tbl[k];
+
+			/* Valid and extended: go on to the next level. */
+			if ((tbl_entry & RTE_LPM6_VALID_EXT_ENTRY_BITMASK) ==
+					RTE_LPM6_VALID_EXT_ENTRY_BITMASK) {
+				tbl8_index = ips[k][byte] +
+					((tbl_entry & RTE_LPM6_TBL8_BITMASK) *
+					RTE_LPM6_TBL8_GROUP_NUM_ENTRIES);
+				tbl[k] = &lpm->tbl8[tbl8_index];
+				rte_prefetch0(tbl[k]);
+				continue;
+			}
+
+			next_hops[k] = (tbl_entry & RTE_LPM6_LOOKUP_SUCCESS) ?
+				(int32_t)(tbl_entry & RTE_LPM6_TBL8_BITMASK) : -1;
+			active &= ~(1u << k);
+		}
+	}
+}
+
 /*
  * Looks up a group of IP addresses
  */
@@ -976,39 +1029,22 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
 		int32_t *next_hops, unsigned int n)
 {
-	unsigned int i;
-	const struct rte_lpm6_tbl_entry *tbl;
-	const struct rte_lpm6_tbl_entry *tbl_next = NULL;
-	uint32_t tbl24_index, next_hop;
-	uint8_t first_byte;
-	int status;
+	unsigned int i = 0;
 
 	/* DEBUG: Check user input arguments. */
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
-	for (i = 0; i < n; i++) {
-		first_byte = LOOKUP_FIRST_BYTE;
-		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
-				(ips[i][1] << BYTE_SIZE) | ips[i][2];
-
-		/* Calculate pointer to the first entry to be inspected */
-		tbl = &lpm->tbl24[tbl24_index];
+#ifdef CC_LPM6_AVX2_SUPPORT
+	if (lpm6_avx2_supported &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		i = lpm6_lookup_bulk_avx2(lpm->tbl24,
+			(int32_t)(lpm->tbl8 - lpm->tbl24), ips, next_hops, n);
+#endif
 
-		do {
-			/* Continue inspecting following levels
-			 * until success or failure
-			 */
-			status = lookup_step(lpm, tbl, &tbl_next, ips[i],
-					first_byte++, &next_hop);
-			tbl = tbl_next;
-		} while (status == 1);
-
-		if (status < 0)
-			next_hops[i] = -1;
-		else
-			next_hops[i] = (int32_t)next_hop;
-	}
+	for (; i < n; i += LPM6_LOOKUP_INTERLEAVE)
+		lookup_bulk_interleave(lpm, &ips[i], &next_hops[i],
+			RTE_MIN(n - i, (unsigned int)LPM6_LOOKUP_INTERLEAVE));
 
 	return 0;
 }
@@ -445,70 +445,159 @@ int rte_mbuf_check(const struct rte_mbuf *m, int is_header,
 	return 0;
 }
 
+/**
+ * Size of the array holding mbufs from the same mempool pending to be freed
+ * in bulk.
+ */
+#define RTE_PKTMBUF_FREE_PENDING_SZ 64
+
+/** Number of mempools mbufs can be pending to be freed in bulk to. */
+#define RTE_PKTMBUF_FREE_PENDING_POOLS 4
+
+/**
+ * Minimum number of consecutive mbufs put back in their mempool
+ * directly from the array given to rte_pktmbuf_free_bulk().
+ */
+#define RTE_PKTMBUF_FREE_RUN_MIN 8
+
+/* Packet mbuf segments from the same mempool pending to be freed. */
+struct pktmbuf_free_pending {
+	struct rte_mempool *pool;
+	unsigned int nb;
+	struct rte_mbuf *m[RTE_PKTMBUF_FREE_PENDING_SZ];
+};
+
+static inline void
+pktmbuf_free_pending_flush(struct pktmbuf_free_pending *pending)
+{
+	if (pending->nb == 0)
+		return;
+	rte_mempool_put_bulk(pending->pool, (void **)pending->m, pending->nb);
+	pending->nb = 0;
+}
+
 /**
  * @internal helper function for freeing a bulk of packet mbuf segments
- * via an array holding the packet mbuf segments from the same mempool
- * pending to be freed.
+ * via arrays holding the packet mbuf segments pending to be freed, one
+ * per mempool, so that segments from interleaved mempools are still
+ * freed in bulk.
  *
  * @param m
- *  The packet mbuf segment to be freed.
+ *  The packet mbuf segment to be freed, already prefreed.
  * @param pending
- *  Pointer to the array of packet mbuf segments pending to be freed.
- * @param nb_pending
- *  Pointer to the number of elements held in the array.
- * @param pending_sz
- *  Number of elements the array can hold.
- *  Note: The compiler should optimize this parameter away when using a
- *  constant value, such as RTE_PKTMBUF_FREE_PENDING_SZ.
+ *  Pointer to the arrays of packet mbuf segments pending to be freed.
+ * @param nb_pools
+ *  Pointer to the number of arrays in use.
  */
-static void
+static __rte_always_inline void
 __rte_pktmbuf_free_seg_via_array(struct rte_mbuf *m,
-	struct rte_mbuf ** const pending, unsigned int * const nb_pending,
-	const unsigned int pending_sz)
+	struct pktmbuf_free_pending * const pending,
+	unsigned int * const nb_pools)
 {
-	m = rte_pktmbuf_prefree_seg(m);
-	if (likely(m != NULL)) {
-		if (*nb_pending == pending_sz ||
-		    (*nb_pending > 0 && m->pool != pending[0]->pool)) {
-			rte_mempool_put_bulk(pending[0]->pool,
-					(void **)pending, *nb_pending);
-			*nb_pending = 0;
-		}
+	struct pktmbuf_free_pending *p;
+	unsigned int i, full;
 
-		pending[(*nb_pending)++] = m;
+	for (i = 0; i != *nb_pools; i++) {
+		if (pending[i].pool == m->pool)
+			break;
 	}
+
+	if (unlikely(i == *nb_pools)) {
+		if (*nb_pools == RTE_PKTMBUF_FREE_PENDING_POOLS) {
+			/* no array left, free the fullest one for this pool */
+			for (i = 0, full = 1; full != *nb_pools; full++) {
+				if (pending[full].nb > pending[i].nb)
+					i = full;
+			}
+			pktmbuf_free_pending_flush(&pending[i]);
+		} else
+			(*nb_pools)++;
+		pending[i].pool = m->pool;
+		pending[i].nb = 0;
+	}
+
+	p = &pending[i];
+	if (p->nb == RTE_PKTMBUF_FREE_PENDING_SZ)
+		pktmbuf_free_pending_flush(p);
+	p->m[p->nb++] = m;
 }
 
-/**
- * Size of the array holding mbufs from the same mempool pending to be freed
- * in bulk.
+/*
+ * Return the number of consecutive mbufs at the start of the array that
+ * come from the same mempool, and only need to be put back in it to be
+ * freed: direct single segment mbufs, not referenced anywhere else. For
+ * these, rte_pktmbuf_prefree_seg() doesn't modify the mbuf.
  */
-#define RTE_PKTMBUF_FREE_PENDING_SZ 64
+static __rte_always_inline unsigned int
+__rte_pktmbuf_free_run(struct rte_mbuf * const *mbufs, unsigned int count)
+{
+	const struct rte_mempool *pool = mbufs[0]->pool;
+	const struct rte_mbuf *m;
+	unsigned int idx;
+
+	for (idx = 0; idx != count; idx++) {
+		m = mbufs[idx];
+		if (m == NULL || m->pool != pool ||
+				rte_mbuf_refcnt_read(m) != 1 ||
+				m->nb_segs != 1 ||
+				(m->ol_flags & (RTE_MBUF_F_INDIRECT |
+					RTE_MBUF_F_EXTERNAL)) != 0)
+			break;
+		__rte_mbuf_sanity_check(m, 1);
+	}
+
+	return idx;
+}
 
 /* Free a bulk of packet mbufs back into their original mempools. */
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 {
-	struct rte_mbuf *m, *m_next, *pending[RTE_PKTMBUF_FREE_PENDING_SZ];
-	unsigned int idx, nb_pending = 0;
+	struct pktmbuf_free_pending pending[RTE_PKTMBUF_FREE_PENDING_POOLS];
+	struct rte_mbuf *m, *m_next;
+	unsigned int idx, i, nb, nb_pools = 0;
 
-	for (idx = 0; idx < count; idx++) {
+	idx = 0;
+	while (idx < count) {
 		m = mbufs[idx];
-		if (unlikely(m == NULL))
+		if (unlikely(m == NULL)) {
+			idx++;
+			continue;
+		}
+
+		/*
+		 * Fast path: put a run of mbufs from one mempool back
+		 * directly from the array, skipping the per segment prefree.
+		 * Short runs are gathered per mempool instead.
+		 */
+		nb = __rte_pktmbuf_free_run(&mbufs[idx], count - idx);
+		if (nb >= RTE_PKTMBUF_FREE_RUN_MIN) {
+			rte_mempool_put_bulk(m->pool, (void **)&mbufs[idx], nb);
+			idx += nb;
 			continue;
+		}
+		if (nb != 0) {
+			for (i = 0; i != nb; i++)
+				__rte_pktmbuf_free_seg_via_array(mbufs[idx + i],
+						pending, &nb_pools);
+			idx += nb;
+			continue;
+		}
 
 		__rte_mbuf_sanity_check(m, 1);
 
 		do {
 			m_next = m->next;
-			__rte_pktmbuf_free_seg_via_array(m,
-					pending, &nb_pending,
-					RTE_PKTMBUF_FREE_PENDING_SZ);
+			m = rte_pktmbuf_prefree_seg(m);
+			if (likely(m != NULL))
+				__rte_pktmbuf_free_seg_via_array(m,
+						pending, &nb_pools);
 			m = m_next;
 		} while (m != NULL);
+		idx++;
 	}
 
-	if (nb_pending > 0)
-		rte_mempool_put_bulk(pending[0]->pool, (void **)pending, nb_pending);
+	for (i = 0; i != nb_pools; i++)
+		pktmbuf_free_pending_flush(&pending[i]);
 }
 
 /* Creates a shallow copy of mbuf */
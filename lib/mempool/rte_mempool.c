@@ -746,7 +746,8 @@ rte_mempool_free(struct rte_mempool *mp)
 }
 
 static void
-mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
+mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size,
+		   bool adaptive)
 {
 	/* Check that cache have enough space for flush threshold */
 	RTE_BUILD_BUG_ON(CALC_CACHE_FLUSHTHRESH(RTE_MEMPOOL_CACHE_MAX_SIZE) >
@@ -756,6 +757,10 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->size = size;
 	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
 	cache->len = 0;
+
+	/* an adaptive cache starts with the average burst matching its size */
+	cache->max_size = adaptive ? size : 0;
+	cache->burst_avg = (size / RTE_MEMPOOL_CACHE_ADAPT_BURSTS) << 4;
 }
 
 /*
@@ -781,7 +786,7 @@ rte_mempool_cache_create(uint32_t size, int socket_id)
 		return NULL;
 	}
 
-	mempool_cache_init(cache, size);
+	mempool_cache_init(cache, size, false);
 
 	rte_mempool_trace_cache_create(size, socket_id, cache);
 	return cache;
@@ -944,7 +949,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	if (cache_size != 0) {
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
-					   cache_size);
+					   cache_size,
+					   flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE);
 	}
 
 	te->data = mp;
@@ -1047,10 +1053,22 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		return count;
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
 		count += cache_count;
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+		if (cache->stats.get_hit + cache->stats.get_miss +
+		    cache->stats.put_flush == 0)
+			continue;
+		fprintf(f, "    cache_stats[%u]: size=%"PRIu32" get_hit=%"PRIu64
+			" get_miss=%"PRIu64" put_flush=%"PRIu64"\n",
+			lcore_id, cache->size, cache->stats.get_hit,
+			cache->stats.get_miss, cache->stats.put_flush);
+#endif
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
@@ -1557,10 +1575,78 @@ mempool_handle_info(const char *cmd __rte_unused, const char *params,
 	return 0;
 }
 
+static void
+mempool_cache_stats_cb(struct rte_mempool *mp, void *arg)
+{
+	struct mempool_info_cb_arg *info = (struct mempool_info_cb_arg *)arg;
+	const struct rte_mempool_cache *cache;
+	struct rte_tel_data *c;
+	char name[RTE_TEL_MAX_STRING_LEN];
+	unsigned int lcore_id;
+
+	if (strncmp(mp->name, info->pool_name, RTE_MEMZONE_NAMESIZE))
+		return;
+
+	rte_tel_data_add_dict_string(info->d, "name", mp->name);
+	rte_tel_data_add_dict_uint(info->d, "cache_size", mp->cache_size);
+	rte_tel_data_add_dict_uint(info->d, "adaptive",
+		!!(mp->flags & RTE_MEMPOOL_F_ADAPTIVE_CACHE));
+	if (mp->cache_size == 0)
+		return;
+
+	/* only report the caches of the lcores in use */
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (rte_lcore_has_role(lcore_id, ROLE_OFF))
+			continue;
+		cache = &mp->local_cache[lcore_id];
+
+		c = rte_tel_data_alloc();
+		if (c == NULL)
+			return;
+		rte_tel_data_start_dict(c);
+		rte_tel_data_add_dict_uint(c, "size", cache->size);
+		rte_tel_data_add_dict_uint(c, "len", cache->len);
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+		rte_tel_data_add_dict_uint(c, "get_hit", cache->stats.get_hit);
+		rte_tel_data_add_dict_uint(c, "get_miss",
+			cache->stats.get_miss);
+		rte_tel_data_add_dict_uint(c, "put_flush",
+			cache->stats.put_flush);
+#endif
+
+		snprintf(name, sizeof(name), "lcore_%u", lcore_id);
+		if (rte_tel_data_add_dict_container(info->d, name, c, 0) != 0)
+			rte_tel_data_free(c);
+	}
+}
+
+static int
+mempool_handle_cache_stats(const char *cmd __rte_unused, const char *params,
+			   struct rte_tel_data *d)
+{
+	struct mempool_info_cb_arg mp_arg;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	if (!params || strlen(params) == 0)
+		return -EINVAL;
+
+	rte_strlcpy(name, params, RTE_MEMZONE_NAMESIZE);
+
+	rte_tel_data_start_dict(d);
+	mp_arg.pool_name = name;
+	mp_arg.d = d;
+	rte_mempool_walk(mempool_cache_stats_cb, &mp_arg);
+
+	return 0;
+}
+
 RTE_INIT(mempool_init_telemetry)
 {
 	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
 		"Returns list of available mempool. Takes no parameters");
 	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
 		"Returns mempool info. Parameters: pool_name");
+	rte_telemetry_register_cmd("/mempool/cache_stats",
+		mempool_handle_cache_stats,
+		"Returns per-lcore cache statistics of a mempool. Parameters: pool_name");
 }
@@ -91,6 +91,10 @@ struct __rte_cache_aligned rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	/** Maximum size of an adaptive cache, 0 if the size is fixed. */
+	uint32_t max_size;
+	/** Average size (x16) of the requests reaching the common pool. */
+	uint32_t burst_avg;
 #ifdef RTE_LIBRTE_MEMPOOL_STATS
 	uint32_t unused;
 	/*
@@ -102,6 +106,9 @@ struct __rte_cache_aligned rte_mempool_cache {
 		uint64_t put_objs;          /**< Number of objects successfully put. */
 		uint64_t get_success_bulk;  /**< Successful allocation number. */
 		uint64_t get_success_objs;  /**< Objects successfully allocated. */
+		uint64_t get_hit;           /**< Gets served by the cache only. */
+		uint64_t get_miss;          /**< Gets reaching the common pool. */
+		uint64_t put_flush;         /**< Puts reaching the common pool. */
 	} stats;                        /**< Statistics */
 #endif
 	/**
@@ -310,6 +317,11 @@ struct __rte_cache_aligned rte_mempool {
 #define MEMPOOL_F_NO_IOVA_CONTIG	RTE_MEMPOOL_F_NO_IOVA_CONTIG
 /** Internal: no object from the pool can be used for device IO (DMA). */
 #define RTE_MEMPOOL_F_NON_IO		0x0040
+/**
+ * Adapt the size of the per-lcore default caches to the observed
+ * get/put burst sizes, up to the cache size given at creation.
+ */
+#define RTE_MEMPOOL_F_ADAPTIVE_CACHE	0x0080
 
 /**
  * This macro lists all the mempool flags an application may request.
@@ -319,8 +331,14 @@ struct __rte_cache_aligned rte_mempool {
 	| RTE_MEMPOOL_F_SP_PUT \
 	| RTE_MEMPOOL_F_SC_GET \
 	| RTE_MEMPOOL_F_NO_IOVA_CONTIG \
+	| RTE_MEMPOOL_F_ADAPTIVE_CACHE \
 	)
 
+/** Minimum size of an adaptive mempool cache. */
+#define RTE_MEMPOOL_CACHE_ADAPT_MIN_SIZE	32
+/** Number of average bursts an adaptive mempool cache is sized for. */
+#define RTE_MEMPOOL_CACHE_ADAPT_BURSTS		4
+
 /**
  * @internal When stats is enabled, store some statistics.
  *
@@ -1362,6 +1380,48 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Resize an adaptive mempool cache; used internally.
+ *
+ * Called when a get or put request reaches the common pool. The cache is
+ * sized to hold RTE_MEMPOOL_CACHE_ADAPT_BURSTS requests of the average
+ * size, so lcores doing small bursts don't hold objects other lcores may
+ * starve for, while lcores doing large bursts access the common pool less
+ * often. When the common pool runs out of objects, the average is halved
+ * to shrink the cache faster.
+ *
+ * @param cache
+ *   A pointer to a mempool cache structure.
+ * @param n
+ *   The number of objects of the request.
+ * @param starved
+ *   Non-zero if the common pool could not provide the objects.
+ */
+static inline void
+rte_mempool_cache_adapt(struct rte_mempool_cache *cache, unsigned int n,
+			int starved)
+{
+	uint32_t size;
+
+	if (cache->max_size == 0)
+		return;
+
+	/* moving average of the request size with a weight of 1/8 */
+	if (unlikely(starved))
+		cache->burst_avg /= 2;
+	else
+		cache->burst_avg += (RTE_MIN(n, (unsigned int)RTE_MEMPOOL_CACHE_MAX_SIZE) << 1) -
+			(cache->burst_avg >> 3);
+
+	size = (cache->burst_avg >> 4) * RTE_MEMPOOL_CACHE_ADAPT_BURSTS;
+	size = RTE_MAX(size, (uint32_t)RTE_MEMPOOL_CACHE_ADAPT_MIN_SIZE);
+	size = RTE_MIN(size, cache->max_size);
+
+	/* same threshold as for a cache of fixed size */
+	cache->size = size;
+	cache->flushthresh = size + size / 2;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1389,8 +1449,11 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_objs, n);
 
 	/* The request itself is too big for the cache */
-	if (unlikely(n > cache->flushthresh))
+	if (unlikely(n > cache->flushthresh)) {
+		RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_flush, 1);
+		rte_mempool_cache_adapt(cache, n, 0);
 		goto driver_enqueue_stats_incremented;
+	}
 
 	/*
 	 * The cache follows the following algorithm:
@@ -1403,6 +1466,8 @@ rte_mempool_do_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		cache_objs = &cache->objs[cache->len];
 		cache->len += n;
 	} else {
+		RTE_MEMPOOL_CACHE_STAT_ADD(cache, put_flush, 1);
+		rte_mempool_cache_adapt(cache, n, 0);
 		cache_objs = &cache->objs[0];
 		rte_mempool_ops_enqueue_bulk(mp, cache_objs, cache->len);
 		cache->len = n;
@@ -1531,6 +1596,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		for (index = 0; index < n; index++)
 			*obj_table++ = *--cache_objs;
 
+		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_hit, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
 
@@ -1557,16 +1623,21 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 	if (!__extension__(__builtin_constant_p(n)) && remaining == 0) {
 		/* The entire request is satisfied from the cache. */
 
+		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_hit, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_bulk, 1);
 		RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_success_objs, n);
 
 		return 0;
 	}
 
+	RTE_MEMPOOL_CACHE_STAT_ADD(cache, get_miss, 1);
+
 	/* if dequeue below would overflow mem allocated for cache */
 	if (unlikely(remaining > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto driver_dequeue;
 
+	rte_mempool_cache_adapt(cache, n, 0);
+
 	/* Fill the cache from the backend; fetch size + remaining objects. */
 	ret = rte_mempool_ops_dequeue_bulk(mp, cache->objs,
 			cache->size + remaining);
@@ -1577,6 +1648,7 @@ rte_mempool_do_generic_get(struct rte_mempool *mp, void **obj_table,
 		 * Do not fill the cache, just satisfy the remaining part of
 		 * the request directly from the backend.
 		 */
+		rte_mempool_cache_adapt(cache, n, 1);
 		goto driver_dequeue;
 	}
 
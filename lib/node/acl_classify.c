@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#include <stdlib.h>
+
+#include <rte_acl.h>
+#include <rte_debug.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_acl_api.h"
+
+#include "acl_classify_priv.h"
+#include "node_private.h"
+
+struct acl_classify_elem {
+	struct acl_classify_elem *next;
+	struct rte_node_acl_classify_cfg cfg;
+};
+
+/* ACL classify global data struct */
+struct acl_classify_node_main {
+	struct acl_classify_elem *head;
+};
+
+static struct acl_classify_node_main acl_classify_main;
+
+/* ACL classify node xstats */
+enum acl_classify_xstat {
+	ACL_CLASSIFY_XSTAT_MATCH,
+	ACL_CLASSIFY_XSTAT_DENY,
+};
+
+static struct rte_node_xstats acl_classify_xstats = {
+	.nb_xstats = 2,
+	.xstat_desc = {
+		[ACL_CLASSIFY_XSTAT_MATCH] = "acl_classify_match",
+		[ACL_CLASSIFY_XSTAT_DENY] = "acl_classify_deny",
+	},
+};
+
+static uint16_t
+acl_classify_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+			  uint16_t nb_objs)
+{
+	struct acl_classify_ctx *ctx = (struct acl_classify_ctx *)node->ctx;
+	const uint8_t *data[RTE_GRAPH_BURST_SIZE];
+	uint32_t res[RTE_GRAPH_BURST_SIZE];
+	const int dyn = ctx->mbuf_priv1_off;
+	uint16_t held = 0, last_spec = 0;
+	uint16_t nb_match = 0, nb_deny = 0;
+	rte_edge_t next_index, next;
+	struct rte_mbuf *mbuf;
+	void **to_next, **from;
+	uint16_t i, j, n;
+
+	from = objs;
+	next_index = ctx->default_next;
+
+	/* Nodes, which are not configured, send all the packets to pkt_drop */
+	if (unlikely(ctx->acl == NULL)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, RTE_GRAPH_BURST_SIZE);
+
+		for (j = 0; j < n; j++)
+			data[j] = rte_pktmbuf_mtod_offset((struct rte_mbuf *)objs[i + j],
+							  const uint8_t *, ctx->data_offset);
+
+		/* Classify the whole vector at once */
+		rte_acl_classify(ctx->acl, data, res, n, 1);
+
+		for (j = 0; j < n; j++) {
+			next = ctx->default_next;
+			if (res[j] != 0) {
+				mbuf = (struct rte_mbuf *)objs[i + j];
+				node_mbuf_priv1(mbuf, dyn)->acl_id =
+					RTE_NODE_ACL_CLASSIFY_USERDATA_ID(res[j]);
+				next = RTE_NODE_ACL_CLASSIFY_USERDATA_NEXT(res[j]);
+				nb_match++;
+				nb_deny += next == RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP;
+			}
+
+			if (unlikely(next != next_index)) {
+				/* Copy things successfully speculated till now */
+				rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	rte_node_xstat_increment(node, ACL_CLASSIFY_XSTAT_MATCH, nb_match);
+	rte_node_xstat_increment(node, ACL_CLASSIFY_XSTAT_DENY, nb_deny);
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+
+	held += last_spec;
+	/* Copy things successfully speculated till now */
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_acl_classify_configure(struct rte_node_acl_classify_cfg *cfg, uint16_t cnt)
+{
+	struct acl_classify_elem *elem;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		if (cfg[i].ctx == NULL)
+			return -EINVAL;
+
+		elem = malloc(sizeof(struct acl_classify_elem));
+		if (elem == NULL)
+			return -ENOMEM;
+		elem->cfg = cfg[i];
+		elem->next = acl_classify_main.head;
+		acl_classify_main.head = elem;
+	}
+
+	return 0;
+}
+
+static int
+acl_classify_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct acl_classify_ctx *ctx = (struct acl_classify_ctx *)node->ctx;
+	struct acl_classify_elem *elem = acl_classify_main.head;
+	static bool init_once;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(struct acl_classify_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+		init_once = true;
+	}
+	ctx->mbuf_priv1_off = node_mbuf_priv1_dynfield_offset;
+
+	while (elem) {
+		if (elem->cfg.node_id == node->id) {
+			/* Update node specific context */
+			ctx->acl = elem->cfg.ctx;
+			ctx->data_offset = elem->cfg.data_offset;
+			ctx->default_next = elem->cfg.default_next;
+			break;
+		}
+		elem = elem->next;
+	}
+
+	node_dbg("acl_classify", "Initialized acl_classify node, %s",
+		 elem != NULL ? "configured" : "not configured");
+
+	return 0;
+}
+
+static struct rte_node_register acl_classify_node = {
+	.process = acl_classify_node_process,
+	.name = "acl_classify",
+
+	.init = acl_classify_node_init,
+
+	.nb_edges = RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+acl_classify_node_get(void)
+{
+	return &acl_classify_node;
+}
+
+RTE_NODE_XSTATS_REGISTER(acl_classify_node, acl_classify_xstats);
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_ACL_CLASSIFY_PRIV_H__
+#define __INCLUDE_ACL_CLASSIFY_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Acl_classify context structure.
+ */
+struct acl_classify_ctx {
+	const struct rte_acl_ctx *acl;
+	uint16_t data_offset;
+	rte_edge_t default_next;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+/**
+ * @internal
+ *
+ * Get the ACL classify node
+ *
+ * @return
+ *   Pointer to the ACL classify node.
+ */
+struct rte_node_register *acl_classify_node_get(void);
+
+#endif /* __INCLUDE_ACL_CLASSIFY_PRIV_H__ */
@@ -0,0 +1,492 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#include <stdlib.h>
+
+#include <rte_cryptodev.h>
+#include <rte_debug.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ipsec.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_esp_api.h"
+
+#include "esp_priv.h"
+#include "node_private.h"
+
+/* Next edge of the packets processed */
+#define ESP_NEXT_FWD (RTE_NODE_ESP_NEXT_PKT_DROP + 1)
+
+/* Session index of the packets, which cannot be processed */
+#define ESP_SA_INVALID UINT32_MAX
+
+struct esp_elem {
+	struct esp_elem *next;
+	struct rte_node_esp_cfg cfg;
+};
+
+/* ESP global data struct */
+struct esp_node_main {
+	struct esp_elem *inbound;
+	struct esp_elem *outbound;
+};
+
+static struct esp_node_main esp_main;
+
+/* ESP node xstats */
+enum esp_xstat {
+	ESP_XSTAT_ENQ,
+	ESP_XSTAT_DEQ,
+	ESP_XSTAT_ERRORS,
+};
+
+static struct rte_node_xstats esp_inbound_xstats = {
+	.nb_xstats = 3,
+	.xstat_desc = {
+		[ESP_XSTAT_ENQ] = "esp_inbound_enq",
+		[ESP_XSTAT_DEQ] = "esp_inbound_deq",
+		[ESP_XSTAT_ERRORS] = "esp_inbound_errors",
+	},
+};
+
+static struct rte_node_xstats esp_outbound_xstats = {
+	.nb_xstats = 3,
+	.xstat_desc = {
+		[ESP_XSTAT_ENQ] = "esp_outbound_enq",
+		[ESP_XSTAT_DEQ] = "esp_outbound_deq",
+		[ESP_XSTAT_ERRORS] = "esp_outbound_errors",
+	},
+};
+
+/* Remove the L2 header and set the header lengths lib ipsec expects. */
+static __rte_always_inline int
+esp_pkt_prepare(struct rte_mbuf *mbuf)
+{
+	const struct rte_ether_hdr *eth;
+
+	eth = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+	switch (eth->ether_type) {
+	case RTE_BE16(RTE_ETHER_TYPE_IPV4):
+		mbuf->l3_len = rte_ipv4_hdr_len((const struct rte_ipv4_hdr *)(eth + 1));
+		break;
+	case RTE_BE16(RTE_ETHER_TYPE_IPV6):
+		mbuf->l3_len = sizeof(struct rte_ipv6_hdr);
+		break;
+	default:
+		return -EINVAL;
+	}
+	mbuf->l2_len = 0;
+	rte_pktmbuf_adj(mbuf, sizeof(*eth));
+
+	return 0;
+}
+
+/* Prepare the crypto operations of a burst and enqueue them to the device. */
+static __rte_always_inline void
+esp_enqueue(struct rte_graph *graph, struct rte_node *node, struct rte_mbuf **mb,
+	    uint16_t nb)
+{
+	struct esp_ctx *ctx = (struct esp_ctx *)node->ctx;
+	const struct rte_node_esp_cfg *cfg = ctx->cfg;
+	struct rte_crypto_op *cop[RTE_GRAPH_BURST_SIZE];
+	struct rte_mbuf *drop[RTE_GRAPH_BURST_SIZE];
+	uint32_t sa[RTE_GRAPH_BURST_SIZE];
+	const int dyn = ctx->mbuf_priv1_off;
+	uint16_t nb_cop = 0, nb_drop = 0;
+	uint16_t i, j, k, n;
+	uint32_t sa_idx;
+
+	for (i = 0; i < nb; i++) {
+		sa[i] = node_mbuf_priv1(mb[i], dyn)->acl_id;
+		if (unlikely(esp_pkt_prepare(mb[i]) != 0))
+			sa[i] = ESP_SA_INVALID;
+	}
+
+	/* Prepare the runs of packets of the same session together */
+	for (i = 0; i < nb; i = j) {
+		sa_idx = sa[i];
+		for (j = i + 1; j < nb && sa[j] == sa_idx; j++)
+			;
+		n = j - i;
+
+		if (unlikely(sa_idx >= cfg->nb_sessions || cfg->sessions[sa_idx] == NULL ||
+			     rte_crypto_op_bulk_alloc(cfg->cop_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+						      &cop[nb_cop], n) == 0)) {
+			rte_memcpy(&drop[nb_drop], &mb[i], n * sizeof(mb[0]));
+			nb_drop += n;
+			continue;
+		}
+
+		k = rte_ipsec_pkt_crypto_prepare(cfg->sessions[sa_idx], &mb[i], &cop[nb_cop], n);
+		if (unlikely(k != n)) {
+			/* Failed packets are moved after the prepared ones */
+			rte_mempool_put_bulk(cfg->cop_pool, (void **)&cop[nb_cop + k], n - k);
+			rte_memcpy(&drop[nb_drop], &mb[i + k], (n - k) * sizeof(mb[0]));
+			nb_drop += n - k;
+		}
+		nb_cop += k;
+	}
+
+	k = rte_cryptodev_enqueue_burst(cfg->dev_id, ctx->qp_id, cop, nb_cop);
+	if (unlikely(k != nb_cop)) {
+		for (i = k; i < nb_cop; i++)
+			drop[nb_drop++] = cop[i]->sym->m_src;
+		rte_mempool_put_bulk(cfg->cop_pool, (void **)&cop[k], nb_cop - k);
+	}
+
+	rte_node_xstat_increment(node, ESP_XSTAT_ENQ, k);
+	if (nb_drop) {
+		rte_node_enqueue(graph, node, RTE_NODE_ESP_NEXT_PKT_DROP, (void **)drop, nb_drop);
+		rte_node_xstat_increment(node, ESP_XSTAT_ERRORS, nb_drop);
+	}
+}
+
+/* Dequeue the crypto operations completed and finish the packets processing. */
+static __rte_always_inline uint16_t
+esp_dequeue(struct rte_graph *graph, struct rte_node *node)
+{
+	struct esp_ctx *ctx = (struct esp_ctx *)node->ctx;
+	const struct rte_node_esp_cfg *cfg = ctx->cfg;
+	struct rte_ipsec_group grp[RTE_GRAPH_BURST_SIZE];
+	struct rte_crypto_op *cop[RTE_GRAPH_BURST_SIZE];
+	struct rte_mbuf *mb[RTE_GRAPH_BURST_SIZE];
+	uint16_t i, j, k, n, ng, nb_grp;
+	uint16_t nb_deq = 0, nb_errs;
+	struct rte_mbuf *mbuf;
+	void **to_next;
+	uint16_t idx;
+
+	do {
+		n = rte_cryptodev_dequeue_burst(cfg->dev_id, ctx->qp_id, cop, RTE_DIM(cop));
+		if (n == 0)
+			break;
+
+		ng = rte_ipsec_pkt_crypto_group((const struct rte_crypto_op **)(uintptr_t)cop,
+						mb, grp, n);
+		/* Packets without a session are not copied when there is no group */
+		if (unlikely(ng == 0)) {
+			for (i = 0; i < n; i++)
+				mb[i] = cop[i]->sym->m_src;
+		}
+		rte_mempool_put_bulk(cfg->cop_pool, (void **)cop, n);
+
+		to_next = rte_node_next_stream_get(graph, node, ESP_NEXT_FWD, n);
+		idx = 0;
+		nb_grp = 0;
+		for (i = 0; i < ng; i++) {
+			k = rte_ipsec_pkt_process(grp[i].id.ptr, grp[i].m, grp[i].cnt);
+			for (j = 0; j < k; j++) {
+				/* Give room for the L2 header back to the next nodes */
+				mbuf = grp[i].m[j];
+				if (unlikely(rte_pktmbuf_prepend(mbuf, RTE_ETHER_HDR_LEN) == NULL)) {
+					rte_node_enqueue_x1(graph, node, RTE_NODE_ESP_NEXT_PKT_DROP,
+							    mbuf);
+					continue;
+				}
+				mbuf->l2_len = RTE_ETHER_HDR_LEN;
+				to_next[idx++] = mbuf;
+			}
+			/* Failed packets are moved after the processed ones */
+			if (unlikely(k != grp[i].cnt))
+				rte_node_enqueue(graph, node, RTE_NODE_ESP_NEXT_PKT_DROP,
+						 (void **)&grp[i].m[k], grp[i].cnt - k);
+			nb_grp += grp[i].cnt;
+		}
+
+		/* Packets without a session are after the groups */
+		if (unlikely(nb_grp != n))
+			rte_node_enqueue(graph, node, RTE_NODE_ESP_NEXT_PKT_DROP,
+					 (void **)&mb[nb_grp], n - nb_grp);
+
+		rte_node_next_stream_put(graph, node, ESP_NEXT_FWD, idx);
+		nb_errs = n - idx;
+		nb_deq += idx;
+		if (nb_errs)
+			rte_node_xstat_increment(node, ESP_XSTAT_ERRORS, nb_errs);
+	} while (n == RTE_DIM(cop));
+
+	rte_node_xstat_increment(node, ESP_XSTAT_DEQ, nb_deq);
+
+	return nb_deq;
+}
+
+static uint16_t
+esp_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+		 uint16_t nb_objs)
+{
+	struct esp_ctx *ctx = (struct esp_ctx *)node->ctx;
+	uint16_t i, n;
+
+	/* Nodes, which are not configured, send all the packets to pkt_drop */
+	if (unlikely(ctx->cfg == NULL)) {
+		rte_node_next_stream_move(graph, node, RTE_NODE_ESP_NEXT_PKT_DROP);
+		return nb_objs;
+	}
+
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, RTE_GRAPH_BURST_SIZE);
+		esp_enqueue(graph, node, (struct rte_mbuf **)&objs[i], n);
+	}
+
+	/*
+	 * Operations are completed asynchronously by the device, the ones
+	 * enqueued by the previous calls are finished now. The node is only
+	 * called for new packets, esp_poll finishes the others.
+	 */
+	esp_dequeue(graph, node);
+
+	return nb_objs;
+}
+
+static uint16_t
+esp_poll_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+		      uint16_t nb_objs)
+{
+	struct esp_poll_ctx *ctx = (struct esp_poll_ctx *)node->ctx;
+	struct rte_node *esp;
+	uint16_t i, n = 0;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	/* The completed packets are sent to the next nodes of the ESP node */
+	for (i = 0; i < ctx->nb_nodes; i++) {
+		esp = ctx->nodes[i];
+		if (likely(((struct esp_ctx *)esp->ctx)->cfg != NULL))
+			n += esp_dequeue(graph, esp);
+	}
+
+	return n;
+}
+
+static int
+esp_configure(struct esp_elem **head, struct rte_node_esp_cfg *cfg, uint16_t cnt,
+	      uint64_t dir)
+{
+	struct rte_ipsec_session *ss;
+	struct esp_elem *elem;
+	uint32_t j;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		if (cfg[i].sessions == NULL || cfg[i].nb_sessions == 0 ||
+		    cfg[i].cop_pool == NULL || !rte_cryptodev_is_valid_dev(cfg[i].dev_id))
+			return -EINVAL;
+
+		for (j = 0; j < cfg[i].nb_sessions; j++) {
+			ss = cfg[i].sessions[j];
+			if (ss == NULL)
+				continue;
+			if (ss->type != RTE_SECURITY_ACTION_TYPE_NONE ||
+			    ss->crypto.dev_id != cfg[i].dev_id ||
+			    (rte_ipsec_sa_type(ss->sa) & RTE_IPSEC_SATP_DIR_MASK) != dir)
+				return -EINVAL;
+		}
+
+		elem = malloc(sizeof(struct esp_elem));
+		if (elem == NULL)
+			return -ENOMEM;
+		elem->cfg = cfg[i];
+		elem->next = *head;
+		*head = elem;
+	}
+
+	return 0;
+}
+
+int
+rte_node_esp_inbound_configure(struct rte_node_esp_cfg *cfg, uint16_t cnt)
+{
+	return esp_configure(&esp_main.inbound, cfg, cnt, RTE_IPSEC_SATP_DIR_IB);
+}
+
+int
+rte_node_esp_outbound_configure(struct rte_node_esp_cfg *cfg, uint16_t cnt)
+{
+	return esp_configure(&esp_main.outbound, cfg, cnt, RTE_IPSEC_SATP_DIR_OB);
+}
+
+static int
+esp_node_init(const struct rte_graph *graph, struct rte_node *node, struct esp_elem *elem)
+{
+	struct esp_ctx *ctx = (struct esp_ctx *)node->ctx;
+	static bool init_once;
+	int nb_qps;
+
+	RTE_BUILD_BUG_ON(sizeof(struct esp_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+		init_once = true;
+	}
+	ctx->mbuf_priv1_off = node_mbuf_priv1_dynfield_offset;
+
+	while (elem) {
+		if (elem->cfg.node_id == node->id)
+			break;
+		elem = elem->next;
+	}
+
+	if (elem == NULL) {
+		ctx->cfg = NULL;
+		node_dbg("esp", "Node %s is not configured", node->name);
+		return 0;
+	}
+
+	/* Each graph has its own queue pair */
+	nb_qps = rte_cryptodev_queue_pair_count(elem->cfg.dev_id);
+	if (elem->cfg.qp_id + graph->id >= nb_qps) {
+		node_err("esp", "No queue pair of crypto device %u for graph %s",
+			 elem->cfg.dev_id, graph->name);
+		return -ENOSPC;
+	}
+
+	/* Update node specific context */
+	ctx->cfg = &elem->cfg;
+	ctx->qp_id = elem->cfg.qp_id + graph->id;
+
+	node_dbg("esp", "Initialized %s node, crypto device %u queue pair %u",
+		 node->name, elem->cfg.dev_id, ctx->qp_id);
+
+	return 0;
+}
+
+static int
+esp_inbound_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	return esp_node_init(graph, node, esp_main.inbound);
+}
+
+static int
+esp_outbound_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	return esp_node_init(graph, node, esp_main.outbound);
+}
+
+static bool
+esp_node_is_esp(const struct rte_node *node)
+{
+	/* The process function is replaced when the pcap trace is enabled */
+	return node->process == esp_node_process ||
+	       node->original_process == esp_node_process;
+}
+
+static int
+esp_poll_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct esp_poll_ctx *ctx = (struct esp_poll_ctx *)node->ctx;
+	struct rte_graph *g = (struct rte_graph *)(uintptr_t)graph;
+	struct rte_node *n;
+	rte_graph_off_t off;
+	rte_node_t count;
+	uint16_t nb = 0;
+
+	RTE_BUILD_BUG_ON(sizeof(struct esp_poll_ctx) > RTE_NODE_CTX_SZ);
+
+	ctx->nodes = NULL;
+	ctx->nb_nodes = 0;
+
+	rte_graph_foreach_node(count, off, g, n) {
+		if (esp_node_is_esp(n))
+			nb++;
+	}
+	if (nb == 0) {
+		node_dbg("esp", "No ESP node to poll in graph %s", graph->name);
+		return 0;
+	}
+
+	ctx->nodes = rte_zmalloc_socket("esp_poll_nodes", nb * sizeof(ctx->nodes[0]),
+					RTE_CACHE_LINE_SIZE, graph->socket);
+	if (ctx->nodes == NULL)
+		return -ENOMEM;
+
+	rte_graph_foreach_node(count, off, g, n) {
+		if (esp_node_is_esp(n))
+			ctx->nodes[ctx->nb_nodes++] = n;
+	}
+
+	node_dbg("esp", "Polling %u ESP nodes in graph %s", ctx->nb_nodes, graph->name);
+
+	return 0;
+}
+
+static void
+esp_poll_node_fini(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct esp_poll_ctx *ctx = (struct esp_poll_ctx *)node->ctx;
+
+	RTE_SET_USED(graph);
+
+	rte_free(ctx->nodes);
+	ctx->nodes = NULL;
+	ctx->nb_nodes = 0;
+}
+
+static struct rte_node_register esp_inbound_node = {
+	.process = esp_node_process,
+	.name = "esp_inbound",
+
+	.init = esp_inbound_node_init,
+
+	.nb_edges = RTE_NODE_ESP_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_ESP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+static struct rte_node_register esp_outbound_node = {
+	.process = esp_node_process,
+	.name = "esp_outbound",
+
+	.init = esp_outbound_node_init,
+
+	.nb_edges = RTE_NODE_ESP_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_ESP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+/* Source nodes need an edge, the completed packets use the ESP nodes' ones */
+static struct rte_node_register esp_poll_node = {
+	.process = esp_poll_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "esp_poll",
+
+	.init = esp_poll_node_init,
+	.fini = esp_poll_node_fini,
+
+	.nb_edges = 1,
+	.next_nodes = {
+		[0] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+esp_inbound_node_get(void)
+{
+	return &esp_inbound_node;
+}
+
+struct rte_node_register *
+esp_outbound_node_get(void)
+{
+	return &esp_outbound_node;
+}
+
+struct rte_node_register *
+esp_poll_node_get(void)
+{
+	return &esp_poll_node;
+}
+
+RTE_NODE_XSTATS_REGISTER(esp_inbound_node, esp_inbound_xstats);
+RTE_NODE_XSTATS_REGISTER(esp_outbound_node, esp_outbound_xstats);
+RTE_NODE_REGISTER(esp_poll_node);
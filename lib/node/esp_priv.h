@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_ESP_PRIV_H__
+#define __INCLUDE_ESP_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Esp_inbound and esp_outbound context structure.
+ */
+struct esp_ctx {
+	const struct rte_node_esp_cfg *cfg;
+	/* Queue pair of the node in its graph */
+	uint16_t qp_id;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+/**
+ * @internal
+ *
+ * Esp_poll context structure.
+ */
+struct esp_poll_ctx {
+	/* ESP nodes of the graph */
+	struct rte_node **nodes;
+	uint16_t nb_nodes;
+};
+
+/**
+ * @internal
+ *
+ * Get the ESP inbound node
+ *
+ * @return
+ *   Pointer to the ESP inbound node.
+ */
+struct rte_node_register *esp_inbound_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the ESP outbound node
+ *
+ * @return
+ *   Pointer to the ESP outbound node.
+ */
+struct rte_node_register *esp_outbound_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the ESP poll node
+ *
+ * @return
+ *   Pointer to the ESP poll node.
+ */
+struct rte_node_register *esp_poll_node_get(void);
+
+#endif /* __INCLUDE_ESP_PRIV_H__ */
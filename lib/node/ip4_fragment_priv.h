@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_IP4_FRAGMENT_PRIV_H__
+#define __INCLUDE_IP4_FRAGMENT_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Ip4_fragment context structure.
+ */
+struct ip4_fragment_ctx {
+	const struct rte_node_ip4_fragment_cfg *cfg;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+/**
+ * @internal
+ *
+ * Get the IP4 fragment node
+ *
+ * @return
+ *   Pointer to the IP4 fragment node.
+ */
+struct rte_node_register *ip4_fragment_node_get(void);
+
+#endif /* __INCLUDE_IP4_FRAGMENT_PRIV_H__ */
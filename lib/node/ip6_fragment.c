@@ -0,0 +1,255 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#include <stdlib.h>
+
+#include <rte_debug.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "ip6_fragment_priv.h"
+#include "node_private.h"
+
+/* Next edge of the packets that fit in the MTU and of the fragments */
+#define IP6_FRAGMENT_NEXT_FWD (RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP + 1)
+
+struct ip6_fragment_elem {
+	struct ip6_fragment_elem *next;
+	struct rte_node_ip6_fragment_cfg cfg;
+};
+
+/* IP6 fragment global data struct */
+struct ip6_fragment_node_main {
+	struct ip6_fragment_elem *head;
+};
+
+static struct ip6_fragment_node_main ip6_fragment_main;
+
+/* Nodes, which are not configured, pass all the packets through */
+static const struct rte_node_ip6_fragment_cfg ip6_fragment_cfg_default = {
+	.mtu = UINT16_MAX,
+};
+
+/* IP6 fragment node xstats */
+enum ip6_fragment_xstat {
+	IP6_FRAGMENT_XSTAT_PKTS,
+	IP6_FRAGMENT_XSTAT_FRAGS,
+	IP6_FRAGMENT_XSTAT_ERRORS,
+};
+
+static struct rte_node_xstats ip6_fragment_xstats = {
+	.nb_xstats = 3,
+	.xstat_desc = {
+		[IP6_FRAGMENT_XSTAT_PKTS] = "ip6_fragment_pkts",
+		[IP6_FRAGMENT_XSTAT_FRAGS] = "ip6_fragment_frags",
+		[IP6_FRAGMENT_XSTAT_ERRORS] = "ip6_fragment_errors",
+	},
+};
+
+/* Add the L2 header of the original packet and its next hop data to a fragment. */
+static __rte_always_inline int
+ip6_fragment_prepare(struct rte_mbuf *frag, const struct rte_ether_hdr *eth,
+		     struct rte_mbuf *mbuf, const int dyn)
+{
+	struct rte_ether_hdr *frag_eth;
+
+	frag_eth = (struct rte_ether_hdr *)rte_pktmbuf_prepend(frag, sizeof(*frag_eth));
+	if (unlikely(frag_eth == NULL))
+		return -ENOSPC;
+	rte_ether_addr_copy(&eth->dst_addr, &frag_eth->dst_addr);
+	rte_ether_addr_copy(&eth->src_addr, &frag_eth->src_addr);
+	frag_eth->ether_type = eth->ether_type;
+	frag->l2_len = sizeof(*frag_eth);
+
+	node_mbuf_priv1(frag, dyn)->u = node_mbuf_priv1(mbuf, dyn)->u;
+
+	return 0;
+}
+
+static uint16_t
+ip6_fragment_node_process_slow(struct rte_graph *graph, struct rte_node *node,
+			       void **objs, uint16_t nb_objs, uint16_t start)
+{
+	struct ip6_fragment_ctx *ctx = (struct ip6_fragment_ctx *)node->ctx;
+	const struct rte_node_ip6_fragment_cfg *cfg = ctx->cfg;
+	const uint32_t max_len = cfg->mtu + sizeof(struct rte_ether_hdr);
+	struct rte_mbuf *frags[RTE_LIBRTE_IP_FRAG_MAX_FRAG];
+	struct rte_mbuf *done[RTE_GRAPH_BURST_SIZE];
+	const int dyn = ctx->mbuf_priv1_off;
+	uint16_t nb_done = 0, nb_pkts = 0;
+	uint16_t nb_errs = 0, nb_out = 0;
+	uint16_t idx, space, i, j;
+	struct rte_ether_hdr *eth;
+	struct rte_mbuf *mbuf;
+	void **to_next;
+	int32_t n;
+
+	/* Packets before start fit in the MTU */
+	space = nb_objs;
+	to_next = rte_node_next_stream_get(graph, node, IP6_FRAGMENT_NEXT_FWD, space);
+	rte_memcpy(to_next, objs, start * sizeof(objs[0]));
+	idx = start;
+
+	for (i = start; i < nb_objs; i++) {
+		mbuf = (struct rte_mbuf *)objs[i];
+		if (likely(mbuf->pkt_len <= max_len)) {
+			to_next[idx++] = mbuf;
+			continue;
+		}
+
+		eth = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
+		rte_pktmbuf_adj(mbuf, sizeof(struct rte_ether_hdr));
+		n = rte_ipv6_fragment_packet(mbuf, frags, RTE_DIM(frags), cfg->mtu,
+					     cfg->pool_direct, cfg->pool_indirect);
+		if (unlikely(n < 0)) {
+			rte_pktmbuf_prepend(mbuf, sizeof(struct rte_ether_hdr));
+			rte_node_enqueue_x1(graph, node, RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP,
+					    mbuf);
+			nb_errs++;
+			continue;
+		}
+
+		/* Make room for the fragments and the remaining packets */
+		if (unlikely(idx + n + nb_objs - i - 1 > space)) {
+			rte_node_next_stream_put(graph, node, IP6_FRAGMENT_NEXT_FWD, idx);
+			space = n + nb_objs - i - 1;
+			to_next = rte_node_next_stream_get(graph, node,
+							   IP6_FRAGMENT_NEXT_FWD, space);
+			idx = 0;
+		}
+
+		for (j = 0; j < n; j++) {
+			if (unlikely(ip6_fragment_prepare(frags[j], eth, mbuf, dyn))) {
+				rte_node_enqueue_x1(graph, node,
+						    RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP,
+						    frags[j]);
+				nb_errs++;
+				continue;
+			}
+			to_next[idx++] = frags[j];
+			nb_out++;
+		}
+		nb_pkts++;
+
+		/* The fragments hold references to the original packet data */
+		done[nb_done++] = mbuf;
+		if (unlikely(nb_done == RTE_DIM(done))) {
+			rte_pktmbuf_free_bulk(done, nb_done);
+			nb_done = 0;
+		}
+	}
+	rte_node_next_stream_put(graph, node, IP6_FRAGMENT_NEXT_FWD, idx);
+
+	if (nb_done)
+		rte_pktmbuf_free_bulk(done, nb_done);
+
+	rte_node_xstat_increment(node, IP6_FRAGMENT_XSTAT_PKTS, nb_pkts);
+	rte_node_xstat_increment(node, IP6_FRAGMENT_XSTAT_FRAGS, nb_out);
+	if (nb_errs)
+		rte_node_xstat_increment(node, IP6_FRAGMENT_XSTAT_ERRORS, nb_errs);
+
+	return nb_objs;
+}
+
+static uint16_t
+ip6_fragment_node_process(struct rte_graph *graph, struct rte_node *node, void **objs,
+			  uint16_t nb_objs)
+{
+	struct ip6_fragment_ctx *ctx = (struct ip6_fragment_ctx *)node->ctx;
+	const uint32_t max_len = ctx->cfg->mtu + sizeof(struct rte_ether_hdr);
+	uint16_t i;
+
+	/* Speculate that all the packets fit in the MTU */
+	for (i = 0; i < nb_objs; i++) {
+		if (unlikely(((struct rte_mbuf *)objs[i])->pkt_len > max_len))
+			return ip6_fragment_node_process_slow(graph, node, objs, nb_objs, i);
+	}
+
+	/* Home run, move the whole stream */
+	rte_node_next_stream_move(graph, node, IP6_FRAGMENT_NEXT_FWD);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip6_fragment_configure(struct rte_node_ip6_fragment_cfg *cfg, uint16_t cnt)
+{
+	struct ip6_fragment_elem *elem;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		if (cfg[i].pool_direct == NULL || cfg[i].pool_indirect == NULL ||
+		    cfg[i].mtu < RTE_IPV6_MIN_MTU)
+			return -EINVAL;
+
+		elem = malloc(sizeof(struct ip6_fragment_elem));
+		if (elem == NULL)
+			return -ENOMEM;
+		elem->cfg = cfg[i];
+		elem->next = ip6_fragment_main.head;
+		ip6_fragment_main.head = elem;
+	}
+
+	return 0;
+}
+
+static int
+ip6_fragment_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ip6_fragment_ctx *ctx = (struct ip6_fragment_ctx *)node->ctx;
+	struct ip6_fragment_elem *elem = ip6_fragment_main.head;
+	static bool init_once;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(struct ip6_fragment_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+		init_once = true;
+	}
+	ctx->mbuf_priv1_off = node_mbuf_priv1_dynfield_offset;
+
+	ctx->cfg = &ip6_fragment_cfg_default;
+	while (elem) {
+		if (elem->cfg.node_id == node->id) {
+			/* Update node specific context */
+			ctx->cfg = &elem->cfg;
+			break;
+		}
+		elem = elem->next;
+	}
+
+	node_dbg("ip6_fragment", "Initialized ip6_fragment node, mtu %u", ctx->cfg->mtu);
+
+	return 0;
+}
+
+static struct rte_node_register ip6_fragment_node = {
+	.process = ip6_fragment_node_process,
+	.name = "ip6_fragment",
+
+	.init = ip6_fragment_node_init,
+
+	.nb_edges = RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP + 1,
+	.next_nodes = {
+		[RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ip6_fragment_node_get(void)
+{
+	return &ip6_fragment_node;
+}
+
+RTE_NODE_XSTATS_REGISTER(ip6_fragment_node, ip6_fragment_xstats);
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_IP6_FRAGMENT_PRIV_H__
+#define __INCLUDE_IP6_FRAGMENT_PRIV_H__
+
+/**
+ * @internal
+ *
+ * Ip6_fragment context structure.
+ */
+struct ip6_fragment_ctx {
+	const struct rte_node_ip6_fragment_cfg *cfg;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+/**
+ * @internal
+ *
+ * Get the IP6 fragment node
+ *
+ * @return
+ *   Pointer to the IP6 fragment node.
+ */
+struct rte_node_register *ip6_fragment_node_get(void);
+
+#endif /* __INCLUDE_IP6_FRAGMENT_PRIV_H__ */
@@ -36,6 +36,11 @@ struct node_mbuf_priv1 {
 			uint32_t cksum;
 		};
 
+		/* ACL classify, ESP outbound */
+		struct {
+			uint32_t acl_id;
+		};
+
 		uint64_t u;
 	};
 };
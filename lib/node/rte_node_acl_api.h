@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_ACL_API_H__
+#define __INCLUDE_RTE_NODE_ACL_API_H__
+
+/**
+ * @file rte_node_acl_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to do control path functions of the acl_classify node.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+#include <rte_compat.h>
+
+#include <rte_graph.h>
+
+/**
+ * ACL classify next nodes.
+ */
+enum rte_node_acl_classify_next {
+	RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * Build the user data of an ACL rule for the acl_classify node.
+ *
+ * Packets matching the rule are sent to the next node edge, and the id is
+ * stored in the mbuf for that next node, e.g. the SA index for esp_outbound.
+ * A rule sending packets to RTE_NODE_ACL_CLASSIFY_NEXT_PKT_DROP is a deny rule.
+ */
+#define RTE_NODE_ACL_CLASSIFY_USERDATA(next, id) \
+	(((uint32_t)(id) << 8) | (((next) + 1) & 0xff))
+
+/** Get the next node edge from the user data of an ACL rule. */
+#define RTE_NODE_ACL_CLASSIFY_USERDATA_NEXT(userdata) (((userdata) & 0xff) - 1)
+
+/** Get the id from the user data of an ACL rule. */
+#define RTE_NODE_ACL_CLASSIFY_USERDATA_ID(userdata) ((userdata) >> 8)
+
+/**
+ * ACL classify configure structure.
+ * @see rte_node_acl_classify_configure
+ */
+struct rte_node_acl_classify_cfg {
+	const struct rte_acl_ctx *ctx;
+	/**< Built ACL context, classified with one category. */
+	uint16_t data_offset;
+	/**< Offset, from the mbuf data start, of the data the rules apply to. */
+	rte_edge_t default_next;
+	/**< Next node edge of the packets not matching any rule. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
+/**
+ * Add acl_classify node configuration data.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_acl_classify_configure(struct rte_node_acl_classify_cfg *cfg, uint16_t cnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_ACL_API_H__ */
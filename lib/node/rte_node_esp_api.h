@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2024 Marvell.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_ESP_API_H__
+#define __INCLUDE_RTE_NODE_ESP_API_H__
+
+/**
+ * @file rte_node_esp_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to do control path functions of the esp_inbound and
+ * esp_outbound nodes.
+ *
+ * The nodes process the packets of lookaside crypto IPsec sessions: the
+ * crypto operations prepared for the packets are enqueued to a crypto device
+ * queue pair, and the operations completed by the device are dequeued on the
+ * following calls of the node, or by the esp_poll source node on each graph
+ * walk. The packets completed are sent to the next node edge added by the
+ * application, the packets failing the processing are dropped.
+ *
+ * The esp_poll node must be added to the graphs of the ESP nodes, so that
+ * the last packets enqueued to the device do not wait for new packets.
+ *
+ * The session of a packet is the session with the index stored by the
+ * acl_classify node, i.e. the id of the ACL rule the packet matched.
+ * The packets must start with an Ethernet header, the nodes remove it
+ * before the processing and add room for one again for the next nodes.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+#include <rte_compat.h>
+
+#include <rte_graph.h>
+#include <rte_ipsec.h>
+
+/**
+ * ESP inbound and outbound next nodes.
+ */
+enum rte_node_esp_next {
+	RTE_NODE_ESP_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * ESP configure structure.
+ * @see rte_node_esp_inbound_configure
+ * @see rte_node_esp_outbound_configure
+ */
+struct rte_node_esp_cfg {
+	struct rte_ipsec_session **sessions;
+	/**< Prepared lookaside crypto sessions, indexed by the ACL rule id. */
+	uint32_t nb_sessions;
+	/**< Number of sessions. */
+	struct rte_mempool *cop_pool;
+	/**< Pool of the symmetric crypto operations. */
+	uint8_t dev_id;
+	/**< Crypto device of the sessions. */
+	uint16_t qp_id;
+	/**< First queue pair, the node of the graph with id N uses qp_id + N. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
+/**
+ * Add esp_inbound node configuration data.
+ *
+ * The sessions must be inbound sessions, which are not used by other nodes.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_esp_inbound_configure(struct rte_node_esp_cfg *cfg, uint16_t cnt);
+
+/**
+ * Add esp_outbound node configuration data.
+ *
+ * The sessions must be outbound sessions, which are not used by other nodes.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_esp_outbound_configure(struct rte_node_esp_cfg *cfg, uint16_t cnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_ESP_API_H__ */
@@ -67,6 +67,29 @@ struct rte_node_ip4_reassembly_cfg {
 	/**< Node identifier to configure. */
 };
 
+/**
+ * IP4 fragmentation next nodes.
+ */
+enum rte_node_ip4_fragment_next {
+	RTE_NODE_IP4_FRAGMENT_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * Fragmentation configure structure.
+ * @see rte_node_ip4_fragment_configure
+ */
+struct rte_node_ip4_fragment_cfg {
+	struct rte_mempool *pool_direct;
+	/**< Pool of the mbufs holding the headers of the fragments. */
+	struct rte_mempool *pool_indirect;
+	/**< Pool of the mbufs attached to the payload of the fragments. */
+	uint16_t mtu;
+	/**< MTU of the fragments, including the IPv4 header. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
 /**
  * Add ipv4 route to lookup table.
  *
@@ -117,6 +140,20 @@ int rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 __rte_experimental
 int rte_node_ip4_reassembly_configure(struct rte_node_ip4_reassembly_cfg *cfg, uint16_t cnt);
 
+/**
+ * Add fragmentation node configuration data.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_fragment_configure(struct rte_node_ip4_fragment_cfg *cfg, uint16_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
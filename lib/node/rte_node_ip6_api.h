@@ -13,7 +13,7 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * This API allows to do control path functions of ip6_* nodes
- * like ip6_lookup, ip6_rewrite.
+ * like ip6_lookup, ip6_rewrite, ip6_reassembly and ip6_fragment.
  */
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +22,8 @@ extern "C" {
 #include <rte_common.h>
 #include <rte_compat.h>
 
+#include <rte_graph.h>
+
 /**
  * IP6 lookup next nodes.
  */
@@ -32,6 +34,50 @@ enum rte_node_ip6_lookup_next {
 	/**< Packet drop node. */
 };
 
+/**
+ * IP6 reassembly next nodes.
+ */
+enum rte_node_ip6_reassembly_next {
+	RTE_NODE_IP6_REASSEMBLY_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * Reassembly configure structure.
+ * @see rte_node_ip6_reassembly_configure
+ */
+struct rte_node_ip6_reassembly_cfg {
+	struct rte_ip_frag_tbl *tbl;
+	/**< Reassembly fragmentation table. */
+	struct rte_ip_frag_death_row *dr;
+	/**< Reassembly deathrow table. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
+/**
+ * IP6 fragmentation next nodes.
+ */
+enum rte_node_ip6_fragment_next {
+	RTE_NODE_IP6_FRAGMENT_NEXT_PKT_DROP,
+	/**< Packet drop node. */
+};
+
+/**
+ * Fragmentation configure structure.
+ * @see rte_node_ip6_fragment_configure
+ */
+struct rte_node_ip6_fragment_cfg {
+	struct rte_mempool *pool_direct;
+	/**< Pool of the mbufs holding the headers of the fragments. */
+	struct rte_mempool *pool_indirect;
+	/**< Pool of the mbufs attached to the payload of the fragments. */
+	uint16_t mtu;
+	/**< MTU of the fragments, including the IPv6 header. */
+	rte_node_t node_id;
+	/**< Node identifier to configure. */
+};
+
 /**
  * Add IPv6 route to lookup table.
  *
@@ -70,6 +116,34 @@ __rte_experimental
 int rte_node_ip6_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * Add reassembly node configuration data.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_reassembly_configure(struct rte_node_ip6_reassembly_cfg *cfg, uint16_t cnt);
+
+/**
+ * Add fragmentation node configuration data.
+ *
+ * @param cfg
+ *   Pointer to the configuration structure.
+ * @param cnt
+ *   Number of configuration structures passed.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip6_fragment_configure(struct rte_node_ip6_fragment_cfg *cfg, uint16_t cnt);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,7 +22,9 @@
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_ether.h>
+#include <rte_malloc.h>
 #include <rte_mbuf.h>
+#include <rte_memcpy.h>
 #include <rte_os_shim.h>
 #include <rte_pcapng.h>
 #include <rte_reciprocal.h>
@@ -36,6 +38,9 @@
 /* upper bound for section, stats and interface blocks */
 #define PCAPNG_BLKSIZ	2048
 
+/* alignment of the optional write buffer */
+#define PCAPNG_BUF_ALIGN	4096
+
 /* Format of the capture file handle */
 struct rte_pcapng {
 	int  outfd;		/* output file */
@@ -43,6 +48,11 @@ struct rte_pcapng {
 	uint64_t offset_ns;	/* ns since 1/1/1970 when initialized */
 	uint64_t tsc_base;	/* TSC when started */
 
+	/* optional buffer where packet blocks are gathered before write */
+	uint8_t *buf;
+	size_t buf_size;
+	size_t buf_len;
+
 	/* DPDK port id to interface index in file */
 	uint32_t port_index[RTE_MAX_ETHPORTS];
 };
@@ -133,6 +143,29 @@ pcapng_add_option(struct pcapng_option *popt, uint16_t code,
 	return (struct pcapng_option *)((uint8_t *)popt + pcapng_optlen(len));
 }
 
+/* Write out the content of the packet buffer */
+static ssize_t
+pcapng_buf_flush(rte_pcapng_t *self)
+{
+	size_t done = 0;
+	ssize_t ret;
+
+	while (done < self->buf_len) {
+		ret = write(self->outfd, self->buf + done,
+			    self->buf_len - done);
+		if (unlikely(ret < 0)) {
+			if (errno == EINTR)
+				continue;
+			rte_errno = errno;
+			return -1;
+		}
+		done += ret;
+	}
+
+	self->buf_len = 0;
+	return done;
+}
+
 /*
  * Write required initial section header describing the capture
  */
@@ -313,6 +346,10 @@ rte_pcapng_add_interface(rte_pcapng_t *self, uint16_t port,
 	/* remember the file index */
 	self->port_index[port] = self->ports++;
 
+	/* keep blocks in order if packets were already buffered */
+	if (self->buf_len != 0 && pcapng_buf_flush(self) < 0)
+		return -1;
+
 	return write(self->outfd, buf, len);
 }
 
@@ -381,6 +418,9 @@ rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port_id,
 	/* clone block_length after option */
 	memcpy(opt, &len, sizeof(uint32_t));
 
+	if (self->buf_len != 0 && pcapng_buf_flush(self) < 0)
+		return -1;
+
 	return write(self->outfd, buf, len);
 }
 
@@ -605,6 +645,45 @@ rte_pcapng_copy(uint16_t port_id, uint32_t queue,
 	return NULL;
 }
 
+/* Append a packet block to the write buffer, flushing it when full */
+static ssize_t
+pcapng_buf_packet(rte_pcapng_t *self, struct rte_mbuf *m)
+{
+	uint32_t len = rte_pktmbuf_pkt_len(m);
+	struct iovec iov[IOV_MAX];
+	unsigned int cnt = 0;
+	ssize_t ret;
+
+	if (self->buf_len + len > self->buf_size &&
+	    pcapng_buf_flush(self) < 0)
+		return -1;
+
+	/* blocks larger than the whole buffer are written directly */
+	if (unlikely(len > self->buf_size)) {
+		do {
+			iov[cnt].iov_base = rte_pktmbuf_mtod(m, void *);
+			iov[cnt].iov_len = rte_pktmbuf_data_len(m);
+			++cnt;
+		} while ((m = m->next) && cnt < IOV_MAX);
+
+		ret = writev(self->outfd, iov, cnt);
+		if (unlikely(ret < 0)) {
+			rte_errno = errno;
+			return -1;
+		}
+		return ret;
+	}
+
+	do {
+		rte_memcpy(self->buf + self->buf_len,
+			   rte_pktmbuf_mtod(m, void *),
+			   rte_pktmbuf_data_len(m));
+		self->buf_len += rte_pktmbuf_data_len(m);
+	} while ((m = m->next));
+
+	return len;
+}
+
 /* Write pre-formatted packets to file. */
 ssize_t
 rte_pcapng_write_packets(rte_pcapng_t *self,
@@ -641,6 +720,14 @@ rte_pcapng_write_packets(rte_pcapng_t *self,
 		epb->timestamp_hi = timestamp >> 32;
 		epb->timestamp_lo = (uint32_t)timestamp;
 
+		if (self->buf != NULL) {
+			ret = pcapng_buf_packet(self, m);
+			if (unlikely(ret < 0))
+				return -1;
+			total += ret;
+			continue;
+		}
+
 		/*
 		 * Handle case of highly fragmented and large burst size
 		 * Note: this assumes that max segments per mbuf < IOV_MAX
@@ -666,6 +753,9 @@ rte_pcapng_write_packets(rte_pcapng_t *self,
 		} while ((m = m->next));
 	}
 
+	if (cnt == 0)
+		return total;
+
 	ret = writev(self->outfd, iov, cnt);
 	if (unlikely(ret < 0)) {
 		rte_errno = errno;
@@ -674,6 +764,57 @@ rte_pcapng_write_packets(rte_pcapng_t *self,
 	return total + ret;
 }
 
+uint64_t
+rte_pcapng_mbuf_timestamp(const struct rte_mbuf *m)
+{
+	const struct pcapng_enhance_packet_block *epb;
+
+	epb = rte_pktmbuf_mtod(m, const struct pcapng_enhance_packet_block *);
+	return ((uint64_t)epb->timestamp_hi << 32) | epb->timestamp_lo;
+}
+
+void
+rte_pcapng_mbuf_set_timestamp(struct rte_mbuf *m, uint64_t cycles)
+{
+	struct pcapng_enhance_packet_block *epb;
+
+	epb = rte_pktmbuf_mtod(m, struct pcapng_enhance_packet_block *);
+	epb->timestamp_hi = cycles >> 32;
+	epb->timestamp_lo = (uint32_t)cycles;
+}
+
+int
+rte_pcapng_set_write_buffer(rte_pcapng_t *self, size_t size)
+{
+	uint8_t *buf = NULL;
+
+	if (size != 0) {
+		size = RTE_ALIGN_CEIL(size, PCAPNG_BUF_ALIGN);
+		buf = rte_malloc("pcapng_buf", size, PCAPNG_BUF_ALIGN);
+		if (buf == NULL) {
+			rte_errno = ENOMEM;
+			return -1;
+		}
+	}
+
+	/* write out what is buffered before switching buffers */
+	if (pcapng_buf_flush(self) < 0) {
+		rte_free(buf);
+		return -1;
+	}
+
+	rte_free(self->buf);
+	self->buf = buf;
+	self->buf_size = size;
+	return 0;
+}
+
+ssize_t
+rte_pcapng_flush(rte_pcapng_t *self)
+{
+	return pcapng_buf_flush(self);
+}
+
 /* Create new pcapng writer handle */
 rte_pcapng_t *
 rte_pcapng_fdopen(int fd,
@@ -693,6 +834,9 @@ rte_pcapng_fdopen(int fd,
 
 	self->outfd = fd;
 	self->ports = 0;
+	self->buf = NULL;
+	self->buf_size = 0;
+	self->buf_len = 0;
 
 	/* record start time in ns since 1/1/1970 */
 	cycles = rte_get_tsc_cycles();
@@ -715,6 +859,8 @@ rte_pcapng_fdopen(int fd,
 void
 rte_pcapng_close(rte_pcapng_t *self)
 {
+	pcapng_buf_flush(self);
+	rte_free(self->buf);
 	close(self->outfd);
 	free(self);
 }
@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <rte_compat.h>
 #include <rte_mempool.h>
 
 #ifdef __cplusplus
@@ -161,6 +162,8 @@ rte_pcapng_mbuf_size(uint32_t length);
  *  The number of packets to write to the file.
  * @return
  *  The number of bytes written to file, -1 on failure to write file.
+ *  When a write buffer is set, the bytes added to the buffer are
+ *  counted as written.
  *  The mbuf's in *pkts* are always freed.
  */
 ssize_t
@@ -192,6 +195,85 @@ rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port,
 		       uint64_t ifrecv, uint64_t ifdrop,
 		       const char *comment);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the capture time of a packet formatted by rte_pcapng_copy().
+ *
+ * The value is only meaningful before the packet is written to a file,
+ * and can be used to merge packets captured on several queues.
+ *
+ * @param m
+ *  The mbuf returned by rte_pcapng_copy().
+ * @return
+ *  The capture time in TSC cycles (see rte_get_tsc_cycles()).
+ */
+__rte_experimental
+uint64_t
+rte_pcapng_mbuf_timestamp(const struct rte_mbuf *m);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the capture time of a packet formatted by rte_pcapng_copy().
+ *
+ * Used when the packet is formatted some time after it was captured,
+ * to record the actual capture time.
+ *
+ * @param m
+ *  The mbuf returned by rte_pcapng_copy().
+ * @param cycles
+ *  The capture time in TSC cycles (see rte_get_tsc_cycles()).
+ */
+__rte_experimental
+void
+rte_pcapng_mbuf_set_timestamp(struct rte_mbuf *m, uint64_t cycles);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Gather the packets written to the capture file in a buffer.
+ *
+ * Packet blocks are copied into a page aligned buffer which is written
+ * to the file once full, so that large captures are written with few
+ * large writes instead of one writev() per burst.
+ * Interface and statistics blocks flush the buffer before being written.
+ *
+ * Unlike the unbuffered mode, writes are no longer atomic, so a
+ * buffered handle must not be used by several threads at the same time.
+ *
+ * @param self
+ *  The handle to the packet capture file
+ * @param size
+ *  Size of the buffer in bytes, rounded up to a page.
+ *  Zero flushes and removes the buffer.
+ * @return
+ *  0 on success, -1 on failure to allocate the buffer or to write
+ *  previously buffered packets (and rte_errno is set).
+ */
+__rte_experimental
+int
+rte_pcapng_set_write_buffer(rte_pcapng_t *self, size_t size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Write the packets held in the write buffer to the capture file.
+ *
+ * @param self
+ *  The handle to the packet capture file
+ * @return
+ *  The number of bytes written to file, -1 on failure to write file
+ *  (and rte_errno is set).
+ */
+__rte_experimental
+ssize_t
+rte_pcapng_flush(rte_pcapng_t *self);
+
 #ifdef __cplusplus
 }
 #endif
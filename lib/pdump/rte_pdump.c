@@ -2,9 +2,12 @@
  * Copyright(c) 2016-2018 Intel Corporation
  */
 
+#include <stdalign.h>
 #include <stdlib.h>
 
+#include <rte_cycles.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
@@ -46,6 +49,7 @@ struct pdump_request {
 
 	const struct rte_bpf_prm *prm;
 	uint32_t snaplen;
+	struct rte_pdump_sampling sampling;
 };
 
 struct pdump_response {
@@ -54,6 +58,18 @@ struct pdump_response {
 	int32_t err_value;
 };
 
+/*
+ * Sampling state of a queue, only used by the thread polling the queue.
+ */
+struct pdump_sample {
+	uint32_t period;     /* capture 1 out of period packets */
+	uint32_t count;      /* packets since the last captured one */
+	uint64_t tb_cycles;  /* token bucket: cycles per token, 0 if unused */
+	uint64_t tb_size;    /* maximum number of tokens */
+	uint64_t tb_tokens;  /* available tokens */
+	uint64_t tb_last;    /* time of the last refill */
+};
+
 static struct pdump_rxtx_cbs {
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
@@ -61,9 +77,32 @@ static struct pdump_rxtx_cbs {
 	const struct rte_bpf *filter;
 	enum pdump_version ver;
 	uint32_t snaplen;
+	bool zerocopy;
+	struct pdump_sample sample;
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
+/*
+ * Where a packet shared in zero-copy mode was captured,
+ * stored in the mbuf enqueued to the ring.
+ */
+struct pdump_zc_meta {
+	uint64_t timestamp;	/* TSC cycles */
+	uint16_t port;
+	uint16_t queue;
+	uint8_t direction;	/* enum rte_pcapng_direction */
+};
+
+#define PDUMP_ZC_META_DYNFIELD_NAME "rte_pdump_dynfield_zc_meta"
+static int pdump_zc_meta_offset = -1;
+
+static inline struct pdump_zc_meta *
+pdump_zc_meta(const struct rte_mbuf *m)
+{
+	return RTE_MBUF_DYNFIELD(m, pdump_zc_meta_offset,
+				 struct pdump_zc_meta *);
+}
+
 
 /*
  * The packet capture statistics keep track of packets
@@ -77,26 +116,110 @@ static struct {
 	const struct rte_memzone *mz;
 } *pdump_stats;
 
+/* Add the tokens earned since the last refill, once per burst. */
+static inline void
+pdump_sample_refill(struct pdump_sample *sample)
+{
+	uint64_t n;
+
+	n = (rte_get_tsc_cycles() - sample->tb_last) / sample->tb_cycles;
+	if (n == 0)
+		return;
+
+	sample->tb_last += n * sample->tb_cycles;
+	sample->tb_tokens = RTE_MIN(sample->tb_tokens + n, sample->tb_size);
+}
+
+/* Decide if a packet accepted by the filter is captured. */
+static inline bool
+pdump_sample_accept(struct pdump_sample *sample)
+{
+	if (sample->period > 1) {
+		if (++sample->count < sample->period)
+			return false;
+		sample->count = 0;
+	}
+
+	if (sample->tb_cycles != 0) {
+		if (sample->tb_tokens == 0)
+			return false;
+		sample->tb_tokens--;
+	}
+
+	return true;
+}
+
+static inline bool
+pdump_has_extbuf(const struct rte_mbuf *m)
+{
+	for (; m != NULL; m = m->next) {
+		if (RTE_MBUF_HAS_EXTBUF(m))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Share the packet, recording where it was captured.
+ * An external buffer is owned by its provider, which may not expect
+ * it to stay referenced, so these packets are copied instead.
+ */
+static inline struct rte_mbuf *
+pdump_zc_clone(uint16_t port_id, uint16_t queue,
+	       enum rte_pcapng_direction direction,
+	       struct rte_mbuf *pkt, struct rte_mempool *mp,
+	       uint32_t snaplen, uint64_t timestamp)
+{
+	struct pdump_zc_meta *meta;
+	struct rte_mbuf *p;
+
+	if (unlikely(pdump_has_extbuf(pkt)))
+		p = rte_pktmbuf_copy(pkt, mp, 0, snaplen);
+	else
+		p = rte_pktmbuf_clone(pkt, mp);
+	if (unlikely(p == NULL))
+		return NULL;
+
+	meta = pdump_zc_meta(p);
+	meta->timestamp = timestamp;
+	meta->port = port_id;
+	meta->queue = queue;
+	meta->direction = direction;
+	return p;
+}
+
 /* Create a clone of mbuf to be placed into ring. */
 static void
 pdump_copy(uint16_t port_id, uint16_t queue,
 	   enum rte_pcapng_direction direction,
 	   struct rte_mbuf **pkts, uint16_t nb_pkts,
-	   const struct pdump_rxtx_cbs *cbs,
+	   struct pdump_rxtx_cbs *cbs,
 	   struct rte_pdump_stats *stats)
 {
 	unsigned int i;
 	int ring_enq;
 	uint16_t d_pkts = 0;
+	uint16_t skipped = 0;
 	struct rte_mbuf *dup_bufs[nb_pkts];
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	struct rte_mbuf *p;
 	uint64_t rcs[nb_pkts];
+	uint64_t timestamp = 0;
+	bool sampled;
 
 	if (cbs->filter)
 		rte_bpf_exec_burst(cbs->filter, (void **)pkts, rcs, nb_pkts);
 
+	sampled = cbs->sample.period > 1 || cbs->sample.tb_cycles != 0;
+	if (cbs->sample.tb_cycles != 0)
+		pdump_sample_refill(&cbs->sample);
+
+	/* all the packets of a burst share the same capture time */
+	if (cbs->zerocopy)
+		timestamp = rte_get_tsc_cycles();
+
 	ring = cbs->ring;
 	mp = cbs->mp;
 	for (i = 0; i < nb_pkts; i++) {
@@ -112,11 +235,21 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 			continue;
 		}
 
+		if (sampled && !pdump_sample_accept(&cbs->sample)) {
+			skipped++;
+			continue;
+		}
+
 		/*
-		 * If using pcapng then want to wrap packets
+		 * In zero-copy mode the consumer makes the copy,
+		 * if using pcapng then want to wrap packets
 		 * otherwise a simple copy.
 		 */
-		if (cbs->ver == V2)
+		if (cbs->zerocopy)
+			p = pdump_zc_clone(port_id, queue, direction,
+					   pkts[i], mp, cbs->snaplen,
+					   timestamp);
+		else if (cbs->ver == V2)
 			p = rte_pcapng_copy(port_id, queue,
 					    pkts[i], mp, cbs->snaplen,
 					    direction, NULL);
@@ -130,6 +263,9 @@ pdump_copy(uint16_t port_id, uint16_t queue,
 	}
 
 	rte_atomic_fetch_add_explicit(&stats->accepted, d_pkts, rte_memory_order_relaxed);
+	if (skipped != 0)
+		rte_atomic_fetch_add_explicit(&stats->skipped, skipped,
+					      rte_memory_order_relaxed);
 
 	ring_enq = rte_ring_enqueue_burst(ring, (void *)&dup_bufs[0], d_pkts, NULL);
 	if (unlikely(ring_enq < d_pkts)) {
@@ -145,7 +281,7 @@ pdump_rx(uint16_t port, uint16_t queue,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->rx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_IN,
@@ -157,7 +293,7 @@ static uint16_t
 pdump_tx(uint16_t port, uint16_t queue,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	const struct pdump_rxtx_cbs *cbs = user_params;
+	struct pdump_rxtx_cbs *cbs = user_params;
 	struct rte_pdump_stats *stats = &pdump_stats->tx[port][queue];
 
 	pdump_copy(port, queue, RTE_PCAPNG_DIRECTION_OUT,
@@ -165,12 +301,56 @@ pdump_tx(uint16_t port, uint16_t queue,
 	return nb_pkts;
 }
 
+static void
+pdump_sample_init(struct pdump_sample *sample,
+		  const struct rte_pdump_sampling *sampling)
+{
+	memset(sample, 0, sizeof(*sample));
+	sample->period = sampling->period;
+
+	if (sampling->rate != 0) {
+		sample->tb_cycles = RTE_MAX(rte_get_tsc_hz() / sampling->rate,
+					    UINT64_C(1));
+		sample->tb_size = RTE_MAX(sampling->burst, 1u);
+		sample->tb_tokens = sample->tb_size;
+		sample->tb_last = rte_get_tsc_cycles();
+	}
+}
+
+/*
+ * The transmit path of drivers using fast free assumes that
+ * mbufs are not shared, which zero-copy capture breaks.
+ */
+static int
+pdump_check_tx_zerocopy(uint16_t port, uint16_t qid)
+{
+	struct rte_eth_txq_info qinfo;
+	struct rte_eth_conf conf;
+	uint64_t offloads = 0;
+
+	if (rte_eth_dev_conf_get(port, &conf) == 0)
+		offloads |= conf.txmode.offloads;
+	if (rte_eth_tx_queue_info_get(port, qid, &qinfo) == 0)
+		offloads |= qinfo.conf.offloads;
+
+	if (offloads & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE) {
+		PDUMP_LOG_LINE(ERR,
+			"zero-copy not supported with mbuf fast free on port=%d queue=%d",
+			port, qid);
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static int
 pdump_register_rx_callbacks(enum pdump_version ver,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
 			    struct rte_ring *ring, struct rte_mempool *mp,
 			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    uint16_t operation, uint32_t snaplen,
+			    bool zerocopy,
+			    const struct rte_pdump_sampling *sampling)
 {
 	uint16_t qid;
 
@@ -190,6 +370,8 @@ pdump_register_rx_callbacks(enum pdump_version ver,
 			cbs->mp = mp;
 			cbs->snaplen = snaplen;
 			cbs->filter = filter;
+			cbs->zerocopy = zerocopy;
+			pdump_sample_init(&cbs->sample, sampling);
 
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
@@ -227,7 +409,9 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 			    uint16_t end_q, uint16_t port, uint16_t queue,
 			    struct rte_ring *ring, struct rte_mempool *mp,
 			    struct rte_bpf *filter,
-			    uint16_t operation, uint32_t snaplen)
+			    uint16_t operation, uint32_t snaplen,
+			    bool zerocopy,
+			    const struct rte_pdump_sampling *sampling)
 {
 
 	uint16_t qid;
@@ -243,11 +427,19 @@ pdump_register_tx_callbacks(enum pdump_version ver,
 					port, qid);
 				return -EEXIST;
 			}
+			if (zerocopy) {
+				int ret = pdump_check_tx_zerocopy(port, qid);
+
+				if (ret < 0)
+					return ret;
+			}
 			cbs->ver = ver;
 			cbs->ring = ring;
 			cbs->mp = mp;
 			cbs->snaplen = snaplen;
 			cbs->filter = filter;
+			cbs->zerocopy = zerocopy;
+			pdump_sample_init(&cbs->sample, sampling);
 
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
@@ -291,6 +483,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	uint16_t operation;
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
+	bool zerocopy;
 
 	/* Check for possible DPDK version mismatch */
 	if (!(p->ver == V1 || p->ver == V2)) {
@@ -320,6 +513,23 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	queue = p->queue;
 	ring = p->ring;
 	mp = p->mp;
+	zerocopy = (flags & RTE_PDUMP_FLAG_ZEROCOPY) != 0;
+
+	if (operation == ENABLE && zerocopy) {
+		static const struct rte_mbuf_dynfield zc_meta_desc = {
+			.name = PDUMP_ZC_META_DYNFIELD_NAME,
+			.size = sizeof(struct pdump_zc_meta),
+			.align = alignof(struct pdump_zc_meta),
+		};
+
+		pdump_zc_meta_offset = rte_mbuf_dynfield_register(&zc_meta_desc);
+		if (pdump_zc_meta_offset < 0) {
+			PDUMP_LOG_LINE(ERR,
+				"failed to register mbuf field for zero-copy: %s",
+				rte_strerror(rte_errno));
+			return -rte_errno;
+		}
+	}
 
 	ret = rte_eth_dev_get_port_by_name(p->device, &port);
 	if (ret < 0) {
@@ -354,7 +564,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 			return -EINVAL;
 		}
 		if ((nb_tx_q == 0 || nb_rx_q == 0) &&
-			flags == RTE_PDUMP_FLAG_RXTX) {
+			(flags & RTE_PDUMP_FLAG_RXTX) == RTE_PDUMP_FLAG_RXTX) {
 			PDUMP_LOG_LINE(ERR,
 				"both tx&rx queues must be non zero");
 			return -EINVAL;
@@ -366,7 +576,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
 		ret = pdump_register_rx_callbacks(p->ver, end_q, port, queue,
 						  ring, mp, filter,
-						  operation, p->snaplen);
+						  operation, p->snaplen,
+						  zerocopy, &p->sampling);
 		if (ret < 0)
 			return ret;
 	}
@@ -376,7 +587,8 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
 		ret = pdump_register_tx_callbacks(p->ver, end_q, port, queue,
 						  ring, mp, filter,
-						  operation, p->snaplen);
+						  operation, p->snaplen,
+						  zerocopy, &p->sampling);
 		if (ret < 0)
 			return ret;
 	}
@@ -487,7 +699,8 @@ pdump_validate_flags(uint32_t flags)
 	}
 
 	/* mask off the flags we know about */
-	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG)) {
+	if (flags & ~(RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_PCAPNG |
+		      RTE_PDUMP_FLAG_ZEROCOPY)) {
 		PDUMP_LOG_LINE(ERR,
 			  "unknown flags: %#x", flags);
 		rte_errno = ENOTSUP;
@@ -525,7 +738,8 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 			     uint16_t operation,
 			     struct rte_ring *ring,
 			     struct rte_mempool *mp,
-			     const struct rte_bpf_prm *prm)
+			     const struct rte_bpf_prm *prm,
+			     const struct rte_pdump_sampling *sampling)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -543,7 +757,7 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 	memset(req, 0, sizeof(*req));
 
 	req->ver = (flags & RTE_PDUMP_FLAG_PCAPNG) ? V2 : V1;
-	req->flags = flags & RTE_PDUMP_FLAG_RXTX;
+	req->flags = flags & (RTE_PDUMP_FLAG_RXTX | RTE_PDUMP_FLAG_ZEROCOPY);
 	req->op = operation;
 	req->queue = queue;
 	rte_strscpy(req->device, device, sizeof(req->device));
@@ -553,6 +767,8 @@ pdump_prepare_client_request(const char *device, uint16_t queue,
 		req->mp = mp;
 		req->prm = prm;
 		req->snaplen = snaplen;
+		if (sampling != NULL)
+			req->sampling = *sampling;
 	}
 
 	rte_strscpy(mp_req.name, PDUMP_MP, RTE_MP_MAX_NAME_LEN);
@@ -584,7 +800,8 @@ static int
 pdump_enable(uint16_t port, uint16_t queue,
 	     uint32_t flags, uint32_t snaplen,
 	     struct rte_ring *ring, struct rte_mempool *mp,
-	     const struct rte_bpf_prm *prm)
+	     const struct rte_bpf_prm *prm,
+	     const struct rte_pdump_sampling *sampling)
 {
 	int ret;
 	char name[RTE_DEV_NAME_MAX_LEN];
@@ -603,7 +820,7 @@ pdump_enable(uint16_t port, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(name, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, sampling);
 }
 
 int
@@ -613,7 +830,7 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		 void *filter __rte_unused)
 {
 	return pdump_enable(port, queue, flags, 0,
-			    ring, mp, NULL);
+			    ring, mp, NULL, NULL);
 }
 
 int
@@ -624,7 +841,19 @@ rte_pdump_enable_bpf(uint16_t port, uint16_t queue,
 		     const struct rte_bpf_prm *prm)
 {
 	return pdump_enable(port, queue, flags, snaplen,
-			    ring, mp, prm);
+			    ring, mp, prm, NULL);
+}
+
+int
+rte_pdump_enable_sampling(uint16_t port, uint16_t queue,
+			  uint32_t flags, uint32_t snaplen,
+			  struct rte_ring *ring,
+			  struct rte_mempool *mp,
+			  const struct rte_bpf_prm *prm,
+			  const struct rte_pdump_sampling *sampling)
+{
+	return pdump_enable(port, queue, flags, snaplen,
+			    ring, mp, prm, sampling);
 }
 
 static int
@@ -647,7 +876,7 @@ pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
 		snaplen = UINT32_MAX;
 
 	return pdump_prepare_client_request(device_id, queue, flags, snaplen,
-					    ENABLE, ring, mp, prm);
+					    ENABLE, ring, mp, prm, NULL);
 }
 
 int
@@ -686,7 +915,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 		return ret;
 
 	ret = pdump_prepare_client_request(name, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
@@ -702,13 +931,13 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 		return ret;
 
 	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
-					   DISABLE, NULL, NULL, NULL);
+					   DISABLE, NULL, NULL, NULL, NULL);
 
 	return ret;
 }
 
 static void
-pdump_sum_stats(uint16_t port, uint16_t nq,
+pdump_sum_stats(uint16_t port, uint16_t first, uint16_t last,
 		struct rte_pdump_stats stats[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 		struct rte_pdump_stats *total)
 {
@@ -717,7 +946,7 @@ pdump_sum_stats(uint16_t port, uint16_t nq,
 	uint64_t val;
 	uint16_t qid;
 
-	for (qid = 0; qid < nq; qid++) {
+	for (qid = first; qid < last; qid++) {
 		const RTE_ATOMIC(uint64_t) *perq = (const uint64_t __rte_atomic *)&stats[port][qid];
 
 		for (i = 0; i < sizeof(*total) / sizeof(uint64_t); i++) {
@@ -727,21 +956,11 @@ pdump_sum_stats(uint16_t port, uint16_t nq,
 	}
 }
 
-int
-rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
+/* Find the shared statistics when called before any enable */
+static int
+pdump_stats_lookup(void)
 {
-	struct rte_eth_dev_info dev_info;
 	const struct rte_memzone *mz;
-	int ret;
-
-	memset(stats, 0, sizeof(*stats));
-	ret = rte_eth_dev_info_get(port, &dev_info);
-	if (ret != 0) {
-		PDUMP_LOG_LINE(ERR,
-			  "Error during getting device (port %u) info: %s",
-			  port, strerror(-ret));
-		return ret;
-	}
 
 	if (pdump_stats == NULL) {
 		if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
@@ -762,7 +981,101 @@ rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
 		pdump_stats = mz->addr;
 	}
 
-	pdump_sum_stats(port, dev_info.nb_rx_queues, pdump_stats->rx, stats);
-	pdump_sum_stats(port, dev_info.nb_tx_queues, pdump_stats->tx, stats);
 	return 0;
 }
+
+int
+rte_pdump_stats(uint16_t port, struct rte_pdump_stats *stats)
+{
+	struct rte_eth_dev_info dev_info;
+	int ret;
+
+	memset(stats, 0, sizeof(*stats));
+	ret = rte_eth_dev_info_get(port, &dev_info);
+	if (ret != 0) {
+		PDUMP_LOG_LINE(ERR,
+			  "Error during getting device (port %u) info: %s",
+			  port, strerror(-ret));
+		return ret;
+	}
+
+	if (pdump_stats_lookup() < 0)
+		return -1;
+
+	pdump_sum_stats(port, 0, dev_info.nb_rx_queues, pdump_stats->rx, stats);
+	pdump_sum_stats(port, 0, dev_info.nb_tx_queues, pdump_stats->tx, stats);
+	return 0;
+}
+
+int
+rte_pdump_queue_stats(uint16_t port, uint16_t queue,
+		      struct rte_pdump_stats *stats)
+{
+	struct rte_eth_dev_info dev_info;
+	int ret;
+
+	memset(stats, 0, sizeof(*stats));
+	ret = rte_eth_dev_info_get(port, &dev_info);
+	if (ret != 0) {
+		PDUMP_LOG_LINE(ERR,
+			  "Error during getting device (port %u) info: %s",
+			  port, strerror(-ret));
+		return ret;
+	}
+
+	if (queue >= RTE_MAX(dev_info.nb_rx_queues, dev_info.nb_tx_queues)) {
+		PDUMP_LOG_LINE(ERR, "invalid queue %u for port %u", queue, port);
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (pdump_stats_lookup() < 0)
+		return -1;
+
+	if (queue < dev_info.nb_rx_queues)
+		pdump_sum_stats(port, queue, queue + 1, pdump_stats->rx, stats);
+	if (queue < dev_info.nb_tx_queues)
+		pdump_sum_stats(port, queue, queue + 1, pdump_stats->tx, stats);
+	return 0;
+}
+
+struct rte_mbuf *
+rte_pdump_zc_copy(const struct rte_mbuf *m, struct rte_mempool *mp,
+		  uint32_t snaplen, uint32_t flags)
+{
+	const struct pdump_zc_meta *meta;
+	struct rte_mbuf *p;
+
+	if (m == NULL || mp == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* field is registered by the primary process */
+	if (pdump_zc_meta_offset < 0) {
+		pdump_zc_meta_offset =
+			rte_mbuf_dynfield_lookup(PDUMP_ZC_META_DYNFIELD_NAME,
+						 NULL);
+		if (pdump_zc_meta_offset < 0) {
+			rte_errno = ENOENT;
+			return NULL;
+		}
+	}
+
+	if (snaplen == 0)
+		snaplen = UINT32_MAX;
+
+	if (flags & RTE_PDUMP_FLAG_PCAPNG) {
+		meta = pdump_zc_meta(m);
+		p = rte_pcapng_copy(meta->port, meta->queue, m, mp, snaplen,
+				    meta->direction, NULL);
+		if (p != NULL)
+			rte_pcapng_mbuf_set_timestamp(p, meta->timestamp);
+	} else {
+		p = rte_pktmbuf_copy(m, mp, 0, snaplen);
+	}
+
+	if (p == NULL)
+		rte_errno = ENOMEM;
+	return p;
+}
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include <rte_bpf.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,27 @@ enum {
 	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX),
 
 	RTE_PDUMP_FLAG_PCAPNG = 4, /* format for pcapng */
+
+	/*
+	 * share the packets instead of copying them (experimental),
+	 * see rte_pdump_zc_copy()
+	 */
+	RTE_PDUMP_FLAG_ZEROCOPY = 8,
+};
+
+/**
+ * Sampling of the packets captured on a queue.
+ *
+ * It applies to the packets accepted by the filter,
+ * and both methods can be combined.
+ */
+struct rte_pdump_sampling {
+	/** Capture one packet out of *period*, 0 or 1 to capture all. */
+	uint32_t period;
+	/** Maximum number of packets captured at once above *rate*. */
+	uint32_t burst;
+	/** Maximum number of packets captured per second, 0 for no limit. */
+	uint64_t rate;
 };
 
 /**
@@ -113,6 +135,53 @@ rte_pdump_enable_bpf(uint16_t port_id, uint16_t queue,
 		     struct rte_mempool *mp,
 		     const struct rte_bpf_prm *prm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enables packet capturing on given port and queue with filtering
+ * and sampling.
+ *
+ * Each queue is sampled independently, so with RTE_PDUMP_ALL_QUEUES
+ * the sampling rate applies to each queue of the port.
+ *
+ * @param port_id
+ *  The Ethernet port on which packet capturing should be enabled.
+ * @param queue
+ *  The queue on the Ethernet port which packet capturing
+ *  should be enabled. Pass UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  Pdump library flags that specify direction, packet format
+ *  and zero-copy mode.
+ * @param snaplen
+ *  The upper limit on bytes to copy.
+ *  Passing UINT32_MAX means capture all the possible data.
+ *  In zero-copy mode, only applies to the packets with an external buffer,
+ *  which are copied rather than shared.
+ * @param ring
+ *  The ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  The mempool on to which original packets will be mirrored or duplicated.
+ *  In zero-copy mode, its data room is only used by the packets
+ *  with an external buffer.
+ * @param prm
+ *  Use BPF program to run to filter packets (can be NULL)
+ * @param sampling
+ *  Sampling of the packets accepted by the filter (can be NULL)
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_sampling(uint16_t port_id, uint16_t queue,
+			  uint32_t flags, uint32_t snaplen,
+			  struct rte_ring *ring,
+			  struct rte_mempool *mp,
+			  const struct rte_bpf_prm *prm,
+			  const struct rte_pdump_sampling *sampling);
+
 /**
  * Disables packet capturing on given port and queue.
  *
@@ -229,8 +298,9 @@ struct rte_pdump_stats {
 	RTE_ATOMIC(uint64_t) filtered; /**< Number of packets rejected by filter. */
 	RTE_ATOMIC(uint64_t) nombuf;   /**< Number of mbuf allocation failures. */
 	RTE_ATOMIC(uint64_t) ringfull; /**< Number of missed packets due to ring full. */
+	RTE_ATOMIC(uint64_t) skipped;  /**< Number of packets skipped by sampling. */
 
-	uint64_t reserved[4]; /**< Reserved and pad to cache line */
+	uint64_t reserved[3]; /**< Reserved and pad to cache line */
 };
 
 /**
@@ -246,6 +316,66 @@ struct rte_pdump_stats {
 int
 rte_pdump_stats(uint16_t port_id, struct rte_pdump_stats *stats);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve the packet capture statistics of one queue of a port,
+ * summing the Rx and Tx queues of that index.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue
+ *   The queue index.
+ * @param stats
+ *   A pointer to structure of type *rte_pdump_stats* to be filled in.
+ * @return
+ *   Zero if successful. -1 on error and rte_errno is set.
+ */
+__rte_experimental
+int
+rte_pdump_queue_stats(uint16_t port_id, uint16_t queue,
+		      struct rte_pdump_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Make the final copy of a packet captured with RTE_PDUMP_FLAG_ZEROCOPY.
+ *
+ * In zero-copy mode, the capture callbacks do not copy the packets:
+ * they enqueue indirect mbufs, allocated from the capture mempool,
+ * sharing the data of the original packets with reference counting.
+ * The packets with an external buffer are copied into the capture mempool
+ * instead, as their buffer may not be kept referenced.
+ * The consumer of the ring copies them with this function,
+ * truncating them to *snaplen*, then frees the mbufs dequeued from the ring,
+ * which releases the original packets.
+ *
+ * Because the data is shared, it reflects any change made to the packet
+ * by the application until it is copied. The capture ring size bounds
+ * the number of packets of the port held by the consumer.
+ * Zero-copy capture cannot be enabled on the transmit queues using
+ * RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE.
+ *
+ * @param m
+ *   The mbuf dequeued from the capture ring.
+ * @param mp
+ *   The mempool from which the copy is allocated.
+ * @param snaplen
+ *   The upper limit on bytes to copy.
+ *   Passing 0 or UINT32_MAX means capture all the possible data.
+ * @param flags
+ *   RTE_PDUMP_FLAG_PCAPNG to format the copy for rte_pcapng_write_packets(),
+ *   with the capture port, queue, direction and time.
+ * @return
+ *   The copy, or NULL on error, with rte_errno set.
+ */
+__rte_experimental
+struct rte_mbuf *
+rte_pdump_zc_copy(const struct rte_mbuf *m, struct rte_mempool *mp,
+		  uint32_t snaplen, uint32_t flags);
+
 
 #ifdef __cplusplus
 }
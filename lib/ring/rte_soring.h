@@ -0,0 +1,392 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _RTE_SORING_H_
+#define _RTE_SORING_H_
+
+/**
+ * @file
+ * This file contains the definition of the RTE staged-ordered ring (SORING).
+ *
+ * A SORING is a ring of elements, which pass through a fixed number of
+ * stages on their way from the producer to the consumer:
+ *
+ *  producer -> stage 0 -> stage 1 -> ... -> stage N-1 -> consumer
+ *
+ * Elements never leave the ring storage between the stages. Threads of a
+ * stage acquire a group of elements, process them (copying them out, or
+ * in place through a zero-copy acquire), and release the group with the
+ * token returned by the acquire. Groups may be released out of order,
+ * but the next stage (or the consumer) only sees elements once all the
+ * preceding ones were released, so the original order of the elements is
+ * kept at every stage.
+ *
+ * It replaces one ring per pipeline hop plus a reorder buffer after
+ * parallel workers with a single ring.
+ *
+ * The producer and the consumer can be multi-thread safe
+ * (RTE_RING_SYNC_MT) or single thread (RTE_RING_SYNC_ST). Acquire and
+ * release of a stage are always multi-thread safe.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include <rte_compat.h>
+#include <rte_ring.h>
+
+/** The maximum number of elements in a SORING. */
+#define RTE_SORING_ELEM_MAX	(RTE_BIT32(30) - 1)
+
+/** The maximum number of stages in a SORING. */
+#define RTE_SORING_STAGE_MAX	64
+
+/* opaque SORING structure */
+struct rte_soring;
+
+/**
+ * SORING creation parameters.
+ */
+struct rte_soring_param {
+	/** Name of the ring. */
+	const char *name;
+	/** Number of elements the ring can hold, up to RTE_SORING_ELEM_MAX. */
+	uint32_t elems;
+	/** Size of an element in bytes, must be a multiple of 4. */
+	uint32_t elem_size;
+	/** Number of stages between the producer and the consumer. */
+	uint32_t stages;
+	/** Sync type of the producer, RTE_RING_SYNC_MT or RTE_RING_SYNC_ST. */
+	enum rte_ring_sync_type prod_synt;
+	/** Sync type of the consumer, RTE_RING_SYNC_MT or RTE_RING_SYNC_ST. */
+	enum rte_ring_sync_type cons_synt;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Calculate the memory size needed for a SORING.
+ *
+ * @param prm
+ *   Pointer to the SORING creation parameters.
+ * @return
+ *   - The memory size needed for the ring on success.
+ *   - -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+ssize_t
+rte_soring_get_memsize(const struct rte_soring_param *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize a SORING structure in the memory pointed to by r.
+ * The memory must be aligned on a cache line and its size must be at
+ * least the value returned by rte_soring_get_memsize().
+ *
+ * @param r
+ *   Pointer to the SORING memory.
+ * @param prm
+ *   Pointer to the SORING creation parameters.
+ * @return
+ *   0 on success, or a negative errno value on error.
+ */
+__rte_experimental
+int
+rte_soring_init(struct rte_soring *r, const struct rte_soring_param *prm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dump the status of a SORING.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param r
+ *   Pointer to the SORING structure.
+ */
+__rte_experimental
+void
+rte_soring_dump(FILE *f, const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Return the number of elements in a SORING, at any stage.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @return
+ *   The number of elements in the ring.
+ */
+__rte_experimental
+uint32_t
+rte_soring_count(const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Return the number of free entries in a SORING.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @return
+ *   The number of free entries in the ring.
+ */
+__rte_experimental
+uint32_t
+rte_soring_free_count(const struct rte_soring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue exactly n elements on a SORING, or none of them.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size.
+ * @param n
+ *   The number of elements to enqueue.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of elements enqueued, either 0 or n.
+ */
+__rte_experimental
+uint32_t
+rte_soring_enqueue_bulk(struct rte_soring *r, const void *objs, uint32_t n,
+	uint32_t *free_space);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue up to n elements on a SORING.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size.
+ * @param n
+ *   The number of elements to enqueue.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of elements enqueued.
+ */
+__rte_experimental
+uint32_t
+rte_soring_enqueue_burst(struct rte_soring *r, const void *objs, uint32_t n,
+	uint32_t *free_space);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue exactly n elements, released by the last stage, from a SORING,
+ * or none of them. Elements are dequeued in the order of enqueue.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size.
+ * @param n
+ *   The number of elements to dequeue.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   dequeue after the dequeue operation has finished.
+ * @return
+ *   The number of elements dequeued, either 0 or n.
+ */
+__rte_experimental
+uint32_t
+rte_soring_dequeue_bulk(struct rte_soring *r, void *objs, uint32_t n,
+	uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue up to n elements, released by the last stage, from a SORING.
+ * Elements are dequeued in the order of enqueue.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size.
+ * @param n
+ *   The number of elements to dequeue.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   dequeue after the dequeue operation has finished.
+ * @return
+ *   The number of elements dequeued.
+ */
+__rte_experimental
+uint32_t
+rte_soring_dequeue_burst(struct rte_soring *r, void *objs, uint32_t n,
+	uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire exactly n elements for a stage of a SORING, or none of them,
+ * and copy them to objs. The elements must be released by
+ * rte_soring_release() with the returned token.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size, or NULL
+ *   to acquire the elements without copying them.
+ * @param stage
+ *   The stage to acquire the elements for.
+ * @param n
+ *   The number of elements to acquire.
+ * @param ftoken
+ *   Returns the token to release the acquired elements with.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   this stage after the acquire operation has finished.
+ * @return
+ *   The number of elements acquired, either 0 or n.
+ */
+__rte_experimental
+uint32_t
+rte_soring_acquire_bulk(struct rte_soring *r, void *objs, uint32_t stage,
+	uint32_t n, uint32_t *ftoken, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire up to n elements for a stage of a SORING and copy them to objs.
+ * The elements must be released by rte_soring_release() with the
+ * returned token.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   Pointer to an array of n elements of the ring element size, or NULL
+ *   to acquire the elements without copying them.
+ * @param stage
+ *   The stage to acquire the elements for.
+ * @param n
+ *   The number of elements to acquire.
+ * @param ftoken
+ *   Returns the token to release the acquired elements with.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   this stage after the acquire operation has finished.
+ * @return
+ *   The number of elements acquired.
+ */
+__rte_experimental
+uint32_t
+rte_soring_acquire_burst(struct rte_soring *r, void *objs, uint32_t stage,
+	uint32_t n, uint32_t *ftoken, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire exactly n elements for a stage of a SORING, or none of them,
+ * without copying them. The elements can be read and modified in place
+ * through zcd, until they are released by rte_soring_release() with the
+ * returned token.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param stage
+ *   The stage to acquire the elements for.
+ * @param n
+ *   The number of elements to acquire.
+ * @param zcd
+ *   Returns the pointers to the acquired elements in the ring storage.
+ * @param ftoken
+ *   Returns the token to release the acquired elements with.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   this stage after the acquire operation has finished.
+ * @return
+ *   The number of elements acquired, either 0 or n.
+ */
+__rte_experimental
+uint32_t
+rte_soring_acquire_zc_bulk(struct rte_soring *r, uint32_t stage, uint32_t n,
+	struct rte_ring_zc_data *zcd, uint32_t *ftoken, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Acquire up to n elements for a stage of a SORING without copying them.
+ * The elements can be read and modified in place through zcd, until they
+ * are released by rte_soring_release() with the returned token.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param stage
+ *   The stage to acquire the elements for.
+ * @param n
+ *   The number of elements to acquire.
+ * @param zcd
+ *   Returns the pointers to the acquired elements in the ring storage.
+ * @param ftoken
+ *   Returns the token to release the acquired elements with.
+ * @param available
+ *   If non-NULL, returns the number of remaining elements ready for
+ *   this stage after the acquire operation has finished.
+ * @return
+ *   The number of elements acquired.
+ */
+__rte_experimental
+uint32_t
+rte_soring_acquire_zc_burst(struct rte_soring *r, uint32_t stage, uint32_t n,
+	struct rte_ring_zc_data *zcd, uint32_t *ftoken, uint32_t *available);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release the elements acquired by a stage of a SORING, which makes them
+ * available to the next stage (or the consumer) once all the preceding
+ * elements are released too.
+ *
+ * @param r
+ *   Pointer to the SORING structure.
+ * @param objs
+ *   If non-NULL, pointer to an array of n elements, which replace the
+ *   acquired elements in the ring.
+ * @param stage
+ *   The stage the elements were acquired for.
+ * @param n
+ *   The number of elements, which must be the number returned by the
+ *   acquire operation.
+ * @param ftoken
+ *   The token returned by the acquire operation.
+ */
+__rte_experimental
+void
+rte_soring_release(struct rte_soring *r, const void *objs, uint32_t stage,
+	uint32_t n, uint32_t ftoken);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_SORING_H_ */
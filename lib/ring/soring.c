@@ -0,0 +1,486 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+/**
+ * @file
+ * Staged-ordered ring (SORING) implementation.
+ *
+ * All the stages share one array of elements and one array of states.
+ * Each stage has a head, up to which its threads acquired elements, and a
+ * tail, up to which the elements were released in order:
+ *
+ *  cons.tail <= cons.head <= stage[N-1].tail <= stage[N-1].head <= ...
+ *            <= stage[0].tail <= stage[0].head <= prod.tail <= prod.head
+ *
+ * Acquire moves the stage head forward with a CAS, like a multi-consumer
+ * dequeue. Release marks the state of the first released element as
+ * finished. Then the thread which holds the tail sync flag walks the
+ * states from the tail over all the finished groups, and moves the tail
+ * past them. Groups released out of order stay marked until the groups
+ * before them are released, so the next stage sees elements in order.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_string_fns.h>
+
+#include "soring.h"
+
+extern int ring_logtype;
+#define RTE_LOGTYPE_RING ring_logtype
+#define SORING_LOG(level, ...) \
+	RTE_LOG_LINE(level, RING, "" __VA_ARGS__)
+
+/*
+ * Move the head of a producer, a stage or the consumer forward, against
+ * the tail of the previous party. For the producer, capacity is the ring
+ * capacity, for the others it is 0.
+ */
+static __rte_always_inline uint32_t
+soring_move_head(volatile RTE_ATOMIC(uint32_t) *head,
+	const volatile RTE_ATOMIC(uint32_t) *s_tail, uint32_t capacity, uint32_t is_st, uint32_t num,
+	enum rte_ring_queue_behavior behavior, uint32_t *old_head,
+	uint32_t *entries)
+{
+	uint32_t n, stail;
+	int success;
+
+	*old_head = rte_atomic_load_explicit(head, rte_memory_order_relaxed);
+	do {
+		n = num;
+
+		/* Ensure the head is read before tail */
+		rte_atomic_thread_fence(rte_memory_order_acquire);
+
+		/* synchronize with the store-release of the tail */
+		stail = rte_atomic_load_explicit(s_tail,
+				rte_memory_order_acquire);
+
+		*entries = capacity + stail - *old_head;
+		if (unlikely(n > *entries))
+			n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : *entries;
+		if (n == 0)
+			return 0;
+
+		if (is_st) {
+			rte_atomic_store_explicit(head, *old_head + n,
+					rte_memory_order_relaxed);
+			success = 1;
+		} else
+			/* on failure, *old_head is updated */
+			success = rte_atomic_compare_exchange_strong_explicit(
+					head, old_head, *old_head + n,
+					rte_memory_order_relaxed,
+					rte_memory_order_relaxed);
+	} while (unlikely(success == 0));
+
+	*entries -= n;
+	return n;
+}
+
+/* Copy n elements to the ring storage, starting at position pos. */
+static __rte_always_inline void
+soring_copy_in(struct rte_soring *r, uint32_t pos, const void *objs,
+	uint32_t n)
+{
+	uint32_t idx, n1;
+
+	idx = pos & r->mask;
+	n1 = RTE_MIN(n, r->size - idx);
+	memcpy(RTE_PTR_ADD(r->elems, (size_t)idx * r->esize), objs,
+			(size_t)n1 * r->esize);
+	if (n1 != n)
+		memcpy(r->elems, RTE_PTR_ADD(objs, (size_t)n1 * r->esize),
+				(size_t)(n - n1) * r->esize);
+}
+
+/* Copy n elements from the ring storage, starting at position pos. */
+static __rte_always_inline void
+soring_copy_out(const struct rte_soring *r, uint32_t pos, void *objs,
+	uint32_t n)
+{
+	uint32_t idx, n1;
+
+	idx = pos & r->mask;
+	n1 = RTE_MIN(n, r->size - idx);
+	memcpy(objs, RTE_PTR_ADD(r->elems, (size_t)idx * r->esize),
+			(size_t)n1 * r->esize);
+	if (n1 != n)
+		memcpy(RTE_PTR_ADD(objs, (size_t)n1 * r->esize), r->elems,
+				(size_t)(n - n1) * r->esize);
+}
+
+/* The tail up to which the stage (or the consumer, if stage == nb_stage)
+ * can acquire elements.
+ */
+static __rte_always_inline const volatile RTE_ATOMIC(uint32_t) *
+soring_prev_tail(const struct rte_soring *r, uint32_t stage)
+{
+	const union soring_stage_tail *tail;
+
+	if (stage == 0)
+		return &r->prod.tail;
+	tail = &r->stage[stage - 1].tail;
+	return (const RTE_ATOMIC(uint32_t) *)(uintptr_t)&tail->pos;
+}
+
+/*
+ * Move the tail of a stage past all the finished groups. Only the thread
+ * which sets the sync flag does it, the others rely on that thread.
+ */
+static void
+soring_stage_finalize(struct rte_soring *r, struct soring_stage *stg)
+{
+	union soring_stage_tail ot, nt;
+	union soring_state st;
+	uint32_t head, idx, tail;
+
+	do {
+		ot.raw = rte_atomic_load_explicit(&stg->tail.raw,
+				rte_memory_order_acquire);
+		/* another thread is moving the tail and re-checks after it */
+		if (ot.sync != 0)
+			return;
+
+		nt.pos = ot.pos;
+		nt.sync = 1;
+		if (rte_atomic_compare_exchange_strong_explicit(&stg->tail.raw,
+				(uint64_t *)(uintptr_t)&ot.raw, nt.raw,
+				rte_memory_order_acquire,
+				rte_memory_order_relaxed) == 0)
+			return;
+
+		head = rte_atomic_load_explicit(&stg->head,
+				rte_memory_order_acquire);
+
+		/* walk over the finished groups, starting from the tail */
+		for (tail = ot.pos; tail != head;
+				tail += st.stnum & SORING_ST_MASK) {
+			idx = tail & r->mask;
+			st.raw = rte_atomic_load_explicit(&r->state[idx].raw,
+					rte_memory_order_acquire);
+			if (st.ftoken != tail ||
+					(st.stnum & SORING_ST_FINISH) == 0)
+				break;
+			rte_atomic_store_explicit(&r->state[idx].raw, 0,
+					rte_memory_order_relaxed);
+		}
+
+		/* release the sync flag along with the new tail */
+		nt.pos = tail;
+		nt.sync = 0;
+		rte_atomic_store_explicit(&stg->tail.raw, nt.raw,
+				rte_memory_order_release);
+
+		/*
+		 * A group released while the flag was held may have been
+		 * missed, and its releaser left the work to us. Pairs with
+		 * the fence in soring_release().
+		 */
+		rte_atomic_thread_fence(rte_memory_order_seq_cst);
+		head = rte_atomic_load_explicit(&stg->head,
+				rte_memory_order_relaxed);
+		st.raw = rte_atomic_load_explicit(&r->state[tail & r->mask].raw,
+				rte_memory_order_relaxed);
+	} while (tail != head && st.ftoken == tail &&
+			(st.stnum & SORING_ST_FINISH) != 0);
+}
+
+static __rte_always_inline uint32_t
+soring_enqueue(struct rte_soring *r, const void *objs, uint32_t n,
+	enum rte_ring_queue_behavior behavior, uint32_t *free_space)
+{
+	uint32_t head, free;
+	uint32_t is_st = (r->prod.sync_type == RTE_RING_SYNC_ST);
+
+	n = soring_move_head(&r->prod.head, &r->cons.tail, r->capacity, is_st,
+			n, behavior, &head, &free);
+	if (n != 0) {
+		soring_copy_in(r, head, objs, n);
+		__rte_ring_update_tail(&r->prod, head, head + n, is_st, 1);
+	}
+
+	if (free_space != NULL)
+		*free_space = free;
+	return n;
+}
+
+static __rte_always_inline uint32_t
+soring_dequeue(struct rte_soring *r, void *objs, uint32_t n,
+	enum rte_ring_queue_behavior behavior, uint32_t *available)
+{
+	uint32_t head, avail;
+	uint32_t is_st = (r->cons.sync_type == RTE_RING_SYNC_ST);
+
+	n = soring_move_head(&r->cons.head, soring_prev_tail(r, r->nb_stage),
+			0, is_st, n, behavior, &head, &avail);
+	if (n != 0) {
+		soring_copy_out(r, head, objs, n);
+		__rte_ring_update_tail(&r->cons, head, head + n, is_st, 0);
+	}
+
+	if (available != NULL)
+		*available = avail;
+	return n;
+}
+
+static __rte_always_inline uint32_t
+soring_acquire(struct rte_soring *r, void *objs, struct rte_ring_zc_data *zcd,
+	uint32_t stage, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *ftoken, uint32_t *available)
+{
+	uint32_t head, avail, idx;
+
+	RTE_ASSERT(stage < r->nb_stage);
+
+	n = soring_move_head(&r->stage[stage].head, soring_prev_tail(r, stage),
+			0, 0, n, behavior, &head, &avail);
+	if (n != 0) {
+		if (objs != NULL)
+			soring_copy_out(r, head, objs, n);
+		if (zcd != NULL) {
+			idx = head & r->mask;
+			zcd->ptr1 = RTE_PTR_ADD(r->elems,
+					(size_t)idx * r->esize);
+			zcd->n1 = RTE_MIN(n, r->size - idx);
+			zcd->ptr2 = (zcd->n1 != n) ? r->elems : NULL;
+		}
+		*ftoken = head;
+	}
+
+	if (available != NULL)
+		*available = avail;
+	return n;
+}
+
+uint32_t
+rte_soring_enqueue_bulk(struct rte_soring *r, const void *objs, uint32_t n,
+	uint32_t *free_space)
+{
+	return soring_enqueue(r, objs, n, RTE_RING_QUEUE_FIXED, free_space);
+}
+
+uint32_t
+rte_soring_enqueue_burst(struct rte_soring *r, const void *objs, uint32_t n,
+	uint32_t *free_space)
+{
+	return soring_enqueue(r, objs, n, RTE_RING_QUEUE_VARIABLE, free_space);
+}
+
+uint32_t
+rte_soring_dequeue_bulk(struct rte_soring *r, void *objs, uint32_t n,
+	uint32_t *available)
+{
+	return soring_dequeue(r, objs, n, RTE_RING_QUEUE_FIXED, available);
+}
+
+uint32_t
+rte_soring_dequeue_burst(struct rte_soring *r, void *objs, uint32_t n,
+	uint32_t *available)
+{
+	return soring_dequeue(r, objs, n, RTE_RING_QUEUE_VARIABLE, available);
+}
+
+uint32_t
+rte_soring_acquire_bulk(struct rte_soring *r, void *objs, uint32_t stage,
+	uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, objs, NULL, stage, n, RTE_RING_QUEUE_FIXED,
+			ftoken, available);
+}
+
+uint32_t
+rte_soring_acquire_burst(struct rte_soring *r, void *objs, uint32_t stage,
+	uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, objs, NULL, stage, n, RTE_RING_QUEUE_VARIABLE,
+			ftoken, available);
+}
+
+uint32_t
+rte_soring_acquire_zc_bulk(struct rte_soring *r, uint32_t stage, uint32_t n,
+	struct rte_ring_zc_data *zcd, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, NULL, zcd, stage, n, RTE_RING_QUEUE_FIXED,
+			ftoken, available);
+}
+
+uint32_t
+rte_soring_acquire_zc_burst(struct rte_soring *r, uint32_t stage, uint32_t n,
+	struct rte_ring_zc_data *zcd, uint32_t *ftoken, uint32_t *available)
+{
+	return soring_acquire(r, NULL, zcd, stage, n, RTE_RING_QUEUE_VARIABLE,
+			ftoken, available);
+}
+
+void
+rte_soring_release(struct rte_soring *r, const void *objs, uint32_t stage,
+	uint32_t n, uint32_t ftoken)
+{
+	struct soring_stage *stg;
+	union soring_stage_tail tail;
+	union soring_state st;
+
+	RTE_ASSERT(stage < r->nb_stage);
+	RTE_ASSERT(n != 0 && n <= r->capacity);
+
+	stg = &r->stage[stage];
+	if (objs != NULL)
+		soring_copy_in(r, ftoken, objs, n);
+
+	/* mark the group as finished, after the updates of its elements */
+	st.ftoken = ftoken;
+	st.stnum = SORING_ST_FINISH | n;
+	rte_atomic_store_explicit(&r->state[ftoken & r->mask].raw, st.raw,
+			rte_memory_order_release);
+
+	/*
+	 * Only the group at the tail can move it. Pairs with the fence in
+	 * soring_stage_finalize(): either we see the tail reaching our
+	 * group, or the thread moving the tail sees our group finished.
+	 */
+	rte_atomic_thread_fence(rte_memory_order_seq_cst);
+	tail.raw = rte_atomic_load_explicit(&stg->tail.raw,
+			rte_memory_order_relaxed);
+	if (tail.pos == ftoken && tail.sync == 0)
+		soring_stage_finalize(r, stg);
+}
+
+uint32_t
+rte_soring_count(const struct rte_soring *r)
+{
+	uint32_t prod_tail = rte_atomic_load_explicit(&r->prod.tail,
+			rte_memory_order_relaxed);
+	uint32_t cons_tail = rte_atomic_load_explicit(&r->cons.tail,
+			rte_memory_order_relaxed);
+	uint32_t count = (prod_tail - cons_tail) & UINT32_MAX;
+
+	return (count > r->capacity) ? r->capacity : count;
+}
+
+uint32_t
+rte_soring_free_count(const struct rte_soring *r)
+{
+	return r->capacity - rte_soring_count(r);
+}
+
+static int
+soring_check_param(const struct rte_soring_param *prm)
+{
+	if (prm->elem_size == 0 || prm->elem_size % 4 != 0) {
+		SORING_LOG(ERR, "element size is not a multiple of 4");
+		return -EINVAL;
+	}
+	if (prm->elems == 0 || prm->elems > RTE_SORING_ELEM_MAX) {
+		SORING_LOG(ERR, "number of elements %u is not in range (0, %u]",
+			prm->elems, RTE_SORING_ELEM_MAX);
+		return -EINVAL;
+	}
+	if (prm->stages == 0 || prm->stages > RTE_SORING_STAGE_MAX) {
+		SORING_LOG(ERR, "number of stages %u is not in range (0, %u]",
+			prm->stages, RTE_SORING_STAGE_MAX);
+		return -EINVAL;
+	}
+	if ((prm->prod_synt != RTE_RING_SYNC_MT &&
+			prm->prod_synt != RTE_RING_SYNC_ST) ||
+			(prm->cons_synt != RTE_RING_SYNC_MT &&
+			 prm->cons_synt != RTE_RING_SYNC_ST)) {
+		SORING_LOG(ERR, "unsupported producer or consumer sync type");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+/* Offsets of the arrays following the SORING structure. */
+static void
+soring_layout(const struct rte_soring_param *prm, size_t *stage_ofs,
+	size_t *state_ofs, size_t *elems_ofs, size_t *total)
+{
+	uint32_t size = rte_align32pow2(prm->elems);
+
+	*stage_ofs = RTE_ALIGN_CEIL(sizeof(struct rte_soring),
+			RTE_CACHE_LINE_SIZE);
+	*state_ofs = *stage_ofs +
+		(size_t)prm->stages * sizeof(struct soring_stage);
+	*elems_ofs = RTE_ALIGN_CEIL(*state_ofs +
+			(size_t)size * sizeof(union soring_state),
+			RTE_CACHE_LINE_SIZE);
+	*total = RTE_ALIGN_CEIL(*elems_ofs + (size_t)size * prm->elem_size,
+			RTE_CACHE_LINE_SIZE);
+}
+
+ssize_t
+rte_soring_get_memsize(const struct rte_soring_param *prm)
+{
+	size_t stage_ofs, state_ofs, elems_ofs, total;
+
+	if (prm == NULL || soring_check_param(prm) != 0)
+		return -EINVAL;
+
+	soring_layout(prm, &stage_ofs, &state_ofs, &elems_ofs, &total);
+	return total;
+}
+
+int
+rte_soring_init(struct rte_soring *r, const struct rte_soring_param *prm)
+{
+	size_t stage_ofs, state_ofs, elems_ofs, total;
+	int ret;
+
+	if (r == NULL || prm == NULL)
+		return -EINVAL;
+
+	ret = soring_check_param(prm);
+	if (ret != 0)
+		return ret;
+
+	soring_layout(prm, &stage_ofs, &state_ofs, &elems_ofs, &total);
+	memset(r, 0, total);
+
+	if (prm->name != NULL &&
+			strlcpy(r->name, prm->name, sizeof(r->name)) >=
+			sizeof(r->name))
+		return -ENAMETOOLONG;
+
+	r->size = rte_align32pow2(prm->elems);
+	r->mask = r->size - 1;
+	r->capacity = prm->elems;
+	r->esize = prm->elem_size;
+	r->nb_stage = prm->stages;
+	r->stage = RTE_PTR_ADD(r, stage_ofs);
+	r->state = RTE_PTR_ADD(r, state_ofs);
+	r->elems = RTE_PTR_ADD(r, elems_ofs);
+	r->prod.sync_type = prm->prod_synt;
+	r->cons.sync_type = prm->cons_synt;
+
+	return 0;
+}
+
+void
+rte_soring_dump(FILE *f, const struct rte_soring *r)
+{
+	uint32_t i;
+
+	if (f == NULL || r == NULL)
+		return;
+
+	fprintf(f, "soring <%s>@%p\n", r->name, r);
+	fprintf(f, "  size=%"PRIu32"\n", r->size);
+	fprintf(f, "  capacity=%"PRIu32"\n", r->capacity);
+	fprintf(f, "  esize=%"PRIu32"\n", r->esize);
+	fprintf(f, "  ph=%"PRIu32"\n", r->prod.head);
+	fprintf(f, "  pt=%"PRIu32"\n", r->prod.tail);
+	for (i = 0; i != r->nb_stage; i++) {
+		fprintf(f, "  stage[%"PRIu32"]: h=%"PRIu32", t=%"PRIu32"\n",
+			i, r->stage[i].head, r->stage[i].tail.pos);
+	}
+	fprintf(f, "  ch=%"PRIu32"\n", r->cons.head);
+	fprintf(f, "  ct=%"PRIu32"\n", r->cons.tail);
+	fprintf(f, "  used=%u\n", rte_soring_count(r));
+	fprintf(f, "  avail=%u\n", rte_soring_free_count(r));
+}
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2024 Intel Corporation
+ */
+
+#ifndef _SORING_H_
+#define _SORING_H_
+
+/**
+ * @file
+ * This file contains internal structures of the staged-ordered ring.
+ * It is not supposed to be included by applications.
+ */
+
+#include <rte_soring.h>
+
+/* Bits of soring_state.stnum: the release flag and the element count */
+#define SORING_ST_FINISH	RTE_BIT32(31)
+#define SORING_ST_MASK		(RTE_SORING_ELEM_MAX)
+
+/*
+ * Per element state, valid only for the first element of a released
+ * group. It records the token of the group and the number of elements
+ * in it, so that the stage tail can walk over finished groups in order.
+ */
+union soring_state {
+	alignas(sizeof(uint64_t)) RTE_ATOMIC(uint64_t) raw;
+	struct {
+		uint32_t ftoken;
+		uint32_t stnum;
+	};
+};
+
+/*
+ * Stage tail: the position and a flag, which grants one thread at a time
+ * the right to move the tail forward.
+ */
+union soring_stage_tail {
+	alignas(sizeof(uint64_t)) RTE_ATOMIC(uint64_t) raw;
+	struct {
+		uint32_t sync;
+		uint32_t pos;
+	};
+};
+
+struct soring_stage {
+	/* position up to which elements were acquired by this stage */
+	alignas(RTE_CACHE_LINE_SIZE) RTE_ATOMIC(uint32_t) head;
+	/* position up to which elements were released, in order */
+	alignas(RTE_CACHE_LINE_SIZE) union soring_stage_tail tail;
+};
+
+struct __rte_cache_aligned rte_soring {
+	uint32_t size;		/* size of the ring, a power of 2 */
+	uint32_t mask;		/* mask (size - 1) of the ring */
+	uint32_t capacity;	/* usable size of the ring */
+	uint32_t esize;		/* size of an element, in bytes */
+	uint32_t nb_stage;	/* number of stages */
+
+	struct soring_stage *stage;	/* array of nb_stage stages */
+	union soring_state *state;	/* array of size states */
+	void *elems;			/* array of size elements */
+
+	alignas(RTE_CACHE_LINE_SIZE) char name[RTE_RING_NAMESIZE];
+
+	/* producer head/tail, stage 0 acquires up to the producer tail */
+	alignas(RTE_CACHE_LINE_SIZE) struct rte_ring_headtail prod;
+
+	/*
+	 * consumer head/tail, the consumer dequeues up to the tail of the
+	 * last stage and the producer enqueues up to the consumer tail
+	 */
+	alignas(RTE_CACHE_LINE_SIZE) struct rte_ring_headtail cons;
+};
+
+#endif /* _SORING_H_ */
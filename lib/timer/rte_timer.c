@@ -18,9 +18,45 @@
 #include <rte_random.h>
 #include <rte_pause.h>
 #include <rte_memzone.h>
+#include <rte_malloc.h>
+#include <rte_bitops.h>
 
 #include "rte_timer.h"
 
+/* Timer wheel geometry: TIMER_WHEEL_LVL_NUM levels of TIMER_WHEEL_LVL_SIZE
+ * slots, each level covering TIMER_WHEEL_LVL_BITS more bits of the tick
+ * than the previous one. Timers further away than that sit in an overflow
+ * slot, which is scanned once per turn of the last level.
+ */
+#define TIMER_WHEEL_LVL_BITS	8
+#define TIMER_WHEEL_LVL_SIZE	(1 << TIMER_WHEEL_LVL_BITS)
+#define TIMER_WHEEL_LVL_MASK	(TIMER_WHEEL_LVL_SIZE - 1)
+#define TIMER_WHEEL_LVL_NUM	4
+#define TIMER_WHEEL_OVERFLOW	(TIMER_WHEEL_LVL_NUM * TIMER_WHEEL_LVL_SIZE)
+
+/* In a wheel, sl_next[0] links the timers of a slot and sl_next[1] holds
+ * the address of the pointer to the timer (slot head or previous sl_next[0]),
+ * or NULL once the timer has been taken out of the wheel to be run.
+ */
+#define WHEEL_NEXT(tim)		((tim)->sl_next[0])
+#define WHEEL_PPREV_GET(tim)	\
+	((struct rte_timer **)(uintptr_t)(tim)->sl_next[1])
+#define WHEEL_PPREV_SET(tim, pprev)	\
+	((tim)->sl_next[1] = (struct rte_timer *)(uintptr_t)(pprev))
+
+/**
+ * Per-lcore timer wheel.
+ */
+struct timer_wheel {
+	uint64_t cur;   /**< next tick to process */
+	uint32_t shift; /**< log2 of the tick length in timer cycles */
+	uint32_t count; /**< number of timers in the wheel */
+	/** bitmap of the non empty slots of each level */
+	uint64_t slot_bmp[TIMER_WHEEL_LVL_NUM][TIMER_WHEEL_LVL_SIZE / 64];
+	/** lists of timers, per level and slot, followed by the overflow */
+	struct rte_timer *slots[TIMER_WHEEL_OVERFLOW + 1];
+};
+
 /**
  * Per-lcore info for timers.
  */
@@ -40,6 +76,9 @@ struct __rte_cache_aligned priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timer wheel used instead of the skiplist, if any */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -108,12 +147,69 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+int
+rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution)
+{
+	struct rte_timer_data *data;
+	struct timer_wheel *wheels;
+	uint32_t id, lcore_id, shift;
+	uint64_t cur;
+	int ret;
+
+	if (resolution == 0)
+		return -EINVAL;
+
+	if (!rte_timer_subsystem_initialized)
+		return -ENOMEM;
+
+	wheels = rte_zmalloc("rte_timer_wheel",
+			RTE_MAX_LCORE * sizeof(*wheels), RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL)
+		return -ENOMEM;
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret != 0) {
+		rte_free(wheels);
+		return ret;
+	}
+
+	shift = rte_fls_u64(resolution) - 1;
+	cur = rte_get_timer_cycles() >> shift;
+
+	data = &rte_timer_data_arr[id];
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].shift = shift;
+		wheels[lcore_id].cur = cur;
+		data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
+/* release the timer wheels of a timer data instance, if any */
+static void
+timer_data_free_wheels(struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id;
+
+	if (timer_data->priv_timer[0].wheel == NULL)
+		return;
+
+	rte_free(timer_data->priv_timer[0].wheel);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	timer_data_free_wheels(timer_data);
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -187,6 +283,8 @@ rte_timer_subsystem_init(void)
 void
 rte_timer_subsystem_finalize(void)
 {
+	int i;
+
 	rte_mcfg_timer_lock();
 
 	if (!rte_timer_subsystem_initialized) {
@@ -194,8 +292,11 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			timer_data_free_wheels(&rte_timer_data_arr[i]);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -382,6 +483,201 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/* link the timer at the head of the given wheel slot */
+static inline void
+timer_wheel_link(struct timer_wheel *wheel, struct rte_timer *tim,
+		 uint32_t slot)
+{
+	struct rte_timer **head = &wheel->slots[slot];
+
+	WHEEL_NEXT(tim) = *head;
+	if (*head != NULL)
+		WHEEL_PPREV_SET(*head, &WHEEL_NEXT(tim));
+	WHEEL_PPREV_SET(tim, head);
+	*head = tim;
+
+	if (slot != TIMER_WHEEL_OVERFLOW)
+		wheel->slot_bmp[slot / TIMER_WHEEL_LVL_SIZE]
+			[(slot % TIMER_WHEEL_LVL_SIZE) / 64] |=
+			RTE_BIT64(slot % 64);
+}
+
+/* clear the bitmap bit of a wheel slot that became empty */
+static inline void
+timer_wheel_slot_clear(struct timer_wheel *wheel, uint32_t slot)
+{
+	if (slot != TIMER_WHEEL_OVERFLOW)
+		wheel->slot_bmp[slot / TIMER_WHEEL_LVL_SIZE]
+			[(slot % TIMER_WHEEL_LVL_SIZE) / 64] &=
+			~RTE_BIT64(slot % 64);
+}
+
+/*
+ * Put the timer in the slot matching its expire time: the tick at or
+ * after expire, on the lowest level that still reaches it from the
+ * current tick.
+ */
+static void
+timer_wheel_add(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint64_t tick, delta;
+	uint32_t lvl, slot;
+
+	tick = (tim->expire >> wheel->shift) +
+		((tim->expire & (RTE_BIT64(wheel->shift) - 1)) != 0);
+	if (tick < wheel->cur)
+		tick = wheel->cur;
+	delta = tick - wheel->cur;
+
+	slot = TIMER_WHEEL_OVERFLOW;
+	for (lvl = 0; lvl != TIMER_WHEEL_LVL_NUM; lvl++) {
+		if (delta < RTE_BIT64((lvl + 1) * TIMER_WHEEL_LVL_BITS)) {
+			slot = lvl * TIMER_WHEEL_LVL_SIZE +
+				((tick >> (lvl * TIMER_WHEEL_LVL_BITS)) &
+				TIMER_WHEEL_LVL_MASK);
+			break;
+		}
+	}
+
+	timer_wheel_link(wheel, tim, slot);
+	wheel->count++;
+}
+
+/* unlink the timer from its slot, unless it was already taken out */
+static void
+timer_wheel_del(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = WHEEL_PPREV_GET(tim);
+	struct rte_timer *next = WHEEL_NEXT(tim);
+	uintptr_t ofs;
+
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL)
+		WHEEL_PPREV_SET(next, pprev);
+	WHEEL_PPREV_SET(tim, NULL);
+	wheel->count--;
+
+	/* pprev is a slot head when the timer was first in its slot */
+	ofs = (uintptr_t)pprev - (uintptr_t)wheel->slots;
+	if (next == NULL && ofs < sizeof(wheel->slots))
+		timer_wheel_slot_clear(wheel, ofs / sizeof(wheel->slots[0]));
+}
+
+/* take all timers of a slot out of the wheel, return the list head */
+static struct rte_timer *
+timer_wheel_slot_take(struct timer_wheel *wheel, uint32_t slot)
+{
+	struct rte_timer *head, *tim;
+
+	head = wheel->slots[slot];
+	wheel->slots[slot] = NULL;
+	timer_wheel_slot_clear(wheel, slot);
+
+	for (tim = head; tim != NULL; tim = WHEEL_NEXT(tim)) {
+		WHEEL_PPREV_SET(tim, NULL);
+		wheel->count--;
+	}
+
+	return head;
+}
+
+/* re-insert the timers of a higher level slot closer to their expiry */
+static void
+timer_wheel_cascade_slot(struct timer_wheel *wheel, uint32_t slot)
+{
+	struct rte_timer *tim, *next;
+
+	for (tim = timer_wheel_slot_take(wheel, slot); tim != NULL;
+			tim = next) {
+		next = WHEEL_NEXT(tim);
+		timer_wheel_add(wheel, tim);
+	}
+}
+
+/* the current tick starts a new turn of level 0, cascade higher levels */
+static void
+timer_wheel_cascade(struct timer_wheel *wheel)
+{
+	uint32_t idx, lvl;
+
+	for (lvl = 1; lvl != TIMER_WHEEL_LVL_NUM; lvl++) {
+		idx = (wheel->cur >> (lvl * TIMER_WHEEL_LVL_BITS)) &
+			TIMER_WHEEL_LVL_MASK;
+		timer_wheel_cascade_slot(wheel,
+			lvl * TIMER_WHEEL_LVL_SIZE + idx);
+		if (idx != 0)
+			return;
+	}
+
+	timer_wheel_cascade_slot(wheel, TIMER_WHEEL_OVERFLOW);
+}
+
+/* find the first non empty level 0 slot at or after idx */
+static inline uint32_t
+timer_wheel_next_slot(const struct timer_wheel *wheel, uint32_t idx)
+{
+	uint32_t i;
+	uint64_t bmp;
+
+	i = idx / 64;
+	bmp = wheel->slot_bmp[0][i] & ~(RTE_BIT64(idx % 64) - 1);
+	while (bmp == 0) {
+		if (++i == RTE_DIM(wheel->slot_bmp[0]))
+			return TIMER_WHEEL_LVL_SIZE;
+		bmp = wheel->slot_bmp[0][i];
+	}
+
+	return i * 64 + rte_ctz64(bmp);
+}
+
+/*
+ * Advance the wheel up to cur_time and take out all timers of the ticks
+ * elapsed, linked through sl_next[0]. Empty slots are skipped using the
+ * level 0 bitmap. Call with the list lock held.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct timer_wheel *wheel, uint64_t cur_time)
+{
+	struct rte_timer *run_first_tim, **pprev, *tim;
+	uint64_t now, last;
+	uint32_t idx, n;
+
+	now = cur_time >> wheel->shift;
+	run_first_tim = NULL;
+	pprev = &run_first_tim;
+
+	while (wheel->cur <= now && wheel->count != 0) {
+		idx = wheel->cur & TIMER_WHEEL_LVL_MASK;
+		if (idx == 0)
+			timer_wheel_cascade(wheel);
+
+		n = timer_wheel_next_slot(wheel, idx);
+		last = wheel->cur | TIMER_WHEEL_LVL_MASK;
+		if (n == TIMER_WHEEL_LVL_SIZE || wheel->cur + n - idx > now) {
+			/* nothing to run before now or the next turn */
+			wheel->cur = (last >= now) ? now + 1 : last + 1;
+			continue;
+		}
+
+		wheel->cur += n - idx;
+		tim = timer_wheel_slot_take(wheel, n);
+		*pprev = tim;
+		while (tim != NULL) {
+			pprev = &WHEEL_NEXT(tim);
+			tim = *pprev;
+		}
+		wheel->cur++;
+	}
+
+	if (wheel->cur <= now)
+		wheel->cur = now + 1;
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -393,6 +689,19 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 {
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
+	struct timer_wheel *wheel = priv_timer[tim_lcore].wheel;
+
+	if (wheel != NULL) {
+		/* an empty wheel doesn't need to catch up with elapsed ticks */
+		if (wheel->count == 0)
+			wheel->cur = RTE_MAX(wheel->cur,
+				rte_get_timer_cycles() >> wheel->shift);
+		timer_wheel_add(wheel, tim);
+		/* next tick is the earliest time something can expire */
+		priv_timer[tim_lcore].pending_head.expire =
+			wheel->cur << wheel->shift;
+		return;
+	}
 
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
@@ -439,6 +748,11 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
 
+	if (priv_timer[prev_owner].wheel != NULL) {
+		timer_wheel_del(priv_timer[prev_owner].wheel, tim);
+		goto unlock;
+	}
+
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -459,6 +773,7 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		else
 			break;
 
+unlock:
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
@@ -650,6 +965,65 @@ rte_timer_pending(struct rte_timer *tim)
 				rte_memory_order_relaxed) == RTE_TIMER_PENDING;
 }
 
+/* check whether no timer is pending on the given lcore */
+static inline int
+timer_list_empty(const struct priv_timer *privp)
+{
+	if (privp->wheel != NULL)
+		return privp->wheel->count == 0;
+
+	return privp->pending_head.sl_next[0] == NULL;
+}
+
+/*
+ * Take the timers expired at cur_time out of the pending list of
+ * tim_lcore, and return them linked through sl_next[0].
+ * Call with the list lock held.
+ */
+static struct rte_timer *
+timer_get_expired(uint64_t cur_time, unsigned int tim_lcore,
+		  struct priv_timer *priv_timer)
+{
+	struct priv_timer *privp = &priv_timer[tim_lcore];
+	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
+	struct rte_timer *tim;
+	int i;
+
+	if (privp->wheel != NULL) {
+		tim = timer_wheel_expire(privp->wheel, cur_time);
+		/* next tick is the earliest time something can expire */
+		privp->pending_head.expire =
+			privp->wheel->cur << privp->wheel->shift;
+		return tim;
+	}
+
+	/* if nothing to do just return */
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time)
+		return NULL;
+
+	/* save start of list of expired timers */
+	tim = privp->pending_head.sl_next[0];
+
+	/* break the existing list at current time point */
+	timer_get_prev_entries(cur_time, tim_lcore, prev, priv_timer);
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
+			continue;
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
+		if (prev[i]->sl_next[i] == NULL)
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
+	}
+
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
+
+	return tim;
+}
+
 /* must be called periodically, run all timer that expired */
 static void
 __rte_timer_manage(struct rte_timer_data *timer_data)
@@ -658,9 +1032,8 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
 	unsigned lcore_id = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
-	int i, ret;
+	int ret;
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
 	/* timer manager only runs on EAL thread with valid lcore_id */
@@ -668,7 +1041,7 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 
 	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
+	if (timer_list_empty(&priv_timer[lcore_id]))
 		return;
 	cur_time = rte_get_timer_cycles();
 
@@ -683,28 +1056,14 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	/* browse ordered list, add expired timers in 'expired' list */
 	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
 
+	tim = timer_get_expired(cur_time, lcore_id, priv_timer);
+
 	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
+	if (tim == NULL) {
 		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 		return;
 	}
 
-	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
-
-	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
-			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
-		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
-	}
-
 	/* transition run-list from PENDING to RUNNING */
 	run_first_tim = tim;
 	pprev = &run_first_tim;
@@ -723,11 +1082,6 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
-
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
 	/* now scan expired list and call callbacks */
@@ -800,9 +1154,8 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	struct rte_timer *tim, *next_tim, **pprev;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
-	int i, j, ret;
+	int i, ret;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
 	struct priv_timer *privp;
@@ -825,7 +1178,7 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		privp = &data->priv_timer[poll_lcore];
 
 		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
+		if (timer_list_empty(privp))
 			continue;
 		cur_time = rte_get_timer_cycles();
 
@@ -841,30 +1194,15 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		/* browse ordered list, add expired timers in 'expired' list */
 		rte_spinlock_lock(&privp->list_lock);
 
+		tim = timer_get_expired(cur_time, poll_lcore,
+					data->priv_timer);
+
 		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
+		if (tim == NULL) {
 			rte_spinlock_unlock(&privp->list_lock);
 			continue;
 		}
 
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
 		/* transition run-list from PENDING to RUNNING */
 		run_first_tims[nb_runlists] = tim;
 		pprev = &run_first_tims[nb_runlists];
@@ -884,11 +1222,6 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 			}
 		}
 
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
 		rte_spinlock_unlock(&privp->list_lock);
 	}
 
@@ -969,6 +1302,23 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Stop the timers of a pending list, calling user-specified function */
+static void
+timer_stop_list(struct rte_timer *tim, struct rte_timer_data *timer_data,
+		rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct rte_timer *next_tim;
+
+	for (; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		__rte_timer_stop(tim, timer_data);
+
+		if (f)
+			f(tim, f_arg);
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -977,8 +1327,7 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 {
 	int i;
 	struct priv_timer *priv_timer;
-	uint32_t walk_lcore;
-	struct rte_timer *tim, *next_tim;
+	uint32_t slot, walk_lcore;
 	struct rte_timer_data *timer_data;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
@@ -987,16 +1336,15 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
-		for (tim = priv_timer->pending_head.sl_next[0];
-		     tim != NULL;
-		     tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			__rte_timer_stop(tim, timer_data);
-
-			if (f)
-				f(tim, f_arg);
+		if (priv_timer->wheel == NULL) {
+			timer_stop_list(priv_timer->pending_head.sl_next[0],
+					timer_data, f, f_arg);
+			continue;
 		}
+
+		for (slot = 0; slot <= TIMER_WHEEL_OVERFLOW; slot++)
+			timer_stop_list(priv_timer->wheel->slots[slot],
+					timer_data, f, f_arg);
 	}
 
 	return 0;
@@ -38,6 +38,7 @@
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_spinlock.h>
 
 #ifdef __cplusplus
@@ -156,6 +157,40 @@ int rte_timer_data_alloc(uint32_t *id_ptr);
  */
 int rte_timer_data_dealloc(uint32_t id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate a timer data instance that keeps pending timers in per-lcore
+ * hierarchical timer wheels instead of skiplists.
+ *
+ * Arming and stopping a timer of such an instance is O(1), and
+ * rte_timer_alt_manage() takes expired timers out a whole wheel slot at a
+ * time. In exchange, timers expire at the first tick of the wheel at or
+ * after their expiry time, so they may run up to one resolution late, and
+ * timers expiring within the same tick are not ordered.
+ * Timers further than 2^32 ticks away are kept in an overflow list that is
+ * scanned once every 2^32 ticks.
+ *
+ * The instance is used through the rte_timer_alt_*() functions and released
+ * with rte_timer_data_dealloc(), as any other timer data instance.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param resolution
+ *   Length of a wheel tick in timer cycles (see rte_get_timer_hz()),
+ *   rounded down to a power of 2.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid resolution
+ *   - -ENOMEM: timer subsystem not initialized or no memory for the wheels
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution);
+
 /**
  * Initialize the timer library.
  *
@@ -286,6 +286,31 @@ __rte_experimental
 int
 rte_vhost_async_dma_unconfigure(int16_t dma_id, uint16_t vchan_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the length under which the copies of a vhost queue using async
+ * channel acceleration are done by the CPU instead of the DMA vChannel.
+ * Submitting a DMA copy and polling its completion costs more than
+ * copying a few bytes, so small packets or segments are better copied
+ * by the CPU; these copies are gathered and done once per burst.
+ * The threshold is reset when the async channel is unregistered.
+ *
+ * @param vid
+ *  ID of vhost device
+ * @param queue_id
+ *  ID of virtqueue, with an async channel registered
+ * @param len
+ *  Length in bytes, 0 (the default) to use the DMA vChannel for all copies
+ * @return
+ *  0 on success, and -1 on failure
+ */
+__rte_experimental
+int
+rte_vhost_async_set_cpu_copy_threshold(int vid, uint16_t queue_id,
+		uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
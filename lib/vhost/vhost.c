@@ -2329,5 +2329,42 @@ rte_vhost_async_dma_unconfigure(int16_t dma_id, uint16_t vchan_id)
 	return -1;
 }
 
+int
+rte_vhost_async_set_cpu_copy_threshold(int vid, uint16_t queue_id,
+		uint32_t len)
+{
+	struct vhost_virtqueue *vq;
+	struct virtio_net *dev = get_device(vid);
+	int ret = -1;
+
+	if (dev == NULL)
+		return ret;
+
+	if (queue_id >= VHOST_MAX_VRING)
+		return ret;
+
+	vq = dev->virtqueue[queue_id];
+
+	if (vq == NULL)
+		return ret;
+
+	rte_rwlock_write_lock(&vq->access_lock);
+
+	if (vq->async == NULL) {
+		VHOST_CONFIG_LOG(dev->ifname, ERR,
+			"async channel not registered for queue id %u.",
+			queue_id);
+		goto out_unlock;
+	}
+
+	vq->async->cpu_copy_thresh = len;
+	ret = 0;
+
+out_unlock:
+	rte_rwlock_write_unlock(&vq->access_lock);
+
+	return ret;
+}
+
 RTE_LOG_REGISTER_SUFFIX(vhost_config_log_level, config, INFO);
 RTE_LOG_REGISTER_SUFFIX(vhost_data_log_level, data, WARNING);
@@ -267,6 +267,9 @@ struct vhost_async {
 		uint16_t last_desc_idx_split;
 		uint16_t last_buffer_idx_packed;
 	};
+
+	/* copies shorter than this are done by the CPU rather than the DMA */
+	uint32_t cpu_copy_thresh;
 };
 
 /**
@@ -114,6 +114,12 @@ vhost_async_dma_transfer_one(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	uint32_t nr_segs = pkt->nr_segs;
 	uint16_t i;
 
+	/* all the copies of the packet were done by the CPU */
+	if (nr_segs == 0) {
+		vq->async->pkts_cmpl_flag[flag_idx] = true;
+		return 0;
+	}
+
 	if (rte_dma_burst_capacity(dma_id, vchan_id) < nr_segs)
 		return -1;
 
@@ -1224,6 +1230,7 @@ mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	struct rte_mbuf *hdr_mbuf;
 	struct virtio_net_hdr_mrg_rxbuf tmp_hdr, *hdr = NULL;
 	struct vhost_async *async = vq->async;
+	uint16_t nb_cpu_copies = vq->batch_copy_nb_elems;
 
 	if (unlikely(m == NULL))
 		return -1;
@@ -1310,7 +1317,11 @@ mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
 
 		if (is_async) {
-			if (async_fill_seg(dev, vq, m, mbuf_offset,
+			if (cpy_len < async->cpu_copy_thresh)
+				sync_fill_seg(dev, vq, m, mbuf_offset,
+					      buf_addr + buf_offset,
+					      buf_iova + buf_offset, cpy_len, true);
+			else if (async_fill_seg(dev, vq, m, mbuf_offset,
 					   buf_iova + buf_offset, cpy_len, true) < 0)
 				goto error;
 		} else {
@@ -1330,8 +1341,10 @@ mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	return 0;
 error:
-	if (is_async)
+	if (is_async) {
 		async_iter_cancel(async);
+		vq->batch_copy_nb_elems = nb_cpu_copies;
+	}
 
 	return -1;
 }
@@ -1859,6 +1872,9 @@ virtio_dev_rx_async_submit_split(struct virtio_net *dev, struct vhost_virtqueue
 		vq->last_avail_idx += num_buffers;
 	}
 
+	/* small copies left to the CPU */
+	do_data_copy_enqueue(dev, vq);
+
 	if (unlikely(pkt_idx == 0))
 		return 0;
 
@@ -2010,8 +2026,9 @@ virtio_dev_rx_async_packed_batch_enqueue(struct virtio_net *dev,
 	uint16_t avail_idx = vq->last_avail_idx;
 	uint32_t mbuf_offset = 0;
 	uint16_t ids[PACKED_BATCH_SIZE];
-	uint64_t mapped_len[PACKED_BATCH_SIZE];
-	void *host_iova[PACKED_BATCH_SIZE];
+	bool cpu_copy[PACKED_BATCH_SIZE];
+	uint64_t mapped_len;
+	void *host_iova;
 	uintptr_t desc;
 	uint16_t i;
 
@@ -2019,6 +2036,9 @@ virtio_dev_rx_async_packed_batch_enqueue(struct virtio_net *dev,
 		rte_prefetch0((void *)(uintptr_t)desc_addrs[i]);
 		desc = vhost_iova_to_vva(dev, vq, desc_addrs[i], &lens[i], VHOST_ACCESS_RW);
 		hdrs[i] = (struct virtio_net_hdr_mrg_rxbuf *)(uintptr_t)desc;
+		/* the CPU copy needs the whole buffer to be mapped */
+		cpu_copy[i] = pkts[i]->pkt_len < async->cpu_copy_thresh &&
+			lens[i] >= pkts[i]->pkt_len + buf_offset;
 		lens[i] = pkts[i]->pkt_len +
 			sizeof(struct virtio_net_hdr_mrg_rxbuf);
 	}
@@ -2034,17 +2054,22 @@ virtio_dev_rx_async_packed_batch_enqueue(struct virtio_net *dev,
 
 	vq_inc_last_avail_packed(vq, PACKED_BATCH_SIZE);
 
-	vhost_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
-		host_iova[i] = (void *)(uintptr_t)gpa_to_first_hpa(dev,
-			desc_addrs[i] + buf_offset, lens[i], &mapped_len[i]);
-	}
-
+	/* only the DMA copies need the host IOVA of the buffer */
 	vhost_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
 		async_iter_initialize(dev, async);
-		async_iter_add_iovec(dev, async,
+		if (cpu_copy[i]) {
+			sync_fill_seg(dev, vq, pkts[i], mbuf_offset,
+				      (uintptr_t)hdrs[i] + buf_offset,
+				      desc_addrs[i] + buf_offset,
+				      pkts[i]->pkt_len, true);
+		} else {
+			host_iova = (void *)(uintptr_t)gpa_to_first_hpa(dev,
+				desc_addrs[i] + buf_offset, lens[i], &mapped_len);
+			async_iter_add_iovec(dev, async,
 				(void *)(uintptr_t)rte_pktmbuf_iova_offset(pkts[i], mbuf_offset),
-				host_iova[i],
-				mapped_len[i]);
+				host_iova,
+				mapped_len);
+		}
 		async->iter_idx++;
 	}
 
@@ -2157,6 +2182,9 @@ virtio_dev_rx_async_submit_packed(struct virtio_net *dev, struct vhost_virtqueue
 		vq_inc_last_avail_packed(vq, num_descs);
 	} while (pkt_idx < count);
 
+	/* small copies left to the CPU */
+	do_data_copy_enqueue(dev, vq);
+
 	if (unlikely(pkt_idx == 0))
 		return 0;
 
@@ -2906,6 +2934,7 @@ desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	uint16_t vec_idx;
 	struct vhost_async *async = vq->async;
 	struct async_inflight_info *pkts_info;
+	uint16_t nb_cpu_copies = vq->batch_copy_nb_elems;
 
 	/*
 	 * The caller has checked the descriptors chain is larger than the
@@ -2955,7 +2984,11 @@ desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
 
 		if (is_async) {
-			if (async_fill_seg(dev, vq, cur, mbuf_offset,
+			if (cpy_len < async->cpu_copy_thresh)
+				sync_fill_seg(dev, vq, cur, mbuf_offset,
+					      buf_addr + buf_offset,
+					      buf_iova + buf_offset, cpy_len, false);
+			else if (async_fill_seg(dev, vq, cur, mbuf_offset,
 					   buf_iova + buf_offset, cpy_len, false) < 0)
 				goto error;
 		} else if (likely(hdr && cur == m)) {
@@ -3026,8 +3059,10 @@ desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	return 0;
 error:
-	if (is_async)
+	if (is_async) {
 		async_iter_cancel(async);
+		vq->batch_copy_nb_elems = nb_cpu_copies;
+	}
 
 	return -1;
 }
@@ -3823,6 +3858,9 @@ virtio_dev_tx_async_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		vq->last_avail_idx++;
 	}
 
+	/* small copies left to the CPU */
+	do_data_copy_dequeue(vq);
+
 	if (unlikely(dropped))
 		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx], count - pkt_idx);
 
@@ -3979,8 +4017,9 @@ virtio_dev_tx_async_packed_batch(struct virtio_net *dev,
 	uintptr_t desc_addrs[PACKED_BATCH_SIZE];
 	uint64_t desc_vva;
 	uint64_t lens[PACKED_BATCH_SIZE];
-	void *host_iova[PACKED_BATCH_SIZE];
-	uint64_t mapped_len[PACKED_BATCH_SIZE];
+	uint64_t cpu_addrs[PACKED_BATCH_SIZE];
+	uint64_t mapped_len;
+	void *host_iova;
 	uint16_t ids[PACKED_BATCH_SIZE];
 	uint16_t i;
 
@@ -3991,17 +4030,35 @@ virtio_dev_tx_async_packed_batch(struct virtio_net *dev,
 	vhost_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE)
 		rte_prefetch0((void *)(uintptr_t)desc_addrs[i]);
 
+	/* the CPU copy needs the whole buffer to be mapped */
 	vhost_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
-		host_iova[i] = (void *)(uintptr_t)gpa_to_first_hpa(dev,
-			desc_addrs[i] + buf_offset, pkts[i]->pkt_len, &mapped_len[i]);
+		cpu_addrs[i] = 0;
+		if (pkts[i]->pkt_len < async->cpu_copy_thresh) {
+			mapped_len = pkts[i]->pkt_len + buf_offset;
+			desc_vva = vhost_iova_to_vva(dev, vq, desc_addrs[i],
+						&mapped_len, VHOST_ACCESS_RO);
+			if (mapped_len >= pkts[i]->pkt_len + buf_offset)
+				cpu_addrs[i] = desc_vva;
+		}
 	}
 
+	/* only the DMA copies need the host IOVA of the buffer */
 	vhost_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
 		async_iter_initialize(dev, async);
-		async_iter_add_iovec(dev, async,
-		host_iova[i],
-		(void *)(uintptr_t)rte_pktmbuf_iova_offset(pkts[i], mbuf_offset),
-		mapped_len[i]);
+		if (cpu_addrs[i]) {
+			sync_fill_seg(dev, vq, pkts[i], mbuf_offset,
+				      cpu_addrs[i] + buf_offset,
+				      desc_addrs[i] + buf_offset,
+				      pkts[i]->pkt_len, false);
+		} else {
+			host_iova = (void *)(uintptr_t)gpa_to_first_hpa(dev,
+				desc_addrs[i] + buf_offset, pkts[i]->pkt_len,
+				&mapped_len);
+			async_iter_add_iovec(dev, async,
+				host_iova,
+				(void *)(uintptr_t)rte_pktmbuf_iova_offset(pkts[i], mbuf_offset),
+				mapped_len);
+		}
 		async->iter_idx++;
 	}
 
@@ -4083,6 +4140,9 @@ virtio_dev_tx_async_packed(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		pkt_idx++;
 	} while (pkt_idx < count);
 
+	/* small copies left to the CPU */
+	do_data_copy_dequeue(vq);
+
 	n_xfer = vhost_async_dma_transfer(dev, vq, dma_id, vchan_id, async->pkts_idx,
 					async->iov_iter, pkt_idx);
 